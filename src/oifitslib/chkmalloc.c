@@ -1,7 +1,8 @@
 /**
  * @file
  * @ingroup oitable
- * Implementation of wrappers for malloc() and realloc().
+ * Implementation of wrappers for malloc() and realloc(), and of
+ * allocation statistics.
  *
  * Copyright (C) 2015 John Young
  *
@@ -24,8 +25,493 @@
  */
 
 #include "chkmalloc.h"
+#include "oicontext.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h> /* uintptr_t */
+#include <stdatomic.h>
+#include <pthread.h>
+
+/** Environment variable that enables allocation statistics */
+#define STATS_ENV_VAR "OIFITSLIB_MALLOC_STATS"
+
+/** Size of call site hash table, a power of two > CHKMALLOC_MAX_SITE */
+#define SITE_TABLE_SIZE 256
+
+/** Initial size of live block hash table, a power of two */
+#define INIT_BLOCK_TABLE_SIZE 1024
+
+/** Multiplier for Fibonacci hashing */
+#define HASH_MULT 2654435761u
+
+/**
+ * Add @a n to counter that only one thread writes.
+ *
+ * A plain load and store suffice, but are atomic so that other
+ * threads may read the counter while totalling statistics.
+ */
+#define BUMP(counter, n)                                                       \
+  atomic_store_explicit(                                                       \
+      &(counter),                                                              \
+      atomic_load_explicit(&(counter), memory_order_relaxed) + (n),            \
+      memory_order_relaxed)
+
+/** Read counter written by another thread */
+#define PEEK(counter) atomic_load_explicit(&(counter), memory_order_relaxed)
+
+/** Block allocated while statistics enabled and not yet freed */
+typedef struct
+{
+  void *ptr;
+  size_t size;
+
+} live_block;
+
+/** Statistics for a single call site, readable by other threads */
+typedef struct
+{
+  const char *file;
+  int line;
+  const char *func;
+  atomic_ulong numCall;
+  atomic_size_t bytes;
+
+} site_state;
+
+/**
+ * Allocation statistics and associated lookup tables.
+ *
+ * Only the owning thread writes these while it is running, so no
+ * lock is needed to record allocations. Other threads may read the
+ * counters while holding statsLock.
+ */
+typedef struct stats_state
+{
+  atomic_ulong numAlloc;
+  atomic_ulong numRealloc;
+  atomic_ulong numFree;
+  atomic_size_t current;
+  atomic_size_t peak;
+  atomic_int numSite; /* sites before this index may be read */
+  atomic_int sitesFull;
+  site_state sites[CHKMALLOC_MAX_SITE];
+  int siteIndex[SITE_TABLE_SIZE]; /* 1 + index into sites, or 0 */
+  live_block *blocks; /* open-addressed hash table keyed on ptr */
+  size_t numBlock;
+  size_t blockTableSize;
+  struct stats_state *next; /* next in list of live threads */
+
+} stats_state;
+
+/** -1 if environment not yet checked, otherwise TRUE if enabled */
+static atomic_int statsEnabled = -1;
+
+/** Key for statistics of calling thread, merged into totals on exit */
+static pthread_key_t stateKey;
+static pthread_once_t stateKeyOnce = PTHREAD_ONCE_INIT;
+
+/*
+ * The following are shared between threads and protected by statsLock
+ */
+static pthread_mutex_t statsLock = PTHREAD_MUTEX_INITIALIZER;
+
+/** List of statistics for live threads that have recorded anything */
+static stats_state *liveStates = NULL;
+
+/** Statistics and live blocks merged from threads that have exited */
+static stats_state retired;
+
+/** Number of blocks in retired, readable without statsLock */
+static atomic_size_t numRetiredBlock = 0;
+
+/*
+ * Private functions
+ */
+
+/** Return TRUE if statistics are enabled */
+static int stats_on(void)
+{
+  const char *value;
+  int enabled, expected;
+
+  enabled = atomic_load_explicit(&statsEnabled, memory_order_relaxed);
+  if (enabled < 0)
+  {
+    value = getenv(STATS_ENV_VAR);
+    expected = -1;
+    atomic_compare_exchange_strong(&statsEnabled, &expected,
+                                   (value != NULL && atoi(value) != 0));
+    enabled = atomic_load(&statsEnabled);
+  }
+  return enabled;
+}
+
+/** Find or add call site, returning NULL if table full */
+static site_state *find_site(stats_state *pSt, const char *file, int line,
+                             const char *func)
+{
+  site_state *pSite;
+  unsigned int i, h;
+  int *pIndex, numSite;
+
+  /* File name strings may be duplicated, so hash on line only */
+  h = (unsigned int)line * HASH_MULT;
+  for (i = 0; i < SITE_TABLE_SIZE; i++)
+  {
+    pIndex = &pSt->siteIndex[(h + i) & (SITE_TABLE_SIZE - 1)];
+    if (*pIndex == 0)
+    {
+      numSite = PEEK(pSt->numSite);
+      if (numSite == CHKMALLOC_MAX_SITE)
+      {
+        atomic_store_explicit(&pSt->sitesFull, 1, memory_order_relaxed);
+        return NULL;
+      }
+      pSite = &pSt->sites[numSite];
+      pSite->file = file;
+      pSite->line = line;
+      pSite->func = func;
+      atomic_store_explicit(&pSite->numCall, 0, memory_order_relaxed);
+      atomic_store_explicit(&pSite->bytes, 0, memory_order_relaxed);
+      /* Publish the new entry to threads totalling statistics */
+      atomic_store_explicit(&pSt->numSite, numSite + 1, memory_order_release);
+      *pIndex = numSite + 1;
+      return pSite;
+    }
+    pSite = &pSt->sites[*pIndex - 1];
+    if (pSite->line == line &&
+        (pSite->file == file || strcmp(pSite->file, file) == 0))
+      return pSite;
+  }
+  return NULL;
+}
+
+/** Return home slot of ptr in live block table */
+static size_t block_slot(const stats_state *pSt, const void *ptr)
+{
+  return (size_t)(((uintptr_t)ptr >> 4) * HASH_MULT) &
+         (pSt->blockTableSize - 1);
+}
+
+static void grow_blocks(stats_state *);
+
+/** Add block to live block table */
+static void add_block(stats_state *pSt, void *ptr, size_t size)
+{
+  size_t i;
+
+  if (2 * (pSt->numBlock + 1) > pSt->blockTableSize) grow_blocks(pSt);
+  i = block_slot(pSt, ptr);
+  while (pSt->blocks[i].ptr != NULL)
+    i = (i + 1) & (pSt->blockTableSize - 1);
+  pSt->blocks[i].ptr = ptr;
+  pSt->blocks[i].size = size;
+  ++pSt->numBlock;
+}
+
+/** Double size of live block table */
+static void grow_blocks(stats_state *pSt)
+{
+  live_block *oldBlocks = pSt->blocks;
+  size_t oldSize = pSt->blockTableSize;
+  size_t i;
+
+  pSt->blockTableSize = (oldSize > 0) ? 2 * oldSize : INIT_BLOCK_TABLE_SIZE;
+  pSt->blocks = calloc(pSt->blockTableSize, sizeof(live_block));
+  assert_not_null(pSt->blocks);
+  pSt->numBlock = 0;
+  for (i = 0; i < oldSize; i++)
+  {
+    if (oldBlocks[i].ptr != NULL)
+      add_block(pSt, oldBlocks[i].ptr, oldBlocks[i].size);
+  }
+  free(oldBlocks);
+}
+
+/**
+ * Remove block from live block table and subtract its size from the
+ * current usage.
+ *
+ * @param pSt  statistics containing table
+ * @param ptr  pointer to block
+ *
+ * @return TRUE if block was found, FALSE otherwise
+ */
+static int remove_block(stats_state *pSt, const void *ptr)
+{
+  size_t i, j, k, mask, size;
+
+  if (pSt->blockTableSize == 0) return 0;
+  mask = pSt->blockTableSize - 1;
+  i = block_slot(pSt, ptr);
+  while (pSt->blocks[i].ptr != ptr)
+  {
+    if (pSt->blocks[i].ptr == NULL) return 0;
+    i = (i + 1) & mask;
+  }
+  size = pSt->blocks[i].size;
+
+  /* Shift later entries back to fill the gap, so that lookups still
+   * terminate at the first empty slot */
+  j = i;
+  for (;;)
+  {
+    j = (j + 1) & mask;
+    if (pSt->blocks[j].ptr == NULL) break;
+    k = block_slot(pSt, pSt->blocks[j].ptr);
+    if ((i <= j) ? (k <= i || k > j) : (k <= i && k > j))
+    {
+      pSt->blocks[i] = pSt->blocks[j];
+      i = j;
+    }
+  }
+  pSt->blocks[i].ptr = NULL;
+  --pSt->numBlock;
+  BUMP(pSt->current, -size);
+  return 1;
+}
+
+/**
+ * Stop tracking block that is about to be released.
+ *
+ * Blocks allocated by the calling thread are found without locking.
+ * Otherwise statsLock is only taken if a thread that has exited left
+ * blocks allocated. Blocks allocated by another running thread are
+ * not found.
+ *
+ * @param pSt        statistics for calling thread, or NULL
+ * @param ptr        pointer to block
+ * @param countFree  if TRUE, count block as freed
+ */
+static void untrack_block(stats_state *pSt, const void *ptr, int countFree)
+{
+  if (pSt != NULL && remove_block(pSt, ptr))
+  {
+    if (countFree) BUMP(pSt->numFree, 1);
+    return;
+  }
+  if (atomic_load_explicit(&numRetiredBlock, memory_order_relaxed) == 0)
+    return;
+  pthread_mutex_lock(&statsLock);
+  if (remove_block(&retired, ptr))
+  {
+    if (countFree) BUMP(retired.numFree, 1);
+    atomic_store_explicit(&numRetiredBlock, retired.numBlock,
+                          memory_order_relaxed);
+  }
+  pthread_mutex_unlock(&statsLock);
+}
+
+/** Add counters and call sites from @a pSrc to @a pDest */
+static void add_stats(chkmalloc_stats *pDest, const stats_state *pSrc)
+{
+  const site_state *pSrcSite;
+  chkmalloc_site *pSite;
+  int i, j, numSite;
+
+  pDest->numAlloc += PEEK(pSrc->numAlloc);
+  pDest->numRealloc += PEEK(pSrc->numRealloc);
+  pDest->numFree += PEEK(pSrc->numFree);
+  pDest->current += PEEK(pSrc->current);
+  pDest->peak += PEEK(pSrc->peak);
+  if (PEEK(pSrc->sitesFull)) pDest->sitesFull = 1;
+  numSite = atomic_load_explicit(&pSrc->numSite, memory_order_acquire);
+  for (i = 0; i < numSite; i++)
+  {
+    pSrcSite = &pSrc->sites[i];
+    for (j = 0; j < pDest->numSite; j++)
+    {
+      pSite = &pDest->sites[j];
+      if (pSite->line == pSrcSite->line &&
+          strcmp(pSite->file, pSrcSite->file) == 0)
+        break;
+    }
+    if (j == pDest->numSite)
+    {
+      if (pDest->numSite == CHKMALLOC_MAX_SITE)
+      {
+        pDest->sitesFull = 1;
+        continue;
+      }
+      pSite = &pDest->sites[pDest->numSite++];
+      pSite->file = pSrcSite->file;
+      pSite->line = pSrcSite->line;
+      pSite->func = pSrcSite->func;
+      pSite->numCall = 0;
+      pSite->bytes = 0;
+    }
+    pSite->numCall += PEEK(pSrcSite->numCall);
+    pSite->bytes += PEEK(pSrcSite->bytes);
+  }
+}
+
+/** Remove statistics from list of live threads. Caller holds statsLock */
+static void unlink_state(stats_state *pSt)
+{
+  stats_state **ppSt;
+
+  for (ppSt = &liveStates; *ppSt != NULL; ppSt = &(*ppSt)->next)
+  {
+    if (*ppSt == pSt)
+    {
+      *ppSt = pSt->next;
+      break;
+    }
+  }
+}
+
+/**
+ * Destructor for stateKey, called on exit of thread.
+ *
+ * Adds the thread's statistics to the retired totals, and moves its
+ * live blocks there so that they can still be freed by other threads.
+ */
+static void retire_state(void *data)
+{
+  stats_state *pSt = data;
+  const site_state *pSrcSite;
+  site_state *pSite;
+  size_t i;
+  int j;
+
+  pthread_mutex_lock(&statsLock);
+  unlink_state(pSt);
+  BUMP(retired.numAlloc, PEEK(pSt->numAlloc));
+  BUMP(retired.numRealloc, PEEK(pSt->numRealloc));
+  BUMP(retired.numFree, PEEK(pSt->numFree));
+  BUMP(retired.current, PEEK(pSt->current));
+  BUMP(retired.peak, PEEK(pSt->peak));
+  if (PEEK(pSt->sitesFull))
+    atomic_store_explicit(&retired.sitesFull, 1, memory_order_relaxed);
+  for (j = 0; j < PEEK(pSt->numSite); j++)
+  {
+    pSrcSite = &pSt->sites[j];
+    pSite = find_site(&retired, pSrcSite->file, pSrcSite->line,
+                      pSrcSite->func);
+    if (pSite != NULL)
+    {
+      BUMP(pSite->numCall, PEEK(pSrcSite->numCall));
+      BUMP(pSite->bytes, PEEK(pSrcSite->bytes));
+    }
+  }
+  for (i = 0; i < pSt->blockTableSize; i++)
+  {
+    if (pSt->blocks[i].ptr != NULL)
+      add_block(&retired, pSt->blocks[i].ptr, pSt->blocks[i].size);
+  }
+  atomic_store_explicit(&numRetiredBlock, retired.numBlock,
+                        memory_order_relaxed);
+  pthread_mutex_unlock(&statsLock);
+  free(pSt->blocks);
+  free(pSt);
+}
+
+static void create_state_key(void)
+{
+  int ret;
+
+  ret = pthread_key_create(&stateKey, retire_state);
+  assert_no_error(ret, ret);
+}
+
+/** Get statistics for the calling thread, or NULL if nothing recorded */
+static stats_state *current_state(void)
+{
+  pthread_once(&stateKeyOnce, create_state_key);
+  return pthread_getspecific(stateKey);
+}
+
+/**
+ * Get statistics for the calling thread, creating them if necessary.
+ *
+ * The bookkeeping uses the standard allocator rather than oi_malloc(),
+ * so that it is not itself counted and outlives any ::oi_context.
+ */
+static stats_state *get_state(void)
+{
+  stats_state *pSt;
+  int ret;
+
+  pSt = current_state();
+  if (pSt == NULL)
+  {
+    pSt = calloc(1, sizeof(stats_state));
+    assert_not_null(pSt);
+    ret = pthread_setspecific(stateKey, pSt);
+    assert_no_error(ret, ret);
+    pthread_mutex_lock(&statsLock);
+    pSt->next = liveStates;
+    liveStates = pSt;
+    pthread_mutex_unlock(&statsLock);
+  }
+  return pSt;
+}
+
+/** Record successful allocation or reallocation */
+static void record_alloc(void *ret, int isRealloc, size_t size,
+                         const char *file, int line, const char *func)
+{
+  stats_state *pSt = get_state();
+  site_state *pSite;
+
+  if (isRealloc)
+    BUMP(pSt->numRealloc, 1);
+  else
+    BUMP(pSt->numAlloc, 1);
+
+  /* If the address is still tracked, the block was freed by another
+   * thread, so the stale entry is replaced */
+  if (remove_block(pSt, ret)) BUMP(pSt->numFree, 1);
+  add_block(pSt, ret, size);
+  BUMP(pSt->current, size);
+  if (PEEK(pSt->current) > PEEK(pSt->peak))
+    atomic_store_explicit(&pSt->peak, PEEK(pSt->current),
+                          memory_order_relaxed);
+  pSite = find_site(pSt, file, line, func);
+  if (pSite != NULL)
+  {
+    BUMP(pSite->numCall, 1);
+    BUMP(pSite->bytes, size);
+  }
+}
+
+/** Compare call sites by decreasing number of bytes requested */
+static int compare_sites(const void *a, const void *b)
+{
+  const chkmalloc_site *pSiteA = a, *pSiteB = b;
+
+  if (pSiteA->bytes != pSiteB->bytes)
+    return (pSiteA->bytes < pSiteB->bytes) ? 1 : -1;
+  return (pSiteA->numCall < pSiteB->numCall) -
+         (pSiteA->numCall > pSiteB->numCall);
+}
+
+/** Print allocation statistics */
+static void print_stats(FILE *stream, chkmalloc_stats *pStats)
+{
+  int i;
+
+  fprintf(stream, "Allocations: %lu  Reallocations: %lu  Frees: %lu\n",
+          pStats->numAlloc, pStats->numRealloc, pStats->numFree);
+  fprintf(stream, "Current usage: %lu bytes  Peak usage: %lu bytes\n",
+          (unsigned long)pStats->current, (unsigned long)pStats->peak);
+  qsort(pStats->sites, pStats->numSite, sizeof(chkmalloc_site),
+        compare_sites);
+  fprintf(stream, "%10s %14s  %s\n", "Calls", "Bytes", "Call site");
+  for (i = 0; i < pStats->numSite; i++)
+  {
+    fprintf(stream, "%10lu %14lu  %s:%d:%s\n", pStats->sites[i].numCall,
+            (unsigned long)pStats->sites[i].bytes, pStats->sites[i].file,
+            pStats->sites[i].line, pStats->sites[i].func);
+  }
+  if (pStats->sitesFull)
+    fprintf(stream, "[Call sites after the first %d not listed]\n",
+            CHKMALLOC_MAX_SITE);
+}
+
+/*
+ * Public functions
+ */
 
 void *_chkmalloc(size_t size, const char *file, int line, const char *func)
 {
@@ -35,30 +521,37 @@ void *_chkmalloc(size_t size, const char *file, int line, const char *func)
             file, line, func);
     abort();
   }
-  void *ret = malloc(size);
+  void *ret = oi_malloc(size);
   if (ret == NULL)
   {
     fprintf(stderr, "ERROR:%s:%d:%s: Memory allocation of %lu bytes failed\n",
             file, line, func, (unsigned long)size);
     abort();
   }
+  if (stats_on()) record_alloc(ret, 0, size, file, line, func);
   return ret;
 }
 
 void *_chkrealloc(void *ptr, size_t size, const char *file, int line,
                   const char *func)
 {
+  int stats;
+
   /* Note that realloc() with a zero size could be used instead of
    * free(), but we don't allow that here */
   if (size == 0)
   {
     fprintf(stderr,
             "ERROR:%s:%d:%s: Trapped reallocation of memory at %p"
-            " to zero bytes. Use free() instead\n",
+            " to zero bytes. Use oi_free() instead\n",
             file, line, func, ptr);
     abort();
   }
-  void *ret = realloc(ptr, size);
+  /* Stop tracking old block before it is released, as its address may
+   * then be reused at once */
+  stats = stats_on();
+  if (stats && ptr != NULL) untrack_block(current_state(), ptr, 0);
+  void *ret = oi_realloc(ptr, size);
   if (ret == NULL)
   {
     fprintf(stderr,
@@ -67,5 +560,149 @@ void *_chkrealloc(void *ptr, size_t size, const char *file, int line,
             file, line, func, ptr, (unsigned long)size);
     abort();
   }
+  if (stats) record_alloc(ret, (ptr != NULL), size, file, line, func);
   return ret;
 }
+
+/**
+ * Stop tracking block that is about to be freed.
+ *
+ * Called by oi_free(). Blocks allocated while statistics were
+ * disabled, or by another thread that is still running, are ignored.
+ *
+ * @param ptr  pointer to block, or NULL
+ */
+void _chkmalloc_forget(void *ptr)
+{
+  if (ptr == NULL) return;
+  untrack_block(current_state(), ptr, 1);
+}
+
+/**
+ * Enable or disable allocation statistics for all threads.
+ *
+ * This overrides the OIFITSLIB_MALLOC_STATS environment variable.
+ * Disabling statistics discards those recorded so far by the calling
+ * thread. Other threads keep theirs until they exit.
+ *
+ * @param enable  TRUE to enable statistics, FALSE to disable
+ */
+void chkmalloc_stats_enable(int enable)
+{
+  stats_state *pSt;
+
+  atomic_store(&statsEnabled, (enable != 0));
+  if (!enable && (pSt = current_state()) != NULL)
+  {
+    pthread_mutex_lock(&statsLock);
+    unlink_state(pSt);
+    pthread_mutex_unlock(&statsLock);
+    pthread_setspecific(stateKey, NULL);
+    free(pSt->blocks);
+    free(pSt);
+  }
+}
+
+/**
+ * Return TRUE if allocation statistics are enabled.
+ */
+int chkmalloc_stats_enabled(void)
+{
+  return stats_on();
+}
+
+/**
+ * Get allocation statistics for calling thread.
+ *
+ * Only memory obtained through chkmalloc() and chkrealloc() by the
+ * calling thread is counted. Memory is only subtracted from the
+ * current usage when it is released by oi_free() on the same thread,
+ * or when its address is reused by the thread.
+ *
+ * @param pStats  return location for statistics
+ */
+void chkmalloc_stats_get(chkmalloc_stats *pStats)
+{
+  stats_state *pSt = current_state();
+
+  memset(pStats, 0, sizeof(*pStats));
+  if (pSt != NULL) add_stats(pStats, pSt);
+}
+
+/**
+ * Get allocation statistics totalled over all threads.
+ *
+ * Includes threads that are still running and those that have exited.
+ * The peak usage is the sum of the peaks for each thread, so is an
+ * upper limit on the peak for the whole process. Memory allocated by
+ * a thread that has exited is subtracted from the current usage when
+ * it is released by oi_free() on any thread.
+ *
+ * @param pStats  return location for statistics
+ */
+void chkmalloc_stats_get_total(chkmalloc_stats *pStats)
+{
+  const stats_state *pSt;
+
+  memset(pStats, 0, sizeof(*pStats));
+  pthread_mutex_lock(&statsLock);
+  add_stats(pStats, &retired);
+  for (pSt = liveStates; pSt != NULL; pSt = pSt->next)
+    add_stats(pStats, pSt);
+  pthread_mutex_unlock(&statsLock);
+}
+
+/**
+ * Reset allocation statistics for calling thread.
+ *
+ * The call counts are set to zero and the peak usage is set to the
+ * current usage. Blocks that are still allocated remain tracked.
+ */
+void chkmalloc_stats_reset(void)
+{
+  stats_state *pSt = current_state();
+  int i;
+
+  if (pSt == NULL) return;
+  /* Don't change call sites while another thread totals them */
+  pthread_mutex_lock(&statsLock);
+  atomic_store(&pSt->numAlloc, 0);
+  atomic_store(&pSt->numRealloc, 0);
+  atomic_store(&pSt->numFree, 0);
+  atomic_store(&pSt->peak, PEEK(pSt->current));
+  atomic_store(&pSt->numSite, 0);
+  atomic_store(&pSt->sitesFull, 0);
+  for (i = 0; i < SITE_TABLE_SIZE; i++)
+    pSt->siteIndex[i] = 0;
+  pthread_mutex_unlock(&statsLock);
+}
+
+/**
+ * Print allocation statistics for calling thread.
+ *
+ * Call sites are listed in order of decreasing bytes requested.
+ *
+ * @param stream  stream to print to, e.g. stderr
+ */
+void chkmalloc_stats_dump(FILE *stream)
+{
+  chkmalloc_stats stats;
+
+  chkmalloc_stats_get(&stats);
+  print_stats(stream, &stats);
+}
+
+/**
+ * Print allocation statistics totalled over all threads.
+ *
+ * Call sites are listed in order of decreasing bytes requested.
+ *
+ * @param stream  stream to print to, e.g. stderr
+ */
+void chkmalloc_stats_dump_total(FILE *stream)
+{
+  chkmalloc_stats stats;
+
+  chkmalloc_stats_get_total(&stats);
+  print_stats(stream, &stats);
+}
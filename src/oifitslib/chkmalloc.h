@@ -6,6 +6,13 @@
  * Used to terminate the program if memory allocation fails or if an
  * unexpected NULL pointer value is encountered.
  *
+ * The wrappers can also keep per-thread allocation statistics, which
+ * are disabled by default. They are enabled by setting the
+ * OIFITSLIB_MALLOC_STATS environment variable to a non-zero value, or
+ * by calling chkmalloc_stats_enable(), and apply to all threads. Each
+ * thread records its own statistics without locking, and these are
+ * added to process-wide totals when it exits.
+ *
  * Copyright (C) 2015 John Young
  *
  *
@@ -68,6 +75,9 @@
 /**
  * Replacement for malloc() that either succeeds (returning a non-NULL
  * pointer) or terminates the program with a useful error message.
+ *
+ * The memory is obtained from oi_malloc() and should be released with
+ * oi_free().
  */
 #define chkmalloc(size) (_chkmalloc(size, __FILE__, __LINE__, __func__))
 
@@ -79,8 +89,44 @@
 #define chkrealloc(ptr, size)                                                  \
   (_chkrealloc(ptr, size, __FILE__, __LINE__, __func__))
 
+/** Maximum number of call sites recorded by allocation statistics */
+#define CHKMALLOC_MAX_SITE 128
+
+/** Allocation statistics for a single chkmalloc()/chkrealloc() call */
+typedef struct
+{
+  const char *file;      /**< Source file containing call */
+  int line;              /**< Line number of call */
+  const char *func;      /**< Function containing call */
+  unsigned long numCall; /**< Number of allocations made */
+  size_t bytes;          /**< Total bytes requested */
+
+} chkmalloc_site;
+
+/** Allocation statistics for one thread or the whole process */
+typedef struct
+{
+  unsigned long numAlloc;   /**< Number of chkmalloc() calls */
+  unsigned long numRealloc; /**< Number of chkrealloc() calls */
+  unsigned long numFree;    /**< Number of tracked blocks freed */
+  size_t current;           /**< Bytes currently allocated */
+  size_t peak;              /**< Peak value of current since reset */
+  int numSite;              /**< Number of entries in sites */
+  int sitesFull;            /**< TRUE if some call sites not recorded */
+  chkmalloc_site sites[CHKMALLOC_MAX_SITE]; /**< Per-call-site stats */
+
+} chkmalloc_stats;
+
 void *_chkmalloc(size_t size, const char *file, int line, const char *func);
 void *_chkrealloc(void *ptr, size_t size, const char *file, int line,
                   const char *func);
+void _chkmalloc_forget(void *ptr);
+void chkmalloc_stats_enable(int enable);
+int chkmalloc_stats_enabled(void);
+void chkmalloc_stats_get(chkmalloc_stats *pStats);
+void chkmalloc_stats_get_total(chkmalloc_stats *pStats);
+void chkmalloc_stats_reset(void);
+void chkmalloc_stats_dump(FILE *stream);
+void chkmalloc_stats_dump_total(FILE *stream);
 
 #endif /* #ifndef CHK_MALLOC_H */
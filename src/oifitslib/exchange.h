@@ -44,6 +44,9 @@
 #include <fitsio.h>
 #include <complex.h>
 
+#include "oicontext.h"
+#include "oiprofile.h"
+
 #define OI_REVN_V1_TARGET 1
 #define OI_REVN_V1_ARRAY 1
 #define OI_REVN_V1_WAVELENGTH 1
@@ -379,6 +382,14 @@ STATUS read_next_oi_vis(fitsfile *fptr, oi_vis *pVis, STATUS *pStatus);
 STATUS read_next_oi_vis2(fitsfile *fptr, oi_vis2 *pVis2, STATUS *pStatus);
 STATUS read_next_oi_t3(fitsfile *fptr, oi_t3 *pT3, STATUS *pStatus);
 STATUS read_next_oi_flux(fitsfile *fptr, oi_flux *pFlux, STATUS *pStatus);
+STATUS read_oi_vis_rows(fitsfile *fptr, long firstRow, long numRows,
+                        oi_vis *pVis, STATUS *pStatus);
+STATUS read_oi_vis2_rows(fitsfile *fptr, long firstRow, long numRows,
+                         oi_vis2 *pVis2, STATUS *pStatus);
+STATUS read_oi_t3_rows(fitsfile *fptr, long firstRow, long numRows,
+                       oi_t3 *pT3, STATUS *pStatus);
+STATUS read_oi_flux_rows(fitsfile *fptr, long firstRow, long numRows,
+                         oi_flux *pFlux, STATUS *pStatus);
 /* Functions from alloc_fits.c */
 void alloc_oi_array(oi_array *pArray, int nelement);
 void alloc_oi_target(oi_target *pTargets, int ntarget);
@@ -33,7 +33,7 @@
  */
 void free_oi_array(oi_array *pArray)
 {
-  free(pArray->elem);
+  oi_free(pArray->elem);
 }
 
 /**
@@ -43,7 +43,7 @@ void free_oi_array(oi_array *pArray)
  */
 void free_oi_target(oi_target *pTargets)
 {
-  free(pTargets->targ);
+  oi_free(pTargets->targ);
 }
 
 /**
@@ -53,8 +53,8 @@ void free_oi_target(oi_target *pTargets)
  */
 void free_oi_wavelength(oi_wavelength *pWave)
 {
-  free(pWave->eff_wave);
-  free(pWave->eff_band);
+  oi_free(pWave->eff_wave);
+  oi_free(pWave->eff_band);
 }
 
 /**
@@ -64,9 +64,9 @@ void free_oi_wavelength(oi_wavelength *pWave)
  */
 void free_oi_corr(oi_corr *pCorr)
 {
-  free(pCorr->iindx);
-  free(pCorr->jindx);
-  free(pCorr->corr);
+  oi_free(pCorr->iindx);
+  oi_free(pCorr->jindx);
+  oi_free(pCorr->corr);
 }
 
 /**
@@ -80,12 +80,12 @@ void free_oi_inspol(oi_inspol *pInspol)
 
   for (i = 0; i < pInspol->numrec; i++)
   {
-    free(pInspol->record[i].jxx);
-    free(pInspol->record[i].jyy);
-    free(pInspol->record[i].jxy);
-    free(pInspol->record[i].jyx);
+    oi_free(pInspol->record[i].jxx);
+    oi_free(pInspol->record[i].jyy);
+    oi_free(pInspol->record[i].jxy);
+    oi_free(pInspol->record[i].jyx);
   }
-  free(pInspol->record);
+  oi_free(pInspol->record);
 }
 
 /**
@@ -99,23 +99,23 @@ void free_oi_vis(oi_vis *pVis)
 
   for (i = 0; i < pVis->numrec; i++)
   {
-    free(pVis->record[i].visamp);
-    free(pVis->record[i].visamperr);
-    free(pVis->record[i].visphi);
-    free(pVis->record[i].visphierr);
-    free(pVis->record[i].flag);
+    oi_free(pVis->record[i].visamp);
+    oi_free(pVis->record[i].visamperr);
+    oi_free(pVis->record[i].visphi);
+    oi_free(pVis->record[i].visphierr);
+    oi_free(pVis->record[i].flag);
 
-    if (pVis->usevisrefmap) free(pVis->record[i].visrefmap);
+    if (pVis->usevisrefmap) oi_free(pVis->record[i].visrefmap);
 
     if (pVis->usecomplex)
     {
-      free(pVis->record[i].rvis);
-      free(pVis->record[i].rviserr);
-      free(pVis->record[i].ivis);
-      free(pVis->record[i].iviserr);
+      oi_free(pVis->record[i].rvis);
+      oi_free(pVis->record[i].rviserr);
+      oi_free(pVis->record[i].ivis);
+      oi_free(pVis->record[i].iviserr);
     }
   }
-  free(pVis->record);
+  oi_free(pVis->record);
 }
 
 /**
@@ -129,11 +129,11 @@ void free_oi_vis2(oi_vis2 *pVis2)
 
   for (i = 0; i < pVis2->numrec; i++)
   {
-    free(pVis2->record[i].vis2data);
-    free(pVis2->record[i].vis2err);
-    free(pVis2->record[i].flag);
+    oi_free(pVis2->record[i].vis2data);
+    oi_free(pVis2->record[i].vis2err);
+    oi_free(pVis2->record[i].flag);
   }
-  free(pVis2->record);
+  oi_free(pVis2->record);
 }
 
 /**
@@ -147,13 +147,13 @@ void free_oi_t3(oi_t3 *pT3)
 
   for (i = 0; i < pT3->numrec; i++)
   {
-    free(pT3->record[i].t3amp);
-    free(pT3->record[i].t3amperr);
-    free(pT3->record[i].t3phi);
-    free(pT3->record[i].t3phierr);
-    free(pT3->record[i].flag);
+    oi_free(pT3->record[i].t3amp);
+    oi_free(pT3->record[i].t3amperr);
+    oi_free(pT3->record[i].t3phi);
+    oi_free(pT3->record[i].t3phierr);
+    oi_free(pT3->record[i].flag);
   }
-  free(pT3->record);
+  oi_free(pT3->record);
 }
 
 /**
@@ -167,9 +167,9 @@ void free_oi_flux(oi_flux *pFlux)
 
   for (i = 0; i < pFlux->numrec; i++)
   {
-    free(pFlux->record[i].fluxdata);
-    free(pFlux->record[i].fluxerr);
-    free(pFlux->record[i].flag);
+    oi_free(pFlux->record[i].fluxdata);
+    oi_free(pFlux->record[i].fluxerr);
+    oi_free(pFlux->record[i].flag);
   }
-  free(pFlux->record);
+  oi_free(pFlux->record);
 }
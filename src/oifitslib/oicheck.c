@@ -1252,3 +1252,622 @@ oi_breach_level check_flux(const oi_fits *pOi, oi_check_result *pResult)
 
   return pResult->level;
 }
+
+/** Results of per-record checks evaluated by oi_check_fused() */
+typedef struct
+{
+  oi_check_result *pTargets;  /**< check_targets_present() result, or NULL */
+  oi_check_result *pElements; /**< check_elements_present() result, or NULL */
+  oi_check_result *pFlagging; /**< check_flagging() result, or NULL */
+  oi_check_result *pT3amp;    /**< check_t3amp() result, or NULL */
+  oi_check_result *pTime;     /**< check_time() result, or NULL */
+  oi_breach_level stopLevel;  /**< Stop at first breach this severe */
+
+} fused_results;
+
+/** Record breach in specified record of data table. */
+static void set_record_result(oi_check_result *pResult, oi_breach_level level,
+                              const char *description, const char *extname,
+                              int itab, long irec)
+{
+  char location[FLEN_VALUE];
+
+  /* Only the first few locations are stored, don't format the rest */
+  location[0] = '\0';
+  if (pResult->numBreach < MAX_REPORT - 1)
+    g_snprintf(location, FLEN_VALUE, "%s #%d record %ld", extname, itab, irec);
+  set_result(pResult, level, description, location);
+}
+
+/** Record breach in specified channel of data table. */
+static void set_channel_result(oi_check_result *pResult, oi_breach_level level,
+                               const char *description, const char *extname,
+                               int itab, long irec, int ichan)
+{
+  char location[FLEN_VALUE];
+
+  location[0] = '\0';
+  if (pResult->numBreach < MAX_REPORT - 1)
+    g_snprintf(location, FLEN_VALUE, "%s #%d record %ld channel %d", extname,
+               itab, irec, ichan);
+  set_result(pResult, level, description, location);
+}
+
+/** Return TRUE if result is at least as severe as @a stopLevel */
+static gboolean reached_level(const oi_check_result *pResult,
+                              oi_breach_level stopLevel)
+{
+  return (stopLevel != OI_BREACH_NONE && pResult != NULL &&
+          pResult->level >= stopLevel);
+}
+
+/** Return TRUE if per-record checks may stop early */
+static gboolean fused_stopped(const fused_results *pRes)
+{
+  return (reached_level(pRes->pTargets, pRes->stopLevel) ||
+          reached_level(pRes->pElements, pRes->stopLevel) ||
+          reached_level(pRes->pFlagging, pRes->stopLevel) ||
+          reached_level(pRes->pT3amp, pRes->stopLevel) ||
+          reached_level(pRes->pTime, pRes->stopLevel));
+}
+
+/** Apply per-record checks to TARGET_ID value */
+static void fused_check_target(const oi_fits *pOi, const fused_results *pRes,
+                               int targetId, const char *extname, int itab,
+                               long irec)
+{
+  if (pRes->pTargets != NULL && oi_fits_lookup_target(pOi, targetId) == NULL)
+    set_record_result(pRes->pTargets, OI_BREACH_NOT_OIFITS,
+                      "Reference to missing target record", extname, itab,
+                      irec);
+}
+
+/** Apply per-record checks to STA_INDEX value */
+static void fused_check_element(const oi_fits *pOi, const fused_results *pRes,
+                                const char *arrname, int staIndex,
+                                const char *extname, int itab, long irec)
+{
+  if (pRes->pElements != NULL &&
+      oi_fits_lookup_element(pOi, arrname, staIndex) == NULL)
+    set_record_result(pRes->pElements, OI_BREACH_NOT_OIFITS,
+                      "Reference to missing array element", extname, itab,
+                      irec);
+}
+
+/** Apply per-record checks to TIME value */
+static void fused_check_time(const fused_results *pRes, double time,
+                             const char *extname, int itab, long irec)
+{
+  if (pRes->pTime != NULL && fabs(time) > 1e-10)
+    set_record_result(pRes->pTime, OI_BREACH_WARNING,
+                      "Non-zero TIME values in OIFITS v2 data table", extname,
+                      itab, irec);
+}
+
+/** Report negative error bar for check_flagging() */
+static void fused_set_flagging(const fused_results *pRes, const char *extname,
+                               int itab, long irec, int ichan)
+{
+  set_channel_result(pRes->pFlagging, OI_BREACH_NOT_OIFITS,
+                     "Data table contains negative error bar", extname, itab,
+                     irec, ichan);
+}
+
+/** Visit each record of OI_INSPOL tables once */
+static void fused_check_inspol(const oi_fits *pOi, const fused_results *pRes)
+{
+  GList *link;
+  oi_inspol *pInspol;
+  char location[FLEN_VALUE];
+  int itab, i;
+
+  if (pRes->pElements == NULL) return;
+  for (link = pOi->inspolList, itab = 1;
+       link != NULL && !fused_stopped(pRes); link = link->next, itab++)
+  {
+    pInspol = link->data;
+    if (strlen(pInspol->arrname) > 0)
+    {
+      for (i = 0; i < pInspol->numrec && !fused_stopped(pRes); i++)
+        fused_check_element(pOi, pRes, pInspol->arrname,
+                            pInspol->record[i].sta_index, "OI_INSPOL", itab,
+                            i + 1);
+    }
+    else
+    {
+      /* Location matches that from check_elements_present() */
+      g_snprintf(location, FLEN_VALUE, "OI_INSPOL #%d",
+                 g_list_position(pOi->visList, link) + 1);
+      set_result(pRes->pElements, OI_BREACH_NOT_OIFITS, "ARRNAME missing",
+                 location);
+    }
+  }
+}
+
+/** Visit each record and channel of OI_VIS table once */
+static void fused_check_vis(const oi_fits *pOi, const fused_results *pRes,
+                            const oi_vis *pVis, int itab, long row0)
+{
+  oi_vis_record *pRec;
+  gboolean hasArrname;
+  long irec;
+  int i, j;
+
+  hasArrname = (strlen(pVis->arrname) > 0);
+  for (i = 0; i < pVis->numrec && !fused_stopped(pRes); i++)
+  {
+    pRec = &pVis->record[i];
+    irec = row0 + i + 1;
+    fused_check_target(pOi, pRes, pRec->target_id, "OI_VIS", itab, irec);
+    if (hasArrname)
+      for (j = 0; j < 2; j++)
+        fused_check_element(pOi, pRes, pVis->arrname, pRec->sta_index[j],
+                            "OI_VIS", itab, irec);
+    fused_check_time(pRes, pRec->time, "OI_VIS", itab, irec);
+    if (pRes->pFlagging == NULL) continue;
+    for (j = 0; j < pVis->nwave; j++)
+    {
+      if (pRec->flag[j]) continue;
+      if (pRec->visamperr[j] < 0. || pRec->visphierr[j] < 0.)
+        fused_set_flagging(pRes, "OI_VIS", itab, irec, j + 1);
+    }
+  }
+}
+
+/** Visit each record and channel of OI_VIS2 table once */
+static void fused_check_vis2(const oi_fits *pOi, const fused_results *pRes,
+                             const oi_vis2 *pVis2, int itab, long row0)
+{
+  oi_vis2_record *pRec;
+  gboolean hasArrname;
+  long irec;
+  int i, j;
+
+  hasArrname = (strlen(pVis2->arrname) > 0);
+  for (i = 0; i < pVis2->numrec && !fused_stopped(pRes); i++)
+  {
+    pRec = &pVis2->record[i];
+    irec = row0 + i + 1;
+    fused_check_target(pOi, pRes, pRec->target_id, "OI_VIS2", itab, irec);
+    if (hasArrname)
+      for (j = 0; j < 2; j++)
+        fused_check_element(pOi, pRes, pVis2->arrname, pRec->sta_index[j],
+                            "OI_VIS2", itab, irec);
+    fused_check_time(pRes, pRec->time, "OI_VIS2", itab, irec);
+    if (pRes->pFlagging == NULL) continue;
+    for (j = 0; j < pVis2->nwave; j++)
+    {
+      if (pRec->flag[j]) continue;
+      if (pRec->vis2err[j] < 0.)
+        fused_set_flagging(pRes, "OI_VIS2", itab, irec, j + 1);
+    }
+  }
+}
+
+/** Visit each record and channel of OI_T3 table once */
+static void fused_check_t3(const oi_fits *pOi, const fused_results *pRes,
+                           const oi_t3 *pT3, int itab, long row0)
+{
+  oi_t3_record *pRec;
+  gboolean hasArrname;
+  long irec;
+  int i, j;
+
+  hasArrname = (strlen(pT3->arrname) > 0);
+  for (i = 0; i < pT3->numrec && !fused_stopped(pRes); i++)
+  {
+    pRec = &pT3->record[i];
+    irec = row0 + i + 1;
+    fused_check_target(pOi, pRes, pRec->target_id, "OI_T3", itab, irec);
+    if (hasArrname)
+      for (j = 0; j < 3; j++)
+        fused_check_element(pOi, pRes, pT3->arrname, pRec->sta_index[j],
+                            "OI_T3", itab, irec);
+    fused_check_time(pRes, pRec->time, "OI_T3", itab, irec);
+    if (pRes->pFlagging == NULL && pRes->pT3amp == NULL) continue;
+    for (j = 0; j < pT3->nwave; j++)
+    {
+      if (pRec->flag[j]) continue;
+      if (pRes->pFlagging != NULL &&
+          (pRec->t3amperr[j] < 0. || pRec->t3phierr[j] < 0.))
+        fused_set_flagging(pRes, "OI_T3", itab, irec, j + 1);
+      /* use one sigma in case error bars are overestimated */
+      if (pRes->pT3amp != NULL &&
+          (pRec->t3amp[j] - 1.0) > 1 * pRec->t3amperr[j])
+        set_channel_result(
+            pRes->pT3amp, OI_BREACH_NOT_OIFITS,
+            "OI_T3 table may contain unnormalised triple product amplitude",
+            "OI_T3", itab, irec, j + 1);
+    }
+  }
+}
+
+/** Visit each record of OI_FLUX table once */
+static void fused_check_flux(const oi_fits *pOi, const fused_results *pRes,
+                             const oi_flux *pFlux, int itab, long row0)
+{
+  oi_flux_record *pRec;
+  gboolean hasArrname;
+  long irec;
+  int i;
+
+  hasArrname = (strlen(pFlux->arrname) > 0);
+  for (i = 0; i < pFlux->numrec && !fused_stopped(pRes); i++)
+  {
+    pRec = &pFlux->record[i];
+    irec = row0 + i + 1;
+    fused_check_target(pOi, pRes, pRec->target_id, "OI_FLUX", itab, irec);
+    if (hasArrname && pRec->sta_index != -1)
+      fused_check_element(pOi, pRes, pFlux->arrname, pRec->sta_index,
+                          "OI_FLUX", itab, irec);
+  }
+}
+
+/** Return TRUE if @a check is evaluated per record by the fused checker */
+static gboolean is_fused_check(check_func check)
+{
+  return (check == check_targets_present || check == check_elements_present ||
+          check == check_flagging || check == check_t3amp ||
+          check == check_time);
+}
+
+/** Initialise results of checks evaluated per record */
+static void init_fused_results(fused_results *pRes, int numCheck,
+                               const check_func checks[],
+                               oi_breach_level stopLevel,
+                               oi_check_result results[])
+{
+  oi_check_result **ppFused;
+  int i;
+
+  pRes->pTargets = NULL;
+  pRes->pElements = NULL;
+  pRes->pFlagging = NULL;
+  pRes->pT3amp = NULL;
+  pRes->pTime = NULL;
+  pRes->stopLevel = stopLevel;
+  for (i = 0; i < numCheck; i++)
+  {
+    if (checks[i] == check_targets_present)
+      ppFused = &pRes->pTargets;
+    else if (checks[i] == check_elements_present)
+      ppFused = &pRes->pElements;
+    else if (checks[i] == check_flagging)
+      ppFused = &pRes->pFlagging;
+    else if (checks[i] == check_t3amp)
+      ppFused = &pRes->pT3amp;
+    else if (checks[i] == check_time)
+      ppFused = &pRes->pTime;
+    else
+      ppFused = NULL;
+
+    if (ppFused != NULL)
+    {
+      init_check_result(&results[i]);
+      *ppFused = &results[i];
+    }
+  }
+}
+
+/**
+ * Call checks not evaluated per record, returning TRUE if a breach at
+ * least as severe as @a stopLevel was found. Checks after that point
+ * are not called, but their results are initialised.
+ */
+static gboolean run_unfused(const oi_fits *pOi, int numCheck,
+                            const check_func checks[],
+                            oi_breach_level stopLevel,
+                            oi_check_result results[])
+{
+  gboolean stopped;
+  int i;
+
+  stopped = FALSE;
+  for (i = 0; i < numCheck; i++)
+  {
+    if (is_fused_check(checks[i])) continue;
+    if (stopped)
+    {
+      init_check_result(&results[i]);
+    }
+    else
+    {
+      (void)(*checks[i])(pOi, &results[i]);
+      stopped = reached_level(&results[i], stopLevel);
+    }
+  }
+  return stopped;
+}
+
+/** Return worst oi_breach_level from array of results */
+static oi_breach_level worst_result(int numCheck,
+                                    const oi_check_result results[])
+{
+  oi_breach_level worst;
+  int i;
+
+  worst = OI_BREACH_NONE;
+  for (i = 0; i < numCheck; i++)
+    if (results[i].level > worst) worst = results[i].level;
+  return worst;
+}
+
+/**
+ * Run specified checks, visiting each data record only once.
+ *
+ * check_targets_present(), check_elements_present(), check_flagging(),
+ * check_t3amp() and check_time() each scan every record (and in some
+ * cases every channel) of the data tables. Where these appear in @a
+ * checks, they are evaluated together in a single pass over the
+ * data, giving the same results as calling the individual
+ * functions. Other checks are called in the usual way.
+ *
+ * Each result must subsequently be passed to free_check_result().
+ *
+ * @param pOi       pointer to oi_fits struct to check
+ * @param numCheck  number of checks to run
+ * @param checks    array of @a numCheck checking functions
+ * @param results   array of @a numCheck oi_check_result structs to
+ *                  store results in
+ *
+ * @return worst oi_breach_level from all checks
+ */
+oi_breach_level oi_check_fused(const oi_fits *pOi, int numCheck,
+                               const check_func checks[],
+                               oi_check_result results[])
+{
+  return oi_check_until(pOi, numCheck, checks, OI_BREACH_NONE, results);
+}
+
+/**
+ * Run specified checks until a breach of given severity is found.
+ *
+ * Behaves like oi_check_fused(), but stops as soon as any check
+ * finds a breach at least as severe as @a stopLevel. This is much
+ * faster than running every check to completion when only a pass/fail
+ * decision is needed. The checks that do not scan the data records
+ * are called first. Each of these is run to completion, so the
+ * threshold is only applied between them and within the single pass
+ * over the data records. A check that is stopped early reports fewer
+ * occurrences than it would otherwise, and checks that are not run
+ * at all report OI_BREACH_NONE.
+ *
+ * Each result must subsequently be passed to free_check_result().
+ *
+ * @param pOi        pointer to oi_fits struct to check
+ * @param numCheck   number of checks to run
+ * @param checks     array of @a numCheck checking functions
+ * @param stopLevel  severity at which to stop, or OI_BREACH_NONE to
+ *                   run all checks to completion
+ * @param results    array of @a numCheck oi_check_result structs to
+ *                   store results in
+ *
+ * @return worst oi_breach_level from all checks, which is at least
+ *         @a stopLevel if and only if running all checks to
+ *         completion would give such a result
+ */
+oi_breach_level oi_check_until(const oi_fits *pOi, int numCheck,
+                               const check_func checks[],
+                               oi_breach_level stopLevel,
+                               oi_check_result results[])
+{
+  fused_results res;
+  GList *link;
+  int itab;
+
+  init_fused_results(&res, numCheck, checks, stopLevel, results);
+
+  /* TIME is only checked in OIFITS v2 data */
+  if (!is_oi_fits_two(pOi)) res.pTime = NULL;
+
+  if (!run_unfused(pOi, numCheck, checks, stopLevel, results))
+  {
+    fused_check_inspol(pOi, &res);
+    for (link = pOi->visList, itab = 1; link != NULL && !fused_stopped(&res);
+         link = link->next, itab++)
+      fused_check_vis(pOi, &res, link->data, itab, 0);
+    for (link = pOi->vis2List, itab = 1; link != NULL && !fused_stopped(&res);
+         link = link->next, itab++)
+      fused_check_vis2(pOi, &res, link->data, itab, 0);
+    for (link = pOi->t3List, itab = 1; link != NULL && !fused_stopped(&res);
+         link = link->next, itab++)
+      fused_check_t3(pOi, &res, link->data, itab, 0);
+    for (link = pOi->fluxList, itab = 1; link != NULL && !fused_stopped(&res);
+         link = link->next, itab++)
+      fused_check_flux(pOi, &res, link->data, itab, 0);
+  }
+
+  return worst_result(numCheck, results);
+}
+
+/** User data for check_chunk() */
+typedef struct
+{
+  int numCheck;
+  const check_func *checks;
+  oi_check_result *results;
+  fused_results res;
+  gboolean started; /**< Checks not evaluated per record have been run */
+  gboolean stopped; /**< Stop level reached */
+
+} chunk_check;
+
+/** Run checks that only need the metadata and OI_INSPOL tables */
+static void start_chunk_check(const oi_fits *pOi, chunk_check *pCheck)
+{
+  pCheck->started = TRUE;
+  if (!is_oi_fits_two(pOi)) pCheck->res.pTime = NULL;
+  pCheck->stopped = run_unfused(pOi, pCheck->numCheck, pCheck->checks,
+                                pCheck->res.stopLevel, pCheck->results);
+  if (!pCheck->stopped)
+  {
+    fused_check_inspol(pOi, &pCheck->res);
+    pCheck->stopped = fused_stopped(&pCheck->res);
+  }
+}
+
+/** Function called by read_oi_fits_chunked() to check one chunk */
+static gboolean check_chunk(const oi_fits *pOi, const char *extname,
+                            int itab, long firstRow, const void *pChunk,
+                            gpointer userData)
+{
+  chunk_check *pCheck = userData;
+
+  /* Metadata and OI_INSPOL tables are read before the first chunk */
+  if (!pCheck->started) start_chunk_check(pOi, pCheck);
+  if (pCheck->stopped) return FALSE;
+
+  if (strcmp(extname, "OI_VIS") == 0)
+    fused_check_vis(pOi, &pCheck->res, pChunk, itab, firstRow - 1);
+  else if (strcmp(extname, "OI_VIS2") == 0)
+    fused_check_vis2(pOi, &pCheck->res, pChunk, itab, firstRow - 1);
+  else if (strcmp(extname, "OI_T3") == 0)
+    fused_check_t3(pOi, &pCheck->res, pChunk, itab, firstRow - 1);
+  else
+    fused_check_flux(pOi, &pCheck->res, pChunk, itab, firstRow - 1);
+  pCheck->stopped = fused_stopped(&pCheck->res);
+  return !pCheck->stopped;
+}
+
+/**
+ * Run specified checks on a file, reading its data tables in chunks.
+ *
+ * This gives the same results as reading the file with
+ * read_oi_fits() and passing it to oi_check_until(), but only holds
+ * @a chunkSize records of one data table in memory at a time, so
+ * that files too large to load can be validated. The checks
+ * evaluated by oi_check_fused() in a single pass are applied to each
+ * chunk as it is read. Other checks are called before the first
+ * chunk, on a dataset in which each data table contains only its
+ * first record. If @a stopLevel is reached, the rest of the file is
+ * not read.
+ *
+ * Each result must subsequently be passed to free_check_result(),
+ * unless the file could not be read.
+ *
+ * @param filename   name of file to check
+ * @param chunkSize  maximum number of records to read at once
+ * @param numCheck   number of checks to run
+ * @param checks     array of @a numCheck checking functions, which
+ *                   should not inspect every record unless evaluated
+ *                   by oi_check_fused()
+ * @param stopLevel  severity at which to stop, or OI_BREACH_NONE to
+ *                   run all checks to completion
+ * @param results    array of @a numCheck oi_check_result structs to
+ *                   store results in
+ * @param pStatus    pointer to status variable
+ *
+ * @return worst oi_breach_level from all checks, or OI_BREACH_NOT_FITS
+ *         if the file could not be read (*pStatus is then non-zero)
+ */
+oi_breach_level oi_check_file(const char *filename, long chunkSize,
+                              int numCheck, const check_func checks[],
+                              oi_breach_level stopLevel,
+                              oi_check_result results[], STATUS *pStatus)
+{
+  chunk_check check;
+  oi_fits oi;
+  int i;
+
+  if (*pStatus) return OI_BREACH_NOT_FITS; /* error flag set - do nothing */
+
+  check.numCheck = numCheck;
+  check.checks = checks;
+  check.results = results;
+  check.started = FALSE;
+  check.stopped = FALSE;
+  init_fused_results(&check.res, numCheck, checks, stopLevel, results);
+
+  if (read_oi_fits_chunked(filename, chunkSize, check_chunk, &check, &oi,
+                           pStatus))
+  {
+    for (i = 0; i < numCheck; i++)
+      if (check.started || is_fused_check(checks[i]))
+        free_check_result(&results[i]);
+    return OI_BREACH_NOT_FITS;
+  }
+
+  /* No chunks if there are no data records */
+  if (!check.started) start_chunk_check(&oi, &check);
+  free_oi_fits(&oi);
+
+  return worst_result(numCheck, results);
+}
+
+/** Checking functions called by oi_check_all(), in order of reporting */
+const check_func oi_check_funcs[] = {check_tables,
+                                     check_header,
+                                     check_keywords,
+                                     check_visrefmap,
+                                     check_unique_targets,
+                                     check_targets_present,
+                                     check_arrname,
+                                     check_elements_present,
+                                     check_corr_present,
+                                     check_flagging,
+                                     check_t3amp,
+                                     check_waveorder,
+                                     check_time,
+                                     check_flux,
+                                     NULL};
+
+/** One check to be run by check_worker() */
+typedef struct
+{
+  check_func check;
+  const oi_fits *pOi;
+  oi_check_result *pResult;
+
+} check_job;
+
+/** GThreadPool worker function to run one check */
+static void check_worker(gpointer data, gpointer userData)
+{
+  check_job *pJob = data;
+
+  oi_set_context(userData); /* pool threads don't inherit caller's context */
+  (void)(*pJob->check)(pJob->pOi, pJob->pResult);
+}
+
+/**
+ * Run all checks in oi_check_funcs, concurrently if requested.
+ *
+ * The checks only read from @a pOi, so they may safely be run in
+ * parallel. The result of oi_check_funcs[i] is stored in @a
+ * results[i] regardless of the order in which the checks complete.
+ * If @a njobs is 1, the checks are instead run by oi_check_fused(),
+ * which makes a single pass over the data records.
+ * Each result must subsequently be passed to free_check_result().
+ *
+ * @param pOi      pointer to oi_fits struct to check
+ * @param njobs    maximum number of checks to run concurrently
+ * @param results  array of OI_NUM_CHECK oi_check_result structs to
+ *                 store results in
+ *
+ * @return worst oi_breach_level from all checks
+ */
+oi_breach_level oi_check_all(const oi_fits *pOi, int njobs,
+                             oi_check_result results[])
+{
+  GThreadPool *pool;
+  check_job jobs[OI_NUM_CHECK];
+  int i;
+
+  if (njobs <= 1)
+    return oi_check_fused(pOi, OI_NUM_CHECK, oi_check_funcs, results);
+
+  for (i = 0; i < OI_NUM_CHECK; i++)
+  {
+    jobs[i].check = oi_check_funcs[i];
+    jobs[i].pOi = pOi;
+    jobs[i].pResult = &results[i];
+  }
+
+  pool = g_thread_pool_new(check_worker, (gpointer)oi_get_context(), njobs,
+                           TRUE, NULL);
+  for (i = 0; i < OI_NUM_CHECK; i++)
+    g_thread_pool_push(pool, &jobs[i], NULL);
+  g_thread_pool_free(pool, FALSE, TRUE); /* wait for all checks */
+
+  return worst_result(OI_NUM_CHECK, results);
+}
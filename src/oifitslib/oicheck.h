@@ -64,6 +64,15 @@
  * Before reusing a oi_check_result for another check, you should pass
  * its address to free_check_result() to avoid memory leaks.
  *
+ * All of the checks listed above may be run (optionally in parallel)
+ * by calling oi_check_all(), which stores the results in the same
+ * order as the ::oi_check_funcs array. The checks that scan every
+ * data record may instead be run together in a single pass by
+ * calling oi_check_fused(). Files too large to load may be checked
+ * by calling oi_check_file(), which reads the data tables in chunks.
+ * If only a pass/fail decision is needed, oi_check_until() and
+ * oi_check_file() can stop at the first breach of a given severity.
+ *
  * @{
  */
 
@@ -104,6 +113,10 @@ typedef struct
 /** Standard interface to checking function. */
 typedef oi_breach_level (*check_func)(const oi_fits *, oi_check_result *);
 
+#define OI_NUM_CHECK 14 /**< Number of functions in oi_check_funcs */
+
+extern const check_func oi_check_funcs[];
+
 /*
  * Function prototypes
  */
@@ -125,6 +138,13 @@ oi_breach_level check_t3amp(const oi_fits *, oi_check_result *);
 oi_breach_level check_waveorder(const oi_fits *, oi_check_result *);
 oi_breach_level check_time(const oi_fits *, oi_check_result *);
 oi_breach_level check_flux(const oi_fits *, oi_check_result *);
+oi_breach_level oi_check_fused(const oi_fits *, int, const check_func[],
+                               oi_check_result[]);
+oi_breach_level oi_check_until(const oi_fits *, int, const check_func[],
+                               oi_breach_level, oi_check_result[]);
+oi_breach_level oi_check_all(const oi_fits *, int, oi_check_result[]);
+oi_breach_level oi_check_file(const char *, long, int, const check_func[],
+                              oi_breach_level, oi_check_result[], STATUS *);
 
 #endif /* #ifndef OICHECK_H */
 
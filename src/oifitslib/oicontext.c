@@ -0,0 +1,218 @@
+/**
+ * @file
+ * @ingroup oitable
+ * Implementation of per-thread library context.
+ *
+ * Copyright (C) 2026 the OIFITSlib authors
+ *
+ *
+ * This file is part of OIFITSlib.
+ *
+ * OIFITSlib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * OIFITSlib is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with OIFITSlib.  If not, see
+ * http://www.gnu.org/licenses/
+ */
+
+#include "exchange.h"
+#include "chkmalloc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+
+/** Maximum length of message passed to logging callback */
+#define MAX_LOG_MESSAGE 256
+
+/** Context installed by calling thread, or NULL for defaults */
+static _Thread_local const oi_context *pThreadContext = NULL;
+
+/*
+ * Private functions
+ */
+
+/** Pass formatted message to logging callback, removing final newline */
+static void log_message(const oi_context *pCtx, oi_log_level level,
+                        const char *format, va_list ap)
+{
+  char message[MAX_LOG_MESSAGE];
+  size_t len;
+
+  vsnprintf(message, MAX_LOG_MESSAGE, format, ap);
+  len = strlen(message);
+  if (len > 0 && message[len - 1] == '\n') message[len - 1] = '\0';
+  (*pCtx->logFunc)(level, message, pCtx->logData);
+}
+
+/*
+ * Public functions
+ */
+
+/**
+ * Initialise library context to default behaviour.
+ *
+ * Errors are reported to stderr, warnings are printed to stdout and
+ * memory is obtained from the standard allocator.
+ *
+ * @param pCtx  pointer to context to initialise
+ */
+void init_oi_context(oi_context *pCtx)
+{
+  pCtx->hushErrors = 0;
+  pCtx->logFunc = NULL;
+  pCtx->logData = NULL;
+  pCtx->mallocFunc = NULL;
+  pCtx->reallocFunc = NULL;
+  pCtx->freeFunc = NULL;
+}
+
+/**
+ * Install library context for calling thread.
+ *
+ * The context is not copied, so must remain valid until it is
+ * replaced. Other threads are not affected. Data structures allocated
+ * by the library while a context is installed must be freed while a
+ * context with the same allocator is installed.
+ *
+ * @param pCtx  pointer to context, or NULL to restore default
+ *              behaviour (controlled by ::oi_hush_errors)
+ *
+ * @return Context previously installed for calling thread, or NULL
+ */
+const oi_context *oi_set_context(const oi_context *pCtx)
+{
+  const oi_context *pPrev = pThreadContext;
+
+  pThreadContext = pCtx;
+  return pPrev;
+}
+
+/**
+ * Get library context for calling thread.
+ *
+ * @return Context installed by oi_set_context(), or NULL if none
+ */
+const oi_context *oi_get_context(void)
+{
+  return pThreadContext;
+}
+
+/**
+ * Report CFITSIO error in named library function.
+ *
+ * @param function  name of function in which error occurred
+ * @param status    CFITSIO status code
+ */
+void oi_report_error(const char *function, int status)
+{
+  const oi_context *pCtx = pThreadContext;
+  char desc[FLEN_STATUS];
+  char message[MAX_LOG_MESSAGE];
+
+  if (pCtx == NULL ? oi_hush_errors : pCtx->hushErrors) return;
+
+  /* Message stack is shared with other threads, so don't use it */
+  fits_get_errstatus(status, desc);
+  snprintf(message, MAX_LOG_MESSAGE, "CFITSIO error in %s: %s", function,
+           desc);
+  if (pCtx != NULL && pCtx->logFunc != NULL)
+    (*pCtx->logFunc)(OI_LOG_ERROR, message, pCtx->logData);
+  else
+    fprintf(stderr, "%s\n", message);
+}
+
+/**
+ * Report that a bad table is being skipped.
+ *
+ * @param extname  EXTNAME of table
+ * @param status   CFITSIO status code from reading table
+ */
+void oi_report_bad_table(const char *extname, int status)
+{
+  const oi_context *pCtx = pThreadContext;
+  char desc[FLEN_STATUS];
+  char message[MAX_LOG_MESSAGE];
+
+  fits_get_errstatus(status, desc);
+  snprintf(message, MAX_LOG_MESSAGE, "Skipping bad %s (%s)", extname, desc);
+  if (pCtx != NULL && pCtx->logFunc != NULL)
+    (*pCtx->logFunc)(OI_LOG_WARNING, message, pCtx->logData);
+  else
+    fprintf(stderr, "\n%s\n", message);
+}
+
+/**
+ * Report warning using printf()-style format.
+ *
+ * @param format  printf() format string, followed by any arguments
+ */
+void oi_warning(const char *format, ...)
+{
+  const oi_context *pCtx = pThreadContext;
+  va_list ap;
+
+  va_start(ap, format);
+  if (pCtx != NULL && pCtx->logFunc != NULL)
+  {
+    log_message(pCtx, OI_LOG_WARNING, format, ap);
+  }
+  else
+  {
+    printf("WARNING! ");
+    vprintf(format, ap);
+  }
+  va_end(ap);
+}
+
+/**
+ * Allocate memory using allocator from context for calling thread.
+ */
+void *oi_malloc(size_t size)
+{
+  const oi_context *pCtx = pThreadContext;
+
+  if (pCtx != NULL && pCtx->mallocFunc != NULL)
+    return (*pCtx->mallocFunc)(size);
+  return malloc(size);
+}
+
+/**
+ * Reallocate memory using allocator from context for calling thread.
+ */
+void *oi_realloc(void *ptr, size_t size)
+{
+  const oi_context *pCtx = pThreadContext;
+
+  if (pCtx != NULL && pCtx->reallocFunc != NULL)
+    return (*pCtx->reallocFunc)(ptr, size);
+  return realloc(ptr, size);
+}
+
+/**
+ * Free memory using allocator from context for calling thread.
+ *
+ * Memory allocated by the library must be freed with this function
+ * (or the free_oi_*() functions) if a context with a replacement
+ * allocator is installed. The allocators in all contexts that share
+ * data must be compatible.
+ */
+void oi_free(void *ptr)
+{
+  const oi_context *pCtx = pThreadContext;
+
+  _chkmalloc_forget(ptr);
+  if (pCtx != NULL && pCtx->freeFunc != NULL)
+    (*pCtx->freeFunc)(ptr);
+  else
+    free(ptr);
+}
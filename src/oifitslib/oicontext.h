@@ -0,0 +1,97 @@
+/**
+ * @file
+ * @ingroup oitable
+ * Definition of per-thread library context.
+ *
+ * Copyright (C) 2026 the OIFITSlib authors
+ *
+ *
+ * This file is part of OIFITSlib.
+ *
+ * OIFITSlib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * OIFITSlib is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with OIFITSlib.  If not, see
+ * http://www.gnu.org/licenses/
+ */
+
+/**
+ * @addtogroup oitable
+ *
+ * By default, I/O errors are reported to stderr unless the global
+ * ::oi_hush_errors flag is set, warnings are printed to stdout, and
+ * memory is obtained from malloc(). Since the flag is shared by all
+ * threads, these defaults are not suitable for reading and writing
+ * files on several threads at once.
+ *
+ * Instead, each thread may install its own ::oi_context by calling
+ * oi_set_context(). Every read, write, filter, merge and check
+ * function called from that thread then follows the error-reporting
+ * policy, logging callback and allocator in the context. Warnings
+ * issued through g_warning() by the GLib-based modules may be
+ * redirected with g_log_set_handler().
+ *
+ * The library does not use the CFITSIO error message stack, which is
+ * also shared by all threads. Errors are reported from the CFITSIO
+ * status code alone, and optional keywords and columns are detected
+ * from the status code without setting error marks.
+ *
+ * @{
+ */
+
+#ifndef OICONTEXT_H
+#define OICONTEXT_H
+
+#include <stddef.h>
+
+/** Severity of message passed to ::oi_log_func */
+typedef enum
+{
+  OI_LOG_WARNING, /**< Problem that does not prevent the operation */
+  OI_LOG_ERROR,   /**< CFITSIO error causing the operation to fail */
+
+} oi_log_level;
+
+/**
+ * Function to report a message. The arguments are the severity,
+ * the message (without a trailing newline), and the user data from
+ * the context.
+ */
+typedef void (*oi_log_func)(oi_log_level, const char *, void *);
+
+/** Error-reporting policy, logging callback and allocator */
+typedef struct
+{
+  int hushErrors;                       /**< If TRUE, don't report errors */
+  oi_log_func logFunc;                  /**< Logging callback, or NULL */
+  void *logData;                        /**< User data passed to logFunc */
+  void *(*mallocFunc)(size_t);          /**< Replacement for malloc() */
+  void *(*reallocFunc)(void *, size_t); /**< Replacement for realloc() */
+  void (*freeFunc)(void *);             /**< Replacement for free() */
+
+} oi_context;
+
+/*
+ * Function prototypes
+ */
+void init_oi_context(oi_context *);
+const oi_context *oi_set_context(const oi_context *);
+const oi_context *oi_get_context(void);
+void oi_report_error(const char *, int);
+void oi_report_bad_table(const char *, int);
+void oi_warning(const char *, ...);
+void *oi_malloc(size_t);
+void *oi_realloc(void *, size_t);
+void oi_free(void *);
+
+#endif /* #ifndef OICONTEXT_H */
+
+/** @} */
@@ -615,6 +615,42 @@ void set_oi_header(oi_fits *pOi)
   g_strlcpy(pOi->header.insmode, "UNKNOWN", FLEN_VALUE);
 }
 
+/**
+ * Rebuild hash tables of OI_ARRAY, OI_WAVELENGTH and OI_CORR tables
+ *
+ * read_oi_fits() may key the hash tables with names held by the data
+ * tables. Call this after removing or moving tables in place, so that
+ * every key points into the metadata table it refers to.
+ *
+ * @param pOi  pointer to file data struct, see oifile.h
+ */
+void rehash_oi_fits(oi_fits *pOi)
+{
+  GList *link;
+  oi_array *pArray;
+  oi_wavelength *pWave;
+  oi_corr *pCorr;
+
+  g_hash_table_remove_all(pOi->arrayHash);
+  for (link = pOi->arrayList; link != NULL; link = link->next)
+  {
+    pArray = link->data;
+    g_hash_table_insert(pOi->arrayHash, pArray->arrname, pArray);
+  }
+  g_hash_table_remove_all(pOi->wavelengthHash);
+  for (link = pOi->wavelengthList; link != NULL; link = link->next)
+  {
+    pWave = link->data;
+    g_hash_table_insert(pOi->wavelengthHash, pWave->insname, pWave);
+  }
+  g_hash_table_remove_all(pOi->corrHash);
+  for (link = pOi->corrList; link != NULL; link = link->next)
+  {
+    pCorr = link->data;
+    g_hash_table_insert(pOi->corrHash, pCorr->corrname, pCorr);
+  }
+}
+
 /**
  * Write OIFITS tables to new FITS file
  *
@@ -663,43 +699,23 @@ STATUS write_oi_fits(const char *filename, oi_fits oi, STATUS *pStatus)
 
 except:
   if (fptr) fits_close_file(fptr, pStatus);
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
 
 /**
- * Read all OIFITS tables from FITS file
+ * Read primary header and all OI_TARGET, OI_ARRAY, OI_WAVELENGTH and
+ * OI_CORR tables from open FITS file
  *
- * @param filename  name of file to read
- * @param pOi       pointer to uninitialised file data struct, see oifile.h
- * @param pStatus   pointer to status variable
- *
- * @return On error, returns non-zero cfitsio error code (also assigned to
- *         *pStatus). Contents of file data struct are undefined
+ * Initialises the lists of OI_INSPOL and data tables to empty.
  */
-STATUS read_oi_fits(const char *filename, oi_fits *pOi, STATUS *pStatus)
+static STATUS read_oi_fits_metadata(fitsfile *fptr, oi_fits *pOi,
+                                    STATUS *pStatus)
 {
-  const char function[] = "read_oi_fits";
-  char desc[FLEN_STATUS];
-  fitsfile *fptr = NULL;
   int hdutype;
   oi_array *pArray;
   oi_wavelength *pWave;
   oi_corr *pCorr;
-  oi_inspol *pInspol;
-  oi_vis *pVis;
-  oi_vis2 *pVis2;
-  oi_t3 *pT3;
-  oi_flux *pFlux;
-
-  if (*pStatus) return *pStatus; /* error flag set - do nothing */
-
-  fits_open_file(&fptr, filename, READONLY, pStatus);
-  if (*pStatus) goto except;
 
   /* Create empty data structures */
   pOi->arrayHash = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, NULL);
@@ -720,7 +736,7 @@ STATUS read_oi_fits(const char *filename, oi_fits *pOi, STATUS *pStatus)
 
   /* Read compulsory OI_TARGET table */
   read_oi_target(fptr, &pOi->targets, pStatus);
-  if (*pStatus) goto except;
+  if (*pStatus) return *pStatus;
 
   /* Read all OI_ARRAY tables */
   pOi->numArray = 0;
@@ -728,15 +744,13 @@ STATUS read_oi_fits(const char *filename, oi_fits *pOi, STATUS *pStatus)
   while (TRUE)
   {
     pArray = chkmalloc(sizeof(oi_array));
-    fits_write_errmark();
     if (read_next_oi_array(fptr, pArray, pStatus)) break; /* no more OI_ARRAY */
     pOi->arrayList = g_list_append(pOi->arrayList, pArray);
     ++pOi->numArray;
   }
-  free(pArray);
-  if (*pStatus != END_OF_FILE) goto except;
+  oi_free(pArray);
+  if (*pStatus != END_OF_FILE) return *pStatus;
   *pStatus = 0; /* reset EOF */
-  fits_clear_errmark();
 
   /* Read all OI_WAVELENGTH tables */
   pOi->numWavelength = 0;
@@ -744,16 +758,14 @@ STATUS read_oi_fits(const char *filename, oi_fits *pOi, STATUS *pStatus)
   while (TRUE)
   {
     pWave = chkmalloc(sizeof(oi_wavelength));
-    fits_write_errmark();
     if (read_next_oi_wavelength(fptr, pWave, pStatus))
       break; /* no more OI_WAVELENGTH */
     pOi->wavelengthList = g_list_append(pOi->wavelengthList, pWave);
     ++pOi->numWavelength;
   }
-  free(pWave);
-  if (*pStatus != END_OF_FILE) goto except;
+  oi_free(pWave);
+  if (*pStatus != END_OF_FILE) return *pStatus;
   *pStatus = 0; /* reset EOF */
-  fits_clear_errmark();
 
   /* Read all OI_CORR tables, skipping over failed tables */
   pOi->numCorr = 0;
@@ -761,18 +773,15 @@ STATUS read_oi_fits(const char *filename, oi_fits *pOi, STATUS *pStatus)
   while (TRUE)
   {
     pCorr = chkmalloc(sizeof(oi_corr));
-    fits_write_errmark();
     if (read_next_oi_corr(fptr, pCorr, pStatus))
     {
-      free(pCorr);
-      fits_clear_errmark();
+      oi_free(pCorr);
       if (*pStatus == END_OF_FILE)
       {
         *pStatus = 0;
         break; /* no more OI_CORR */
       }
-      fits_get_errstatus(*pStatus, desc);
-      fprintf(stderr, "\nSkipping bad OI_CORR (%s)\n", desc);
+      oi_report_bad_table("OI_CORR", *pStatus);
       *pStatus = 0;
       continue;
     }
@@ -780,30 +789,108 @@ STATUS read_oi_fits(const char *filename, oi_fits *pOi, STATUS *pStatus)
     ++pOi->numCorr;
   }
 
-  /* Read all OI_INSPOL tables, skipping over failed tables */
+  pOi->numInspol = 0;
+  pOi->numVis = 0;
+  pOi->numVis2 = 0;
+  pOi->numT3 = 0;
+  pOi->numFlux = 0;
+  return *pStatus;
+}
+
+/**
+ * Read all OI_INSPOL tables from open FITS file, skipping over failed
+ * tables
+ */
+static STATUS read_all_oi_inspol(fitsfile *fptr, oi_fits *pOi, STATUS *pStatus)
+{
+  int hdutype;
+  oi_inspol *pInspol;
+
   pOi->numInspol = 0;
   fits_movabs_hdu(fptr, 1, &hdutype, pStatus); /* back to start */
   while (TRUE)
   {
     pInspol = chkmalloc(sizeof(oi_inspol));
-    fits_write_errmark();
     if (read_next_oi_inspol(fptr, pInspol, pStatus))
     {
-      free(pInspol);
-      fits_clear_errmark();
+      oi_free(pInspol);
       if (*pStatus == END_OF_FILE)
       {
         *pStatus = 0;
         break; /* no more OI_INSPOL */
       }
-      fits_get_errstatus(*pStatus, desc);
-      fprintf(stderr, "\nSkipping bad OI_INSPOL (%s)\n", desc);
+      oi_report_bad_table("OI_INSPOL", *pStatus);
       *pStatus = 0;
       continue;
     }
     pOi->inspolList = g_list_append(pOi->inspolList, pInspol);
     ++pOi->numInspol;
   }
+  return *pStatus;
+}
+
+/**
+ * Set @a dateObs to earliest DATE-OBS keyword value from data tables
+ * in open FITS file, if any.
+ *
+ * Used in place of the record MJDs to set DATE-OBS for OIFITS v1
+ * files read without their data tables.
+ */
+static void read_min_date_obs(fitsfile *fptr, char *dateObs, STATUS *pStatus)
+{
+  char extname[FLEN_VALUE], tabDateObs[FLEN_VALUE];
+  int ihdu, nhdu, hdutype, found;
+
+  found = FALSE;
+  fits_get_num_hdus(fptr, &nhdu, pStatus);
+  for (ihdu = 2; ihdu <= nhdu && !*pStatus; ihdu++)
+  {
+    fits_movabs_hdu(fptr, ihdu, &hdutype, pStatus);
+    if (fits_read_key(fptr, TSTRING, "EXTNAME", extname, NULL, pStatus) ||
+        (strcmp(extname, "OI_VIS") != 0 && strcmp(extname, "OI_VIS2") != 0 &&
+         strcmp(extname, "OI_T3") != 0) ||
+        fits_read_key(fptr, TSTRING, "DATE-OBS", tabDateObs, NULL, pStatus))
+    {
+      /* not a v1 data table, or no DATE-OBS */
+      if (*pStatus == KEY_NO_EXIST) *pStatus = 0;
+      continue;
+    }
+    if (!found || strncmp(tabDateObs, dateObs, 10) < 0)
+      g_strlcpy(dateObs, tabDateObs, FLEN_VALUE);
+    found = TRUE;
+  }
+}
+
+/**
+ * Read all OIFITS tables from FITS file
+ *
+ * @param filename  name of file to read
+ * @param pOi       pointer to uninitialised file data struct, see oifile.h
+ * @param pStatus   pointer to status variable
+ *
+ * @return On error, returns non-zero cfitsio error code (also assigned to
+ *         *pStatus). Contents of file data struct are undefined
+ */
+STATUS read_oi_fits(const char *filename, oi_fits *pOi, STATUS *pStatus)
+{
+  const char function[] = "read_oi_fits";
+  fitsfile *fptr = NULL;
+  int hdutype;
+  oi_vis *pVis;
+  oi_vis2 *pVis2;
+  oi_t3 *pT3;
+  oi_flux *pFlux;
+
+  if (*pStatus) return *pStatus; /* error flag set - do nothing */
+
+  fits_open_file(&fptr, filename, READONLY, pStatus);
+  if (*pStatus) goto except;
+
+  /* Read primary header and metadata tables */
+  read_oi_fits_metadata(fptr, pOi, pStatus);
+  if (*pStatus) goto except;
+
+  read_all_oi_inspol(fptr, pOi, pStatus);
 
   /* Read all OI_VIS, hash-tabling corresponding array, wavelength and
    * corr tables, skipping over failed tables */
@@ -812,18 +899,15 @@ STATUS read_oi_fits(const char *filename, oi_fits *pOi, STATUS *pStatus)
   while (TRUE)
   {
     pVis = chkmalloc(sizeof(oi_vis));
-    fits_write_errmark();
     if (read_next_oi_vis(fptr, pVis, pStatus))
     {
-      free(pVis);
-      fits_clear_errmark();
+      oi_free(pVis);
       if (*pStatus == END_OF_FILE)
       {
         *pStatus = 0;
         break; /* no more OI_VIS */
       }
-      fits_get_errstatus(*pStatus, desc);
-      fprintf(stderr, "\nSkipping bad OI_VIS (%s)\n", desc);
+      oi_report_bad_table("OI_VIS", *pStatus);
       *pStatus = 0;
       continue;
     }
@@ -853,18 +937,15 @@ STATUS read_oi_fits(const char *filename, oi_fits *pOi, STATUS *pStatus)
   while (TRUE)
   {
     pVis2 = chkmalloc(sizeof(oi_vis2));
-    fits_write_errmark();
     if (read_next_oi_vis2(fptr, pVis2, pStatus))
     {
-      free(pVis2);
-      fits_clear_errmark();
+      oi_free(pVis2);
       if (*pStatus == END_OF_FILE)
       {
         *pStatus = 0;
         break; /* no more OI_VIS2 */
       }
-      fits_get_errstatus(*pStatus, desc);
-      fprintf(stderr, "\nSkipping bad OI_VIS2 (%s)\n", desc);
+      oi_report_bad_table("OI_VIS2", *pStatus);
       *pStatus = 0;
       continue;
     }
@@ -894,18 +975,15 @@ STATUS read_oi_fits(const char *filename, oi_fits *pOi, STATUS *pStatus)
   while (TRUE)
   {
     pT3 = chkmalloc(sizeof(oi_t3));
-    fits_write_errmark();
     if (read_next_oi_t3(fptr, pT3, pStatus))
     {
-      free(pT3);
-      fits_clear_errmark();
+      oi_free(pT3);
       if (*pStatus == END_OF_FILE)
       {
         *pStatus = 0;
         break; /* no more OI_T3 */
       }
-      fits_get_errstatus(*pStatus, desc);
-      fprintf(stderr, "\nSkipping bad OI_T3 (%s)\n", desc);
+      oi_report_bad_table("OI_T3", *pStatus);
       *pStatus = 0;
       continue;
     }
@@ -935,18 +1013,15 @@ STATUS read_oi_fits(const char *filename, oi_fits *pOi, STATUS *pStatus)
   while (TRUE)
   {
     pFlux = chkmalloc(sizeof(oi_flux));
-    fits_write_errmark();
     if (read_next_oi_flux(fptr, pFlux, pStatus))
     {
-      free(pFlux);
-      fits_clear_errmark();
+      oi_free(pFlux);
       if (*pStatus == END_OF_FILE)
       {
         *pStatus = 0;
         break; /* no more OI_FLUX */
       }
-      fits_get_errstatus(*pStatus, desc);
-      fprintf(stderr, "\nSkipping bad OI_FLUX (%s)\n", desc);
+      oi_report_bad_table("OI_FLUX", *pStatus);
       *pStatus = 0;
       continue;
     }
@@ -967,14 +1042,398 @@ STATUS read_oi_fits(const char *filename, oi_fits *pOi, STATUS *pStatus)
 
 except:
   if (fptr) fits_close_file(fptr, pStatus);
-  if (*pStatus && !oi_hush_errors)
+  if (*pStatus) oi_report_error(function, *pStatus);
+  return *pStatus;
+}
+
+/**
+ * Read primary header and metadata tables from FITS file
+ *
+ * Reads the OI_TARGET, OI_ARRAY, OI_WAVELENGTH and OI_CORR tables
+ * only, leaving the lists of OI_INSPOL and data tables empty. This
+ * allows a large number of files to be inspected without holding
+ * their data in memory. The data tables can subsequently be read one
+ * at a time using read_next_oi_vis() etc.
+ *
+ * @param filename  name of file to read
+ * @param pOi       pointer to uninitialised file data struct, see oifile.h
+ * @param pStatus   pointer to status variable
+ *
+ * @return On error, returns non-zero cfitsio error code (also assigned to
+ *         *pStatus). Contents of file data struct are undefined
+ */
+STATUS read_oi_fits_meta(const char *filename, oi_fits *pOi, STATUS *pStatus)
+{
+  const char function[] = "read_oi_fits_meta";
+  fitsfile *fptr = NULL;
+
+  if (*pStatus) return *pStatus; /* error flag set - do nothing */
+
+  fits_open_file(&fptr, filename, READONLY, pStatus);
+  if (*pStatus) goto except;
+
+  read_oi_fits_metadata(fptr, pOi, pStatus);
+  if (*pStatus) goto except;
+
+  if (!is_oi_fits_two(pOi))
   {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
+    /* No record MJDs available, use table DATE-OBS instead */
+    set_oi_header(pOi);
+    read_min_date_obs(fptr, pOi->header.date_obs, pStatus);
   }
+
+except:
+  if (fptr) fits_close_file(fptr, pStatus);
+  if (*pStatus) oi_report_error(function, *pStatus);
+  return *pStatus;
+}
+
+/**
+ * Add tables referenced by a data table to the hash tables in @a pOi
+ *
+ * @a corrname may be NULL if the data table has no CORRNAME keyword.
+ */
+static void hash_data_table_refs(oi_fits *pOi, char *arrname, char *insname,
+                                 char *corrname)
+{
+  if (strlen(arrname) > 0)
+  {
+    if (!g_hash_table_lookup(pOi->arrayHash, arrname))
+      g_hash_table_insert(pOi->arrayHash, arrname, find_oi_array(pOi, arrname));
+  }
+  if (!g_hash_table_lookup(pOi->wavelengthHash, insname))
+    g_hash_table_insert(pOi->wavelengthHash, insname,
+                        find_oi_wavelength(pOi, insname));
+  if (corrname != NULL && strlen(corrname) > 0)
+  {
+    if (!g_hash_table_lookup(pOi->corrHash, corrname))
+      g_hash_table_insert(pOi->corrHash, corrname, find_oi_corr(pOi, corrname));
+  }
+}
+
+/**
+ * Move to next binary table HDU with specified EXTNAME, returning
+ * FALSE if there are no more such HDUs
+ */
+static gboolean next_chunked_hdu(fitsfile *fptr, const char *reqName,
+                                 int *pHdu, STATUS *pStatus)
+{
+  char extname[FLEN_VALUE];
+  int nhdu, hdutype;
+
+  fits_get_num_hdus(fptr, &nhdu, pStatus);
+  while (!*pStatus && ++(*pHdu) <= nhdu)
+  {
+    fits_movabs_hdu(fptr, *pHdu, &hdutype, pStatus);
+    if (*pStatus || hdutype != BINARY_TBL) continue;
+    fits_read_key(fptr, TSTRING, "EXTNAME", extname, NULL, pStatus);
+    if (*pStatus == KEY_NO_EXIST)
+    {
+      *pStatus = 0;
+    }
+    else if (!*pStatus && strcmp(extname, reqName) == 0)
+    {
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+/** Data table to be read in chunks by read_oi_fits_chunked() */
+typedef struct
+{
+  int hdunum;          /**< HDU number of table */
+  const char *extname; /**< EXTNAME of table */
+  int itab;            /**< Position of table in list (1 for first) */
+  long nrows;          /**< Number of rows in table */
+
+} chunked_table;
+
+/**
+ * Read first record of each data table of one type from open FITS
+ * file, appending the tables to @a tabList and their locations to
+ * the GArray @a tables. Bad tables are skipped.
+ */
+#define READ_FIRST_RECORDS(fptr, pOi, reqName, tabType, tabList, numTab,       \
+                           readRows, corrname, tables, pStatus)                \
+  do                                                                           \
+  {                                                                            \
+    chunked_table entry;                                                       \
+    tabType *pTab;                                                             \
+    int ihdu;                                                                  \
+    ihdu = 1;                                                                  \
+    (numTab) = 0;                                                              \
+    while (next_chunked_hdu(fptr, reqName, &ihdu, pStatus))                    \
+    {                                                                          \
+      pTab = chkmalloc(sizeof(tabType));                                       \
+      fits_get_num_rows(fptr, &entry.nrows, pStatus);                          \
+      if (readRows(fptr, 1, 1, pTab, pStatus))                                 \
+      {                                                                        \
+        oi_free(pTab);                                                         \
+        oi_report_bad_table(reqName, *(pStatus));                              \
+        *(pStatus) = 0;                                                        \
+        continue;                                                              \
+      }                                                                        \
+      (tabList) = g_list_append((tabList), pTab);                              \
+      ++(numTab);                                                              \
+      hash_data_table_refs(pOi, pTab->arrname, pTab->insname, corrname);       \
+      entry.hdunum = ihdu;                                                     \
+      entry.extname = reqName;                                                 \
+      entry.itab = (numTab);                                                   \
+      g_array_append_val((tables), entry);                                     \
+    }                                                                          \
+  } while (0)
+
+/**
+ * Read all records of data table at current HDU in chunks, passing
+ * each chunk to @a chunkFunc. Sets @a more to FALSE if @a chunkFunc
+ * requests that reading stops
+ */
+#define READ_CHUNKS(fptr, pOi, pEntry, tabType, readRows, freeTab, chunkSize,  \
+                    chunkFunc, userData, more, pStatus)                        \
+  do                                                                           \
+  {                                                                            \
+    tabType chunk;                                                             \
+    long firstRow;                                                             \
+    for (firstRow = 1; firstRow <= (pEntry)->nrows; firstRow += (chunkSize))   \
+    {                                                                          \
+      if (readRows(fptr, firstRow, (chunkSize), &chunk, pStatus)) break;       \
+      (more) = (*(chunkFunc))(pOi, (pEntry)->extname, (pEntry)->itab,          \
+                              firstRow, &chunk, userData);                     \
+      freeTab(&chunk);                                                         \
+      if (!(more)) break;                                                      \
+    }                                                                          \
+  } while (0)
+
+/**
+ * Read FITS file in chunks of data table records
+ *
+ * Reads the primary header, the OI_TARGET, OI_ARRAY, OI_WAVELENGTH,
+ * OI_CORR and OI_INSPOL tables, and the first record of every data
+ * table. Each OI_VIS, OI_VIS2, OI_T3 and OI_FLUX table (in that
+ * order) is then read in chunks of at most @a chunkSize records. Each
+ * chunk is passed to @a chunkFunc, then freed before the next is
+ * read, so the memory used does not depend on the size of the data
+ * tables. If @a chunkFunc returns FALSE, no more chunks are read.
+ *
+ * Each data table in @a pOi contains only its first record, so that
+ * the table keywords and column formats are available. The dataset
+ * passed to @a chunkFunc is otherwise complete, including its hash
+ * tables.
+ *
+ * @param filename   name of file to read
+ * @param chunkSize  maximum number of records per chunk
+ * @param chunkFunc  function to call for each chunk
+ * @param userData   user data to pass to @a chunkFunc
+ * @param pOi        pointer to uninitialised file data struct, see oifile.h
+ * @param pStatus    pointer to status variable
+ *
+ * @return On error, returns non-zero cfitsio error code (also assigned to
+ *         *pStatus). Contents of file data struct are undefined
+ */
+STATUS read_oi_fits_chunked(const char *filename, long chunkSize,
+                            oi_chunk_func chunkFunc, gpointer userData,
+                            oi_fits *pOi, STATUS *pStatus)
+{
+  const char function[] = "read_oi_fits_chunked";
+  fitsfile *fptr = NULL;
+  GArray *tables;
+  const chunked_table *pEntry;
+  gboolean more;
+  int hdutype;
+  guint i;
+
+  if (*pStatus) return *pStatus; /* error flag set - do nothing */
+  g_assert_cmpint(chunkSize, >, 0);
+
+  tables = g_array_new(FALSE, FALSE, sizeof(chunked_table));
+  fits_open_file(&fptr, filename, READONLY, pStatus);
+  if (*pStatus) goto except;
+
+  /* Read primary header, metadata tables and first data records */
+  read_oi_fits_metadata(fptr, pOi, pStatus);
+  if (*pStatus) goto except;
+  read_all_oi_inspol(fptr, pOi, pStatus);
+  READ_FIRST_RECORDS(fptr, pOi, "OI_VIS", oi_vis, pOi->visList, pOi->numVis,
+                     read_oi_vis_rows, pTab->corrname, tables, pStatus);
+  READ_FIRST_RECORDS(fptr, pOi, "OI_VIS2", oi_vis2, pOi->vis2List,
+                     pOi->numVis2, read_oi_vis2_rows, pTab->corrname, tables,
+                     pStatus);
+  READ_FIRST_RECORDS(fptr, pOi, "OI_T3", oi_t3, pOi->t3List, pOi->numT3,
+                     read_oi_t3_rows, pTab->corrname, tables, pStatus);
+  READ_FIRST_RECORDS(fptr, pOi, "OI_FLUX", oi_flux, pOi->fluxList,
+                     pOi->numFlux, read_oi_flux_rows, NULL, tables, pStatus);
+  if (*pStatus) goto except;
+  if (!is_oi_fits_two(pOi))
+  {
+    /* Only first record MJDs available, use table DATE-OBS instead */
+    set_oi_header(pOi);
+    read_min_date_obs(fptr, pOi->header.date_obs, pStatus);
+  }
+
+  /* Read data tables in chunks */
+  more = TRUE;
+  for (i = 0; i < tables->len && more && !*pStatus; i++)
+  {
+    pEntry = &g_array_index(tables, chunked_table, i);
+    fits_movabs_hdu(fptr, pEntry->hdunum, &hdutype, pStatus);
+    if (strcmp(pEntry->extname, "OI_VIS") == 0)
+      READ_CHUNKS(fptr, pOi, pEntry, oi_vis, read_oi_vis_rows, free_oi_vis,
+                  chunkSize, chunkFunc, userData, more, pStatus);
+    else if (strcmp(pEntry->extname, "OI_VIS2") == 0)
+      READ_CHUNKS(fptr, pOi, pEntry, oi_vis2, read_oi_vis2_rows, free_oi_vis2,
+                  chunkSize, chunkFunc, userData, more, pStatus);
+    else if (strcmp(pEntry->extname, "OI_T3") == 0)
+      READ_CHUNKS(fptr, pOi, pEntry, oi_t3, read_oi_t3_rows, free_oi_t3,
+                  chunkSize, chunkFunc, userData, more, pStatus);
+    else
+      READ_CHUNKS(fptr, pOi, pEntry, oi_flux, read_oi_flux_rows, free_oi_flux,
+                  chunkSize, chunkFunc, userData, more, pStatus);
+  }
+
+except:
+  g_array_free(tables, TRUE);
+  if (fptr) fits_close_file(fptr, pStatus);
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
 
+/** Function to read one file into an oi_fits struct */
+typedef STATUS (*read_file_func)(const char *, oi_fits *, STATUS *);
+
+/** Slot for one file read by read_file_list() */
+typedef struct
+{
+  const char *filename;
+  read_file_func readFunc;
+  oi_fits *pOi;
+  STATUS status;
+
+} read_file_slot;
+
+/** GThreadPool worker function to read one file */
+static void read_file_worker(gpointer data, gpointer userData)
+{
+  read_file_slot *pSlot = data;
+
+  oi_set_context(userData); /* pool threads don't inherit caller's context */
+  pSlot->status = 0;
+  pSlot->pOi = chkmalloc(sizeof(oi_fits));
+  if ((*pSlot->readFunc)(pSlot->filename, pSlot->pOi, &pSlot->status))
+  {
+    oi_free(pSlot->pOi);
+    pSlot->pOi = NULL;
+  }
+}
+
+/**
+ * Read list of files using up to @a njobs concurrent threads.
+ *
+ * @return Linked list of oi_fits structs in same order as
+ *         @a filenameList, or NULL on error
+ */
+static GList *read_file_list(const GList *filenameList, int njobs,
+                             read_file_func readFunc, STATUS *pStatus)
+{
+  GThreadPool *pool;
+  GList *oiList;
+  const GList *link;
+  read_file_slot *slots;
+  int i, num;
+
+  if (*pStatus) return NULL; /* error flag set - do nothing */
+
+  num = g_list_length((GList *)filenameList);
+  if (num == 0) return NULL;
+  slots = chkmalloc(num * sizeof(read_file_slot));
+  for (i = 0, link = filenameList; link != NULL; i++, link = link->next)
+  {
+    slots[i].filename = link->data;
+    slots[i].readFunc = readFunc;
+    slots[i].pOi = NULL;
+    slots[i].status = 0;
+  }
+
+  /* Read files, concurrently if more than one job requested and
+   * CFITSIO can be called from several threads */
+  if (njobs > 1 && fits_is_reentrant())
+  {
+    pool = g_thread_pool_new(read_file_worker, (gpointer)oi_get_context(),
+                             MIN(njobs, num), TRUE, NULL);
+    for (i = 0; i < num; i++)
+      g_thread_pool_push(pool, &slots[i], NULL);
+    g_thread_pool_free(pool, FALSE, TRUE); /* wait for all reads */
+  }
+  else
+  {
+    for (i = 0; i < num; i++)
+    {
+      read_file_worker(&slots[i], NULL);
+      if (slots[i].status) break; /* no point reading the rest */
+    }
+  }
+
+  /* Assemble list in input order, reporting first error */
+  oiList = NULL;
+  for (i = 0; i < num; i++)
+  {
+    if (slots[i].status && !*pStatus) *pStatus = slots[i].status;
+    if (slots[i].pOi != NULL) oiList = g_list_append(oiList, slots[i].pOi);
+  }
+  oi_free(slots);
+  if (*pStatus)
+  {
+    for (link = oiList; link != NULL; link = link->next)
+    {
+      free_oi_fits(link->data);
+      oi_free(link->data);
+    }
+    g_list_free(oiList);
+    oiList = NULL;
+  }
+  return oiList;
+}
+
+/**
+ * Read list of OIFITS files, optionally in parallel
+ *
+ * Files are read by up to @a njobs concurrent threads, which
+ * benefits filesystems that reward concurrent reads. If CFITSIO was
+ * built without thread support, the files are read one at a time
+ * whatever the value of @a njobs.
+ *
+ * @param filenameList  linked list of names of files to read
+ * @param njobs         maximum number of files to read concurrently
+ * @param pStatus       pointer to status variable
+ *
+ * @return Linked list of pointers to oi_fits structs, in the same
+ *         order as @a filenameList, to be freed by the caller. On
+ *         error, returns NULL and assigns the first non-zero cfitsio
+ *         error code (in list order) to *pStatus
+ */
+GList *read_oi_fits_list(const GList *filenameList, int njobs, STATUS *pStatus)
+{
+  return read_file_list(filenameList, njobs, read_oi_fits, pStatus);
+}
+
+/**
+ * Read metadata from list of OIFITS files, optionally in parallel
+ *
+ * As read_oi_fits_list(), but reads each file using read_oi_fits_meta().
+ *
+ * @param filenameList  linked list of names of files to read
+ * @param njobs         maximum number of files to read concurrently
+ * @param pStatus       pointer to status variable
+ *
+ * @return Linked list of pointers to oi_fits structs, in the same
+ *         order as @a filenameList, or NULL on error
+ */
+GList *read_oi_fits_meta_list(const GList *filenameList, int njobs,
+                              STATUS *pStatus)
+{
+  return read_file_list(filenameList, njobs, read_oi_fits_meta, pStatus);
+}
+
 /** Free linked list and contents. */
 static void free_list(GList *list, free_func internalFree)
 {
@@ -984,7 +1443,7 @@ static void free_list(GList *list, free_func internalFree)
   while (link != NULL)
   {
     if (internalFree) (*internalFree)(link->data);
-    free(link->data);
+    oi_free(link->data);
     link = link->next;
   }
   g_list_free(list);
@@ -94,6 +94,20 @@ typedef struct
 
 } oi_fits;
 
+/**
+ * Function called by read_oi_fits_chunked() for each chunk of data
+ * table records.
+ *
+ * The arguments are the partially-read dataset, the EXTNAME of the
+ * data table, the position of the table in the corresponding list in
+ * the dataset (1 for first), the table row number of the first record
+ * in the chunk, a pointer to the oi_vis, oi_vis2, oi_t3 or oi_flux
+ * struct holding the chunk, and the user data. The function should
+ * return FALSE to stop reading the file.
+ */
+typedef gboolean (*oi_chunk_func)(const oi_fits *, const char *, int, long,
+                                  const void *, gpointer);
+
 /*
  * Function prototypes, for functions from oifile.c
  */
@@ -104,8 +118,14 @@ int is_oi_fits_two(const oi_fits *);
 int is_atomic(const oi_fits *, double);
 void count_oi_fits_data(const oi_fits *, long *const, long *const, long *const);
 void set_oi_header(oi_fits *);
+void rehash_oi_fits(oi_fits *);
 STATUS write_oi_fits(const char *, oi_fits, STATUS *);
 STATUS read_oi_fits(const char *, oi_fits *, STATUS *);
+STATUS read_oi_fits_meta(const char *, oi_fits *, STATUS *);
+STATUS read_oi_fits_chunked(const char *, long, oi_chunk_func, gpointer,
+                            oi_fits *, STATUS *);
+GList *read_oi_fits_list(const GList *, int, STATUS *);
+GList *read_oi_fits_meta_list(const GList *, int, STATUS *);
 void free_oi_fits(oi_fits *);
 oi_array *oi_fits_lookup_array(const oi_fits *, const char *);
 element *oi_fits_lookup_element(const oi_fits *, const char *, int);
@@ -131,306 +131,199 @@ static gboolean filter_post_parse(GOptionContext *context, GOptionGroup *group,
 }
 
 /**
- * Return new linked list of ARRNAMEs referenced by the
+ * Add name of each table in @a list to @a nameSet
+ */
+#define ADD_NAMES(list, tabType, name, nameSet)                                \
+  do                                                                           \
+  {                                                                            \
+    GList *link = (list);                                                      \
+    while (link != NULL)                                                       \
+    {                                                                          \
+      g_hash_table_add((nameSet), ((tabType *)link->data)->name);              \
+      link = link->next;                                                       \
+    }                                                                          \
+  } while (0)
+
+/**
+ * Return new set of non-empty ARRNAMEs referenced by the
  * OI_VIS/VIS2/T3/FLUX tables
  */
-static GList *get_arrname_list(const oi_fits *pData)
+static GHashTable *get_arrname_set(const oi_fits *pData)
 {
-  GList *arrnameList, *link;
-  oi_vis *pVis;
-  oi_vis2 *pVis2;
-  oi_t3 *pT3;
-  oi_flux *pFlux;
-
-  arrnameList = NULL;
-
-  link = pData->visList;
-  while (link != NULL)
-  {
-    pVis = (oi_vis *)link->data;
-    if (pVis->arrname[0] != '\0' &&
-        g_list_find_custom(arrnameList, pVis->arrname, (GCompareFunc)strcmp) ==
-            NULL)
-      arrnameList = g_list_prepend(arrnameList, pVis->arrname);
-    link = link->next;
-  }
-
-  link = pData->vis2List;
-  while (link != NULL)
-  {
-    pVis2 = (oi_vis2 *)link->data;
-    if (pVis2->arrname[0] != '\0' &&
-        g_list_find_custom(arrnameList, pVis2->arrname, (GCompareFunc)strcmp) ==
-            NULL)
-      arrnameList = g_list_prepend(arrnameList, pVis2->arrname);
-    link = link->next;
-  }
-
-  link = pData->t3List;
-  while (link != NULL)
-  {
-    pT3 = (oi_t3 *)link->data;
-    if (pT3->arrname[0] != '\0' &&
-        g_list_find_custom(arrnameList, pT3->arrname, (GCompareFunc)strcmp) ==
-            NULL)
-      arrnameList = g_list_prepend(arrnameList, pT3->arrname);
-    link = link->next;
-  }
-
-  link = pData->fluxList;
-  while (link != NULL)
-  {
-    pFlux = (oi_flux *)link->data;
-    if (pFlux->arrname[0] != '\0' &&
-        g_list_find_custom(arrnameList, pFlux->arrname, (GCompareFunc)strcmp) ==
-            NULL)
-      arrnameList = g_list_prepend(arrnameList, pFlux->arrname);
-    link = link->next;
-  }
-  return g_list_reverse(arrnameList);
+  GHashTable *arrnameSet;
+
+  arrnameSet = g_hash_table_new(g_str_hash, g_str_equal);
+  ADD_NAMES(pData->visList, oi_vis, arrname, arrnameSet);
+  ADD_NAMES(pData->vis2List, oi_vis2, arrname, arrnameSet);
+  ADD_NAMES(pData->t3List, oi_t3, arrname, arrnameSet);
+  ADD_NAMES(pData->fluxList, oi_flux, arrname, arrnameSet);
+  g_hash_table_remove(arrnameSet, "");
+  return arrnameSet;
 }
 
 /**
- * Return new linked list of INSNAMEs referenced by the
- * OI_VIS/VIS2/T3/FLUX tables
+ * Return new set of INSNAMEs referenced by the OI_VIS/VIS2/T3/FLUX tables
  */
-static GList *get_insname_list(const oi_fits *pData)
+static GHashTable *get_insname_set(const oi_fits *pData)
 {
-  GList *insnameList, *link;
-  oi_vis *pVis;
-  oi_vis2 *pVis2;
-  oi_t3 *pT3;
-  oi_flux *pFlux;
-
-  insnameList = NULL;
-
-  link = pData->visList;
-  while (link != NULL)
-  {
-    pVis = (oi_vis *)link->data;
-    if (g_list_find_custom(insnameList, pVis->insname, (GCompareFunc)strcmp) ==
-        NULL)
-      insnameList = g_list_prepend(insnameList, pVis->insname);
-    link = link->next;
-  }
-
-  link = pData->vis2List;
-  while (link != NULL)
-  {
-    pVis2 = (oi_vis2 *)link->data;
-    if (g_list_find_custom(insnameList, pVis2->insname, (GCompareFunc)strcmp) ==
-        NULL)
-      insnameList = g_list_prepend(insnameList, pVis2->insname);
-    link = link->next;
-  }
-
-  link = pData->t3List;
-  while (link != NULL)
-  {
-    pT3 = (oi_t3 *)link->data;
-    if (g_list_find_custom(insnameList, pT3->insname, (GCompareFunc)strcmp) ==
-        NULL)
-      insnameList = g_list_prepend(insnameList, pT3->insname);
-    link = link->next;
-  }
-
-  link = pData->fluxList;
-  while (link != NULL)
-  {
-    pFlux = (oi_flux *)link->data;
-    if (g_list_find_custom(insnameList, pFlux->insname, (GCompareFunc)strcmp) ==
-        NULL)
-      insnameList = g_list_prepend(insnameList, pFlux->insname);
-    link = link->next;
-  }
-  return g_list_reverse(insnameList);
+  GHashTable *insnameSet;
+
+  insnameSet = g_hash_table_new(g_str_hash, g_str_equal);
+  ADD_NAMES(pData->visList, oi_vis, insname, insnameSet);
+  ADD_NAMES(pData->vis2List, oi_vis2, insname, insnameSet);
+  ADD_NAMES(pData->t3List, oi_t3, insname, insnameSet);
+  ADD_NAMES(pData->fluxList, oi_flux, insname, insnameSet);
+  return insnameSet;
 }
 
 /**
- * Return new linked list of CORRNAMEs referenced by the
+ * Return new set of non-empty CORRNAMEs referenced by the
  * OI_VIS/VIS2/T3/FLUX tables
  */
-static GList *get_corrname_list(const oi_fits *pData)
+static GHashTable *get_corrname_set(const oi_fits *pData)
 {
-  GList *corrnameList, *link;
-  oi_vis *pVis;
-  oi_vis2 *pVis2;
-  oi_t3 *pT3;
-  oi_flux *pFlux;
-
-  corrnameList = NULL;
-
-  link = pData->visList;
-  while (link != NULL)
-  {
-    pVis = (oi_vis *)link->data;
-    if (pVis->corrname[0] != '\0' &&
-        g_list_find_custom(corrnameList, pVis->corrname,
-                           (GCompareFunc)strcmp) == NULL)
-      corrnameList = g_list_prepend(corrnameList, pVis->corrname);
-    link = link->next;
-  }
-
-  link = pData->vis2List;
-  while (link != NULL)
-  {
-    pVis2 = (oi_vis2 *)link->data;
-    if (pVis2->corrname[0] != '\0' &&
-        g_list_find_custom(corrnameList, pVis2->corrname,
-                           (GCompareFunc)strcmp) == NULL)
-      corrnameList = g_list_prepend(corrnameList, pVis2->corrname);
-    link = link->next;
-  }
-
-  link = pData->t3List;
-  while (link != NULL)
-  {
-    pT3 = (oi_t3 *)link->data;
-    if (pT3->corrname[0] != '\0' &&
-        g_list_find_custom(corrnameList, pT3->corrname, (GCompareFunc)strcmp) ==
-            NULL)
-      corrnameList = g_list_prepend(corrnameList, pT3->corrname);
-    link = link->next;
-  }
-
-  link = pData->fluxList;
-  while (link != NULL)
-  {
-    pFlux = (oi_flux *)link->data;
-    if (pFlux->corrname[0] != '\0' &&
-        g_list_find_custom(corrnameList, pFlux->corrname,
-                           (GCompareFunc)strcmp) == NULL)
-      corrnameList = g_list_prepend(corrnameList, pFlux->corrname);
-    link = link->next;
-  }
-  return g_list_reverse(corrnameList);
+  GHashTable *corrnameSet;
+
+  corrnameSet = g_hash_table_new(g_str_hash, g_str_equal);
+  ADD_NAMES(pData->visList, oi_vis, corrname, corrnameSet);
+  ADD_NAMES(pData->vis2List, oi_vis2, corrname, corrnameSet);
+  ADD_NAMES(pData->t3List, oi_t3, corrname, corrnameSet);
+  ADD_NAMES(pData->fluxList, oi_flux, corrname, corrnameSet);
+  g_hash_table_remove(corrnameSet, "");
+  return corrnameSet;
 }
 
 /**
- * Remove first OI_ARRAY table with ARRNAME not in @a arrnameList
- *
- * @return gboolean  TRUE if a table was removed, FALSE if all checked
+ * Remove all OI_ARRAY tables with ARRNAME not in @a arrnameSet
  */
-static gboolean prune_oi_array(oi_fits *pData, GList *arrnameList)
+static void prune_oi_array(oi_fits *pData, GHashTable *arrnameSet)
 {
-  GList *link;
+  GList *link, *next;
   oi_array *pArray;
 
   link = pData->arrayList;
   while (link != NULL)
   {
+    next = link->next;
     pArray = (oi_array *)link->data;
-    if (g_list_find_custom(arrnameList, pArray->arrname,
-                           (GCompareFunc)strcmp) == NULL)
+    if (!g_hash_table_contains(arrnameSet, pArray->arrname))
     {
       g_warning("Unreferenced OI_ARRAY table with ARRNAME=%s "
                 "removed from filter output",
                 pArray->arrname);
       g_hash_table_remove(pData->arrayHash, pArray->arrname);
-      pData->arrayList = g_list_remove(pData->arrayList, pArray);
+      pData->arrayList = g_list_delete_link(pData->arrayList, link);
       --pData->numArray;
       free_oi_array(pArray);
-      free(pArray);
-      return TRUE;
+      oi_free(pArray);
     }
-    link = link->next;
+    link = next;
   }
-  return FALSE;
 }
 
 /**
- * Remove first OI_WAVELENGTH table with INSNAME not in @a insnameList
- *
- * @return gboolean  TRUE if a table was removed, FALSE if all checked
+ * Remove all OI_WAVELENGTH tables with INSNAME not in @a insnameSet
  */
-static gboolean prune_oi_wavelength(oi_fits *pData, GList *insnameList)
+static void prune_oi_wavelength(oi_fits *pData, GHashTable *insnameSet)
 {
-  GList *link;
+  GList *link, *next;
   oi_wavelength *pWave;
 
   link = pData->wavelengthList;
   while (link != NULL)
   {
+    next = link->next;
     pWave = (oi_wavelength *)link->data;
-    if (g_list_find_custom(insnameList, pWave->insname, (GCompareFunc)strcmp) ==
-        NULL)
+    if (!g_hash_table_contains(insnameSet, pWave->insname))
     {
       g_warning("Unreferenced OI_WAVELENGTH table with INSNAME=%s "
                 "removed from filter output",
                 pWave->insname);
       g_hash_table_remove(pData->wavelengthHash, pWave->insname);
-      pData->wavelengthList = g_list_remove(pData->wavelengthList, pWave);
+      pData->wavelengthList = g_list_delete_link(pData->wavelengthList, link);
       --pData->numWavelength;
       free_oi_wavelength(pWave);
-      free(pWave);
-      return TRUE;
+      oi_free(pWave);
     }
-    link = link->next;
+    link = next;
   }
-  return FALSE;
 }
 
 /**
- * Remove first OI_CORR table with CORRNAME not in @a corrnameList
- *
- * @return gboolean  TRUE if a table was removed, FALSE if all checked
+ * Remove all OI_CORR tables with CORRNAME not in @a corrnameSet
  */
-static gboolean prune_oi_corr(oi_fits *pData, GList *corrnameList)
+static void prune_oi_corr(oi_fits *pData, GHashTable *corrnameSet)
 {
-  GList *link;
+  GList *link, *next;
   oi_corr *pCorr;
 
   link = pData->corrList;
   while (link != NULL)
   {
+    next = link->next;
     pCorr = (oi_corr *)link->data;
-    if (g_list_find_custom(corrnameList, pCorr->corrname,
-                           (GCompareFunc)strcmp) == NULL)
+    if (!g_hash_table_contains(corrnameSet, pCorr->corrname))
     {
       g_warning("Unreferenced OI_CORR table with CORRNAME=%s "
                 "removed from filter output",
                 pCorr->corrname);
       g_hash_table_remove(pData->corrHash, pCorr->corrname);
-      pData->corrList = g_list_remove(pData->corrList, pCorr);
+      pData->corrList = g_list_delete_link(pData->corrList, link);
       --pData->numCorr;
       free_oi_corr(pCorr);
-      free(pCorr);
-      return TRUE;
+      oi_free(pCorr);
     }
-    link = link->next;
+    link = next;
   }
-  return FALSE;
 }
 
 /**
- * Remove first OI_INSPOL table with ARRNAME not in @a arrnameList
- *
- * @return gboolean  TRUE if a table was removed, FALSE if all checked
+ * Remove all OI_INSPOL tables with ARRNAME not in @a arrnameSet
  */
-static gboolean prune_oi_inspol(oi_fits *pData, GList *arrnameList)
+static void prune_oi_inspol(oi_fits *pData, GHashTable *arrnameSet)
 {
-  GList *link;
+  GList *link, *next;
   oi_inspol *pInspol;
 
   link = pData->inspolList;
   while (link != NULL)
   {
+    next = link->next;
     pInspol = (oi_inspol *)link->data;
-    if (g_list_find_custom(arrnameList, pInspol->arrname,
-                           (GCompareFunc)strcmp) == NULL)
+    if (!g_hash_table_contains(arrnameSet, pInspol->arrname))
     {
       g_warning("Unreferenced OI_INSPOL table with ARRNAME=%s "
                 "removed from filter output",
                 pInspol->arrname);
-      pData->inspolList = g_list_remove(pData->inspolList, pInspol);
+      pData->inspolList = g_list_delete_link(pData->inspolList, link);
       --pData->numInspol;
       free_oi_inspol(pInspol);
-      free(pInspol);
-      return TRUE;
+      oi_free(pInspol);
     }
-    link = link->next;
+    link = next;
   }
-  return FALSE;
+}
+
+/**
+ * Remove orphaned OI_ARRAY, OI_INSPOL, OI_WAVELENGTH and OI_CORR tables
+ *
+ * Each table list is traversed once, so the time taken is linear in
+ * the number of tables.
+ */
+static void prune_oi_fits(oi_fits *pData)
+{
+  GHashTable *nameSet;
+
+  nameSet = get_arrname_set(pData);
+  prune_oi_array(pData, nameSet);
+  prune_oi_inspol(pData, nameSet);
+  g_hash_table_destroy(nameSet);
+  nameSet = get_insname_set(pData);
+  prune_oi_wavelength(pData, nameSet);
+  g_hash_table_destroy(nameSet);
+  nameSet = get_corrname_set(pData);
+  prune_oi_corr(pData, nameSet);
+  g_hash_table_destroy(nameSet);
 }
 
 /*
@@ -480,6 +373,16 @@ void apply_user_oi_filter(const oi_fits *pInput, oi_fits *pOutput)
   apply_oi_filter(pInput, get_user_oi_filter(), pOutput);
 }
 
+/**
+ * Filter OIFITS data in place using filter specified on commandline
+ *
+ * @param pData  pointer to file data struct to filter, see oifile.h
+ */
+void apply_user_oi_filter_inplace(oi_fits *pData)
+{
+  apply_oi_filter_inplace(pData, get_user_oi_filter());
+}
+
 /**
  * Initialise filter specification to accept all data
  *
@@ -507,6 +410,7 @@ void init_oi_filter(oi_filter_spec *pFilter)
   pFilter->accept_t3phi = 1;
   pFilter->accept_flux = 1;
   pFilter->accept_flagged = 1;
+  pFilter->insname_exact = 0;
 
   pFilter->arrname_pttn = NULL;
   pFilter->insname_pttn = NULL;
@@ -586,8 +490,10 @@ void print_oi_filter(const oi_filter_spec *pFilter)
    g_pattern_match_string((pFilter)->arrname_pttn, (pObject)->arrname))
 
 #define ACCEPT_INSNAME(pObject, pFilter)                                       \
-  ((pFilter)->insname_pttn == NULL ||                                          \
-   g_pattern_match_string((pFilter)->insname_pttn, (pObject)->insname))
+  ((pFilter)->insname_exact                                                    \
+       ? strcmp((pFilter)->insname, (pObject)->insname) == 0                   \
+       : ((pFilter)->insname_pttn == NULL ||                                   \
+          g_pattern_match_string((pFilter)->insname_pttn, (pObject)->insname)))
 
 #define ACCEPT_CORRNAME(pObject, pFilter)                                      \
   ((pFilter)->corrname_pttn == NULL ||                                         \
@@ -696,7 +602,7 @@ GHashTable *filter_all_oi_wavelength(const oi_fits *pInput,
   char *useWave;
   GList *link;
 
-  useWaveHash = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, free);
+  useWaveHash = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, oi_free);
   link = pInput->wavelengthList;
   while (link != NULL)
   {
@@ -720,8 +626,8 @@ GHashTable *filter_all_oi_wavelength(const oi_fits *pInput,
         g_hash_table_insert(useWaveHash, g_strdup(pInWave->insname), NULL);
         g_warning("Empty tables with INSNAME=%s removed from filter output",
                   pInWave->insname);
-        free(useWave);
-        free(pOutWave);
+        oi_free(useWave);
+        oi_free(pOutWave);
       }
     }
     link = link->next;
@@ -767,9 +673,9 @@ void filter_oi_wavelength(const oi_wavelength *pInWave,
   }
   if (pOutWave->nwave < pInWave->nwave)
   {
-    pOutWave->eff_wave = realloc(
+    pOutWave->eff_wave = oi_realloc(
         pOutWave->eff_wave, pOutWave->nwave * sizeof(pInWave->eff_wave[0]));
-    pOutWave->eff_band = realloc(
+    pOutWave->eff_band = oi_realloc(
         pOutWave->eff_band, pOutWave->nwave * sizeof(pInWave->eff_band[0]));
   }
 }
@@ -842,14 +748,92 @@ void filter_all_oi_inspol(const oi_fits *pInput, const oi_filter_spec *pFilter,
     {
       g_warning("Empty OI_INSPOL table removed from filter output");
       g_debug("Removed empty OI_INSPOL with ARRNAME=%s", pOutTab->arrname);
-      free(pOutTab);
+      oi_free(pOutTab);
+    }
+  }
+}
+
+/**
+ * Does OI_INSPOL record pass filter on TARGET_ID, INSNAME and MJD?
+ */
+static bool accept_inspol_record(const oi_inspol_record *pRec,
+                                 const oi_filter_spec *pFilter,
+                                 GHashTable *useWaveHash)
+{
+  if (pFilter->target_id >= 0 && pRec->target_id != pFilter->target_id)
+    return FALSE; /* TARGET_ID doesn't match */
+  if (!ACCEPT_INSNAME(pRec, pFilter))
+    return FALSE; /* INSNAME doesn't match */
+  if ((pRec->mjd_end < pFilter->mjd_range[0]) ||
+      (pRec->mjd_obs > pFilter->mjd_range[1]))
+    return FALSE; /* MJD ranges don't overlap */
+  if (g_hash_table_lookup(useWaveHash, pRec->insname) == NULL)
+    return FALSE; /* INSNAME filtered out */
+  return TRUE;
+}
+
+/**
+ * Filter channels of OI_INSPOL table row by wavelength
+ *
+ * The arrays of @a pOutRec must be allocated by the caller, and may
+ * be those of @a pInRec, so that a record can be filtered in place.
+ */
+static void compact_oi_inspol_record(const oi_inspol_record *pInRec,
+                                     const char *useWave, int nwaveIn,
+                                     int nwaveOut, oi_inspol_record *pOutRec)
+{
+  int j, k;
+
+  k = 0;
+  for (j = 0; j < nwaveIn && k < nwaveOut; j++)
+  {
+    if (useWave[j])
+    {
+      pOutRec->jxx[k] = pInRec->jxx[j];
+      pOutRec->jyy[k] = pInRec->jyy[j];
+      pOutRec->jxy[k] = pInRec->jxy[j];
+      pOutRec->jyx[k] = pInRec->jyx[j];
+      ++k;
     }
   }
 }
 
+/**
+ * Filter OI_INSPOL table row by wavelength
+ */
+static void filter_oi_inspol_record(const oi_inspol_record *pInRec,
+                                    const oi_filter_spec *pFilter,
+                                    const char *useWave, int nwaveIn,
+                                    int nwaveOut, oi_inspol_record *pOutRec)
+{
+  memcpy(pOutRec, pInRec, sizeof(oi_inspol_record));
+  if (pFilter->target_id >= 0) pOutRec->target_id = 1;
+  pOutRec->jxx = chkmalloc(nwaveOut * sizeof(pOutRec->jxx[0]));
+  pOutRec->jyy = chkmalloc(nwaveOut * sizeof(pOutRec->jyy[0]));
+  pOutRec->jxy = chkmalloc(nwaveOut * sizeof(pOutRec->jxy[0]));
+  pOutRec->jyx = chkmalloc(nwaveOut * sizeof(pOutRec->jyx[0]));
+  compact_oi_inspol_record(pInRec, useWave, nwaveIn, nwaveOut, pOutRec);
+}
+
+/**
+ * Return number of wavelength channels selected by @a useWave
+ */
+static int count_use_wave(const char *useWave, int nwave)
+{
+  int j, n;
+
+  n = 0;
+  for (j = 0; j < nwave; j++)
+    if (useWave[j]) ++n;
+  return n;
+}
+
 /**
  * Filter an OI_INSPOL table by TARGET_ID, INSNAME, and MJD
  *
+ * The number of wavelength channels in the output table is set by
+ * the first accepted record.
+ *
  * @param pInTab   pointer to input oi_inspol
  * @param pFilter  pointer to filter specification
  * @param useWaveHash  hash table with INSAME values as keys and char[]
@@ -859,7 +843,7 @@ void filter_all_oi_inspol(const oi_fits *pInput, const oi_filter_spec *pFilter,
 void filter_oi_inspol(const oi_inspol *pInTab, const oi_filter_spec *pFilter,
                       GHashTable *useWaveHash, oi_inspol *pOutTab)
 {
-  int i, j, k, nrec;
+  int i, nrec;
   char *useWave;
 
   /* Copy table header items */
@@ -872,62 +856,20 @@ void filter_oi_inspol(const oi_inspol *pInTab, const oi_filter_spec *pFilter,
   pOutTab->nwave = pInTab->nwave;                        /* upper limit */
   for (i = 0; i < pInTab->numrec; i++)
   {
-    if (pFilter->target_id >= 0 &&
-        pInTab->record[i].target_id != pFilter->target_id)
-      continue; /* skip record as TARGET_ID doesn't match */
-    if (pFilter->insname_pttn != NULL &&
-        !g_pattern_match_string(pFilter->insname_pttn,
-                                pInTab->record[i].insname))
-      continue; /* skip record as INSNAME doesn't match */
-    if ((pInTab->record[i].mjd_end < pFilter->mjd_range[0]) ||
-        (pInTab->record[i].mjd_obs > pFilter->mjd_range[1]))
-      continue; /* skip record as MJD ranges don't overlap */
+    if (!accept_inspol_record(&pInTab->record[i], pFilter, useWaveHash))
+      continue;
     useWave = g_hash_table_lookup(useWaveHash, pInTab->record[i].insname);
-    if (useWave == NULL) continue; /* skip record as INSNAME filtered out */
+    g_assert(useWave != NULL);
+    if (nrec == 0) pOutTab->nwave = count_use_wave(useWave, pInTab->nwave);
 
     /* Create output record */
-    memcpy(&pOutTab->record[nrec], &pInTab->record[i],
-           sizeof(oi_inspol_record));
-    if (pFilter->target_id >= 0) pOutTab->record[nrec].target_id = 1;
-    pOutTab->record[nrec].jxx =
-        chkmalloc(pOutTab->nwave * sizeof(pOutTab->record[0].jxx[0]));
-    pOutTab->record[nrec].jyy =
-        chkmalloc(pOutTab->nwave * sizeof(pOutTab->record[0].jyy[0]));
-    pOutTab->record[nrec].jxy =
-        chkmalloc(pOutTab->nwave * sizeof(pOutTab->record[0].jxy[0]));
-    pOutTab->record[nrec].jyx =
-        chkmalloc(pOutTab->nwave * sizeof(pOutTab->record[0].jyx[0]));
-    k = 0;
-    g_assert(useWave != NULL);
-    for (j = 0; j < pInTab->nwave; j++)
-    {
-      if (useWave[j])
-      {
-        pOutTab->record[nrec].jxx[k] = pInTab->record[i].jxx[j];
-        pOutTab->record[nrec].jyy[k] = pInTab->record[i].jyy[j];
-        pOutTab->record[nrec].jxy[k] = pInTab->record[i].jxy[j];
-        pOutTab->record[nrec].jyx[k] = pInTab->record[i].jyx[j];
-        ++k;
-      }
-    }
-    if (nrec == 0 && k < pOutTab->nwave)
-    {
-      /* For 1st output record, length of vectors wasn't known when
-         originally allocated, so reallocate */
-      pOutTab->nwave = k;
-      pOutTab->record[nrec].jxx = realloc(
-          pOutTab->record[nrec].jxx, k * sizeof(pOutTab->record[0].jxx[0]));
-      pOutTab->record[nrec].jyy = realloc(
-          pOutTab->record[nrec].jyy, k * sizeof(pOutTab->record[0].jyy[0]));
-      pOutTab->record[nrec].jxy = realloc(
-          pOutTab->record[nrec].jxy, k * sizeof(pOutTab->record[0].jxy[0]));
-      pOutTab->record[nrec].jyx = realloc(
-          pOutTab->record[nrec].jyx, k * sizeof(pOutTab->record[0].jyx[0]));
-    }
-    ++nrec;
+    filter_oi_inspol_record(&pInTab->record[i], pFilter, useWave,
+                            pInTab->nwave, pOutTab->nwave,
+                            &pOutTab->record[nrec++]);
   }
   pOutTab->numrec = nrec;
-  pOutTab->record = realloc(pOutTab->record, nrec * sizeof(oi_inspol_record));
+  pOutTab->record =
+      oi_realloc(pOutTab->record, nrec * sizeof(oi_inspol_record));
 }
 
 /**
@@ -980,7 +922,7 @@ void filter_all_oi_vis(const oi_fits *pInput, const oi_filter_spec *pFilter,
         g_warning("Empty OI_VIS table removed from filter output");
         g_debug("Removed empty OI_VIS with DATE-OBS=%s INSNAME=%s",
                 pOutTab->date_obs, pOutTab->insname);
-        free(pOutTab);
+        oi_free(pOutTab);
       }
     }
   }
@@ -1021,46 +963,46 @@ static bool any_vis_chan_ok(const oi_vis_record *pRec,
 }
 
 /**
- * Filter OI_VIS table row by wavelength, UV radius and SNR
+ * Does OI_VIS record pass filter on TARGET_ID, MJD, baseline and flagging?
  */
-static void filter_oi_vis_record(const oi_vis_record *pInRec,
-                                 const oi_filter_spec *pFilter,
-                                 const oi_wavelength *pWave,
-                                 const char *useWave, int nwaveIn, int nwaveOut,
-                                 BOOL usevisrefmap, BOOL usecomplex,
-                                 oi_vis_record *pOutRec)
+static bool accept_vis_record(const oi_vis_record *pRec,
+                              const oi_filter_spec *pFilter,
+                              const oi_wavelength *pWave, const char *useWave,
+                              int nwave)
+{
+  double bas;
+
+  if (pFilter->target_id >= 0 && pRec->target_id != pFilter->target_id)
+    return FALSE; /* TARGET_ID doesn't match */
+  if (pRec->mjd < pFilter->mjd_range[0] || pRec->mjd > pFilter->mjd_range[1])
+    return FALSE; /* MJD out of range */
+  bas = pow(pRec->ucoord * pRec->ucoord + pRec->vcoord * pRec->vcoord, 0.5);
+  if (bas < pFilter->bas_range[0] || bas > pFilter->bas_range[1])
+    return FALSE; /* projected baseline out of range */
+  if (!pFilter->accept_flagged &&
+      !any_vis_chan_ok(pRec, pFilter, pWave, useWave, nwave))
+    return FALSE; /* all-flagged record */
+  return TRUE;
+}
+
+/**
+ * Filter channels of OI_VIS table row by wavelength, UV radius and SNR
+ *
+ * The arrays of @a pOutRec must be allocated by the caller, and may
+ * be those of @a pInRec, so that a record can be filtered in place.
+ */
+static void compact_oi_vis_record(const oi_vis_record *pInRec,
+                                  const oi_filter_spec *pFilter,
+                                  const oi_wavelength *pWave,
+                                  const char *useWave, int nwaveIn,
+                                  int nwaveOut, BOOL usevisrefmap,
+                                  BOOL usecomplex, oi_vis_record *pOutRec)
 {
   bool someUnflagged;
   int j, k, l, m;
   float snrAmp, snrPhi;
   double uvrad;
 
-  memcpy(pOutRec, pInRec, sizeof(oi_vis_record));
-  if (pFilter->target_id >= 0) pOutRec->target_id = 1;
-  pOutRec->visamp = chkmalloc(nwaveOut * sizeof(pOutRec->visamp[0]));
-  pOutRec->visamperr = chkmalloc(nwaveOut * sizeof(pOutRec->visamperr[0]));
-  pOutRec->visphi = chkmalloc(nwaveOut * sizeof(pOutRec->visphi[0]));
-  pOutRec->visphierr = chkmalloc(nwaveOut * sizeof(pOutRec->visphierr[0]));
-  pOutRec->flag = chkmalloc(nwaveOut * sizeof(pOutRec->flag[0]));
-  if (usevisrefmap)
-    pOutRec->visrefmap =
-        chkmalloc(nwaveOut * nwaveOut * sizeof(pOutRec->visrefmap[0]));
-  else
-    pOutRec->visrefmap = NULL;
-  if (usecomplex)
-  {
-    pOutRec->rvis = chkmalloc(nwaveOut * sizeof(pOutRec->rvis[0]));
-    pOutRec->rviserr = chkmalloc(nwaveOut * sizeof(pOutRec->rviserr[0]));
-    pOutRec->ivis = chkmalloc(nwaveOut * sizeof(pOutRec->ivis[0]));
-    pOutRec->iviserr = chkmalloc(nwaveOut * sizeof(pOutRec->iviserr[0]));
-  }
-  else
-  {
-    pOutRec->rvis = NULL;
-    pOutRec->rviserr = NULL;
-    pOutRec->ivis = NULL;
-    pOutRec->iviserr = NULL;
-  }
   k = 0;
   someUnflagged = FALSE;
   for (j = 0; j < nwaveIn; j++)
@@ -1117,6 +1059,46 @@ static void filter_oi_vis_record(const oi_vis_record *pInRec,
   g_assert(pFilter->accept_flagged || someUnflagged);
 }
 
+/**
+ * Filter OI_VIS table row by wavelength, UV radius and SNR
+ */
+static void filter_oi_vis_record(const oi_vis_record *pInRec,
+                                 const oi_filter_spec *pFilter,
+                                 const oi_wavelength *pWave,
+                                 const char *useWave, int nwaveIn, int nwaveOut,
+                                 BOOL usevisrefmap, BOOL usecomplex,
+                                 oi_vis_record *pOutRec)
+{
+  memcpy(pOutRec, pInRec, sizeof(oi_vis_record));
+  if (pFilter->target_id >= 0) pOutRec->target_id = 1;
+  pOutRec->visamp = chkmalloc(nwaveOut * sizeof(pOutRec->visamp[0]));
+  pOutRec->visamperr = chkmalloc(nwaveOut * sizeof(pOutRec->visamperr[0]));
+  pOutRec->visphi = chkmalloc(nwaveOut * sizeof(pOutRec->visphi[0]));
+  pOutRec->visphierr = chkmalloc(nwaveOut * sizeof(pOutRec->visphierr[0]));
+  pOutRec->flag = chkmalloc(nwaveOut * sizeof(pOutRec->flag[0]));
+  if (usevisrefmap)
+    pOutRec->visrefmap =
+        chkmalloc(nwaveOut * nwaveOut * sizeof(pOutRec->visrefmap[0]));
+  else
+    pOutRec->visrefmap = NULL;
+  if (usecomplex)
+  {
+    pOutRec->rvis = chkmalloc(nwaveOut * sizeof(pOutRec->rvis[0]));
+    pOutRec->rviserr = chkmalloc(nwaveOut * sizeof(pOutRec->rviserr[0]));
+    pOutRec->ivis = chkmalloc(nwaveOut * sizeof(pOutRec->ivis[0]));
+    pOutRec->iviserr = chkmalloc(nwaveOut * sizeof(pOutRec->iviserr[0]));
+  }
+  else
+  {
+    pOutRec->rvis = NULL;
+    pOutRec->rviserr = NULL;
+    pOutRec->ivis = NULL;
+    pOutRec->iviserr = NULL;
+  }
+  compact_oi_vis_record(pInRec, pFilter, pWave, useWave, nwaveIn, nwaveOut,
+                        usevisrefmap, usecomplex, pOutRec);
+}
+
 /**
  * Filter an OI_VIS table by TARGET_ID, MJD, wavelength, UV radius, and SNR
  *
@@ -1131,7 +1113,6 @@ void filter_oi_vis(const oi_vis *pInTab, const oi_filter_spec *pFilter,
                    oi_vis *pOutTab)
 {
   int i, j, nrec;
-  double u1, v1, bas;
 
   /* Copy table header items */
   memcpy(pOutTab, pInTab, sizeof(oi_vis));
@@ -1145,21 +1126,9 @@ void filter_oi_vis(const oi_vis *pInTab, const oi_filter_spec *pFilter,
       chkmalloc(pInTab->numrec * sizeof(oi_vis_record)); /* will reallocate */
   for (i = 0; i < pInTab->numrec; i++)
   {
-    if (pFilter->target_id >= 0 &&
-        pInTab->record[i].target_id != pFilter->target_id)
-      continue; /* skip record as TARGET_ID doesn't match */
-    if (pInTab->record[i].mjd < pFilter->mjd_range[0] ||
-        pInTab->record[i].mjd > pFilter->mjd_range[1])
-      continue; /* skip record as MJD out of range */
-    u1 = pInTab->record[i].ucoord;
-    v1 = pInTab->record[i].vcoord;
-    bas = pow(u1 * u1 + v1 * v1, 0.5);
-    if (bas < pFilter->bas_range[0] || bas > pFilter->bas_range[1])
-      continue; /* skip record as projected baseline out of range */
-    if (!pFilter->accept_flagged &&
-        !any_vis_chan_ok(&pInTab->record[i], pFilter, pWave, useWave,
-                         pInTab->nwave))
-      continue; /* filter out all-flagged record */
+    if (!accept_vis_record(&pInTab->record[i], pFilter, pWave, useWave,
+                           pInTab->nwave))
+      continue;
 
     /* Create output record */
     filter_oi_vis_record(&pInTab->record[i], pFilter, pWave, useWave,
@@ -1167,7 +1136,7 @@ void filter_oi_vis(const oi_vis *pInTab, const oi_filter_spec *pFilter,
                          pInTab->usecomplex, &pOutTab->record[nrec++]);
   }
   pOutTab->numrec = nrec;
-  pOutTab->record = realloc(pOutTab->record, nrec * sizeof(oi_vis_record));
+  pOutTab->record = oi_realloc(pOutTab->record, nrec * sizeof(oi_vis_record));
 }
 
 /**
@@ -1220,7 +1189,7 @@ void filter_all_oi_vis2(const oi_fits *pInput, const oi_filter_spec *pFilter,
         g_warning("Empty OI_VIS2 table removed from filter output");
         g_debug("Removed empty OI_VIS2 with DATE-OBS=%s INSNAME=%s",
                 pOutTab->date_obs, pOutTab->insname);
-        free(pOutTab);
+        oi_free(pOutTab);
       }
     }
   }
@@ -1258,24 +1227,45 @@ static bool any_vis2_chan_ok(const oi_vis2_record *pRec,
 }
 
 /**
- * Filter OI_VIS2 table row by wavelength, UV radius and SNR
+ * Does OI_VIS2 record pass filter on TARGET_ID, MJD, baseline and flagging?
  */
-static void filter_oi_vis2_record(const oi_vis2_record *pInRec,
-                                  const oi_filter_spec *pFilter,
-                                  const oi_wavelength *pWave,
-                                  const char *useWave, int nwaveIn,
-                                  int nwaveOut, oi_vis2_record *pOutRec)
+static bool accept_vis2_record(const oi_vis2_record *pRec,
+                               const oi_filter_spec *pFilter,
+                               const oi_wavelength *pWave, const char *useWave,
+                               int nwave)
+{
+  double bas;
+
+  if (pFilter->target_id >= 0 && pRec->target_id != pFilter->target_id)
+    return FALSE; /* TARGET_ID doesn't match */
+  if (pRec->mjd < pFilter->mjd_range[0] || pRec->mjd > pFilter->mjd_range[1])
+    return FALSE; /* MJD out of range */
+  bas = pow(pRec->ucoord * pRec->ucoord + pRec->vcoord * pRec->vcoord, 0.5);
+  if (bas < pFilter->bas_range[0] || bas > pFilter->bas_range[1])
+    return FALSE; /* projected baseline out of range */
+  if (!pFilter->accept_flagged &&
+      !any_vis2_chan_ok(pRec, pFilter, pWave, useWave, nwave))
+    return FALSE; /* all-flagged record */
+  return TRUE;
+}
+
+/**
+ * Filter channels of OI_VIS2 table row by wavelength, UV radius and SNR
+ *
+ * The arrays of @a pOutRec must be allocated by the caller, and may
+ * be those of @a pInRec, so that a record can be filtered in place.
+ */
+static void compact_oi_vis2_record(const oi_vis2_record *pInRec,
+                                   const oi_filter_spec *pFilter,
+                                   const oi_wavelength *pWave,
+                                   const char *useWave, int nwaveIn,
+                                   int nwaveOut, oi_vis2_record *pOutRec)
 {
   bool someUnflagged;
   int j, k;
   float snr;
   double uvrad;
 
-  memcpy(pOutRec, pInRec, sizeof(oi_vis2_record));
-  if (pFilter->target_id >= 0) pOutRec->target_id = 1;
-  pOutRec->vis2data = chkmalloc(nwaveOut * sizeof(pOutRec->vis2data[0]));
-  pOutRec->vis2err = chkmalloc(nwaveOut * sizeof(pOutRec->vis2err[0]));
-  pOutRec->flag = chkmalloc(nwaveOut * sizeof(pOutRec->flag[0]));
   k = 0;
   someUnflagged = FALSE;
   for (j = 0; j < nwaveIn; j++)
@@ -1309,20 +1299,37 @@ static void filter_oi_vis2_record(const oi_vis2_record *pInRec,
 }
 
 /**
- * Filter an OI_VIS2 table by TARGET_ID, MJD, wavelength, UV radius and SNR
- *
- * @param pInTab   pointer to input oi_vis2
- * @param pFilter  pointer to filter specification
- * @param pWave    pointer to oi_wavelength referenced by this table
- * @param useWave  boolean array giving wavelength channels to accept
- * @param pOutTab  pointer to output oi_vis2
+ * Filter OI_VIS2 table row by wavelength, UV radius and SNR
  */
-void filter_oi_vis2(const oi_vis2 *pInTab, const oi_filter_spec *pFilter,
-                    const oi_wavelength *pWave, const char *useWave,
-                    oi_vis2 *pOutTab)
-{
+static void filter_oi_vis2_record(const oi_vis2_record *pInRec,
+                                  const oi_filter_spec *pFilter,
+                                  const oi_wavelength *pWave,
+                                  const char *useWave, int nwaveIn,
+                                  int nwaveOut, oi_vis2_record *pOutRec)
+{
+  memcpy(pOutRec, pInRec, sizeof(oi_vis2_record));
+  if (pFilter->target_id >= 0) pOutRec->target_id = 1;
+  pOutRec->vis2data = chkmalloc(nwaveOut * sizeof(pOutRec->vis2data[0]));
+  pOutRec->vis2err = chkmalloc(nwaveOut * sizeof(pOutRec->vis2err[0]));
+  pOutRec->flag = chkmalloc(nwaveOut * sizeof(pOutRec->flag[0]));
+  compact_oi_vis2_record(pInRec, pFilter, pWave, useWave, nwaveIn, nwaveOut,
+                         pOutRec);
+}
+
+/**
+ * Filter an OI_VIS2 table by TARGET_ID, MJD, wavelength, UV radius and SNR
+ *
+ * @param pInTab   pointer to input oi_vis2
+ * @param pFilter  pointer to filter specification
+ * @param pWave    pointer to oi_wavelength referenced by this table
+ * @param useWave  boolean array giving wavelength channels to accept
+ * @param pOutTab  pointer to output oi_vis2
+ */
+void filter_oi_vis2(const oi_vis2 *pInTab, const oi_filter_spec *pFilter,
+                    const oi_wavelength *pWave, const char *useWave,
+                    oi_vis2 *pOutTab)
+{
   int i, j, nrec;
-  double bas, u1, v1;
 
   /* Copy table header items */
   memcpy(pOutTab, pInTab, sizeof(oi_vis2));
@@ -1336,21 +1343,9 @@ void filter_oi_vis2(const oi_vis2 *pInTab, const oi_filter_spec *pFilter,
       chkmalloc(pInTab->numrec * sizeof(oi_vis2_record)); /* will reallocate */
   for (i = 0; i < pInTab->numrec; i++)
   {
-    if (pFilter->target_id >= 0 &&
-        pInTab->record[i].target_id != pFilter->target_id)
-      continue; /* skip record as TARGET_ID doesn't match */
-    if ((pInTab->record[i].mjd < pFilter->mjd_range[0]) ||
-        (pInTab->record[i].mjd > pFilter->mjd_range[1]))
-      continue; /* skip record as MJD out of range */
-    u1 = pInTab->record[i].ucoord;
-    v1 = pInTab->record[i].vcoord;
-    bas = pow(u1 * u1 + v1 * v1, 0.5);
-    if (bas < pFilter->bas_range[0] || bas > pFilter->bas_range[1])
-      continue; /* skip record as projected baseline out of range */
-    if (!pFilter->accept_flagged &&
-        !any_vis2_chan_ok(&pInTab->record[i], pFilter, pWave, useWave,
-                          pInTab->nwave))
-      continue; /* filter out all-flagged record */
+    if (!accept_vis2_record(&pInTab->record[i], pFilter, pWave, useWave,
+                            pInTab->nwave))
+      continue;
 
     /* Create output record */
     filter_oi_vis2_record(&pInTab->record[i], pFilter, pWave, useWave,
@@ -1358,7 +1353,7 @@ void filter_oi_vis2(const oi_vis2 *pInTab, const oi_filter_spec *pFilter,
                           &pOutTab->record[nrec++]);
   }
   pOutTab->numrec = nrec;
-  pOutTab->record = realloc(pOutTab->record, nrec * sizeof(oi_vis2_record));
+  pOutTab->record = oi_realloc(pOutTab->record, nrec * sizeof(oi_vis2_record));
 }
 
 /**
@@ -1410,7 +1405,7 @@ void filter_all_oi_t3(const oi_fits *pInput, const oi_filter_spec *pFilter,
         g_warning("Empty OI_T3 table removed from filter output");
         g_debug("Removed empty OI_T3 with DATE-OBS=%s INSNAME=%s",
                 pOutTab->date_obs, pOutTab->insname);
-        free(pOutTab);
+        oi_free(pOutTab);
       }
     }
   }
@@ -1470,13 +1465,49 @@ static bool any_t3_chan_ok(const oi_t3_record *pRec,
 }
 
 /**
- * Filter OI_T3 table row by wavelength and SNR
+ * Does OI_T3 record pass filter on TARGET_ID, MJD, baselines and flagging?
  */
-static void filter_oi_t3_record(const oi_t3_record *pInRec,
-                                const oi_filter_spec *pFilter,
-                                const oi_wavelength *pWave, const char *useWave,
-                                int nwaveIn, int nwaveOut,
-                                oi_t3_record *pOutRec)
+static bool accept_t3_record(const oi_t3_record *pRec,
+                             const oi_filter_spec *pFilter,
+                             const oi_wavelength *pWave, const char *useWave,
+                             int nwave)
+{
+  double u1, v1, u2, v2, bas;
+
+  if (pFilter->target_id >= 0 && pRec->target_id != pFilter->target_id)
+    return FALSE; /* TARGET_ID doesn't match */
+  if (pRec->mjd < pFilter->mjd_range[0] || pRec->mjd > pFilter->mjd_range[1])
+    return FALSE; /* MJD out of range */
+  u1 = pRec->u1coord;
+  v1 = pRec->v1coord;
+  u2 = pRec->u2coord;
+  v2 = pRec->v2coord;
+  bas = pow(u1 * u1 + v1 * v1, 0.5);
+  if (bas < pFilter->bas_range[0] || bas > pFilter->bas_range[1])
+    return FALSE; /* projected baseline ab out of range */
+  bas = pow(u2 * u2 + v2 * v2, 0.5);
+  if (bas < pFilter->bas_range[0] || bas > pFilter->bas_range[1])
+    return FALSE; /* projected baseline bc out of range */
+  bas = pow((u1 + u2) * (u1 + u2) + (v1 + v2) * (v1 + v2), 0.5);
+  if (bas < pFilter->bas_range[0] || bas > pFilter->bas_range[1])
+    return FALSE; /* projected baseline ac out of range */
+  if (!pFilter->accept_flagged &&
+      !any_t3_chan_ok(pRec, pFilter, pWave, useWave, nwave))
+    return FALSE; /* all-flagged record */
+  return TRUE;
+}
+
+/**
+ * Filter channels of OI_T3 table row by wavelength and SNR
+ *
+ * The arrays of @a pOutRec must be allocated by the caller, and may
+ * be those of @a pInRec, so that a record can be filtered in place.
+ */
+static void compact_oi_t3_record(const oi_t3_record *pInRec,
+                                 const oi_filter_spec *pFilter,
+                                 const oi_wavelength *pWave,
+                                 const char *useWave, int nwaveIn, int nwaveOut,
+                                 oi_t3_record *pOutRec)
 {
   bool someUnflagged;
   int j, k;
@@ -1490,13 +1521,6 @@ static void filter_oi_t3_record(const oi_t3_record *pInRec,
     nan /= nan;
   }
 
-  memcpy(pOutRec, pInRec, sizeof(oi_t3_record));
-  if (pFilter->target_id >= 0) pOutRec->target_id = 1;
-  pOutRec->t3amp = chkmalloc(nwaveOut * sizeof(pOutRec->t3amp[0]));
-  pOutRec->t3amperr = chkmalloc(nwaveOut * sizeof(pOutRec->t3amperr[0]));
-  pOutRec->t3phi = chkmalloc(nwaveOut * sizeof(pOutRec->t3phi[0]));
-  pOutRec->t3phierr = chkmalloc(nwaveOut * sizeof(pOutRec->t3phierr[0]));
-  pOutRec->flag = chkmalloc(nwaveOut * sizeof(pOutRec->flag[0]));
   k = 0;
   someUnflagged = FALSE;
   u1 = pInRec->u1coord;
@@ -1560,6 +1584,26 @@ static void filter_oi_t3_record(const oi_t3_record *pInRec,
   g_assert(pFilter->accept_flagged || someUnflagged);
 }
 
+/**
+ * Filter OI_T3 table row by wavelength and SNR
+ */
+static void filter_oi_t3_record(const oi_t3_record *pInRec,
+                                const oi_filter_spec *pFilter,
+                                const oi_wavelength *pWave, const char *useWave,
+                                int nwaveIn, int nwaveOut,
+                                oi_t3_record *pOutRec)
+{
+  memcpy(pOutRec, pInRec, sizeof(oi_t3_record));
+  if (pFilter->target_id >= 0) pOutRec->target_id = 1;
+  pOutRec->t3amp = chkmalloc(nwaveOut * sizeof(pOutRec->t3amp[0]));
+  pOutRec->t3amperr = chkmalloc(nwaveOut * sizeof(pOutRec->t3amperr[0]));
+  pOutRec->t3phi = chkmalloc(nwaveOut * sizeof(pOutRec->t3phi[0]));
+  pOutRec->t3phierr = chkmalloc(nwaveOut * sizeof(pOutRec->t3phierr[0]));
+  pOutRec->flag = chkmalloc(nwaveOut * sizeof(pOutRec->flag[0]));
+  compact_oi_t3_record(pInRec, pFilter, pWave, useWave, nwaveIn, nwaveOut,
+                       pOutRec);
+}
+
 /**
  * Filter an OI_T3 table by TARGET_ID, MJD, wavelength, UV radius and SNR
  *
@@ -1574,7 +1618,6 @@ void filter_oi_t3(const oi_t3 *pInTab, const oi_filter_spec *pFilter,
                   oi_t3 *pOutTab)
 {
   int i, j, nrec;
-  double u1, v1, u2, v2, bas;
 
   /* Copy table header items */
   memcpy(pOutTab, pInTab, sizeof(oi_t3));
@@ -1588,29 +1631,9 @@ void filter_oi_t3(const oi_t3 *pInTab, const oi_filter_spec *pFilter,
       chkmalloc(pInTab->numrec * sizeof(oi_t3_record)); /* will reallocate */
   for (i = 0; i < pInTab->numrec; i++)
   {
-    if (pFilter->target_id >= 0 &&
-        pInTab->record[i].target_id != pFilter->target_id)
-      continue; /* skip record as TARGET_ID doesn't match */
-    if ((pInTab->record[i].mjd < pFilter->mjd_range[0]) ||
-        (pInTab->record[i].mjd > pFilter->mjd_range[1]))
-      continue; /* skip record as MJD out of range */
-    u1 = pInTab->record[i].u1coord;
-    v1 = pInTab->record[i].v1coord;
-    u2 = pInTab->record[i].u2coord;
-    v2 = pInTab->record[i].v2coord;
-    bas = pow(u1 * u1 + v1 * v1, 0.5);
-    if (bas < pFilter->bas_range[0] || bas > pFilter->bas_range[1])
-      continue; /* skip record as projected baseline ab out of range */
-    bas = pow(u2 * u2 + v2 * v2, 0.5);
-    if (bas < pFilter->bas_range[0] || bas > pFilter->bas_range[1])
-      continue; /* skip record as projected baseline bc out of range */
-    bas = pow((u1 + u2) * (u1 + u2) + (v1 + v2) * (v1 + v2), 0.5);
-    if (bas < pFilter->bas_range[0] || bas > pFilter->bas_range[1])
-      continue; /* skip record as projected baseline ac out of range */
-    if (!pFilter->accept_flagged &&
-        !any_t3_chan_ok(&pInTab->record[i], pFilter, pWave, useWave,
-                        pInTab->nwave))
-      continue; /* filter out all-flagged record */
+    if (!accept_t3_record(&pInTab->record[i], pFilter, pWave, useWave,
+                          pInTab->nwave))
+      continue;
 
     /* Create output record */
     filter_oi_t3_record(&pInTab->record[i], pFilter, pWave, useWave,
@@ -1618,7 +1641,7 @@ void filter_oi_t3(const oi_t3 *pInTab, const oi_filter_spec *pFilter,
                         &pOutTab->record[nrec++]);
   }
   pOutTab->numrec = nrec;
-  pOutTab->record = realloc(pOutTab->record, nrec * sizeof(oi_t3_record));
+  pOutTab->record = oi_realloc(pOutTab->record, nrec * sizeof(oi_t3_record));
 }
 
 /**
@@ -1666,19 +1689,35 @@ void filter_all_oi_flux(const oi_fits *pInput, const oi_filter_spec *pFilter,
         g_warning("Empty OI_FLUX table removed from filter output");
         g_debug("Removed empty OI_FLUX with DATE-OBS=%s INSNAME=%s",
                 pOutTab->date_obs, pOutTab->insname);
-        free(pOutTab);
+        oi_free(pOutTab);
       }
     }
   }
 }
 
 /**
- * Filter OI_FLUX table row by wavelength and SNR
+ * Does OI_FLUX record pass filter on TARGET_ID and MJD?
  */
-static void filter_oi_flux_record(const oi_flux_record *pInRec,
-                                  const oi_filter_spec *pFilter,
-                                  const char *useWave, int nwaveIn,
-                                  int nwaveOut, oi_flux_record *pOutRec)
+static bool accept_flux_record(const oi_flux_record *pRec,
+                               const oi_filter_spec *pFilter)
+{
+  if (pFilter->target_id >= 0 && pRec->target_id != pFilter->target_id)
+    return FALSE; /* TARGET_ID doesn't match */
+  if (pRec->mjd < pFilter->mjd_range[0] || pRec->mjd > pFilter->mjd_range[1])
+    return FALSE; /* MJD out of range */
+  return TRUE;
+}
+
+/**
+ * Filter channels of OI_FLUX table row by wavelength and SNR
+ *
+ * The arrays of @a pOutRec must be allocated by the caller, and may
+ * be those of @a pInRec, so that a record can be filtered in place.
+ */
+static void compact_oi_flux_record(const oi_flux_record *pInRec,
+                                   const oi_filter_spec *pFilter,
+                                   const char *useWave, int nwaveIn,
+                                   int nwaveOut, oi_flux_record *pOutRec)
 {
   int j, k;
   double nan;
@@ -1688,11 +1727,6 @@ static void filter_oi_flux_record(const oi_flux_record *pInRec,
   nan = 0.0;
   nan /= nan;
 
-  memcpy(pOutRec, pInRec, sizeof(oi_flux_record));
-  if (pFilter->target_id >= 0) pOutRec->target_id = 1;
-  pOutRec->fluxdata = chkmalloc(nwaveOut * sizeof(pOutRec->fluxdata[0]));
-  pOutRec->fluxerr = chkmalloc(nwaveOut * sizeof(pOutRec->fluxerr[0]));
-  pOutRec->flag = chkmalloc(nwaveOut * sizeof(pOutRec->flag[0]));
   k = 0;
   for (j = 0; j < nwaveIn; j++)
   {
@@ -1715,6 +1749,23 @@ static void filter_oi_flux_record(const oi_flux_record *pInRec,
   }
 }
 
+/**
+ * Filter OI_FLUX table row by wavelength and SNR
+ */
+static void filter_oi_flux_record(const oi_flux_record *pInRec,
+                                  const oi_filter_spec *pFilter,
+                                  const char *useWave, int nwaveIn,
+                                  int nwaveOut, oi_flux_record *pOutRec)
+{
+  memcpy(pOutRec, pInRec, sizeof(oi_flux_record));
+  if (pFilter->target_id >= 0) pOutRec->target_id = 1;
+  pOutRec->fluxdata = chkmalloc(nwaveOut * sizeof(pOutRec->fluxdata[0]));
+  pOutRec->fluxerr = chkmalloc(nwaveOut * sizeof(pOutRec->fluxerr[0]));
+  pOutRec->flag = chkmalloc(nwaveOut * sizeof(pOutRec->flag[0]));
+  compact_oi_flux_record(pInRec, pFilter, useWave, nwaveIn, nwaveOut,
+                         pOutRec);
+}
+
 /**
  * Filter an OI_FLUX table by TARGET_ID, MJD, wavelength and SNR
  *
@@ -1740,19 +1791,14 @@ void filter_oi_flux(const oi_flux *pInTab, const oi_filter_spec *pFilter,
       chkmalloc(pInTab->numrec * sizeof(oi_flux_record)); /* will reallocate */
   for (i = 0; i < pInTab->numrec; i++)
   {
-    if (pFilter->target_id >= 0 &&
-        pInTab->record[i].target_id != pFilter->target_id)
-      continue; /* skip record as TARGET_ID doesn't match */
-    if (pInTab->record[i].mjd < pFilter->mjd_range[0] ||
-        pInTab->record[i].mjd > pFilter->mjd_range[1])
-      continue; /* skip record as MJD out of range */
+    if (!accept_flux_record(&pInTab->record[i], pFilter)) continue;
 
     /* Create output record */
     filter_oi_flux_record(&pInTab->record[i], pFilter, useWave, pInTab->nwave,
                           pOutTab->nwave, &pOutTab->record[nrec++]);
   }
   pOutTab->numrec = nrec;
-  pOutTab->record = realloc(pOutTab->record, nrec * sizeof(oi_flux_record));
+  pOutTab->record = oi_realloc(pOutTab->record, nrec * sizeof(oi_flux_record));
 }
 
 /**
@@ -1766,8 +1812,9 @@ void apply_oi_filter(const oi_fits *pInput, oi_filter_spec *pFilter,
                      oi_fits *pOutput)
 {
   GHashTable *useWaveHash;
-  GList *list;
+  oi_timer start;
 
+  start = oi_profile_start();
   init_oi_fits(pOutput);
 
   /* Compile glob-style patterns for efficiency */
@@ -1798,20 +1845,7 @@ void apply_oi_filter(const oi_fits *pInput, oi_filter_spec *pFilter,
   filter_all_oi_flux(pInput, pFilter, useWaveHash, pOutput);
 
   /* Remove orphaned OI_ARRAY, OI_INSPOL, OI_WAVELENGTH and OI_CORR tables */
-  list = get_arrname_list(pOutput);
-  while (prune_oi_array(pOutput, list))
-    ;
-  while (prune_oi_inspol(pOutput, list))
-    ;
-  g_list_free(list);
-  list = get_insname_list(pOutput);
-  while (prune_oi_wavelength(pOutput, list))
-    ;
-  g_list_free(list);
-  list = get_corrname_list(pOutput);
-  while (prune_oi_corr(pOutput, list))
-    ;
-  g_list_free(list);
+  prune_oi_fits(pOutput);
 
   // TODO: remove orphaned OI_INSPOL records?
   // Note these do not invalidate the OIFITS file
@@ -1825,4 +1859,1738 @@ void apply_oi_filter(const oi_fits *pInput, oi_filter_spec *pFilter,
   pFilter->corrname_pttn = NULL;
 
   g_hash_table_destroy(useWaveHash);
+  oi_profile_stop(OI_PHASE_FILTER, start);
+}
+
+/**
+ * Free dynamically-allocated storage within oi_inspol_record struct
+ */
+static void free_inspol_record(oi_inspol_record *pRec)
+{
+  oi_free(pRec->jxx);
+  oi_free(pRec->jyy);
+  oi_free(pRec->jxy);
+  oi_free(pRec->jyx);
+}
+
+/**
+ * Free dynamically-allocated storage within oi_vis_record struct
+ */
+static void free_vis_record(oi_vis_record *pRec, BOOL usevisrefmap,
+                            BOOL usecomplex)
+{
+  oi_free(pRec->visamp);
+  oi_free(pRec->visamperr);
+  oi_free(pRec->visphi);
+  oi_free(pRec->visphierr);
+  oi_free(pRec->flag);
+  if (usevisrefmap) oi_free(pRec->visrefmap);
+  if (usecomplex)
+  {
+    oi_free(pRec->rvis);
+    oi_free(pRec->rviserr);
+    oi_free(pRec->ivis);
+    oi_free(pRec->iviserr);
+  }
+}
+
+/**
+ * Free dynamically-allocated storage within oi_vis2_record struct
+ */
+static void free_vis2_record(oi_vis2_record *pRec)
+{
+  oi_free(pRec->vis2data);
+  oi_free(pRec->vis2err);
+  oi_free(pRec->flag);
+}
+
+/**
+ * Free dynamically-allocated storage within oi_t3_record struct
+ */
+static void free_t3_record(oi_t3_record *pRec)
+{
+  oi_free(pRec->t3amp);
+  oi_free(pRec->t3amperr);
+  oi_free(pRec->t3phi);
+  oi_free(pRec->t3phierr);
+  oi_free(pRec->flag);
+}
+
+/**
+ * Free dynamically-allocated storage within oi_flux_record struct
+ */
+static void free_flux_record(oi_flux_record *pRec)
+{
+  oi_free(pRec->fluxdata);
+  oi_free(pRec->fluxerr);
+  oi_free(pRec->flag);
+}
+
+/**
+ * Filter OI_TARGET table in place
+ */
+static void filter_oi_target_inplace(oi_target *pTargets,
+                                     const oi_filter_spec *pFilter)
+{
+  int i;
+
+  if (pFilter->target_id < 0) return;
+
+  /* Keep single record. TARGET_ID is set to 1 */
+  for (i = 0; i < pTargets->ntarget; i++)
+  {
+    if (pTargets->targ[i].target_id == pFilter->target_id)
+    {
+      if (i > 0)
+        memcpy(&pTargets->targ[0], &pTargets->targ[i], sizeof(target));
+      pTargets->targ[0].target_id = 1;
+      pTargets->ntarget = 1;
+      pTargets->targ = chkrealloc(pTargets->targ, sizeof(target));
+      return;
+    }
+  }
+  pTargets->ntarget = 0;
+  oi_free(pTargets->targ);
+  pTargets->targ = NULL;
+}
+
+/**
+ * Determine which wavelength channels of each OI_WAVELENGTH table
+ * are accepted, without modifying the tables
+ *
+ * @return Hash table of boolean arrays giving accepted wavelength
+ *         channels, indexed by INSNAME
+ */
+static GHashTable *get_use_wave_hash(const oi_fits *pData,
+                                     const oi_filter_spec *pFilter)
+{
+  GHashTable *useWaveHash;
+  oi_wavelength *pWave;
+  char *useWave;
+  GList *link;
+  int j;
+
+  useWaveHash = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, oi_free);
+  link = pData->wavelengthList;
+  while (link != NULL)
+  {
+    pWave = (oi_wavelength *)link->data;
+    if (ACCEPT_INSNAME(pWave, pFilter))
+    {
+      useWave = chkmalloc(pWave->nwave * sizeof(useWave[0]));
+      for (j = 0; j < pWave->nwave; j++)
+        useWave[j] = !(pWave->eff_wave[j] < pFilter->wave_range[0] ||
+                       pWave->eff_wave[j] > pFilter->wave_range[1]);
+      if (count_use_wave(useWave, pWave->nwave) > 0)
+      {
+        g_hash_table_insert(useWaveHash, g_strdup(pWave->insname), useWave);
+      }
+      else
+      {
+        g_hash_table_insert(useWaveHash, g_strdup(pWave->insname), NULL);
+        g_warning("Empty tables with INSNAME=%s removed from filter output",
+                  pWave->insname);
+        oi_free(useWave);
+      }
+    }
+    link = link->next;
+  }
+  return useWaveHash;
+}
+
+/**
+ * Filter all OI_WAVELENGTH tables in place
+ *
+ * Must be called after the tables with spectral data have been
+ * filtered, as those use the unfiltered wavelengths.
+ */
+static void filter_all_oi_wavelength_inplace(oi_fits *pData,
+                                             GHashTable *useWaveHash)
+{
+  GList *link, *next;
+  oi_wavelength *pWave;
+  const char *useWave;
+  int j, k;
+
+  link = pData->wavelengthList;
+  while (link != NULL)
+  {
+    next = link->next;
+    pWave = (oi_wavelength *)link->data;
+    useWave = g_hash_table_lookup(useWaveHash, pWave->insname);
+    if (useWave != NULL)
+    {
+      k = 0;
+      for (j = 0; j < pWave->nwave; j++)
+      {
+        if (useWave[j])
+        {
+          pWave->eff_wave[k] = pWave->eff_wave[j];
+          pWave->eff_band[k++] = pWave->eff_band[j];
+        }
+      }
+      pWave->nwave = k;
+    }
+    else
+    {
+      g_hash_table_remove(pData->wavelengthHash, pWave->insname);
+      pData->wavelengthList = g_list_delete_link(pData->wavelengthList, link);
+      --pData->numWavelength;
+      free_oi_wavelength(pWave);
+      oi_free(pWave);
+    }
+    link = next;
+  }
+}
+
+/**
+ * Filter an OI_INSPOL table in place
+ */
+static void filter_oi_inspol_inplace(oi_inspol *pTab,
+                                     const oi_filter_spec *pFilter,
+                                     GHashTable *useWaveHash)
+{
+  oi_inspol_record *pRec;
+  const char *useWave;
+  long i, nrec;
+  int nwave;
+
+  nrec = 0; /* counter */
+  nwave = pTab->nwave;
+  for (i = 0; i < pTab->numrec; i++)
+  {
+    pRec = &pTab->record[i];
+    if (!accept_inspol_record(pRec, pFilter, useWaveHash))
+    {
+      free_inspol_record(pRec);
+      continue;
+    }
+    useWave = g_hash_table_lookup(useWaveHash, pRec->insname);
+    if (nrec == 0) nwave = count_use_wave(useWave, pTab->nwave);
+    if (pFilter->target_id >= 0) pRec->target_id = 1;
+    compact_oi_inspol_record(pRec, useWave, pTab->nwave, nwave, pRec);
+    if (nrec != i) pTab->record[nrec] = *pRec;
+    ++nrec;
+  }
+  pTab->nwave = nwave;
+  pTab->numrec = nrec;
+  /* Shrink buffer, unless table is now empty and will be freed */
+  if (nrec > 0)
+    pTab->record = chkrealloc(pTab->record, nrec * sizeof(oi_inspol_record));
+}
+
+/**
+ * Filter an OI_VIS table in place
+ */
+static void filter_oi_vis_inplace(oi_vis *pTab, const oi_filter_spec *pFilter,
+                                  const oi_wavelength *pWave,
+                                  const char *useWave)
+{
+  oi_vis_record *pRec;
+  long i, nrec;
+  int nwave;
+
+  nwave = count_use_wave(useWave, pTab->nwave);
+  nrec = 0; /* counter */
+  for (i = 0; i < pTab->numrec; i++)
+  {
+    pRec = &pTab->record[i];
+    if (!accept_vis_record(pRec, pFilter, pWave, useWave, pTab->nwave))
+    {
+      free_vis_record(pRec, pTab->usevisrefmap, pTab->usecomplex);
+      continue;
+    }
+    if (pFilter->target_id >= 0) pRec->target_id = 1;
+    compact_oi_vis_record(pRec, pFilter, pWave, useWave, pTab->nwave, nwave,
+                          pTab->usevisrefmap, pTab->usecomplex, pRec);
+    if (nrec != i) pTab->record[nrec] = *pRec;
+    ++nrec;
+  }
+  pTab->nwave = nwave;
+  pTab->numrec = nrec;
+  /* Shrink buffer, unless table is now empty and will be freed */
+  if (nrec > 0)
+    pTab->record = chkrealloc(pTab->record, nrec * sizeof(oi_vis_record));
+}
+
+/**
+ * Filter an OI_VIS2 table in place
+ */
+static void filter_oi_vis2_inplace(oi_vis2 *pTab, const oi_filter_spec *pFilter,
+                                   const oi_wavelength *pWave,
+                                   const char *useWave)
+{
+  oi_vis2_record *pRec;
+  long i, nrec;
+  int nwave;
+
+  nwave = count_use_wave(useWave, pTab->nwave);
+  nrec = 0; /* counter */
+  for (i = 0; i < pTab->numrec; i++)
+  {
+    pRec = &pTab->record[i];
+    if (!accept_vis2_record(pRec, pFilter, pWave, useWave, pTab->nwave))
+    {
+      free_vis2_record(pRec);
+      continue;
+    }
+    if (pFilter->target_id >= 0) pRec->target_id = 1;
+    compact_oi_vis2_record(pRec, pFilter, pWave, useWave, pTab->nwave, nwave,
+                           pRec);
+    if (nrec != i) pTab->record[nrec] = *pRec;
+    ++nrec;
+  }
+  pTab->nwave = nwave;
+  pTab->numrec = nrec;
+  /* Shrink buffer, unless table is now empty and will be freed */
+  if (nrec > 0)
+    pTab->record = chkrealloc(pTab->record, nrec * sizeof(oi_vis2_record));
+}
+
+/**
+ * Filter an OI_T3 table in place
+ */
+static void filter_oi_t3_inplace(oi_t3 *pTab, const oi_filter_spec *pFilter,
+                                 const oi_wavelength *pWave,
+                                 const char *useWave)
+{
+  oi_t3_record *pRec;
+  long i, nrec;
+  int nwave;
+
+  nwave = count_use_wave(useWave, pTab->nwave);
+  nrec = 0; /* counter */
+  for (i = 0; i < pTab->numrec; i++)
+  {
+    pRec = &pTab->record[i];
+    if (!accept_t3_record(pRec, pFilter, pWave, useWave, pTab->nwave))
+    {
+      free_t3_record(pRec);
+      continue;
+    }
+    if (pFilter->target_id >= 0) pRec->target_id = 1;
+    compact_oi_t3_record(pRec, pFilter, pWave, useWave, pTab->nwave, nwave,
+                         pRec);
+    if (nrec != i) pTab->record[nrec] = *pRec;
+    ++nrec;
+  }
+  pTab->nwave = nwave;
+  pTab->numrec = nrec;
+  /* Shrink buffer, unless table is now empty and will be freed */
+  if (nrec > 0)
+    pTab->record = chkrealloc(pTab->record, nrec * sizeof(oi_t3_record));
+}
+
+/**
+ * Filter an OI_FLUX table in place
+ */
+static void filter_oi_flux_inplace(oi_flux *pTab, const oi_filter_spec *pFilter,
+                                   const char *useWave)
+{
+  oi_flux_record *pRec;
+  long i, nrec;
+  int nwave;
+
+  nwave = count_use_wave(useWave, pTab->nwave);
+  nrec = 0; /* counter */
+  for (i = 0; i < pTab->numrec; i++)
+  {
+    pRec = &pTab->record[i];
+    if (!accept_flux_record(pRec, pFilter))
+    {
+      free_flux_record(pRec);
+      continue;
+    }
+    if (pFilter->target_id >= 0) pRec->target_id = 1;
+    compact_oi_flux_record(pRec, pFilter, useWave, pTab->nwave, nwave, pRec);
+    if (nrec != i) pTab->record[nrec] = *pRec;
+    ++nrec;
+  }
+  pTab->nwave = nwave;
+  pTab->numrec = nrec;
+  /* Shrink buffer, unless table is now empty and will be freed */
+  if (nrec > 0)
+    pTab->record = chkrealloc(pTab->record, nrec * sizeof(oi_flux_record));
+}
+
+/**
+ * Filter all tables of one type with spectral data in place
+ *
+ * Tables rejected by name, or left empty by filtering, are freed.
+ */
+#define FILTER_ALL_INPLACE(pData, list, num, tabType, extname, accept,         \
+                           filter_inplace, free_func, pFilter, useWaveHash)    \
+  do                                                                           \
+  {                                                                            \
+    GList *link, *next;                                                        \
+    tabType *pTab;                                                             \
+    const oi_wavelength *pWave;                                                \
+    const char *useWave;                                                       \
+    bool keep;                                                                 \
+    link = (list);                                                             \
+    while (link != NULL)                                                       \
+    {                                                                          \
+      next = link->next;                                                       \
+      pTab = (tabType *)link->data;                                            \
+      useWave = g_hash_table_lookup((useWaveHash), pTab->insname);             \
+      keep = ((accept) && ACCEPT_INSNAME(pTab, (pFilter)) &&                   \
+              ACCEPT_ARRNAME(pTab, (pFilter)) &&                               \
+              ACCEPT_CORRNAME(pTab, (pFilter)) && useWave != NULL);            \
+      if (keep)                                                                \
+      {                                                                        \
+        pWave = oi_fits_lookup_wavelength((pData), pTab->insname);             \
+        filter_inplace(pTab, (pFilter), pWave, useWave);                       \
+        if (pTab->nwave == 0 || pTab->numrec == 0)                             \
+        {                                                                      \
+          g_warning("Empty " extname " table removed from filter output");    \
+          g_debug("Removed empty " extname " with DATE-OBS=%s INSNAME=%s",     \
+                  pTab->date_obs, pTab->insname);                              \
+          keep = FALSE;                                                        \
+        }                                                                      \
+      }                                                                        \
+      if (!keep)                                                               \
+      {                                                                        \
+        free_func(pTab);                                                       \
+        oi_free(pTab);                                                         \
+        (list) = g_list_delete_link((list), link);                             \
+        --(num);                                                               \
+      }                                                                        \
+      link = next;                                                             \
+    }                                                                          \
+  } while (0)
+
+/** Adapt filter_oi_flux_inplace() to the signature used by
+ *  FILTER_ALL_INPLACE */
+#define FILTER_OI_FLUX_INPLACE(pTab, pFilter, pWave, useWave)                  \
+  ((void)(pWave), filter_oi_flux_inplace(pTab, pFilter, useWave))
+
+/**
+ * Filter OIFITS data in place, freeing rejected data
+ *
+ * The result is the same as that of apply_oi_filter(), but records
+ * and channels are compacted within the existing buffers, so a
+ * second copy of the dataset is never held in memory.
+ *
+ * @param pData    pointer to file data struct to filter, see oifile.h
+ * @param pFilter  pointer to filter specification
+ */
+void apply_oi_filter_inplace(oi_fits *pData, oi_filter_spec *pFilter)
+{
+  GHashTable *useWaveHash;
+  GList *link, *next;
+  oi_array *pArray;
+  oi_corr *pCorr;
+  oi_inspol *pInspol;
+  bool keep;
+  oi_timer start;
+
+  start = oi_profile_start();
+
+  /* Compile glob-style patterns for efficiency */
+  g_assert(pFilter->arrname_pttn == NULL);
+  pFilter->arrname_pttn = g_pattern_spec_new(pFilter->arrname);
+  g_assert(pFilter->insname_pttn == NULL);
+  pFilter->insname_pttn = g_pattern_spec_new(pFilter->insname);
+  g_assert(pFilter->corrname_pttn == NULL);
+  pFilter->corrname_pttn = g_pattern_spec_new(pFilter->corrname);
+
+  /* Don't let hash keys refer to data tables that may be freed */
+  rehash_oi_fits(pData);
+
+  /* Filter OI_TARGET, OI_ARRAY, and OI_CORR tables */
+  filter_oi_target_inplace(&pData->targets, pFilter);
+  link = pData->arrayList;
+  while (link != NULL)
+  {
+    next = link->next;
+    pArray = (oi_array *)link->data;
+    if (!ACCEPT_ARRNAME(pArray, pFilter))
+    {
+      g_hash_table_remove(pData->arrayHash, pArray->arrname);
+      pData->arrayList = g_list_delete_link(pData->arrayList, link);
+      --pData->numArray;
+      free_oi_array(pArray);
+      oi_free(pArray);
+    }
+    link = next;
+  }
+  link = pData->corrList;
+  while (link != NULL)
+  {
+    next = link->next;
+    pCorr = (oi_corr *)link->data;
+    if (!ACCEPT_CORRNAME(pCorr, pFilter))
+    {
+      g_hash_table_remove(pData->corrHash, pCorr->corrname);
+      pData->corrList = g_list_delete_link(pData->corrList, link);
+      --pData->numCorr;
+      free_oi_corr(pCorr);
+      oi_free(pCorr);
+    }
+    link = next;
+  }
+
+  /* Find which wavelengths are accepted for each INSNAME. The
+     OI_WAVELENGTH tables are filtered last, as the uv radius filter
+     needs the unfiltered wavelengths */
+  useWaveHash = get_use_wave_hash(pData, pFilter);
+
+  /* Filter tables with spectral data */
+  link = pData->inspolList;
+  while (link != NULL)
+  {
+    next = link->next;
+    pInspol = (oi_inspol *)link->data;
+    keep = ACCEPT_ARRNAME(pInspol, pFilter);
+    if (keep)
+    {
+      filter_oi_inspol_inplace(pInspol, pFilter, useWaveHash);
+      if (pInspol->nwave == 0 || pInspol->numrec == 0)
+      {
+        g_warning("Empty OI_INSPOL table removed from filter output");
+        g_debug("Removed empty OI_INSPOL with ARRNAME=%s", pInspol->arrname);
+        keep = FALSE;
+      }
+    }
+    if (!keep)
+    {
+      pData->inspolList = g_list_delete_link(pData->inspolList, link);
+      --pData->numInspol;
+      free_oi_inspol(pInspol);
+      oi_free(pInspol);
+    }
+    link = next;
+  }
+  FILTER_ALL_INPLACE(pData, pData->visList, pData->numVis, oi_vis, "OI_VIS",
+                     pFilter->accept_vis, filter_oi_vis_inplace, free_oi_vis,
+                     pFilter, useWaveHash);
+  FILTER_ALL_INPLACE(pData, pData->vis2List, pData->numVis2, oi_vis2,
+                     "OI_VIS2", pFilter->accept_vis2, filter_oi_vis2_inplace,
+                     free_oi_vis2, pFilter, useWaveHash);
+  FILTER_ALL_INPLACE(pData, pData->t3List, pData->numT3, oi_t3, "OI_T3",
+                     pFilter->accept_t3amp || pFilter->accept_t3phi,
+                     filter_oi_t3_inplace, free_oi_t3, pFilter, useWaveHash);
+  FILTER_ALL_INPLACE(pData, pData->fluxList, pData->numFlux, oi_flux,
+                     "OI_FLUX", pFilter->accept_flux, FILTER_OI_FLUX_INPLACE,
+                     free_oi_flux, pFilter, useWaveHash);
+  filter_all_oi_wavelength_inplace(pData, useWaveHash);
+
+  /* Remove orphaned OI_ARRAY, OI_INSPOL, OI_WAVELENGTH and OI_CORR tables */
+  prune_oi_fits(pData);
+  rehash_oi_fits(pData);
+
+  /* Free compiled patterns */
+  g_pattern_spec_free(pFilter->arrname_pttn);
+  g_pattern_spec_free(pFilter->insname_pttn);
+  g_pattern_spec_free(pFilter->corrname_pttn);
+  pFilter->arrname_pttn = NULL;
+  pFilter->insname_pttn = NULL;
+  pFilter->corrname_pttn = NULL;
+
+  g_hash_table_destroy(useWaveHash);
+  oi_profile_stop(OI_PHASE_FILTER, start);
+}
+
+/**
+ * Create oi_table_view with space for @a maxrec accepted records
+ */
+static oi_table_view *new_table_view(const void *pTable, int extver,
+                                     const oi_wavelength *pWave,
+                                     const char *useWave, int nwaveIn,
+                                     long maxrec)
+{
+  oi_table_view *pTabView;
+
+  pTabView = chkmalloc(sizeof(oi_table_view));
+  pTabView->pTable = pTable;
+  pTabView->extver = extver;
+  pTabView->pWave = pWave;
+  pTabView->useWave = useWave;
+  pTabView->nwaveIn = nwaveIn;
+  pTabView->nwave = (useWave != NULL) ? count_use_wave(useWave, nwaveIn) : 0;
+  pTabView->numrec = 0; /* counter */
+  if (maxrec > 0)
+    pTabView->irec = chkmalloc(maxrec * sizeof(pTabView->irec[0]));
+  else
+    pTabView->irec = NULL;
+  return pTabView;
+}
+
+/**
+ * Free oi_table_view and its list of record indices
+ */
+static void free_table_view(gpointer data)
+{
+  oi_table_view *pTabView = data;
+
+  oi_free(pTabView->irec);
+  oi_free(pTabView);
+}
+
+/**
+ * Append record index to oi_table_view created with no space reserved
+ *
+ * Storage is grown by doubling, so no more than twice the final
+ * number of indices is ever allocated.
+ */
+static void append_table_view_rec(oi_table_view *pTabView, long irec)
+{
+  long n = pTabView->numrec;
+
+  if (n == 0)
+    pTabView->irec = chkmalloc(8 * sizeof(pTabView->irec[0]));
+  else if (n >= 8 && (n & (n - 1)) == 0)
+    pTabView->irec = chkrealloc(pTabView->irec,
+                                2 * n * sizeof(pTabView->irec[0]));
+  pTabView->irec[pTabView->numrec++] = irec;
+}
+
+/**
+ * Prepend oi_table_view to list if it has accepted data, otherwise free it
+ */
+static GList *add_table_view(GList *list, int *pNum, oi_table_view *pTabView,
+                             const char *extname)
+{
+  if (pTabView->nwave > 0 && pTabView->numrec > 0)
+  {
+    pTabView->irec = chkrealloc(pTabView->irec,
+                                pTabView->numrec * sizeof(pTabView->irec[0]));
+    ++(*pNum);
+    return g_list_prepend(list, pTabView);
+  }
+  g_debug("Empty %s table #%d excluded from filtered view", extname,
+          pTabView->extver);
+  free_table_view(pTabView);
+  return list;
+}
+
+/**
+ * Determine accepted channels of all OI_WAVELENGTH tables for view
+ */
+static void view_all_oi_wavelength(oi_fits_view *pView)
+{
+  const oi_filter_spec *pFilter = &pView->filter;
+  GList *link;
+  oi_wavelength *pInWave;
+  oi_table_view *pTabView;
+  char *useWave;
+  int j, extver;
+
+  extver = 1;
+  link = pView->pInput->wavelengthList;
+  while (link != NULL)
+  {
+    pInWave = (oi_wavelength *)link->data;
+    if (ACCEPT_INSNAME(pInWave, pFilter))
+    {
+      useWave = chkmalloc(pInWave->nwave * sizeof(useWave[0]));
+      for (j = 0; j < pInWave->nwave; j++)
+        useWave[j] = !(pInWave->eff_wave[j] < pFilter->wave_range[0] ||
+                       pInWave->eff_wave[j] > pFilter->wave_range[1]);
+      pTabView = new_table_view(pInWave, extver, pInWave, useWave,
+                                pInWave->nwave, 0);
+      if (pTabView->nwave > 0)
+      {
+        g_hash_table_insert(pView->useWaveHash, g_strdup(pInWave->insname),
+                            useWave);
+        pView->wavelengthList = g_list_prepend(pView->wavelengthList, pTabView);
+        ++pView->numWavelength;
+      }
+      else
+      {
+        g_hash_table_insert(pView->useWaveHash, g_strdup(pInWave->insname),
+                            NULL);
+        oi_free(useWave);
+        free_table_view(pTabView);
+      }
+    }
+    ++extver;
+    link = link->next;
+  }
+  pView->wavelengthList = g_list_reverse(pView->wavelengthList);
+}
+
+/**
+ * Determine accepted records of all OI_INSPOL tables for view
+ */
+static void view_all_oi_inspol(oi_fits_view *pView)
+{
+  const oi_filter_spec *pFilter = &pView->filter;
+  GList *link;
+  oi_inspol *pInTab;
+  oi_table_view *pTabView;
+  const char *useWave;
+  long i;
+  int extver;
+
+  extver = 1;
+  link = pView->pInput->inspolList;
+  while (link != NULL)
+  {
+    pInTab = (oi_inspol *)link->data;
+    if (ACCEPT_ARRNAME(pInTab, pFilter))
+    {
+      pTabView =
+          new_table_view(pInTab, extver, NULL, NULL, pInTab->nwave,
+                         pInTab->numrec);
+      for (i = 0; i < pInTab->numrec; i++)
+      {
+        if (!accept_inspol_record(&pInTab->record[i], pFilter,
+                                  pView->useWaveHash))
+          continue;
+        if (pTabView->numrec == 0)
+        {
+          /* As for filter_oi_inspol(), 1st record sets number of channels */
+          useWave = g_hash_table_lookup(pView->useWaveHash,
+                                        pInTab->record[i].insname);
+          pTabView->nwave = count_use_wave(useWave, pInTab->nwave);
+        }
+        pTabView->irec[pTabView->numrec++] = i;
+      }
+      pView->inspolList = add_table_view(pView->inspolList, &pView->numInspol,
+                                         pTabView, "OI_INSPOL");
+    }
+    ++extver;
+    link = link->next;
+  }
+  pView->inspolList = g_list_reverse(pView->inspolList);
+}
+
+/** Adapt accept_flux_record() to the signature used by VIEW_LIST_TABLES */
+#define ACCEPT_FLUX_RECORD(pRec, pFilter, pWave, useWave, nwave)              \
+  accept_flux_record(pRec, pFilter)
+
+#define ACCEPT_VIS_DATA(pFilter) ((pFilter)->accept_vis)
+#define ACCEPT_VIS2_DATA(pFilter) ((pFilter)->accept_vis2)
+#define ACCEPT_T3_DATA(pFilter)                                                \
+  ((pFilter)->accept_t3amp || (pFilter)->accept_t3phi)
+#define ACCEPT_FLUX_DATA(pFilter) ((pFilter)->accept_flux)
+
+/**
+ * Determine accepted records of all data tables of one type for
+ * several views, in a single pass through the input records
+ */
+#define VIEW_LIST_TABLES(pInput, views, nview, listMember, numMember, tabType, \
+                         extname, acceptData, acceptRecord)                    \
+  do                                                                           \
+  {                                                                            \
+    const oi_filter_spec *pFilter;                                             \
+    GList *link;                                                               \
+    tabType *pInTab;                                                           \
+    oi_table_view **tabViews;                                                  \
+    const oi_wavelength *pWave;                                                \
+    const char *useWave;                                                       \
+    long i;                                                                    \
+    int f, nuse, extver = 1;                                                   \
+    tabViews = chkmalloc((nview) * sizeof(tabViews[0]));                       \
+    link = (pInput)->listMember;                                               \
+    while (link != NULL)                                                       \
+    {                                                                          \
+      pInTab = (tabType *)link->data;                                          \
+      pWave = NULL;                                                            \
+      nuse = 0;                                                                \
+      for (f = 0; f < (nview); f++)                                            \
+      {                                                                        \
+        pFilter = &(views)[f].filter;                                          \
+        useWave = g_hash_table_lookup((views)[f].useWaveHash, pInTab->insname);\
+        tabViews[f] = NULL;                                                    \
+        if (acceptData(pFilter) && ACCEPT_INSNAME(pInTab, pFilter) &&          \
+            ACCEPT_ARRNAME(pInTab, pFilter) &&                                 \
+            ACCEPT_CORRNAME(pInTab, pFilter) && useWave != NULL)               \
+        {                                                                      \
+          if (nuse++ == 0)                                                     \
+            pWave = oi_fits_lookup_wavelength((pInput), pInTab->insname);      \
+          tabViews[f] =                                                        \
+              new_table_view(pInTab, extver, pWave, useWave, pInTab->nwave, 0);\
+        }                                                                      \
+      }                                                                        \
+      for (i = 0; i < pInTab->numrec && nuse > 0; i++)                         \
+      {                                                                        \
+        for (f = 0; f < (nview); f++)                                          \
+        {                                                                      \
+          if (tabViews[f] != NULL &&                                           \
+              acceptRecord(&pInTab->record[i], &(views)[f].filter, pWave,      \
+                           tabViews[f]->useWave, pInTab->nwave))               \
+            append_table_view_rec(tabViews[f], i);                             \
+        }                                                                      \
+      }                                                                        \
+      for (f = 0; f < (nview); f++)                                            \
+      {                                                                        \
+        if (tabViews[f] != NULL)                                               \
+          (views)[f].listMember =                                              \
+              add_table_view((views)[f].listMember, &(views)[f].numMember,     \
+                             tabViews[f], (extname));                          \
+      }                                                                        \
+      ++extver;                                                                \
+      link = link->next;                                                       \
+    }                                                                          \
+    for (f = 0; f < (nview); f++)                                              \
+      (views)[f].listMember = g_list_reverse((views)[f].listMember);           \
+    oi_free(tabViews);                                                         \
+  } while (0)
+
+/**
+ * Add referenced names from list of oi_table_view to hash table set
+ */
+#define ADD_VIEW_NAMES(list, tabType, name, nameSet)                           \
+  do                                                                           \
+  {                                                                            \
+    const tabType *pTab;                                                       \
+    GList *link = (list);                                                      \
+    while (link != NULL)                                                       \
+    {                                                                          \
+      pTab = ((oi_table_view *)link->data)->pTable;                            \
+      if (pTab->name[0] != '\0')                                               \
+        g_hash_table_add((nameSet), (gpointer)pTab->name);                     \
+      link = link->next;                                                       \
+    }                                                                          \
+  } while (0)
+
+/**
+ * Remove oi_table_views with name not in @a nameSet from list
+ */
+#define PRUNE_VIEW_LIST(list, num, tabType, name, nameSet)                     \
+  do                                                                           \
+  {                                                                            \
+    const tabType *pTab;                                                       \
+    GList *link, *next;                                                        \
+    link = (list);                                                             \
+    while (link != NULL)                                                       \
+    {                                                                          \
+      next = link->next;                                                       \
+      pTab = ((oi_table_view *)link->data)->pTable;                            \
+      if (!g_hash_table_contains((nameSet), pTab->name))                       \
+      {                                                                        \
+        free_table_view(link->data);                                           \
+        (list) = g_list_delete_link((list), link);                             \
+        --(num);                                                               \
+      }                                                                        \
+      link = next;                                                             \
+    }                                                                          \
+  } while (0)
+
+/**
+ * Select OI_ARRAY and OI_CORR tables and remove unreferenced
+ * OI_INSPOL and OI_WAVELENGTH tables from view
+ */
+static void prune_oi_fits_view(oi_fits_view *pView)
+{
+  GHashTable *arrnameSet, *insnameSet, *corrnameSet;
+  GList *link;
+  oi_array *pArray;
+  oi_corr *pCorr;
+
+  arrnameSet = g_hash_table_new(g_str_hash, g_str_equal);
+  insnameSet = g_hash_table_new(g_str_hash, g_str_equal);
+  corrnameSet = g_hash_table_new(g_str_hash, g_str_equal);
+  ADD_VIEW_NAMES(pView->visList, oi_vis, arrname, arrnameSet);
+  ADD_VIEW_NAMES(pView->vis2List, oi_vis2, arrname, arrnameSet);
+  ADD_VIEW_NAMES(pView->t3List, oi_t3, arrname, arrnameSet);
+  ADD_VIEW_NAMES(pView->fluxList, oi_flux, arrname, arrnameSet);
+  ADD_VIEW_NAMES(pView->visList, oi_vis, insname, insnameSet);
+  ADD_VIEW_NAMES(pView->vis2List, oi_vis2, insname, insnameSet);
+  ADD_VIEW_NAMES(pView->t3List, oi_t3, insname, insnameSet);
+  ADD_VIEW_NAMES(pView->fluxList, oi_flux, insname, insnameSet);
+  ADD_VIEW_NAMES(pView->visList, oi_vis, corrname, corrnameSet);
+  ADD_VIEW_NAMES(pView->vis2List, oi_vis2, corrname, corrnameSet);
+  ADD_VIEW_NAMES(pView->t3List, oi_t3, corrname, corrnameSet);
+  ADD_VIEW_NAMES(pView->fluxList, oi_flux, corrname, corrnameSet);
+
+  link = pView->pInput->arrayList;
+  while (link != NULL)
+  {
+    pArray = (oi_array *)link->data;
+    if (ACCEPT_ARRNAME(pArray, &pView->filter) &&
+        g_hash_table_contains(arrnameSet, pArray->arrname))
+    {
+      pView->arrayList = g_list_prepend(pView->arrayList, pArray);
+      ++pView->numArray;
+    }
+    link = link->next;
+  }
+  pView->arrayList = g_list_reverse(pView->arrayList);
+
+  link = pView->pInput->corrList;
+  while (link != NULL)
+  {
+    pCorr = (oi_corr *)link->data;
+    if (ACCEPT_CORRNAME(pCorr, &pView->filter) &&
+        g_hash_table_contains(corrnameSet, pCorr->corrname))
+    {
+      pView->corrList = g_list_prepend(pView->corrList, pCorr);
+      ++pView->numCorr;
+    }
+    link = link->next;
+  }
+  pView->corrList = g_list_reverse(pView->corrList);
+
+  PRUNE_VIEW_LIST(pView->inspolList, pView->numInspol, oi_inspol, arrname,
+                  arrnameSet);
+  PRUNE_VIEW_LIST(pView->wavelengthList, pView->numWavelength, oi_wavelength,
+                  insname, insnameSet);
+
+  g_hash_table_destroy(arrnameSet);
+  g_hash_table_destroy(insnameSet);
+  g_hash_table_destroy(corrnameSet);
+}
+
+/**
+ * Make new oi_wavelength containing channels accepted by view
+ */
+static oi_wavelength *materialise_oi_wavelength(const oi_fits_view *pView,
+                                                const oi_table_view *pTabView)
+{
+  const oi_wavelength *pInWave = pTabView->pTable;
+  oi_wavelength *pOutWave;
+  int j, k;
+
+  pOutWave = chkmalloc(sizeof(oi_wavelength));
+  pOutWave->revision = pInWave->revision;
+  (void)g_strlcpy(pOutWave->insname, pInWave->insname, FLEN_VALUE);
+  pOutWave->nwave = pTabView->nwave;
+  pOutWave->eff_wave =
+      chkmalloc(pOutWave->nwave * sizeof(pOutWave->eff_wave[0]));
+  pOutWave->eff_band =
+      chkmalloc(pOutWave->nwave * sizeof(pOutWave->eff_band[0]));
+  k = 0;
+  for (j = 0; j < pInWave->nwave; j++)
+  {
+    if (pTabView->useWave[j])
+    {
+      pOutWave->eff_wave[k] = pInWave->eff_wave[j];
+      pOutWave->eff_band[k++] = pInWave->eff_band[j];
+    }
+  }
+  return pOutWave;
+}
+
+/**
+ * Make new oi_inspol containing records accepted by view
+ */
+static oi_inspol *materialise_oi_inspol(const oi_fits_view *pView,
+                                        const oi_table_view *pTabView)
+{
+  const oi_inspol *pInTab = pTabView->pTable;
+  const oi_inspol_record *pInRec;
+  oi_inspol *pOutTab;
+  const char *useWave;
+  long i;
+
+  pOutTab = chkmalloc(sizeof(oi_inspol));
+  memcpy(pOutTab, pInTab, sizeof(oi_inspol));
+  pOutTab->nwave = pTabView->nwave;
+  pOutTab->numrec = pTabView->numrec;
+  pOutTab->record = chkmalloc(pOutTab->numrec * sizeof(oi_inspol_record));
+  for (i = 0; i < pTabView->numrec; i++)
+  {
+    pInRec = &pInTab->record[pTabView->irec[i]];
+    useWave = g_hash_table_lookup(pView->useWaveHash, pInRec->insname);
+    filter_oi_inspol_record(pInRec, &pView->filter, useWave, pInTab->nwave,
+                            pOutTab->nwave, &pOutTab->record[i]);
+  }
+  return pOutTab;
+}
+
+/**
+ * Make new oi_vis containing records and channels accepted by view
+ */
+static oi_vis *materialise_oi_vis(const oi_fits_view *pView,
+                                  const oi_table_view *pTabView)
+{
+  const oi_vis *pInTab = pTabView->pTable;
+  oi_vis *pOutTab;
+  long i;
+
+  pOutTab = chkmalloc(sizeof(oi_vis));
+  memcpy(pOutTab, pInTab, sizeof(oi_vis));
+  pOutTab->nwave = pTabView->nwave;
+  pOutTab->numrec = pTabView->numrec;
+  pOutTab->record = chkmalloc(pOutTab->numrec * sizeof(oi_vis_record));
+  for (i = 0; i < pTabView->numrec; i++)
+    filter_oi_vis_record(&pInTab->record[pTabView->irec[i]], &pView->filter,
+                         pTabView->pWave, pTabView->useWave, pInTab->nwave,
+                         pOutTab->nwave, pInTab->usevisrefmap,
+                         pInTab->usecomplex, &pOutTab->record[i]);
+  return pOutTab;
+}
+
+/**
+ * Make new oi_vis2 containing records and channels accepted by view
+ */
+static oi_vis2 *materialise_oi_vis2(const oi_fits_view *pView,
+                                    const oi_table_view *pTabView)
+{
+  const oi_vis2 *pInTab = pTabView->pTable;
+  oi_vis2 *pOutTab;
+  long i;
+
+  pOutTab = chkmalloc(sizeof(oi_vis2));
+  memcpy(pOutTab, pInTab, sizeof(oi_vis2));
+  pOutTab->nwave = pTabView->nwave;
+  pOutTab->numrec = pTabView->numrec;
+  pOutTab->record = chkmalloc(pOutTab->numrec * sizeof(oi_vis2_record));
+  for (i = 0; i < pTabView->numrec; i++)
+    filter_oi_vis2_record(&pInTab->record[pTabView->irec[i]], &pView->filter,
+                          pTabView->pWave, pTabView->useWave, pInTab->nwave,
+                          pOutTab->nwave, &pOutTab->record[i]);
+  return pOutTab;
+}
+
+/**
+ * Make new oi_t3 containing records and channels accepted by view
+ */
+static oi_t3 *materialise_oi_t3(const oi_fits_view *pView,
+                                const oi_table_view *pTabView)
+{
+  const oi_t3 *pInTab = pTabView->pTable;
+  oi_t3 *pOutTab;
+  long i;
+
+  pOutTab = chkmalloc(sizeof(oi_t3));
+  memcpy(pOutTab, pInTab, sizeof(oi_t3));
+  pOutTab->nwave = pTabView->nwave;
+  pOutTab->numrec = pTabView->numrec;
+  pOutTab->record = chkmalloc(pOutTab->numrec * sizeof(oi_t3_record));
+  for (i = 0; i < pTabView->numrec; i++)
+    filter_oi_t3_record(&pInTab->record[pTabView->irec[i]], &pView->filter,
+                        pTabView->pWave, pTabView->useWave, pInTab->nwave,
+                        pOutTab->nwave, &pOutTab->record[i]);
+  return pOutTab;
+}
+
+/**
+ * Make new oi_flux containing records and channels accepted by view
+ */
+static oi_flux *materialise_oi_flux(const oi_fits_view *pView,
+                                    const oi_table_view *pTabView)
+{
+  const oi_flux *pInTab = pTabView->pTable;
+  oi_flux *pOutTab;
+  long i;
+
+  pOutTab = chkmalloc(sizeof(oi_flux));
+  memcpy(pOutTab, pInTab, sizeof(oi_flux));
+  pOutTab->nwave = pTabView->nwave;
+  pOutTab->numrec = pTabView->numrec;
+  pOutTab->record = chkmalloc(pOutTab->numrec * sizeof(oi_flux_record));
+  for (i = 0; i < pTabView->numrec; i++)
+    filter_oi_flux_record(&pInTab->record[pTabView->irec[i]], &pView->filter,
+                          pTabView->useWave, pInTab->nwave, pOutTab->nwave,
+                          &pOutTab->record[i]);
+  return pOutTab;
+}
+
+/**
+ * Materialise each oi_table_view in list and append to output list
+ */
+#define MATERIALISE_VIEW_LIST(pView, viewList, outList, numOut,                \
+                              materialise_func)                                \
+  do                                                                           \
+  {                                                                            \
+    GList *link = (viewList);                                                  \
+    while (link != NULL)                                                       \
+    {                                                                          \
+      (outList) = g_list_prepend((outList),                                    \
+                                 materialise_func((pView), link->data));       \
+      ++(numOut);                                                              \
+      link = link->next;                                                       \
+    }                                                                          \
+    (outList) = g_list_reverse(outList);                                       \
+  } while (0)
+
+/**
+ * Materialise and write each oi_table_view in list, one table at a time
+ */
+#define WRITE_VIEW_LIST(fptr, pView, viewList, type, materialise_func,         \
+                        write_func, free_func, pStatus)                        \
+  do                                                                           \
+  {                                                                            \
+    GList *link = (viewList);                                                  \
+    int extver = 1;                                                            \
+    type *pTab;                                                                \
+    while (link != NULL && !*(pStatus))                                        \
+    {                                                                          \
+      pTab = materialise_func((pView), link->data);                            \
+      write_func(fptr, *pTab, extver++, pStatus);                              \
+      free_func(pTab);                                                         \
+      oi_free(pTab);                                                           \
+      link = link->next;                                                       \
+    }                                                                          \
+  } while (0)
+
+/**
+ * Initialise view struct with no tables selected
+ *
+ * The filter is copied, without its compiled patterns. The caller
+ * must set useWaveHash.
+ */
+static void init_oi_fits_view(oi_fits_view *pView, const oi_fits *pInput,
+                              const oi_filter_spec *pFilter)
+{
+  pView->pInput = pInput;
+  pView->filter = *pFilter;
+  pView->filter.arrname_pttn = NULL;
+  pView->filter.insname_pttn = NULL;
+  pView->filter.corrname_pttn = NULL;
+  pView->numArray = 0;
+  pView->numWavelength = 0;
+  pView->numCorr = 0;
+  pView->numInspol = 0;
+  pView->numVis = 0;
+  pView->numVis2 = 0;
+  pView->numT3 = 0;
+  pView->numFlux = 0;
+  pView->night = 0;
+  pView->arrayList = NULL;
+  pView->wavelengthList = NULL;
+  pView->corrList = NULL;
+  pView->inspolList = NULL;
+  pView->visList = NULL;
+  pView->vis2List = NULL;
+  pView->t3List = NULL;
+  pView->fluxList = NULL;
+  pView->useWaveHash = NULL;
+}
+
+/**
+ * Create filtered view of OIFITS data, without copying any data
+ *
+ * The view refers to the tables in @a pInput, which must not be
+ * modified or freed until free_oi_fits_view() has been called.
+ *
+ * @param pInput   pointer to input file data struct, see oifile.h
+ * @param pFilter  pointer to filter specification
+ * @param pView    pointer to uninitialised view struct
+ */
+void apply_oi_filter_view(const oi_fits *pInput, const oi_filter_spec *pFilter,
+                          oi_fits_view *pView)
+{
+  apply_oi_filter_view_list(pInput, pFilter, 1, pView);
+}
+
+/**
+ * Create several filtered views of OIFITS data in a single pass
+ *
+ * Equivalent to calling apply_oi_filter_view() once for each filter,
+ * but the input records are traversed only once.
+ *
+ * @param pInput   pointer to input file data struct, see oifile.h
+ * @param filters  array of @a nfilter filter specifications
+ * @param nfilter  number of filters
+ * @param views    array of @a nfilter uninitialised view structs
+ */
+void apply_oi_filter_view_list(const oi_fits *pInput,
+                               const oi_filter_spec filters[], int nfilter,
+                               oi_fits_view views[])
+{
+  oi_fits_view *pView;
+  int f;
+  oi_timer start;
+
+  start = oi_profile_start();
+  for (f = 0; f < nfilter; f++)
+  {
+    pView = &views[f];
+    init_oi_fits_view(pView, pInput, &filters[f]);
+    pView->useWaveHash =
+        g_hash_table_new_full(g_str_hash, g_str_equal, g_free, oi_free);
+
+    /* Compile glob-style patterns in our copy of the filter */
+    pView->filter.arrname_pttn = g_pattern_spec_new(pView->filter.arrname);
+    pView->filter.insname_pttn = g_pattern_spec_new(pView->filter.insname);
+    pView->filter.corrname_pttn = g_pattern_spec_new(pView->filter.corrname);
+
+    view_all_oi_wavelength(pView);
+    view_all_oi_inspol(pView);
+  }
+
+  VIEW_LIST_TABLES(pInput, views, nfilter, visList, numVis, oi_vis, "OI_VIS",
+                   ACCEPT_VIS_DATA, accept_vis_record);
+  VIEW_LIST_TABLES(pInput, views, nfilter, vis2List, numVis2, oi_vis2,
+                   "OI_VIS2", ACCEPT_VIS2_DATA, accept_vis2_record);
+  VIEW_LIST_TABLES(pInput, views, nfilter, t3List, numT3, oi_t3, "OI_T3",
+                   ACCEPT_T3_DATA, accept_t3_record);
+  VIEW_LIST_TABLES(pInput, views, nfilter, fluxList, numFlux, oi_flux,
+                   "OI_FLUX", ACCEPT_FLUX_DATA, ACCEPT_FLUX_RECORD);
+
+  for (f = 0; f < nfilter; f++)
+  {
+    pView = &views[f];
+    prune_oi_fits_view(pView);
+
+    /* Free compiled patterns */
+    g_pattern_spec_free(pView->filter.arrname_pttn);
+    g_pattern_spec_free(pView->filter.insname_pttn);
+    g_pattern_spec_free(pView->filter.corrname_pttn);
+    pView->filter.arrname_pttn = NULL;
+    pView->filter.insname_pttn = NULL;
+    pView->filter.corrname_pttn = NULL;
+  }
+  oi_profile_stop(OI_PHASE_FILTER, start);
+}
+
+/** State used by split_oi_fits_view() */
+typedef struct
+{
+  const oi_fits *pInput;
+  const oi_filter_spec *pFilter; /* base filter, with compiled patterns */
+  oi_split_key key;
+  GHashTable *useWaveHash; /* accepted channels, shared by all views */
+  GHashTable *indexHash;   /* key value -> 1 + index of view */
+  GArray *views;           /* array of oi_fits_view */
+  GPtrArray *tabViews;     /* oi_table_view for current table, per view */
+
+} split_state;
+
+/**
+ * Return night containing @a mjd, for OI_SPLIT_NIGHT
+ *
+ * Nights are taken to run from noon to noon UTC, and are numbered by
+ * the MJD at which they start (rounded down).
+ */
+static int night_of_mjd(double mjd) { return (int)floor(mjd - 0.5); }
+
+/**
+ * Create view for new split key value
+ */
+static void add_split_view(split_state *pState, int targetId,
+                           const char *insname, int night)
+{
+  oi_fits_view view;
+  GList *link;
+  oi_wavelength *pWave;
+  const char *useWave;
+  oi_table_view *pTabView;
+  int extver;
+
+  init_oi_fits_view(&view, pState->pInput, pState->pFilter);
+  switch (pState->key)
+  {
+  case OI_SPLIT_TARGET:
+    view.filter.target_id = targetId;
+    break;
+  case OI_SPLIT_INSNAME:
+    /* INSNAME may contain glob metacharacters, so match it exactly */
+    g_strlcpy(view.filter.insname, insname, FLEN_VALUE);
+    view.filter.insname_exact = 1;
+    break;
+  case OI_SPLIT_NIGHT:
+    /* Filter accepts both ends of its MJD range, so exclude noon on
+     * the following day, which starts the next night */
+    view.night = night;
+    if (view.filter.mjd_range[0] < night + 0.5)
+      view.filter.mjd_range[0] = night + 0.5;
+    if (view.filter.mjd_range[1] >= night + 1.5)
+      view.filter.mjd_range[1] = nextafter(night + 1.5, -HUGE_VAL);
+    break;
+  }
+  view.useWaveHash = g_hash_table_ref(pState->useWaveHash);
+
+  /* Share accepted channels computed for base filter */
+  extver = 1;
+  link = pState->pInput->wavelengthList;
+  while (link != NULL)
+  {
+    pWave = (oi_wavelength *)link->data;
+    useWave = g_hash_table_lookup(pState->useWaveHash, pWave->insname);
+    if (useWave != NULL)
+    {
+      pTabView = new_table_view(pWave, extver, pWave, useWave, pWave->nwave, 0);
+      view.wavelengthList = g_list_prepend(view.wavelengthList, pTabView);
+      ++view.numWavelength;
+    }
+    ++extver;
+    link = link->next;
+  }
+  view.wavelengthList = g_list_reverse(view.wavelengthList);
+
+  g_array_append_val(pState->views, view);
+  g_ptr_array_add(pState->tabViews, NULL);
+}
+
+/**
+ * Return index of view for record with given key values
+ *
+ * @param create  if TRUE, create view if it doesn't exist
+ *
+ * @return index of view, or -1 if not found and @a create is FALSE
+ */
+static int get_split_index(split_state *pState, int targetId,
+                           const char *insname, double mjd, gboolean create)
+{
+  gpointer key;
+  int index, night;
+
+  night = night_of_mjd(mjd);
+  switch (pState->key)
+  {
+  case OI_SPLIT_TARGET:
+    key = GINT_TO_POINTER(targetId);
+    break;
+  case OI_SPLIT_INSNAME:
+    key = (gpointer)insname;
+    break;
+  case OI_SPLIT_NIGHT:
+  default:
+    key = GINT_TO_POINTER(night);
+    break;
+  }
+  index = GPOINTER_TO_INT(g_hash_table_lookup(pState->indexHash, key)) - 1;
+  if (index < 0 && create)
+  {
+    index = pState->views->len;
+    add_split_view(pState, targetId, insname, night);
+    g_hash_table_insert(pState->indexHash, key, GINT_TO_POINTER(index + 1));
+  }
+  return index;
+}
+
+/**
+ * Add oi_table_views for current input table to their views
+ */
+#define FINISH_SPLIT_TABLE(pState, listMember, numMember, extname)            \
+  do                                                                           \
+  {                                                                            \
+    guint f;                                                                   \
+    oi_fits_view *pView;                                                       \
+    oi_table_view *pTabView;                                                   \
+    for (f = 0; f < (pState)->tabViews->len; f++)                              \
+    {                                                                          \
+      pTabView = g_ptr_array_index((pState)->tabViews, f);                     \
+      if (pTabView != NULL)                                                    \
+      {                                                                        \
+        pView = &g_array_index((pState)->views, oi_fits_view, f);              \
+        pView->listMember = add_table_view(pView->listMember,                  \
+                                           &pView->numMember, pTabView,        \
+                                           (extname));                         \
+        g_ptr_array_index((pState)->tabViews, f) = NULL;                       \
+      }                                                                        \
+    }                                                                          \
+  } while (0)
+
+/**
+ * Assign accepted records of all data tables of one type to split views
+ */
+#define SPLIT_ALL_TABLES(pState, listMember, numMember, tabType, extname,     \
+                         acceptRecord)                                         \
+  do                                                                           \
+  {                                                                            \
+    const oi_filter_spec *pFilter = (pState)->pFilter;                         \
+    GList *link;                                                               \
+    tabType *pInTab;                                                           \
+    tabType##_record *pRec;                                                    \
+    oi_table_view *pTabView;                                                   \
+    const oi_wavelength *pWave;                                                \
+    const char *useWave;                                                       \
+    long i;                                                                    \
+    int index, extver = 1;                                                     \
+    link = (pState)->pInput->listMember;                                       \
+    while (link != NULL)                                                       \
+    {                                                                          \
+      pInTab = (tabType *)link->data;                                          \
+      useWave = g_hash_table_lookup((pState)->useWaveHash, pInTab->insname);   \
+      if (ACCEPT_INSNAME(pInTab, pFilter) &&                                   \
+          ACCEPT_ARRNAME(pInTab, pFilter) &&                                   \
+          ACCEPT_CORRNAME(pInTab, pFilter) && useWave != NULL)                 \
+      {                                                                        \
+        pWave = oi_fits_lookup_wavelength((pState)->pInput, pInTab->insname);  \
+        for (i = 0; i < pInTab->numrec; i++)                                   \
+        {                                                                      \
+          pRec = &pInTab->record[i];                                           \
+          if (!acceptRecord(pRec, pFilter, pWave, useWave, pInTab->nwave))     \
+            continue;                                                          \
+          index = get_split_index((pState), pRec->target_id, pInTab->insname,  \
+                                  pRec->mjd, TRUE);                            \
+          pTabView = g_ptr_array_index((pState)->tabViews, index);             \
+          if (pTabView == NULL)                                                \
+          {                                                                    \
+            pTabView = new_table_view(pInTab, extver, pWave, useWave,          \
+                                      pInTab->nwave, 0);                       \
+            g_ptr_array_index((pState)->tabViews, index) = pTabView;           \
+          }                                                                    \
+          append_table_view_rec(pTabView, i);                                  \
+        }                                                                      \
+        FINISH_SPLIT_TABLE((pState), listMember, numMember, (extname));        \
+      }                                                                        \
+      ++extver;                                                                \
+      link = link->next;                                                       \
+    }                                                                          \
+  } while (0)
+
+/**
+ * Assign accepted records of all OI_INSPOL tables to existing split views
+ */
+static void split_all_oi_inspol(split_state *pState)
+{
+  const oi_filter_spec *pFilter = pState->pFilter;
+  GList *link;
+  oi_inspol *pInTab;
+  oi_inspol_record *pRec;
+  oi_table_view *pTabView;
+  const char *useWave;
+  long i;
+  int index, extver, night, lastNight;
+
+  extver = 1;
+  link = pState->pInput->inspolList;
+  while (link != NULL)
+  {
+    pInTab = (oi_inspol *)link->data;
+    if (ACCEPT_ARRNAME(pInTab, pFilter))
+    {
+      for (i = 0; i < pInTab->numrec; i++)
+      {
+        pRec = &pInTab->record[i];
+        if (!accept_inspol_record(pRec, pFilter, pState->useWaveHash))
+          continue;
+        /* Record may span several nights */
+        night = night_of_mjd(pRec->mjd_obs);
+        lastNight = night;
+        if (pState->key == OI_SPLIT_NIGHT &&
+            night_of_mjd(pRec->mjd_end) > night)
+          lastNight = night_of_mjd(pRec->mjd_end);
+        for (; night <= lastNight; night++)
+        {
+          index = get_split_index(pState, pRec->target_id, pRec->insname,
+                                  night + 1.0, FALSE);
+          if (index < 0) continue; /* no data for this key */
+          pTabView = g_ptr_array_index(pState->tabViews, index);
+          if (pTabView == NULL)
+          {
+            /* As for filter_oi_inspol(), 1st record sets no. of channels */
+            pTabView =
+                new_table_view(pInTab, extver, NULL, NULL, pInTab->nwave, 0);
+            useWave = g_hash_table_lookup(pState->useWaveHash, pRec->insname);
+            pTabView->nwave = count_use_wave(useWave, pInTab->nwave);
+            g_ptr_array_index(pState->tabViews, index) = pTabView;
+          }
+          append_table_view_rec(pTabView, i);
+        }
+      }
+      FINISH_SPLIT_TABLE(pState, inspolList, numInspol, "OI_INSPOL");
+    }
+    ++extver;
+    link = link->next;
+  }
+}
+
+/** Order split views by TARGET_ID */
+static gint compare_split_target(gconstpointer a, gconstpointer b)
+{
+  const oi_fits_view *pView1 = a, *pView2 = b;
+  return pView1->filter.target_id - pView2->filter.target_id;
+}
+
+/** Order split views by INSNAME */
+static gint compare_split_insname(gconstpointer a, gconstpointer b)
+{
+  const oi_fits_view *pView1 = a, *pView2 = b;
+  return strcmp(pView1->filter.insname, pView2->filter.insname);
+}
+
+/** Order split views by night */
+static gint compare_split_night(gconstpointer a, gconstpointer b)
+{
+  const oi_fits_view *pView1 = a, *pView2 = b;
+  return pView1->night - pView2->night;
+}
+
+/**
+ * Split filtered OIFITS data into several views in a single pass
+ *
+ * One view is created for each distinct value of @a key amongst the
+ * data accepted by @a pFilter. Each view is the same as would be
+ * created by apply_oi_filter_view() with its filter, in which
+ * target_id, insname, or mjd_range is set to select that key value.
+ * For an INSNAME split, the view's insname is matched exactly rather
+ * than as a glob-style pattern.
+ * The wavelength channels and glob-style patterns are evaluated once
+ * for all views. Views are ordered by key value.
+ *
+ * @param pInput   pointer to input file data struct, see oifile.h
+ * @param pFilter  pointer to filter specification applied to all views
+ * @param key      how to split the data
+ * @param pViews   on return, array of views, or NULL if none. Free each
+ *                 view with free_oi_fits_view() then the array with
+ *                 oi_free()
+ *
+ * @return number of views created
+ */
+int split_oi_fits_view(const oi_fits *pInput, const oi_filter_spec *pFilter,
+                       oi_split_key key, oi_fits_view **pViews)
+{
+  split_state state;
+  oi_filter_spec filter;
+  oi_fits_view *pView, tmpView;
+  int nview;
+  guint f;
+  oi_timer start;
+
+  start = oi_profile_start();
+
+  /* Compile glob-style patterns in our copy of the filter */
+  filter = *pFilter;
+  filter.arrname_pttn = g_pattern_spec_new(filter.arrname);
+  filter.insname_pttn = g_pattern_spec_new(filter.insname);
+  filter.corrname_pttn = g_pattern_spec_new(filter.corrname);
+
+  state.pInput = pInput;
+  state.pFilter = &filter;
+  state.key = key;
+  if (key == OI_SPLIT_INSNAME)
+    state.indexHash = g_hash_table_new(g_str_hash, g_str_equal);
+  else
+    state.indexHash = g_hash_table_new(g_direct_hash, g_direct_equal);
+  state.views = g_array_new(FALSE, FALSE, sizeof(oi_fits_view));
+  state.tabViews = g_ptr_array_new();
+
+  /* Find accepted channels once, using temporary view */
+  init_oi_fits_view(&tmpView, pInput, &filter);
+  tmpView.filter.insname_pttn = filter.insname_pttn;
+  tmpView.useWaveHash =
+      g_hash_table_new_full(g_str_hash, g_str_equal, g_free, oi_free);
+  view_all_oi_wavelength(&tmpView);
+  state.useWaveHash = tmpView.useWaveHash;
+  g_list_free_full(tmpView.wavelengthList, free_table_view);
+
+  if (filter.accept_vis)
+    SPLIT_ALL_TABLES(&state, visList, numVis, oi_vis, "OI_VIS",
+                     accept_vis_record);
+  if (filter.accept_vis2)
+    SPLIT_ALL_TABLES(&state, vis2List, numVis2, oi_vis2, "OI_VIS2",
+                     accept_vis2_record);
+  if (filter.accept_t3amp || filter.accept_t3phi)
+    SPLIT_ALL_TABLES(&state, t3List, numT3, oi_t3, "OI_T3", accept_t3_record);
+  if (filter.accept_flux)
+    SPLIT_ALL_TABLES(&state, fluxList, numFlux, oi_flux, "OI_FLUX",
+                     ACCEPT_FLUX_RECORD);
+  split_all_oi_inspol(&state);
+
+  for (f = 0; f < state.views->len; f++)
+  {
+    pView = &g_array_index(state.views, oi_fits_view, f);
+    pView->inspolList = g_list_reverse(pView->inspolList);
+    pView->visList = g_list_reverse(pView->visList);
+    pView->vis2List = g_list_reverse(pView->vis2List);
+    pView->t3List = g_list_reverse(pView->t3List);
+    pView->fluxList = g_list_reverse(pView->fluxList);
+
+    /* Prune using patterns compiled for base filter */
+    pView->filter.arrname_pttn = filter.arrname_pttn;
+    pView->filter.corrname_pttn = filter.corrname_pttn;
+    prune_oi_fits_view(pView);
+    pView->filter.arrname_pttn = NULL;
+    pView->filter.corrname_pttn = NULL;
+  }
+
+  switch (key)
+  {
+  case OI_SPLIT_TARGET:
+    g_array_sort(state.views, compare_split_target);
+    break;
+  case OI_SPLIT_INSNAME:
+    g_array_sort(state.views, compare_split_insname);
+    break;
+  case OI_SPLIT_NIGHT:
+    g_array_sort(state.views, compare_split_night);
+    break;
+  }
+
+  nview = state.views->len;
+  if (nview > 0)
+  {
+    *pViews = chkmalloc(nview * sizeof(oi_fits_view));
+    memcpy(*pViews, state.views->data, nview * sizeof(oi_fits_view));
+  }
+  else
+  {
+    *pViews = NULL;
+  }
+
+  g_array_free(state.views, TRUE);
+  g_ptr_array_free(state.tabViews, TRUE);
+  g_hash_table_destroy(state.indexHash);
+  g_hash_table_unref(state.useWaveHash);
+  g_pattern_spec_free(filter.arrname_pttn);
+  g_pattern_spec_free(filter.insname_pttn);
+  g_pattern_spec_free(filter.corrname_pttn);
+  oi_profile_stop(OI_PHASE_FILTER, start);
+  return nview;
+}
+
+/**
+ * Copy data selected by filtered view into new dataset
+ *
+ * The result is the same as that of apply_oi_filter() with the
+ * filter used to create the view.
+ *
+ * @param pView    pointer to view struct
+ * @param pOutput  pointer to uninitialised output data struct
+ */
+void materialise_oi_fits_view(const oi_fits_view *pView, oi_fits *pOutput)
+{
+  GList *link;
+  oi_array *pArray;
+  oi_wavelength *pWave;
+  oi_corr *pCorr;
+
+  init_oi_fits(pOutput);
+  filter_oi_header(&pView->pInput->header, &pView->filter, &pOutput->header);
+  filter_oi_target(&pView->pInput->targets, &pView->filter,
+                   &pOutput->targets);
+
+  link = pView->arrayList;
+  while (link != NULL)
+  {
+    pArray = dup_oi_array((oi_array *)link->data);
+    pOutput->arrayList = g_list_prepend(pOutput->arrayList, pArray);
+    ++pOutput->numArray;
+    g_hash_table_insert(pOutput->arrayHash, pArray->arrname, pArray);
+    link = link->next;
+  }
+  pOutput->arrayList = g_list_reverse(pOutput->arrayList);
+
+  link = pView->wavelengthList;
+  while (link != NULL)
+  {
+    pWave = materialise_oi_wavelength(pView, link->data);
+    pOutput->wavelengthList = g_list_prepend(pOutput->wavelengthList, pWave);
+    ++pOutput->numWavelength;
+    g_hash_table_insert(pOutput->wavelengthHash, pWave->insname, pWave);
+    link = link->next;
+  }
+  pOutput->wavelengthList = g_list_reverse(pOutput->wavelengthList);
+
+  link = pView->corrList;
+  while (link != NULL)
+  {
+    pCorr = dup_oi_corr((oi_corr *)link->data);
+    pOutput->corrList = g_list_prepend(pOutput->corrList, pCorr);
+    ++pOutput->numCorr;
+    g_hash_table_insert(pOutput->corrHash, pCorr->corrname, pCorr);
+    link = link->next;
+  }
+  pOutput->corrList = g_list_reverse(pOutput->corrList);
+
+  MATERIALISE_VIEW_LIST(pView, pView->inspolList, pOutput->inspolList,
+                        pOutput->numInspol, materialise_oi_inspol);
+  MATERIALISE_VIEW_LIST(pView, pView->visList, pOutput->visList,
+                        pOutput->numVis, materialise_oi_vis);
+  MATERIALISE_VIEW_LIST(pView, pView->vis2List, pOutput->vis2List,
+                        pOutput->numVis2, materialise_oi_vis2);
+  MATERIALISE_VIEW_LIST(pView, pView->t3List, pOutput->t3List, pOutput->numT3,
+                        materialise_oi_t3);
+  MATERIALISE_VIEW_LIST(pView, pView->fluxList, pOutput->fluxList,
+                        pOutput->numFlux, materialise_oi_flux);
+}
+
+/**
+ * Write data selected by filtered view to new FITS file
+ *
+ * Each table is copied just before it is written, then freed, so
+ * only one filtered table is held in memory at a time.
+ *
+ * @param filename  name of file to create
+ * @param pView     pointer to view struct
+ * @param pStatus   pointer to status variable
+ *
+ * @return On error, returns non-zero cfitsio error code (also assigned to
+ *         *pStatus)
+ */
+STATUS write_oi_fits_view(const char *filename, const oi_fits_view *pView,
+                          STATUS *pStatus)
+{
+  const char function[] = "write_oi_fits_view";
+  fitsfile *fptr = NULL;
+  oi_header header;
+  oi_target targets;
+  GList *link;
+  int extver;
+
+  if (*pStatus) return *pStatus; /* error flag set - do nothing */
+
+  /* Open new FITS file */
+  fits_create_file(&fptr, filename, pStatus);
+  if (*pStatus) goto except;
+
+  /* Write primary header keywords */
+  filter_oi_header(&pView->pInput->header, &pView->filter, &header);
+  write_oi_header(fptr, header, pStatus);
+
+  /* Write OI_TARGET table */
+  targets.ntarget = 0;
+  targets.targ = NULL;
+  filter_oi_target(&pView->pInput->targets, &pView->filter, &targets);
+  write_oi_target(fptr, targets, pStatus);
+  free_oi_target(&targets);
+
+  /* Write all OI_ARRAY tables */
+  extver = 1;
+  link = pView->arrayList;
+  while (link != NULL)
+  {
+    write_oi_array(fptr, *((oi_array *)link->data), extver++, pStatus);
+    link = link->next;
+  }
+
+  /* Write all OI_WAVELENGTH tables */
+  WRITE_VIEW_LIST(fptr, pView, pView->wavelengthList, oi_wavelength,
+                  materialise_oi_wavelength, write_oi_wavelength,
+                  free_oi_wavelength, pStatus);
+
+  /* Write all OI_CORR tables */
+  extver = 1;
+  link = pView->corrList;
+  while (link != NULL)
+  {
+    write_oi_corr(fptr, *((oi_corr *)link->data), extver++, pStatus);
+    link = link->next;
+  }
+
+  /* Write all OI_INSPOL and data tables */
+  WRITE_VIEW_LIST(fptr, pView, pView->inspolList, oi_inspol,
+                  materialise_oi_inspol, write_oi_inspol, free_oi_inspol,
+                  pStatus);
+  WRITE_VIEW_LIST(fptr, pView, pView->visList, oi_vis, materialise_oi_vis,
+                  write_oi_vis, free_oi_vis, pStatus);
+  WRITE_VIEW_LIST(fptr, pView, pView->vis2List, oi_vis2, materialise_oi_vis2,
+                  write_oi_vis2, free_oi_vis2, pStatus);
+  WRITE_VIEW_LIST(fptr, pView, pView->t3List, oi_t3, materialise_oi_t3,
+                  write_oi_t3, free_oi_t3, pStatus);
+  WRITE_VIEW_LIST(fptr, pView, pView->fluxList, oi_flux, materialise_oi_flux,
+                  write_oi_flux, free_oi_flux, pStatus);
+
+except:
+  if (fptr) fits_close_file(fptr, pStatus);
+  if (*pStatus) oi_report_error(function, *pStatus);
+  return *pStatus;
+}
+
+/**
+ * Free storage allocated by apply_oi_filter_view()
+ *
+ * The input dataset is not affected.
+ *
+ * @param pView  pointer to view struct
+ */
+void free_oi_fits_view(oi_fits_view *pView)
+{
+  g_list_free(pView->arrayList);
+  g_list_free_full(pView->wavelengthList, free_table_view);
+  g_list_free(pView->corrList);
+  g_list_free_full(pView->inspolList, free_table_view);
+  g_list_free_full(pView->visList, free_table_view);
+  g_list_free_full(pView->vis2List, free_table_view);
+  g_list_free_full(pView->t3List, free_table_view);
+  g_list_free_full(pView->fluxList, free_table_view);
+  g_hash_table_unref(pView->useWaveHash);
+  pView->arrayList = NULL;
+  pView->wavelengthList = NULL;
+  pView->corrList = NULL;
+  pView->inspolList = NULL;
+  pView->visList = NULL;
+  pView->vis2List = NULL;
+  pView->t3List = NULL;
+  pView->fluxList = NULL;
+  pView->useWaveHash = NULL;
 }
@@ -57,6 +57,24 @@
  * Functions to return and to display string representations of a
  * filter are also provided: format_oi_filter() and print_oi_filter()
  *
+ * Where many different filters are to be applied to the same input
+ * data, apply_oi_filter_view() may be used instead of
+ * apply_oi_filter(). This creates an oi_fits_view, which records the
+ * accepted records and wavelength channels of each input table
+ * without copying any data. A view may be iterated over (see
+ * oiiter.h), written to a file with write_oi_fits_view(), or
+ * converted to a dataset equivalent to the output of
+ * apply_oi_filter() using materialise_oi_fits_view(). The input
+ * dataset must not be modified or freed while views of it exist.
+ * To make many views in a single pass through the input data, use
+ * apply_oi_filter_view_list() with a list of filters, or
+ * split_oi_fits_view() to make one view per target, instrument or
+ * night.
+ *
+ * Where the unfiltered data are no longer needed, use
+ * apply_oi_filter_inplace() to filter a dataset without making a
+ * copy of it.
+ *
  * Applications should not normally need to call the lower-level
  * functions that filter subsets of the OIFITS tables (such as
  * filter_oi_target() and filter_all_oi_vis2())
@@ -94,8 +112,66 @@ typedef struct
   GPatternSpec *insname_pttn; /**< Compiled pattern to match INSNAME against */
   GPatternSpec
       *corrname_pttn; /**< Compiled pattern to match CORRNAME against */
+  int insname_exact;  /**< If non-zero, match insname exactly, not as pattern,
+                           set by split_oi_fits_view() */
 } oi_filter_spec;
 
+/** Records and wavelength channels of an input table accepted by a filter */
+typedef struct
+{
+  const void *pTable;         /**< Input oi_wavelength, oi_inspol, oi_vis,
+                                   oi_vis2, oi_t3 or oi_flux */
+  int extver;                 /**< Position of input table in its list,
+                                   starting from 1 */
+  const oi_wavelength *pWave; /**< Input oi_wavelength referenced by table,
+                                   or NULL */
+  const char *useWave;        /**< Boolean array giving accepted wavelength
+                                   channels, or NULL for OI_INSPOL */
+  int nwaveIn;                /**< Number of channels in input table */
+  int nwave;                  /**< Number of accepted channels */
+  long numrec;                /**< Number of accepted records */
+  long *irec;                 /**< Indices of accepted records in input
+                                   table, or NULL for OI_WAVELENGTH */
+} oi_table_view;
+
+/** Filtered view of an OIFITS dataset, referencing the input data */
+typedef struct
+{
+  const oi_fits *pInput; /**< Dataset that view refers to */
+  oi_filter_spec filter; /**< Filter used to create view */
+  int numArray;          /**< Length of arrayList */
+  int numWavelength;     /**< Length of wavelengthList */
+  int numCorr;           /**< Length of corrList */
+  int numInspol;         /**< Length of inspolList */
+  int numVis;            /**< Length of visList */
+  int numVis2;           /**< Length of vis2List */
+  int numT3;             /**< Length of t3List */
+  int numFlux;           /**< Length of fluxList */
+  GList *arrayList;      /**< Linked list of accepted input oi_array structs */
+  GList *wavelengthList; /**< Linked list of oi_table_view for OI_WAVELENGTH */
+  GList *corrList;       /**< Linked list of accepted input oi_corr structs */
+  GList *inspolList;     /**< Linked list of oi_table_view for OI_INSPOL */
+  GList *visList;        /**< Linked list of oi_table_view for OI_VIS */
+  GList *vis2List;       /**< Linked list of oi_table_view for OI_VIS2 */
+  GList *t3List;         /**< Linked list of oi_table_view for OI_T3 */
+  GList *fluxList;       /**< Linked list of oi_table_view for OI_FLUX */
+  int night;             /**< Night selected by split_oi_fits_view() with
+                              OI_SPLIT_NIGHT, numbered by the MJD at
+                              which it starts, otherwise 0 */
+
+  /** @privatesection */
+  GHashTable *useWaveHash; /**< Accepted channels, indexed by INSNAME */
+} oi_fits_view;
+
+/** Key used to split a dataset into several filtered views */
+typedef enum
+{
+  OI_SPLIT_TARGET,  /**< One view per TARGET_ID */
+  OI_SPLIT_INSNAME, /**< One view per INSNAME */
+  OI_SPLIT_NIGHT,   /**< One view per night, from noon to noon UTC */
+
+} oi_split_key;
+
 /*
  * Function prototypes
  */
@@ -103,9 +179,20 @@ void init_oi_filter(oi_filter_spec *);
 const char *format_oi_filter(const oi_filter_spec *);
 void print_oi_filter(const oi_filter_spec *);
 void apply_oi_filter(const oi_fits *, oi_filter_spec *, oi_fits *);
+void apply_oi_filter_inplace(oi_fits *, oi_filter_spec *);
+void apply_oi_filter_view(const oi_fits *, const oi_filter_spec *,
+                          oi_fits_view *);
+void apply_oi_filter_view_list(const oi_fits *, const oi_filter_spec[], int,
+                               oi_fits_view[]);
+int split_oi_fits_view(const oi_fits *, const oi_filter_spec *, oi_split_key,
+                       oi_fits_view **);
+void materialise_oi_fits_view(const oi_fits_view *, oi_fits *);
+STATUS write_oi_fits_view(const char *, const oi_fits_view *, STATUS *);
+void free_oi_fits_view(oi_fits_view *);
 GOptionGroup *get_oi_filter_option_group(void);
 oi_filter_spec *get_user_oi_filter(void);
 void apply_user_oi_filter(const oi_fits *, oi_fits *);
+void apply_user_oi_filter_inplace(oi_fits *);
 void filter_oi_header(const oi_header *, const oi_filter_spec *, oi_header *);
 void filter_oi_target(const oi_target *, const oi_filter_spec *, oi_target *);
 void filter_all_oi_array(const oi_fits *, const oi_filter_spec *, oi_fits *);
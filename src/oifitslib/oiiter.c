@@ -24,11 +24,88 @@
  */
 
 #include "oiiter.h"
+#include "chkmalloc.h"
 
 #include <math.h>
+#include <stdint.h> /* uintptr_t */
+#include <string.h>
 
 #define RAD2DEG (180.0 / 3.14159)
 
+/** Alignment of arrays in oi_flat_data /bytes */
+#define FLAT_ALIGN 64
+
+/** Round @a size up to a multiple of FLAT_ALIGN */
+#define ALIGN_SIZE(size) (((size) + FLAT_ALIGN - 1) / FLAT_ALIGN * FLAT_ALIGN)
+
+/** Current oi_table_view, for iterator over filtered view */
+#define ITER_TABLE_VIEW(pIter) ((const oi_table_view *)(pIter)->link->data)
+
+/** Current table, for iterator over dataset or filtered view */
+#define ITER_TABLE(pIter, tabType)                                             \
+  ((tabType *)((pIter)->pView != NULL ? ITER_TABLE_VIEW(pIter)->pTable         \
+                                      : (pIter)->link->data))
+
+/** States of iterator mask */
+enum
+{
+  MASK_RECORDING, /**< Accepted data are being recorded */
+  MASK_COMPLETE,  /**< All accepted data have been recorded */
+  MASK_STALE      /**< Recorded data must be discarded */
+};
+
+/** Accepted datum recorded in iterator mask */
+typedef struct
+{
+  int itable; /**< Index into maskTables */
+  int iwave;  /**< Channel index */
+  long irec;  /**< Record index */
+
+} mask_point;
+
+/** Table referenced by iterator mask */
+typedef struct
+{
+  GList *link;          /**< Link to table in table list */
+  int extver;           /**< EXTVER of table */
+  oi_wavelength *pWave; /**< OI_WAVELENGTH referenced by table */
+
+} mask_table;
+
+/** Dimensions of table, used to detect changes to data */
+typedef struct
+{
+  const void *pTable;
+  long numrec;
+  int nwave;
+
+} table_fingerprint;
+
+/** Function returning dimensions of a data table */
+typedef void (*table_size_func)(const void *, long *, int *);
+
+/**
+ * Operations specific to one type of data table. The iterator engine
+ * uses these to visit data of any type in the same way.
+ */
+struct _oi_iter_type
+{
+  /** Does filter accept any data of this type? */
+  bool (*accept_data)(const oi_filter_spec *);
+  /** Does table pass filter on ARRNAME, INSNAME and CORRNAME? */
+  bool (*accept_table)(const void *, const oi_filter_spec *);
+  /** Get INSNAME of table, or NULL if INSNAME is given by each record */
+  const char *(*get_insname)(const void *);
+  /** Get number of records and channels of table */
+  table_size_func size;
+  /** Does current record pass filter? */
+  bool (*accept_record)(_oi_iter *);
+  /** Does current datum pass filter? */
+  bool (*accept_channel)(_oi_iter *);
+};
+
+typedef struct _oi_iter_type iter_type;
+
 /*
  * Private functions
  */
@@ -40,9 +117,11 @@ static bool oi_vis_iter_accept_channel(oi_vis_iter *pIter)
 {
   double uvrad;
   float snrAmp, snrPhi;
-  oi_vis *pTable = (oi_vis *)pIter->link->data;
+  oi_vis *pTable = ITER_TABLE(pIter, oi_vis);
   oi_vis_record *pRec = &pTable->record[pIter->irec];
 
+  if (pIter->useWave != NULL && !pIter->useWave[pIter->iwave]) return false;
+
   if (pIter->pWave->eff_wave[pIter->iwave] < pIter->filter.wave_range[0] ||
       pIter->pWave->eff_wave[pIter->iwave] > pIter->filter.wave_range[1])
     return false;
@@ -71,9 +150,11 @@ static bool oi_vis2_iter_accept_channel(oi_vis2_iter *pIter)
 {
   double uvrad;
   float snr;
-  oi_vis2 *pTable = (oi_vis2 *)pIter->link->data;
+  oi_vis2 *pTable = ITER_TABLE(pIter, oi_vis2);
   oi_vis2_record *pRec = &pTable->record[pIter->irec];
 
+  if (pIter->useWave != NULL && !pIter->useWave[pIter->iwave]) return false;
+
   if (pIter->pWave->eff_wave[pIter->iwave] < pIter->filter.wave_range[0] ||
       pIter->pWave->eff_wave[pIter->iwave] > pIter->filter.wave_range[1])
     return false;
@@ -97,9 +178,11 @@ static bool oi_t3_iter_accept_channel(oi_t3_iter *pIter)
 {
   double u1, v1, u2, v2, abRad, bcRad, acRad;
   float snrAmp, snrPhi;
-  oi_t3 *pTable = (oi_t3 *)pIter->link->data;
+  oi_t3 *pTable = ITER_TABLE(pIter, oi_t3);
   oi_t3_record *pRec = &pTable->record[pIter->irec];
 
+  if (pIter->useWave != NULL && !pIter->useWave[pIter->iwave]) return false;
+
   if (pIter->pWave->eff_wave[pIter->iwave] < pIter->filter.wave_range[0] ||
       pIter->pWave->eff_wave[pIter->iwave] > pIter->filter.wave_range[1])
     return false;
@@ -137,15 +220,53 @@ static bool oi_t3_iter_accept_channel(oi_t3_iter *pIter)
   return true;
 }
 
+/**
+ * Does current OI_FLUX datum pass filter?
+ */
+static bool oi_flux_iter_accept_channel(oi_flux_iter *pIter)
+{
+  float snr;
+  oi_flux *pTable = ITER_TABLE(pIter, oi_flux);
+  oi_flux_record *pRec = &pTable->record[pIter->irec];
+
+  if (pIter->useWave != NULL && !pIter->useWave[pIter->iwave]) return false;
+
+  if (pIter->pWave->eff_wave[pIter->iwave] < pIter->filter.wave_range[0] ||
+      pIter->pWave->eff_wave[pIter->iwave] > pIter->filter.wave_range[1])
+    return false;
+  snr = pRec->fluxdata[pIter->iwave] / pRec->fluxerr[pIter->iwave];
+  if (snr < pIter->filter.snr_range[0] || snr > pIter->filter.snr_range[1])
+    return false;
+  if (pRec->flag[pIter->iwave] && !pIter->filter.accept_flagged) return false;
+
+  return true;
+}
+
+/**
+ * Does current OI_INSPOL datum pass filter?
+ */
+static bool oi_inspol_iter_accept_channel(oi_inspol_iter *pIter)
+{
+  if (pIter->useWave != NULL && !pIter->useWave[pIter->iwave]) return false;
+
+  if (pIter->pWave->eff_wave[pIter->iwave] < pIter->filter.wave_range[0] ||
+      pIter->pWave->eff_wave[pIter->iwave] > pIter->filter.wave_range[1])
+    return false;
+
+  return true;
+}
+
 /**
  * Does current OI_VIS record pass filter?
  */
 static bool oi_vis_iter_accept_record(oi_vis_iter *pIter)
 {
   double bas;
-  oi_vis *pTable = (oi_vis *)pIter->link->data;
+  oi_vis *pTable = ITER_TABLE(pIter, oi_vis);
   oi_vis_record *pRec = &pTable->record[pIter->irec];
 
+  if (pIter->pView != NULL) return true; /* view has selected records */
+
   if (pIter->filter.target_id >= 0 &&
       pRec->target_id != pIter->filter.target_id)
     return false;
@@ -165,9 +286,11 @@ static bool oi_vis_iter_accept_record(oi_vis_iter *pIter)
 static bool oi_vis2_iter_accept_record(oi_vis2_iter *pIter)
 {
   double bas;
-  oi_vis2 *pTable = (oi_vis2 *)pIter->link->data;
+  oi_vis2 *pTable = ITER_TABLE(pIter, oi_vis2);
   oi_vis2_record *pRec = &pTable->record[pIter->irec];
 
+  if (pIter->pView != NULL) return true; /* view has selected records */
+
   if (pIter->filter.target_id >= 0 &&
       pRec->target_id != pIter->filter.target_id)
     return false;
@@ -187,9 +310,11 @@ static bool oi_vis2_iter_accept_record(oi_vis2_iter *pIter)
 static bool oi_t3_iter_accept_record(oi_t3_iter *pIter)
 {
   double u1, v1, u2, v2, bas;
-  oi_t3 *pTable = (oi_t3 *)pIter->link->data;
+  oi_t3 *pTable = ITER_TABLE(pIter, oi_t3);
   oi_t3_record *pRec = &pTable->record[pIter->irec];
 
+  if (pIter->pView != NULL) return true; /* view has selected records */
+
   if (pIter->filter.target_id >= 0 &&
       pRec->target_id != pIter->filter.target_id)
     return false;
@@ -213,223 +338,331 @@ static bool oi_t3_iter_accept_record(oi_t3_iter *pIter)
   return true;
 }
 
+/**
+ * Does current OI_FLUX record pass filter?
+ */
+static bool oi_flux_iter_accept_record(oi_flux_iter *pIter)
+{
+  oi_flux *pTable = ITER_TABLE(pIter, oi_flux);
+  oi_flux_record *pRec = &pTable->record[pIter->irec];
+
+  if (pIter->pView != NULL) return true; /* view has selected records */
+
+  if (pIter->filter.target_id >= 0 &&
+      pRec->target_id != pIter->filter.target_id)
+    return false;
+  if ((pRec->mjd < pIter->filter.mjd_range[0]) ||
+      (pRec->mjd > pIter->filter.mjd_range[1]))
+    return false;
+
+  return true;
+}
+
+/**
+ * Does current OI_INSPOL record pass filter?
+ *
+ * Also looks up the OI_WAVELENGTH table (and for a view, the accepted
+ * channels) for the INSNAME of the record.
+ */
+static bool oi_inspol_iter_accept_record(oi_inspol_iter *pIter)
+{
+  oi_inspol *pTable = ITER_TABLE(pIter, oi_inspol);
+  oi_inspol_record *pRec = &pTable->record[pIter->irec];
+
+  pIter->pWave = g_hash_table_lookup(pIter->insnameWave, pRec->insname);
+  if (pIter->pView != NULL)
+  {
+    /* view has selected records */
+    pIter->useWave =
+        g_hash_table_lookup(pIter->pView->useWaveHash, pRec->insname);
+    return (pIter->pWave != NULL && pIter->useWave != NULL);
+  }
+
+  if (pIter->pWave == NULL) return false; /* INSNAME filtered out */
+  if (pIter->filter.target_id >= 0 &&
+      pRec->target_id != pIter->filter.target_id)
+    return false;
+  if ((pRec->mjd_end < pIter->filter.mjd_range[0]) ||
+      (pRec->mjd_obs > pIter->filter.mjd_range[1]))
+    return false; /* MJD ranges don't overlap */
+
+  return true;
+}
+
 #define ACCEPT_ARRNAME(pTable, pFilter)                                        \
   ((pFilter)->arrname_pttn == NULL ||                                          \
    g_pattern_match_string((pFilter)->arrname_pttn, (pTable)->arrname))
 
 #define ACCEPT_INSNAME(pTable, pFilter)                                        \
-  ((pFilter)->insname_pttn == NULL ||                                          \
-   g_pattern_match_string((pFilter)->insname_pttn, (pTable)->insname))
+  ((pFilter)->insname_exact                                                    \
+       ? strcmp((pFilter)->insname, (pTable)->insname) == 0                    \
+       : ((pFilter)->insname_pttn == NULL ||                                   \
+          g_pattern_match_string((pFilter)->insname_pttn, (pTable)->insname)))
 
 #define ACCEPT_CORRNAME(pTable, pFilter)                                       \
   ((pFilter)->corrname_pttn == NULL ||                                         \
    g_pattern_match_string((pFilter)->corrname_pttn, (pTable)->corrname))
 
 /**
- * Does current OI_VIS table pass filter?
+ * Define functions describing data tables of type @a tabType, which
+ * have ARRNAME, INSNAME and CORRNAME keywords
  */
-static bool oi_vis_iter_accept_table(oi_vis_iter *pIter)
-{
-  oi_vis *pTable = (oi_vis *)pIter->link->data;
-  return (ACCEPT_ARRNAME(pTable, &pIter->filter) &&
-          ACCEPT_INSNAME(pTable, &pIter->filter) &&
-          ACCEPT_CORRNAME(pTable, &pIter->filter));
-}
+#define DEFINE_TABLE_FUNCS(tabType)                                            \
+  static void tabType##_table_size(const void *pTable, long *pNumrec,          \
+                                   int *pNwave)                                \
+  {                                                                            \
+    *pNumrec = ((const tabType *)pTable)->numrec;                              \
+    *pNwave = ((const tabType *)pTable)->nwave;                                \
+  }                                                                            \
+  static bool tabType##_accept_table(const void *pTable,                       \
+                                     const oi_filter_spec *pFilter)            \
+  {                                                                            \
+    const tabType *pTab = pTable;                                              \
+    return (ACCEPT_ARRNAME(pTab, pFilter) && ACCEPT_INSNAME(pTab, pFilter) &&  \
+            ACCEPT_CORRNAME(pTab, pFilter));                                   \
+  }                                                                            \
+  static const char *tabType##_get_insname(const void *pTable)                 \
+  {                                                                            \
+    return ((const tabType *)pTable)->insname;                                 \
+  }
+
+DEFINE_TABLE_FUNCS(oi_vis)
+DEFINE_TABLE_FUNCS(oi_vis2)
+DEFINE_TABLE_FUNCS(oi_t3)
+DEFINE_TABLE_FUNCS(oi_flux)
 
 /**
- * Does current OI_VIS2 table pass filter?
+ * Get number of records and channels of OI_INSPOL table
  */
-static bool oi_vis2_iter_accept_table(oi_vis2_iter *pIter)
+static void oi_inspol_table_size(const void *pTable, long *pNumrec,
+                                 int *pNwave)
 {
-  oi_vis2 *pTable = (oi_vis2 *)pIter->link->data;
-  return (ACCEPT_ARRNAME(pTable, &pIter->filter) &&
-          ACCEPT_INSNAME(pTable, &pIter->filter) &&
-          ACCEPT_CORRNAME(pTable, &pIter->filter));
+  *pNumrec = ((const oi_inspol *)pTable)->numrec;
+  *pNwave = ((const oi_inspol *)pTable)->nwave;
 }
 
 /**
- * Does current OI_T3 table pass filter?
+ * Does OI_INSPOL table pass filter on ARRNAME?
  */
-static bool oi_t3_iter_accept_table(oi_t3_iter *pIter)
+static bool oi_inspol_accept_table(const void *pTable,
+                                   const oi_filter_spec *pFilter)
 {
-  oi_t3 *pTable = (oi_t3 *)pIter->link->data;
-  return (ACCEPT_ARRNAME(pTable, &pIter->filter) &&
-          ACCEPT_INSNAME(pTable, &pIter->filter) &&
-          ACCEPT_CORRNAME(pTable, &pIter->filter));
+  return ACCEPT_ARRNAME((const oi_inspol *)pTable, pFilter);
 }
 
-/*
- * Public functions
- */
+static bool oi_vis_accept_data(const oi_filter_spec *pFilter)
+{
+  return pFilter->accept_vis;
+}
+
+static bool oi_vis2_accept_data(const oi_filter_spec *pFilter)
+{
+  return pFilter->accept_vis2;
+}
+
+static bool oi_t3_accept_data(const oi_filter_spec *pFilter)
+{
+  return (pFilter->accept_t3amp || pFilter->accept_t3phi);
+}
+
+static bool oi_flux_accept_data(const oi_filter_spec *pFilter)
+{
+  return pFilter->accept_flux;
+}
+
+static bool oi_inspol_accept_data(const oi_filter_spec *pFilter)
+{
+  return true; /* polarisation data are always accepted */
+}
+
+static const iter_type visType = {
+    oi_vis_accept_data,        oi_vis_accept_table,
+    oi_vis_get_insname,        oi_vis_table_size,
+    oi_vis_iter_accept_record, oi_vis_iter_accept_channel};
+
+static const iter_type vis2Type = {
+    oi_vis2_accept_data,        oi_vis2_accept_table,
+    oi_vis2_get_insname,        oi_vis2_table_size,
+    oi_vis2_iter_accept_record, oi_vis2_iter_accept_channel};
+
+static const iter_type t3Type = {
+    oi_t3_accept_data,        oi_t3_accept_table,
+    oi_t3_get_insname,        oi_t3_table_size,
+    oi_t3_iter_accept_record, oi_t3_iter_accept_channel};
+
+static const iter_type fluxType = {
+    oi_flux_accept_data,        oi_flux_accept_table,
+    oi_flux_get_insname,        oi_flux_table_size,
+    oi_flux_iter_accept_record, oi_flux_iter_accept_channel};
+
+static const iter_type inspolType = {
+    oi_inspol_accept_data,        oi_inspol_accept_table,
+    NULL,                         oi_inspol_table_size,
+    oi_inspol_iter_accept_record, oi_inspol_iter_accept_channel};
 
 /**
- * Initialise complex visibility iterator.
- *
- * @param pIter    Iterator struct to initialise.
- * @param pData    OIFITS dataset to iterate over.
- * @param pFilter  Filter to apply, or NULL.
+ * Return new hash table of OI_WAVELENGTH tables with INSNAMEs that
+ * pass filter, for data tables that give INSNAME for each record
  */
-void oi_vis_iter_init(oi_vis_iter *pIter, const oi_fits *pData,
-                      const oi_filter_spec *pFilter)
+static GHashTable *new_insname_wave(const oi_fits *pData,
+                                    const oi_filter_spec *pFilter)
 {
-  g_assert(pIter != NULL);
-  g_assert(pData != NULL);
-
-  pIter->pData = pData;
-  if (pFilter != NULL)
-    pIter->filter = *pFilter;
-  else
-    init_oi_filter(&pIter->filter);
-  pIter->link = pData->visList;
-  if (pIter->link != NULL)
+  GHashTable *insnameWave;
+  GPatternSpec *pttn;
+  GList *link;
+  oi_wavelength *pWave;
+
+  insnameWave = g_hash_table_new(g_str_hash, g_str_equal);
+  pttn = g_pattern_spec_new(pFilter->insname);
+  for (link = pData->wavelengthList; link != NULL; link = link->next)
   {
-    oi_vis *pTable = (oi_vis *)pIter->link->data;
-    pIter->pWave = oi_fits_lookup_wavelength(pIter->pData, pTable->insname);
-  }
-  else
-  {
-    pIter->pWave = NULL;
+    pWave = (oi_wavelength *)link->data;
+    if (pFilter->insname_exact ? strcmp(pFilter->insname, pWave->insname) == 0
+                               : g_pattern_match_string(pttn, pWave->insname))
+      g_hash_table_insert(insnameWave, pWave->insname, pWave);
   }
+  g_pattern_spec_free(pttn);
+  return insnameWave;
+}
+
+/**
+ * Set fields common to iterators over dataset and filtered view
+ */
+static void iter_init_common(_oi_iter *pIter, const iter_type *pType,
+                             GList *tableList)
+{
+  pIter->pType = pType;
+  pIter->link = pType->accept_data(&pIter->filter) ? tableList : NULL;
+  pIter->insnameWave = NULL;
+  if (pType->get_insname == NULL && pIter->link != NULL)
+    pIter->insnameWave = new_insname_wave(pIter->pData, &pIter->filter);
+  pIter->endLink = NULL;
+  pIter->endView = 0;
+  pIter->mask = NULL;
+  pIter->maskTables = NULL;
+  pIter->fingerprint = NULL;
+  pIter->replaying = false;
+  pIter->pWave = NULL;
+  pIter->useWave = NULL;
+  pIter->numrec = 0;
+  pIter->nwave = 0;
   pIter->extver = 1;
   pIter->irec = 0;
+  pIter->iview = 0;
   pIter->iwave = -1;
 }
 
 /**
- * Initialise squared visibility iterator.
- *
- * @param pIter    Iterator struct to initialise.
- * @param pData    OIFITS dataset to iterate over.
- * @param pFilter  Filter to apply, or NULL.
+ * Skip data tables rejected by filter, starting from current table
  */
-void oi_vis2_iter_init(oi_vis2_iter *pIter, const oi_fits *pData,
-                       const oi_filter_spec *pFilter)
+static void iter_skip_tables(_oi_iter *pIter)
 {
-  g_assert(pIter != NULL);
-  g_assert(pData != NULL);
+  while (pIter->link != NULL && !pIter->acceptTable[pIter->extver - 1])
+  {
+    pIter->link = pIter->link->next;
+    ++pIter->extver;
+  }
+}
 
-  pIter->pData = pData;
-  if (pFilter != NULL)
-    pIter->filter = *pFilter;
-  else
-    init_oi_filter(&pIter->filter);
-  pIter->link = pData->vis2List;
-  if (pIter->link != NULL)
+/**
+ * Advance iterator to first selected record of current table
+ */
+static void iter_start_table(_oi_iter *pIter)
+{
+  const oi_table_view *pTabView;
+
+  if (pIter->pView != NULL)
   {
-    oi_vis2 *pTable = (oi_vis2 *)pIter->link->data;
-    pIter->pWave = oi_fits_lookup_wavelength(pIter->pData, pTable->insname);
+    pTabView = ITER_TABLE_VIEW(pIter);
+    pIter->pWave = (oi_wavelength *)pTabView->pWave;
+    pIter->useWave = pTabView->useWave;
+    pIter->numrec = pTabView->numrec;
+    pIter->nwave = pTabView->nwaveIn;
+    pIter->extver = pTabView->extver;
+    pIter->irec = pTabView->irec[0];
   }
   else
   {
-    pIter->pWave = NULL;
+    pIter->pWave = pIter->tableWave[pIter->extver - 1];
+    pIter->useWave = NULL;
+    pIter->pType->size(pIter->link->data, &pIter->numrec, &pIter->nwave);
+    pIter->irec = 0;
+  }
+  pIter->iview = 0;
+  pIter->iwave = 0;
+}
+
+/**
+ * Move iterator to start of record @a iview of table @a link
+ */
+static void iter_set_position(_oi_iter *pIter, GList *link, int extver,
+                              long iview)
+{
+  pIter->link = link;
+  pIter->extver = extver;
+  if (link != NULL)
+  {
+    iter_start_table(pIter);
+    pIter->iview = iview;
+    if (pIter->pView != NULL)
+      pIter->irec = ITER_TABLE_VIEW(pIter)->irec[iview];
+    else
+      pIter->irec = iview;
   }
-  pIter->extver = 1;
-  pIter->irec = 0;
   pIter->iwave = -1;
 }
 
 /**
- * Initialise triple product iterator.
- *
- * @param pIter    Iterator struct to initialise.
- * @param pData    OIFITS dataset to iterate over.
- * @param pFilter  Filter to apply, or NULL.
+ * Initialise iterator over data tables in dataset, evaluating the
+ * table selection criteria of the filter once
  */
-void oi_t3_iter_init(oi_t3_iter *pIter, const oi_fits *pData,
-                     const oi_filter_spec *pFilter)
+static void iter_init(_oi_iter *pIter, const iter_type *pType,
+                      const oi_fits *pData, const oi_filter_spec *pFilter,
+                      GList *tableList, int numTables)
 {
+  GList *link;
+  int i;
+
   g_assert(pIter != NULL);
   g_assert(pData != NULL);
 
   pIter->pData = pData;
+  pIter->pView = NULL;
   if (pFilter != NULL)
     pIter->filter = *pFilter;
   else
     init_oi_filter(&pIter->filter);
-  pIter->link = pData->t3List;
-  if (pIter->link != NULL)
+  iter_init_common(pIter, pType, tableList);
+  pIter->numTables = numTables;
+  if (numTables > 0)
   {
-    oi_t3 *pTable = (oi_t3 *)pIter->link->data;
-    pIter->pWave = oi_fits_lookup_wavelength(pIter->pData, pTable->insname);
+    pIter->acceptTable = chkmalloc(numTables * sizeof(pIter->acceptTable[0]));
+    pIter->tableWave = chkmalloc(numTables * sizeof(pIter->tableWave[0]));
   }
   else
   {
-    pIter->pWave = NULL;
+    pIter->acceptTable = NULL;
+    pIter->tableWave = NULL;
   }
-  pIter->extver = 1;
-  pIter->irec = 0;
-  pIter->iwave = -1;
-}
-
-#define NEXT_CHANNEL(pIter, tabType)                                           \
-  ((pIter)->link != NULL &&                                                    \
-   (pIter)->iwave < ((tabType *)((pIter)->link->data))->nwave - 1 &&           \
-   (++(pIter)->iwave, true))
-
-#define NEXT_RECORD(pIter, tabType)                                            \
-  ((pIter)->link != NULL &&                                                    \
-   (pIter)->irec < ((tabType *)((pIter)->link->data))->numrec - 1 &&           \
-   (++(pIter)->irec, (pIter)->iwave = 0, true))
-
-#define NEXT_TABLE(pIter, tabType)                                             \
-  ((pIter)->link != NULL && (pIter)->link->next != NULL &&                     \
-   ((pIter)->link = (pIter)->link->next,                                       \
-    ((pIter)->pWave = oi_fits_lookup_wavelength(                               \
-         (pIter)->pData, ((tabType *)((pIter)->link->data))->insname)),        \
-    ++(pIter)->extver, (pIter)->irec = 0, (pIter)->iwave = 0, true))
-
-/**
- * Get next complex visibility datum that passes filter.
- *
- * @param pIter    Initialised iterator struct.
- * @param pExtver  Return location for EXTVER, or NULL.
- * @param ppTable  Return location for pointer to table struct, or NULL.
- * @param pIrec    Return location for record index, or NULL.
- * @param ppRec    Return location for pointer to record struct, or NULL.
- * @param pIwave   Return location for channel index, or NULL.
- * @return bool  true if succesful, false if end of data reached.
- */
-bool oi_vis_iter_next(oi_vis_iter *pIter, int *const pExtver, oi_vis **ppTable,
-                      long *const pIrec, oi_vis_record **ppRec,
-                      int *const pIwave)
-{
-  bool ret = false;
-
-  g_assert(pIter != NULL);
-  g_assert(pIter->pData != NULL);
 
-  if (!pIter->filter.accept_vis) return false;
-
-  /* Compile glob-style patterns for efficiency */
-  if (pIter->filter.arrname_pttn == NULL)
-    pIter->filter.arrname_pttn = g_pattern_spec_new(pIter->filter.arrname);
-  if (pIter->filter.insname_pttn == NULL)
-    pIter->filter.insname_pttn = g_pattern_spec_new(pIter->filter.insname);
-  if (pIter->filter.corrname_pttn == NULL)
-    pIter->filter.corrname_pttn = g_pattern_spec_new(pIter->filter.corrname);
-
-  /* Advance to next data point */
-  do
+  /* Record which tables pass filter, and look up their OI_WAVELENGTH
+     tables */
+  pIter->filter.arrname_pttn = g_pattern_spec_new(pIter->filter.arrname);
+  pIter->filter.insname_pttn = g_pattern_spec_new(pIter->filter.insname);
+  pIter->filter.corrname_pttn = g_pattern_spec_new(pIter->filter.corrname);
+  i = 0;
+  for (link = pIter->link; link != NULL; link = link->next)
   {
-    if (!(NEXT_CHANNEL(pIter, oi_vis) || NEXT_RECORD(pIter, oi_vis) ||
-          NEXT_TABLE(pIter, oi_vis)))
-      goto finally;
-  } while (!(oi_vis_iter_accept_table(pIter) &&
-             oi_vis_iter_accept_record(pIter) &&
-             oi_vis_iter_accept_channel(pIter)));
-
-  /* Return new current data point */
-  // TODO: provide access to wavelength or u/lambda, v/lambda
-  ret = true;
-  oi_vis *pTable = (oi_vis *)pIter->link->data;
-  if (pExtver != NULL) *pExtver = pIter->extver;
-  if (ppTable != NULL) *ppTable = pTable;
-  if (pIrec != NULL) *pIrec = pIter->irec;
-  if (ppRec != NULL) *ppRec = &pTable->record[pIter->irec];
-  if (pIwave != NULL) *pIwave = pIter->iwave;
-
-finally:
-  /* Free compiled patterns */
+    pIter->acceptTable[i] = pType->accept_table(link->data, &pIter->filter);
+    pIter->tableWave[i] = NULL;
+    if (pIter->acceptTable[i] && pType->get_insname != NULL)
+    {
+      pIter->tableWave[i] =
+          oi_fits_lookup_wavelength(pData, pType->get_insname(link->data));
+      pIter->acceptTable[i] = (pIter->tableWave[i] != NULL);
+    }
+    ++i;
+  }
   g_pattern_spec_free(pIter->filter.arrname_pttn);
   g_pattern_spec_free(pIter->filter.insname_pttn);
   g_pattern_spec_free(pIter->filter.corrname_pttn);
@@ -437,130 +670,1371 @@ finally:
   pIter->filter.insname_pttn = NULL;
   pIter->filter.corrname_pttn = NULL;
 
-  return ret;
+  iter_skip_tables(pIter);
+  iter_set_position(pIter, pIter->link, pIter->extver, 0);
+  pIter->startLink = pIter->link;
+  pIter->startExtver = pIter->extver;
+  pIter->startView = 0;
 }
 
 /**
- * Get next squared visibility datum that passes filter.
- *
- * @param pIter    Initialised iterator struct.
- * @param pExtver  Return location for EXTVER, or NULL.
- * @param ppTable  Return location for pointer to table struct, or NULL.
- * @param pIrec    Return location for record index, or NULL.
- * @param ppRec    Return location for pointer to record struct, or NULL.
- * @param pIwave   Return location for channel index, or NULL.
- * @return bool  true if succesful, false if end of data reached.
+ * Initialise iterator over data tables in filtered view
  */
-bool oi_vis2_iter_next(oi_vis2_iter *pIter, int *const pExtver,
-                       oi_vis2 **ppTable, long *const pIrec,
-                       oi_vis2_record **ppRec, int *const pIwave)
+static void iter_init_view(_oi_iter *pIter, const iter_type *pType,
+                           const oi_fits_view *pView, GList *viewList)
 {
-  bool ret = false;
-
   g_assert(pIter != NULL);
-  g_assert(pIter->pData != NULL);
-
-  if (!pIter->filter.accept_vis2) return false;
-
-  /* Compile glob-style patterns for efficiency */
-  if (pIter->filter.arrname_pttn == NULL)
-    pIter->filter.arrname_pttn = g_pattern_spec_new(pIter->filter.arrname);
-  if (pIter->filter.insname_pttn == NULL)
-    pIter->filter.insname_pttn = g_pattern_spec_new(pIter->filter.insname);
-  if (pIter->filter.corrname_pttn == NULL)
-    pIter->filter.corrname_pttn = g_pattern_spec_new(pIter->filter.corrname);
-
-  /* Advance to next data point */
-  do
-  {
-    if (!(NEXT_CHANNEL(pIter, oi_vis2) || NEXT_RECORD(pIter, oi_vis2) ||
-          NEXT_TABLE(pIter, oi_vis2)))
-      goto finally;
-  } while (!(oi_vis2_iter_accept_table(pIter) &&
-             oi_vis2_iter_accept_record(pIter) &&
-             oi_vis2_iter_accept_channel(pIter)));
-
-  /* Return new current data point */
-  // TODO: provide access to wavelength or u/lambda, v/lambda
-  ret = true;
-  oi_vis2 *pTable = (oi_vis2 *)pIter->link->data;
-  if (pExtver != NULL) *pExtver = pIter->extver;
-  if (ppTable != NULL) *ppTable = pTable;
-  if (pIrec != NULL) *pIrec = pIter->irec;
-  if (ppRec != NULL) *ppRec = &pTable->record[pIter->irec];
-  if (pIwave != NULL) *pIwave = pIter->iwave;
+  g_assert(pView != NULL);
+
+  pIter->pData = pView->pInput;
+  pIter->pView = pView;
+  pIter->filter = pView->filter;
+  pIter->numTables = 0;
+  pIter->acceptTable = NULL;
+  pIter->tableWave = NULL;
+  iter_init_common(pIter, pType, viewList);
+  iter_set_position(pIter, pIter->link, 1, 0);
+  pIter->startLink = pIter->link;
+  pIter->startExtver = pIter->extver;
+  pIter->startView = 0;
+}
 
-finally:
-  /* Free compiled patterns */
-  g_pattern_spec_free(pIter->filter.arrname_pttn);
-  g_pattern_spec_free(pIter->filter.insname_pttn);
-  g_pattern_spec_free(pIter->filter.corrname_pttn);
-  pIter->filter.arrname_pttn = NULL;
-  pIter->filter.insname_pttn = NULL;
-  pIter->filter.corrname_pttn = NULL;
+/*
+ * Generic iterator engine
+ */
 
-  return ret;
-}
+/** Is record @a iview of current table beyond end of iterator range? */
+#define AT_END(pIter, iview)                                                   \
+  ((pIter)->link == (pIter)->endLink && (iview) >= (pIter)->endView)
 
 /**
- * Get next triple product datum that passes filter.
+ * Advance iterator to next channel of current record
  *
- * @param pIter    Initialised iterator struct.
- * @param pExtver  Return location for EXTVER, or NULL.
- * @param ppTable  Return location for pointer to table struct, or NULL.
- * @param pIrec    Return location for record index, or NULL.
- * @param ppRec    Return location for pointer to record struct, or NULL.
- * @param pIwave   Return location for channel index, or NULL.
- * @return bool  true if succesful, false if end of data reached.
+ * @return bool  true if succesful, false if no more channels
  */
-bool oi_t3_iter_next(oi_t3_iter *pIter, int *const pExtver, oi_t3 **ppTable,
-                     long *const pIrec, oi_t3_record **ppRec, int *const pIwave)
+static bool iter_next_channel(_oi_iter *pIter)
 {
-  bool ret = false;
+  if (pIter->link == NULL || pIter->iwave >= pIter->nwave - 1) return false;
+  ++pIter->iwave;
+  return true;
+}
+
+/**
+ * Advance iterator to next selected record of current table
+ *
+ * @return bool  true if succesful, false if no more records in range
+ */
+static bool iter_next_record(_oi_iter *pIter)
+{
+  if (pIter->link == NULL || pIter->iview >= pIter->numrec - 1 ||
+      AT_END(pIter, pIter->iview + 1))
+    return false;
+  ++pIter->iview;
+  if (pIter->pView != NULL)
+    pIter->irec = ITER_TABLE_VIEW(pIter)->irec[pIter->iview];
+  else
+    pIter->irec = pIter->iview;
+  pIter->iwave = 0;
+  return true;
+}
+
+/**
+ * Advance iterator to next table selected by filter or view
+ *
+ * @return bool  true if succesful, false if no more tables
+ */
+static bool iter_next_table(_oi_iter *pIter)
+{
+  GList *link = pIter->link;
+  int extver = pIter->extver;
+
+  if (link == NULL || link->next == NULL || link == pIter->endLink)
+    return false;
+  pIter->link = link->next;
+  if (pIter->pView == NULL)
+  {
+    ++pIter->extver;
+    iter_skip_tables(pIter);
+  }
+  if (pIter->link == NULL ||
+      (pIter->link == pIter->endLink && pIter->endView == 0))
+  {
+    /* Stay at end of last table in range */
+    pIter->link = link;
+    pIter->extver = extver;
+    return false;
+  }
+  iter_start_table(pIter);
+  return true;
+}
+
+/**
+ * Add current datum to iterator mask, if recording
+ */
+static void iter_mask_add(_oi_iter *pIter)
+{
+  const mask_table *pLast;
+  mask_table tab;
+  mask_point point;
+
+  if (pIter->maskState != MASK_RECORDING) return;
+  pLast = NULL;
+  if (pIter->maskTables->len > 0)
+    pLast = &g_array_index(pIter->maskTables, mask_table,
+                           pIter->maskTables->len - 1);
+  if (pLast == NULL || pLast->link != pIter->link ||
+      pLast->pWave != pIter->pWave)
+  {
+    tab.link = pIter->link;
+    tab.extver = pIter->extver;
+    tab.pWave = pIter->pWave;
+    g_array_append_val(pIter->maskTables, tab);
+  }
+  point.itable = pIter->maskTables->len - 1;
+  point.iwave = pIter->iwave;
+  point.irec = pIter->irec;
+  g_array_append_val(pIter->mask, point);
+}
+
+/**
+ * Mark iterator mask complete at end of data, if recording
+ */
+static void iter_mask_end(_oi_iter *pIter)
+{
+  if (pIter->mask != NULL && pIter->maskState == MASK_RECORDING)
+    pIter->maskState = MASK_COMPLETE;
+}
+
+/**
+ * Advance iterator to next datum recorded in mask
+ *
+ * @return bool  true if succesful, false if end of data reached.
+ */
+static bool iter_mask_replay(_oi_iter *pIter)
+{
+  const mask_point *pPoint;
+  const mask_table *pTab;
+
+  if (pIter->imask >= pIter->mask->len) return false;
+  pPoint = &g_array_index(pIter->mask, mask_point, pIter->imask++);
+  pTab = &g_array_index(pIter->maskTables, mask_table, pPoint->itable);
+  pIter->link = pTab->link;
+  pIter->extver = pTab->extver;
+  pIter->pWave = pTab->pWave;
+  pIter->irec = pPoint->irec;
+  pIter->iwave = pPoint->iwave;
+  return true;
+}
+
+/**
+ * Advance iterator to next datum that passes filter
+ *
+ * The record selection criteria are evaluated once per record, and
+ * the remaining channels of a rejected record are skipped.
+ *
+ * @return bool  true if succesful, false if end of data reached.
+ */
+static bool iter_advance(_oi_iter *pIter)
+{
+  const iter_type *pType = pIter->pType;
+
+  if (pIter->replaying) return iter_mask_replay(pIter);
+  while (true)
+  {
+    if (!(iter_next_channel(pIter) || iter_next_record(pIter) ||
+          iter_next_table(pIter)))
+    {
+      iter_mask_end(pIter);
+      return false;
+    }
+    if (pIter->iwave == 0 &&
+        (pIter->iview >= pIter->numrec || !pType->accept_record(pIter)))
+    {
+      pIter->iwave = pIter->nwave - 1; /* skip rest of record */
+      continue;
+    }
+    if (pType->accept_channel(pIter)) break;
+  }
+  if (pIter->mask != NULL) iter_mask_add(pIter);
+  return true;
+}
+
+/*
+ * Public functions
+ */
+
+/**
+ * Initialise complex visibility iterator.
+ *
+ * @param pIter    Iterator struct to initialise.
+ * @param pData    OIFITS dataset to iterate over.
+ * @param pFilter  Filter to apply, or NULL.
+ *
+ * The table selection criteria of the filter are evaluated once,
+ * here. Call oi_vis_iter_free() when finished with the iterator.
+ */
+void oi_vis_iter_init(oi_vis_iter *pIter, const oi_fits *pData,
+                      const oi_filter_spec *pFilter)
+{
+  iter_init(pIter, &visType, pData, pFilter, pData->visList, pData->numVis);
+}
+
+/**
+ * Initialise squared visibility iterator.
+ *
+ * @param pIter    Iterator struct to initialise.
+ * @param pData    OIFITS dataset to iterate over.
+ * @param pFilter  Filter to apply, or NULL.
+ *
+ * The table selection criteria of the filter are evaluated once,
+ * here. Call oi_vis2_iter_free() when finished with the iterator.
+ */
+void oi_vis2_iter_init(oi_vis2_iter *pIter, const oi_fits *pData,
+                       const oi_filter_spec *pFilter)
+{
+  iter_init(pIter, &vis2Type, pData, pFilter, pData->vis2List,
+            pData->numVis2);
+}
+
+/**
+ * Initialise triple product iterator.
+ *
+ * @param pIter    Iterator struct to initialise.
+ * @param pData    OIFITS dataset to iterate over.
+ * @param pFilter  Filter to apply, or NULL.
+ *
+ * The table selection criteria of the filter are evaluated once,
+ * here. Call oi_t3_iter_free() when finished with the iterator.
+ */
+void oi_t3_iter_init(oi_t3_iter *pIter, const oi_fits *pData,
+                     const oi_filter_spec *pFilter)
+{
+  iter_init(pIter, &t3Type, pData, pFilter, pData->t3List, pData->numT3);
+}
+
+/**
+ * Initialise flux iterator.
+ *
+ * @param pIter    Iterator struct to initialise.
+ * @param pData    OIFITS dataset to iterate over.
+ * @param pFilter  Filter to apply, or NULL.
+ *
+ * The table selection criteria of the filter are evaluated once,
+ * here. Call oi_flux_iter_free() when finished with the iterator.
+ */
+void oi_flux_iter_init(oi_flux_iter *pIter, const oi_fits *pData,
+                       const oi_filter_spec *pFilter)
+{
+  iter_init(pIter, &fluxType, pData, pFilter, pData->fluxList,
+            pData->numFlux);
+}
+
+/**
+ * Initialise instrumental polarisation iterator.
+ *
+ * @param pIter    Iterator struct to initialise.
+ * @param pData    OIFITS dataset to iterate over.
+ * @param pFilter  Filter to apply, or NULL.
+ *
+ * The table selection criteria of the filter are evaluated once,
+ * here. Call oi_inspol_iter_free() when finished with the iterator.
+ */
+void oi_inspol_iter_init(oi_inspol_iter *pIter, const oi_fits *pData,
+                         const oi_filter_spec *pFilter)
+{
+  iter_init(pIter, &inspolType, pData, pFilter, pData->inspolList,
+            pData->numInspol);
+}
+
+/**
+ * Initialise complex visibility iterator over filtered view.
+ *
+ * Only the data selected by the view are visited. Table and record
+ * pointers and indices returned by oi_vis_iter_next() refer to the
+ * input dataset of the view.
+ *
+ * @param pIter  Iterator struct to initialise.
+ * @param pView  Filtered view to iterate over.
+ */
+void oi_vis_iter_init_view(oi_vis_iter *pIter, const oi_fits_view *pView)
+{
+  iter_init_view(pIter, &visType, pView, pView->visList);
+}
+
+/**
+ * Initialise squared visibility iterator over filtered view.
+ *
+ * Only the data selected by the view are visited. Table and record
+ * pointers and indices returned by oi_vis2_iter_next() refer to the
+ * input dataset of the view.
+ *
+ * @param pIter  Iterator struct to initialise.
+ * @param pView  Filtered view to iterate over.
+ */
+void oi_vis2_iter_init_view(oi_vis2_iter *pIter, const oi_fits_view *pView)
+{
+  iter_init_view(pIter, &vis2Type, pView, pView->vis2List);
+}
+
+/**
+ * Initialise triple product iterator over filtered view.
+ *
+ * Only the data selected by the view are visited. Table and record
+ * pointers and indices returned by oi_t3_iter_next() refer to the
+ * input dataset of the view.
+ *
+ * @param pIter  Iterator struct to initialise.
+ * @param pView  Filtered view to iterate over.
+ */
+void oi_t3_iter_init_view(oi_t3_iter *pIter, const oi_fits_view *pView)
+{
+  iter_init_view(pIter, &t3Type, pView, pView->t3List);
+}
+
+/**
+ * Initialise flux iterator over filtered view.
+ *
+ * Only the data selected by the view are visited. Table and record
+ * pointers and indices returned by oi_flux_iter_next() refer to the
+ * input dataset of the view.
+ *
+ * @param pIter  Iterator struct to initialise.
+ * @param pView  Filtered view to iterate over.
+ */
+void oi_flux_iter_init_view(oi_flux_iter *pIter, const oi_fits_view *pView)
+{
+  iter_init_view(pIter, &fluxType, pView, pView->fluxList);
+}
+
+/**
+ * Initialise instrumental polarisation iterator over filtered view.
+ *
+ * Only the data selected by the view are visited. Table and record
+ * pointers and indices returned by oi_inspol_iter_next() refer to the
+ * input dataset of the view.
+ *
+ * @param pIter  Iterator struct to initialise.
+ * @param pView  Filtered view to iterate over.
+ */
+void oi_inspol_iter_init_view(oi_inspol_iter *pIter,
+                              const oi_fits_view *pView)
+{
+  iter_init_view(pIter, &inspolType, pView, pView->inspolList);
+}
+
+/**
+ * Get next complex visibility datum that passes filter.
+ *
+ * @param pIter    Initialised iterator struct.
+ * @param pExtver  Return location for EXTVER, or NULL.
+ * @param ppTable  Return location for pointer to table struct, or NULL.
+ * @param pIrec    Return location for record index, or NULL.
+ * @param ppRec    Return location for pointer to record struct, or NULL.
+ * @param pIwave   Return location for channel index, or NULL.
+ * @return bool  true if succesful, false if end of data reached.
+ */
+bool oi_vis_iter_next(oi_vis_iter *pIter, int *const pExtver, oi_vis **ppTable,
+                      long *const pIrec, oi_vis_record **ppRec,
+                      int *const pIwave)
+{
+  g_assert(pIter != NULL);
+  g_assert(pIter->pData != NULL);
+
+  /* Advance to next data point */
+  if (!iter_advance(pIter)) return false;
+
+  /* Return new current data point */
+  // TODO: provide access to wavelength or u/lambda, v/lambda
+  oi_vis *pTable = ITER_TABLE(pIter, oi_vis);
+  if (pExtver != NULL) *pExtver = pIter->extver;
+  if (ppTable != NULL) *ppTable = pTable;
+  if (pIrec != NULL) *pIrec = pIter->irec;
+  if (ppRec != NULL) *ppRec = &pTable->record[pIter->irec];
+  if (pIwave != NULL) *pIwave = pIter->iwave;
+
+  return true;
+}
+
+/**
+ * Get next squared visibility datum that passes filter.
+ *
+ * @param pIter    Initialised iterator struct.
+ * @param pExtver  Return location for EXTVER, or NULL.
+ * @param ppTable  Return location for pointer to table struct, or NULL.
+ * @param pIrec    Return location for record index, or NULL.
+ * @param ppRec    Return location for pointer to record struct, or NULL.
+ * @param pIwave   Return location for channel index, or NULL.
+ * @return bool  true if succesful, false if end of data reached.
+ */
+bool oi_vis2_iter_next(oi_vis2_iter *pIter, int *const pExtver,
+                       oi_vis2 **ppTable, long *const pIrec,
+                       oi_vis2_record **ppRec, int *const pIwave)
+{
+  g_assert(pIter != NULL);
+  g_assert(pIter->pData != NULL);
+
+  /* Advance to next data point */
+  if (!iter_advance(pIter)) return false;
+
+  /* Return new current data point */
+  // TODO: provide access to wavelength or u/lambda, v/lambda
+  oi_vis2 *pTable = ITER_TABLE(pIter, oi_vis2);
+  if (pExtver != NULL) *pExtver = pIter->extver;
+  if (ppTable != NULL) *ppTable = pTable;
+  if (pIrec != NULL) *pIrec = pIter->irec;
+  if (ppRec != NULL) *ppRec = &pTable->record[pIter->irec];
+  if (pIwave != NULL) *pIwave = pIter->iwave;
+
+  return true;
+}
+
+/**
+ * Get next triple product datum that passes filter.
+ *
+ * @param pIter    Initialised iterator struct.
+ * @param pExtver  Return location for EXTVER, or NULL.
+ * @param ppTable  Return location for pointer to table struct, or NULL.
+ * @param pIrec    Return location for record index, or NULL.
+ * @param ppRec    Return location for pointer to record struct, or NULL.
+ * @param pIwave   Return location for channel index, or NULL.
+ * @return bool  true if succesful, false if end of data reached.
+ */
+bool oi_t3_iter_next(oi_t3_iter *pIter, int *const pExtver, oi_t3 **ppTable,
+                     long *const pIrec, oi_t3_record **ppRec, int *const pIwave)
+{
+  g_assert(pIter != NULL);
+  g_assert(pIter->pData != NULL);
+
+  /* Advance to next data point */
+  if (!iter_advance(pIter)) return false;
+
+  /* Return new current data point */
+  // TODO: provide access to wavelength or u/lambda, v/lambda
+  oi_t3 *pTable = ITER_TABLE(pIter, oi_t3);
+  if (pExtver != NULL) *pExtver = pIter->extver;
+  if (ppTable != NULL) *ppTable = pTable;
+  if (pIrec != NULL) *pIrec = pIter->irec;
+  if (ppRec != NULL) *ppRec = &pTable->record[pIter->irec];
+  if (pIwave != NULL) *pIwave = pIter->iwave;
+
+  return true;
+}
+
+/**
+ * Get next flux datum that passes filter.
+ *
+ * @param pIter    Initialised iterator struct.
+ * @param pExtver  Return location for EXTVER, or NULL.
+ * @param ppTable  Return location for pointer to table struct, or NULL.
+ * @param pIrec    Return location for record index, or NULL.
+ * @param ppRec    Return location for pointer to record struct, or NULL.
+ * @param pIwave   Return location for channel index, or NULL.
+ * @return bool  true if succesful, false if end of data reached.
+ */
+bool oi_flux_iter_next(oi_flux_iter *pIter, int *const pExtver,
+                       oi_flux **ppTable, long *const pIrec,
+                       oi_flux_record **ppRec, int *const pIwave)
+{
+  g_assert(pIter != NULL);
+  g_assert(pIter->pData != NULL);
+
+  /* Advance to next data point */
+  if (!iter_advance(pIter)) return false;
+
+  /* Return new current data point */
+  oi_flux *pTable = ITER_TABLE(pIter, oi_flux);
+  if (pExtver != NULL) *pExtver = pIter->extver;
+  if (ppTable != NULL) *ppTable = pTable;
+  if (pIrec != NULL) *pIrec = pIter->irec;
+  if (ppRec != NULL) *ppRec = &pTable->record[pIter->irec];
+  if (pIwave != NULL) *pIwave = pIter->iwave;
+
+  return true;
+}
+
+/**
+ * Get next instrumental polarisation datum that passes filter.
+ *
+ * @param pIter    Initialised iterator struct.
+ * @param pExtver  Return location for EXTVER, or NULL.
+ * @param ppTable  Return location for pointer to table struct, or NULL.
+ * @param pIrec    Return location for record index, or NULL.
+ * @param ppRec    Return location for pointer to record struct, or NULL.
+ * @param pIwave   Return location for channel index, or NULL.
+ * @return bool  true if succesful, false if end of data reached.
+ */
+bool oi_inspol_iter_next(oi_inspol_iter *pIter, int *const pExtver,
+                         oi_inspol **ppTable, long *const pIrec,
+                         oi_inspol_record **ppRec, int *const pIwave)
+{
+  g_assert(pIter != NULL);
+  g_assert(pIter->pData != NULL);
+
+  /* Advance to next data point */
+  if (!iter_advance(pIter)) return false;
+
+  /* Return new current data point */
+  oi_inspol *pTable = ITER_TABLE(pIter, oi_inspol);
+  if (pExtver != NULL) *pExtver = pIter->extver;
+  if (ppTable != NULL) *ppTable = pTable;
+  if (pIrec != NULL) *pIrec = pIter->irec;
+  if (ppRec != NULL) *ppRec = &pTable->record[pIter->irec];
+  if (pIwave != NULL) *pIwave = pIter->iwave;
+
+  return true;
+}
+
+/**
+ * Get next batch of complex visibility data that pass filter.
+ *
+ * @param pIter  Initialised iterator struct.
+ * @param maxN   Maximum number of data to return.
+ * @param pOut   Arrays to fill, each with room for @a maxN values.
+ * @return long  Number of data returned, 0 if end of data reached.
+ */
+long oi_vis_iter_next_batch(oi_vis_iter *pIter, long maxN, oi_vis_batch *pOut)
+{
+  oi_vis *pTable;
+  oi_vis_record *pRec;
+  double effWave;
+  long n;
+  int iwave;
+
+  g_assert(pIter != NULL);
+  g_assert(pIter->pData != NULL);
+  g_assert(pOut != NULL);
+
+  for (n = 0; n < maxN && iter_advance(pIter); n++)
+  {
+    pTable = ITER_TABLE(pIter, oi_vis);
+    pRec = &pTable->record[pIter->irec];
+    iwave = pIter->iwave;
+    effWave = pIter->pWave->eff_wave[iwave];
+    if (pOut->visamp != NULL) pOut->visamp[n] = pRec->visamp[iwave];
+    if (pOut->visamperr != NULL) pOut->visamperr[n] = pRec->visamperr[iwave];
+    if (pOut->visphi != NULL) pOut->visphi[n] = pRec->visphi[iwave];
+    if (pOut->visphierr != NULL) pOut->visphierr[n] = pRec->visphierr[iwave];
+    if (pOut->u != NULL) pOut->u[n] = pRec->ucoord / effWave;
+    if (pOut->v != NULL) pOut->v[n] = pRec->vcoord / effWave;
+    if (pOut->mjd != NULL) pOut->mjd[n] = pRec->mjd;
+    if (pOut->target_id != NULL) pOut->target_id[n] = pRec->target_id;
+    if (pOut->extver != NULL) pOut->extver[n] = pIter->extver;
+    if (pOut->irec != NULL) pOut->irec[n] = pIter->irec;
+    if (pOut->iwave != NULL) pOut->iwave[n] = iwave;
+  }
+  return n;
+}
+
+/**
+ * Get next batch of squared visibility data that pass filter.
+ *
+ * @param pIter  Initialised iterator struct.
+ * @param maxN   Maximum number of data to return.
+ * @param pOut   Arrays to fill, each with room for @a maxN values.
+ * @return long  Number of data returned, 0 if end of data reached.
+ */
+long oi_vis2_iter_next_batch(oi_vis2_iter *pIter, long maxN,
+                             oi_vis2_batch *pOut)
+{
+  oi_vis2 *pTable;
+  oi_vis2_record *pRec;
+  double effWave;
+  long n;
+  int iwave;
+
+  g_assert(pIter != NULL);
+  g_assert(pIter->pData != NULL);
+  g_assert(pOut != NULL);
+
+  for (n = 0; n < maxN && iter_advance(pIter); n++)
+  {
+    pTable = ITER_TABLE(pIter, oi_vis2);
+    pRec = &pTable->record[pIter->irec];
+    iwave = pIter->iwave;
+    effWave = pIter->pWave->eff_wave[iwave];
+    if (pOut->vis2data != NULL) pOut->vis2data[n] = pRec->vis2data[iwave];
+    if (pOut->vis2err != NULL) pOut->vis2err[n] = pRec->vis2err[iwave];
+    if (pOut->u != NULL) pOut->u[n] = pRec->ucoord / effWave;
+    if (pOut->v != NULL) pOut->v[n] = pRec->vcoord / effWave;
+    if (pOut->mjd != NULL) pOut->mjd[n] = pRec->mjd;
+    if (pOut->target_id != NULL) pOut->target_id[n] = pRec->target_id;
+    if (pOut->extver != NULL) pOut->extver[n] = pIter->extver;
+    if (pOut->irec != NULL) pOut->irec[n] = pIter->irec;
+    if (pOut->iwave != NULL) pOut->iwave[n] = iwave;
+  }
+  return n;
+}
+
+/**
+ * Get next batch of triple product data that pass filter.
+ *
+ * @param pIter  Initialised iterator struct.
+ * @param maxN   Maximum number of data to return.
+ * @param pOut   Arrays to fill, each with room for @a maxN values.
+ * @return long  Number of data returned, 0 if end of data reached.
+ */
+long oi_t3_iter_next_batch(oi_t3_iter *pIter, long maxN, oi_t3_batch *pOut)
+{
+  oi_t3 *pTable;
+  oi_t3_record *pRec;
+  double effWave;
+  long n;
+  int iwave;
+
+  g_assert(pIter != NULL);
+  g_assert(pIter->pData != NULL);
+  g_assert(pOut != NULL);
+
+  for (n = 0; n < maxN && iter_advance(pIter); n++)
+  {
+    pTable = ITER_TABLE(pIter, oi_t3);
+    pRec = &pTable->record[pIter->irec];
+    iwave = pIter->iwave;
+    effWave = pIter->pWave->eff_wave[iwave];
+    if (pOut->t3amp != NULL) pOut->t3amp[n] = pRec->t3amp[iwave];
+    if (pOut->t3amperr != NULL) pOut->t3amperr[n] = pRec->t3amperr[iwave];
+    if (pOut->t3phi != NULL) pOut->t3phi[n] = pRec->t3phi[iwave];
+    if (pOut->t3phierr != NULL) pOut->t3phierr[n] = pRec->t3phierr[iwave];
+    if (pOut->u1 != NULL) pOut->u1[n] = pRec->u1coord / effWave;
+    if (pOut->v1 != NULL) pOut->v1[n] = pRec->v1coord / effWave;
+    if (pOut->u2 != NULL) pOut->u2[n] = pRec->u2coord / effWave;
+    if (pOut->v2 != NULL) pOut->v2[n] = pRec->v2coord / effWave;
+    if (pOut->mjd != NULL) pOut->mjd[n] = pRec->mjd;
+    if (pOut->target_id != NULL) pOut->target_id[n] = pRec->target_id;
+    if (pOut->extver != NULL) pOut->extver[n] = pIter->extver;
+    if (pOut->irec != NULL) pOut->irec[n] = pIter->irec;
+    if (pOut->iwave != NULL) pOut->iwave[n] = iwave;
+  }
+  return n;
+}
+
+/**
+ * Get next batch of flux data that pass filter.
+ *
+ * @param pIter  Initialised iterator struct.
+ * @param maxN   Maximum number of data to return.
+ * @param pOut   Arrays to fill, each with room for @a maxN values.
+ * @return long  Number of data returned, 0 if end of data reached.
+ */
+long oi_flux_iter_next_batch(oi_flux_iter *pIter, long maxN,
+                             oi_flux_batch *pOut)
+{
+  oi_flux *pTable;
+  oi_flux_record *pRec;
+  long n;
+  int iwave;
+
+  g_assert(pIter != NULL);
+  g_assert(pIter->pData != NULL);
+  g_assert(pOut != NULL);
+
+  for (n = 0; n < maxN && iter_advance(pIter); n++)
+  {
+    pTable = ITER_TABLE(pIter, oi_flux);
+    pRec = &pTable->record[pIter->irec];
+    iwave = pIter->iwave;
+    if (pOut->fluxdata != NULL) pOut->fluxdata[n] = pRec->fluxdata[iwave];
+    if (pOut->fluxerr != NULL) pOut->fluxerr[n] = pRec->fluxerr[iwave];
+    if (pOut->eff_wave != NULL)
+      pOut->eff_wave[n] = pIter->pWave->eff_wave[iwave];
+    if (pOut->mjd != NULL) pOut->mjd[n] = pRec->mjd;
+    if (pOut->target_id != NULL) pOut->target_id[n] = pRec->target_id;
+    if (pOut->sta_index != NULL) pOut->sta_index[n] = pRec->sta_index;
+    if (pOut->extver != NULL) pOut->extver[n] = pIter->extver;
+    if (pOut->irec != NULL) pOut->irec[n] = pIter->irec;
+    if (pOut->iwave != NULL) pOut->iwave[n] = iwave;
+  }
+  return n;
+}
+
+/**
+ * Get next batch of instrumental polarisation data that pass filter.
+ *
+ * @param pIter  Initialised iterator struct.
+ * @param maxN   Maximum number of data to return.
+ * @param pOut   Arrays to fill, each with room for @a maxN values.
+ * @return long  Number of data returned, 0 if end of data reached.
+ */
+long oi_inspol_iter_next_batch(oi_inspol_iter *pIter, long maxN,
+                               oi_inspol_batch *pOut)
+{
+  oi_inspol *pTable;
+  oi_inspol_record *pRec;
+  long n;
+  int iwave;
+
+  g_assert(pIter != NULL);
+  g_assert(pIter->pData != NULL);
+  g_assert(pOut != NULL);
+
+  for (n = 0; n < maxN && iter_advance(pIter); n++)
+  {
+    pTable = ITER_TABLE(pIter, oi_inspol);
+    pRec = &pTable->record[pIter->irec];
+    iwave = pIter->iwave;
+    if (pOut->jxx != NULL) pOut->jxx[n] = pRec->jxx[iwave];
+    if (pOut->jyy != NULL) pOut->jyy[n] = pRec->jyy[iwave];
+    if (pOut->jxy != NULL) pOut->jxy[n] = pRec->jxy[iwave];
+    if (pOut->jyx != NULL) pOut->jyx[n] = pRec->jyx[iwave];
+    if (pOut->eff_wave != NULL)
+      pOut->eff_wave[n] = pIter->pWave->eff_wave[iwave];
+    if (pOut->mjd_obs != NULL) pOut->mjd_obs[n] = pRec->mjd_obs;
+    if (pOut->mjd_end != NULL) pOut->mjd_end[n] = pRec->mjd_end;
+    if (pOut->target_id != NULL) pOut->target_id[n] = pRec->target_id;
+    if (pOut->sta_index != NULL) pOut->sta_index[n] = pRec->sta_index;
+    if (pOut->extver != NULL) pOut->extver[n] = pIter->extver;
+    if (pOut->irec != NULL) pOut->irec[n] = pIter->irec;
+    if (pOut->iwave != NULL) pOut->iwave[n] = iwave;
+  }
+  return n;
+}
+
+/**
+ * Get number of records to visit and number of channels for table
+ * @a link, or set both to zero if the table is not selected
+ */
+static void iter_table_size(const _oi_iter *pIter, GList *link, int extver,
+                            long *pNumrec, int *pNwave)
+{
+  const oi_table_view *pTabView;
+
+  if (pIter->pView != NULL)
+  {
+    pTabView = (const oi_table_view *)link->data;
+    pIter->pType->size(pTabView->pTable, pNumrec, pNwave);
+    *pNumrec = pTabView->numrec;
+  }
+  else if (pIter->acceptTable[extver - 1])
+  {
+    pIter->pType->size(link->data, pNumrec, pNwave);
+  }
+  else
+  {
+    *pNumrec = 0;
+    *pNwave = 0;
+  }
+}
+
+/**
+ * Make copy of iterator with its own cached table information
+ */
+static void iter_copy(const _oi_iter *pIter, _oi_iter *pCopy)
+{
+  *pCopy = *pIter;
+  pCopy->mask = NULL;
+  pCopy->maskTables = NULL;
+  pCopy->fingerprint = NULL;
+  pCopy->replaying = false;
+  if (pIter->insnameWave != NULL) g_hash_table_ref(pIter->insnameWave);
+  if (pIter->numTables > 0)
+  {
+    pCopy->acceptTable =
+        chkmalloc(pIter->numTables * sizeof(pIter->acceptTable[0]));
+    memcpy(pCopy->acceptTable, pIter->acceptTable,
+           pIter->numTables * sizeof(pIter->acceptTable[0]));
+    pCopy->tableWave =
+        chkmalloc(pIter->numTables * sizeof(pIter->tableWave[0]));
+    memcpy(pCopy->tableWave, pIter->tableWave,
+           pIter->numTables * sizeof(pIter->tableWave[0]));
+  }
+}
+
+/**
+ * Divide range of unstarted iterator into @a k contiguous ranges
+ *
+ * Each record is weighted by its number of channels, and the ranges
+ * are chosen to have approximately equal total weight. Ranges are
+ * divided at record boundaries, so some may be empty.
+ */
+static void iter_split(const _oi_iter *pIter, int k, _oi_iter iters[])
+{
+  GList *link;
+  double total, cum;
+  long numrec, r;
+  int extver, nwave, i, j;
+
+  g_assert(pIter != NULL);
+  g_assert(k > 0);
+  g_assert(iters != NULL);
+  g_assert_cmpint(pIter->iwave, ==, -1); /* iteration not started */
+
+  for (i = 0; i < k; i++)
+  {
+    iter_copy(pIter, &iters[i]);
+    if (i > 0)
+    {
+      /* Empty unless start found below */
+      iters[i].link = NULL;
+      iters[i].startLink = NULL;
+    }
+  }
+  if (k == 1 || pIter->link == NULL) return;
+
+  /* Sum weights of records in range */
+  total = 0.0;
+  extver = pIter->extver;
+  for (link = pIter->link; link != NULL; link = link->next)
+  {
+    iter_table_size(pIter, link, extver++, &numrec, &nwave);
+    if (link == pIter->endLink) numrec = pIter->endView;
+    r = (link == pIter->link) ? pIter->iview : 0;
+    total += (double)(numrec - r) * nwave;
+    if (link == pIter->endLink) break;
+  }
+
+  /* Find record at which each range after the first starts */
+  cum = 0.0;
+  j = 1;
+  extver = pIter->extver;
+  for (link = pIter->link; link != NULL && j < k; link = link->next)
+  {
+    iter_table_size(pIter, link, extver, &numrec, &nwave);
+    if (link == pIter->endLink) numrec = pIter->endView;
+    r = (link == pIter->link) ? pIter->iview : 0;
+    for (; r < numrec && j < k; r++)
+    {
+      while (j < k && cum >= total * j / k)
+      {
+        /* End previous range here, discarding it if empty */
+        iters[j - 1].endLink = link;
+        iters[j - 1].endView = r;
+        if (iters[j - 1].link == link && iters[j - 1].iview == r)
+        {
+          iters[j - 1].link = NULL;
+          iters[j - 1].startLink = NULL;
+        }
+        /* Start next range here */
+        iter_set_position(&iters[j], link, extver, r);
+        iters[j].startLink = link;
+        iters[j].startExtver = iters[j].extver;
+        iters[j].startView = r;
+        iters[j].endLink = pIter->endLink;
+        iters[j].endView = pIter->endView;
+        ++j;
+      }
+      cum += nwave;
+    }
+    if (link == pIter->endLink) break;
+    ++extver;
+  }
+}
+
+/**
+ * Divide complex visibility iterator into several iterators.
+ *
+ * The data that would be returned by @a pIter are divided into @a k
+ * contiguous ranges of approximately equal size, and @a iters is
+ * filled with an iterator over each range. Some of these may visit
+ * no data. The iterators are independent, and may be used
+ * concurrently from different threads. Each must be freed using
+ * oi_vis_iter_free().
+ *
+ * @param pIter  Initialised iterator, which must not have been advanced.
+ * @param k      Number of iterators to create.
+ * @param iters  Array of @a k iterator structs to initialise.
+ */
+void oi_vis_iter_split(const oi_vis_iter *pIter, int k, oi_vis_iter iters[])
+{
+  iter_split(pIter, k, iters);
+}
+
+/**
+ * Divide squared visibility iterator into several iterators.
+ *
+ * The data that would be returned by @a pIter are divided into @a k
+ * contiguous ranges of approximately equal size, and @a iters is
+ * filled with an iterator over each range. Some of these may visit
+ * no data. The iterators are independent, and may be used
+ * concurrently from different threads. Each must be freed using
+ * oi_vis2_iter_free().
+ *
+ * @param pIter  Initialised iterator, which must not have been advanced.
+ * @param k      Number of iterators to create.
+ * @param iters  Array of @a k iterator structs to initialise.
+ */
+void oi_vis2_iter_split(const oi_vis2_iter *pIter, int k,
+                        oi_vis2_iter iters[])
+{
+  iter_split(pIter, k, iters);
+}
+
+/**
+ * Divide triple product iterator into several iterators.
+ *
+ * The data that would be returned by @a pIter are divided into @a k
+ * contiguous ranges of approximately equal size, and @a iters is
+ * filled with an iterator over each range. Some of these may visit
+ * no data. The iterators are independent, and may be used
+ * concurrently from different threads. Each must be freed using
+ * oi_t3_iter_free().
+ *
+ * @param pIter  Initialised iterator, which must not have been advanced.
+ * @param k      Number of iterators to create.
+ * @param iters  Array of @a k iterator structs to initialise.
+ */
+void oi_t3_iter_split(const oi_t3_iter *pIter, int k, oi_t3_iter iters[])
+{
+  iter_split(pIter, k, iters);
+}
+
+/**
+ * Divide flux iterator into several iterators.
+ *
+ * The data that would be returned by @a pIter are divided into @a k
+ * contiguous ranges of approximately equal size, and @a iters is
+ * filled with an iterator over each range. Some of these may visit
+ * no data. The iterators are independent, and may be used
+ * concurrently from different threads. Each must be freed using
+ * oi_flux_iter_free().
+ *
+ * @param pIter  Initialised iterator, which must not have been advanced.
+ * @param k      Number of iterators to create.
+ * @param iters  Array of @a k iterator structs to initialise.
+ */
+void oi_flux_iter_split(const oi_flux_iter *pIter, int k,
+                        oi_flux_iter iters[])
+{
+  iter_split(pIter, k, iters);
+}
+
+/**
+ * Divide instrumental polarisation iterator into several iterators.
+ *
+ * The data that would be returned by @a pIter are divided into @a k
+ * contiguous ranges of approximately equal size, and @a iters is
+ * filled with an iterator over each range. Some of these may visit
+ * no data. The iterators are independent, and may be used
+ * concurrently from different threads. Each must be freed using
+ * oi_inspol_iter_free().
+ *
+ * @param pIter  Initialised iterator, which must not have been advanced.
+ * @param k      Number of iterators to create.
+ * @param iters  Array of @a k iterator structs to initialise.
+ */
+void oi_inspol_iter_split(const oi_inspol_iter *pIter, int k,
+                          oi_inspol_iter iters[])
+{
+  iter_split(pIter, k, iters);
+}
+
+/**
+ * Return new array of dimensions of tables in iterator range
+ */
+static GArray *iter_fingerprint(const _oi_iter *pIter)
+{
+  GArray *fingerprint;
+  table_fingerprint fp;
+  GList *link;
+
+  fingerprint = g_array_new(FALSE, FALSE, sizeof(table_fingerprint));
+  for (link = pIter->startLink; link != NULL; link = link->next)
+  {
+    if (pIter->pView != NULL)
+      fp.pTable = ((const oi_table_view *)link->data)->pTable;
+    else
+      fp.pTable = link->data;
+    pIter->pType->size(fp.pTable, &fp.numrec, &fp.nwave);
+    g_array_append_val(fingerprint, fp);
+    if (link == pIter->endLink) break;
+  }
+  return fingerprint;
+}
+
+/**
+ * Do two arrays of table dimensions match?
+ */
+static bool fingerprint_equal(const GArray *fingerprint1,
+                              const GArray *fingerprint2)
+{
+  const table_fingerprint *pFp1, *pFp2;
+  guint i;
+
+  if (fingerprint1->len != fingerprint2->len) return false;
+  for (i = 0; i < fingerprint1->len; i++)
+  {
+    pFp1 = &g_array_index(fingerprint1, table_fingerprint, i);
+    pFp2 = &g_array_index(fingerprint2, table_fingerprint, i);
+    if (pFp1->pTable != pFp2->pTable || pFp1->numrec != pFp2->numrec ||
+        pFp1->nwave != pFp2->nwave)
+      return false;
+  }
+  return true;
+}
 
+/**
+ * Start recording accepted data in mask
+ */
+static void iter_enable_mask(_oi_iter *pIter)
+{
   g_assert(pIter != NULL);
-  g_assert(pIter->pData != NULL);
+  g_assert(pIter->mask == NULL);
+  g_assert_cmpint(pIter->iwave, ==, -1); /* iteration not started */
+
+  pIter->mask = g_array_new(FALSE, FALSE, sizeof(mask_point));
+  pIter->maskTables = g_array_new(FALSE, FALSE, sizeof(mask_table));
+  pIter->fingerprint = iter_fingerprint(pIter);
+  pIter->maskState = MASK_RECORDING;
+  pIter->imask = 0;
+  pIter->replaying = false;
+}
+
+/**
+ * Return iterator to start of its range, and decide whether to
+ * replay the mask or record it afresh
+ */
+static void iter_reset(_oi_iter *pIter)
+{
+  GArray *fingerprint;
 
-  if (!pIter->filter.accept_t3amp && !pIter->filter.accept_t3phi) return false;
+  g_assert(pIter != NULL);
 
-  /* Compile glob-style patterns for efficiency */
-  if (pIter->filter.arrname_pttn == NULL)
-    pIter->filter.arrname_pttn = g_pattern_spec_new(pIter->filter.arrname);
-  if (pIter->filter.insname_pttn == NULL)
-    pIter->filter.insname_pttn = g_pattern_spec_new(pIter->filter.insname);
-  if (pIter->filter.corrname_pttn == NULL)
-    pIter->filter.corrname_pttn = g_pattern_spec_new(pIter->filter.corrname);
+  iter_set_position(pIter, pIter->startLink, pIter->startExtver,
+                    pIter->startView);
+  if (pIter->mask == NULL) return;
 
-  /* Advance to next data point */
-  do
+  fingerprint = iter_fingerprint(pIter);
+  pIter->replaying = (pIter->maskState == MASK_COMPLETE &&
+                      fingerprint_equal(fingerprint, pIter->fingerprint));
+  if (pIter->replaying)
+  {
+    g_array_free(fingerprint, TRUE);
+  }
+  else
   {
-    if (!(NEXT_CHANNEL(pIter, oi_t3) || NEXT_RECORD(pIter, oi_t3) ||
-          NEXT_TABLE(pIter, oi_t3)))
-      goto finally;
-  } while (!(oi_t3_iter_accept_table(pIter) &&
-             oi_t3_iter_accept_record(pIter) &&
-             oi_t3_iter_accept_channel(pIter)));
+    g_array_set_size(pIter->mask, 0);
+    g_array_set_size(pIter->maskTables, 0);
+    g_array_free(pIter->fingerprint, TRUE);
+    pIter->fingerprint = fingerprint;
+    pIter->maskState = MASK_RECORDING;
+  }
+  pIter->imask = 0;
+}
 
-  /* Return new current data point */
-  // TODO: provide access to wavelength or u/lambda, v/lambda
-  ret = true;
-  oi_t3 *pTable = (oi_t3 *)pIter->link->data;
-  if (pExtver != NULL) *pExtver = pIter->extver;
-  if (ppTable != NULL) *ppTable = pTable;
-  if (pIrec != NULL) *pIrec = pIter->irec;
-  if (ppRec != NULL) *ppRec = &pTable->record[pIter->irec];
-  if (pIwave != NULL) *pIwave = pIter->iwave;
+/**
+ * Discard recorded mask at next reset
+ */
+static void iter_invalidate(_oi_iter *pIter)
+{
+  g_assert(pIter != NULL);
 
-finally:
-  /* Free compiled patterns */
-  g_pattern_spec_free(pIter->filter.arrname_pttn);
-  g_pattern_spec_free(pIter->filter.insname_pttn);
-  g_pattern_spec_free(pIter->filter.corrname_pttn);
-  pIter->filter.arrname_pttn = NULL;
-  pIter->filter.insname_pttn = NULL;
-  pIter->filter.corrname_pttn = NULL;
+  if (pIter->mask != NULL) pIter->maskState = MASK_STALE;
+}
+
+/**
+ * Record data accepted by complex visibility iterator for replay.
+ *
+ * During the first complete pass through the data, the accepted
+ * data are recorded. Passes started by oi_vis_iter_reset() after
+ * this replay the recorded data without re-evaluating the filter.
+ *
+ * @param pIter  Initialised iterator, which must not have been advanced.
+ */
+void oi_vis_iter_enable_mask(oi_vis_iter *pIter)
+{
+  iter_enable_mask(pIter);
+}
+
+/**
+ * Return complex visibility iterator to its initial position.
+ *
+ * If the accepted data were recorded in a complete previous pass
+ * (see oi_vis_iter_enable_mask()), and the number and dimensions of
+ * the tables are unchanged, the next pass replays the recorded
+ * data. Otherwise the data are recorded afresh.
+ *
+ * @param pIter  Initialised iterator struct.
+ */
+void oi_vis_iter_reset(oi_vis_iter *pIter)
+{
+  iter_reset(pIter);
+}
+
+/**
+ * Discard data recorded by complex visibility iterator.
+ *
+ * Call this after modifying data values that may affect which data
+ * pass the filter. The data will be recorded afresh after the next
+ * call to oi_vis_iter_reset(). If tables are added to or removed
+ * from the dataset, the iterator must be freed and re-initialised
+ * instead.
+ *
+ * @param pIter  Initialised iterator struct.
+ */
+void oi_vis_iter_invalidate(oi_vis_iter *pIter)
+{
+  iter_invalidate(pIter);
+}
+
+/**
+ * Record data accepted by squared visibility iterator for replay.
+ *
+ * During the first complete pass through the data, the accepted
+ * data are recorded. Passes started by oi_vis2_iter_reset() after
+ * this replay the recorded data without re-evaluating the filter.
+ *
+ * @param pIter  Initialised iterator, which must not have been advanced.
+ */
+void oi_vis2_iter_enable_mask(oi_vis2_iter *pIter)
+{
+  iter_enable_mask(pIter);
+}
+
+/**
+ * Return squared visibility iterator to its initial position.
+ *
+ * If the accepted data were recorded in a complete previous pass
+ * (see oi_vis2_iter_enable_mask()), and the number and dimensions of
+ * the tables are unchanged, the next pass replays the recorded
+ * data. Otherwise the data are recorded afresh.
+ *
+ * @param pIter  Initialised iterator struct.
+ */
+void oi_vis2_iter_reset(oi_vis2_iter *pIter)
+{
+  iter_reset(pIter);
+}
+
+/**
+ * Discard data recorded by squared visibility iterator.
+ *
+ * Call this after modifying data values that may affect which data
+ * pass the filter. The data will be recorded afresh after the next
+ * call to oi_vis2_iter_reset(). If tables are added to or removed
+ * from the dataset, the iterator must be freed and re-initialised
+ * instead.
+ *
+ * @param pIter  Initialised iterator struct.
+ */
+void oi_vis2_iter_invalidate(oi_vis2_iter *pIter)
+{
+  iter_invalidate(pIter);
+}
+
+/**
+ * Record data accepted by triple product iterator for replay.
+ *
+ * During the first complete pass through the data, the accepted
+ * data are recorded. Passes started by oi_t3_iter_reset() after
+ * this replay the recorded data without re-evaluating the filter.
+ *
+ * @param pIter  Initialised iterator, which must not have been advanced.
+ */
+void oi_t3_iter_enable_mask(oi_t3_iter *pIter)
+{
+  iter_enable_mask(pIter);
+}
+
+/**
+ * Return triple product iterator to its initial position.
+ *
+ * If the accepted data were recorded in a complete previous pass
+ * (see oi_t3_iter_enable_mask()), and the number and dimensions of
+ * the tables are unchanged, the next pass replays the recorded
+ * data. Otherwise the data are recorded afresh.
+ *
+ * @param pIter  Initialised iterator struct.
+ */
+void oi_t3_iter_reset(oi_t3_iter *pIter)
+{
+  iter_reset(pIter);
+}
+
+/**
+ * Discard data recorded by triple product iterator.
+ *
+ * Call this after modifying data values that may affect which data
+ * pass the filter. The data will be recorded afresh after the next
+ * call to oi_t3_iter_reset(). If tables are added to or removed
+ * from the dataset, the iterator must be freed and re-initialised
+ * instead.
+ *
+ * @param pIter  Initialised iterator struct.
+ */
+void oi_t3_iter_invalidate(oi_t3_iter *pIter)
+{
+  iter_invalidate(pIter);
+}
+
+/**
+ * Record data accepted by flux iterator for replay.
+ *
+ * During the first complete pass through the data, the accepted
+ * data are recorded. Passes started by oi_flux_iter_reset() after
+ * this replay the recorded data without re-evaluating the filter.
+ *
+ * @param pIter  Initialised iterator, which must not have been advanced.
+ */
+void oi_flux_iter_enable_mask(oi_flux_iter *pIter)
+{
+  iter_enable_mask(pIter);
+}
+
+/**
+ * Return flux iterator to its initial position.
+ *
+ * If the accepted data were recorded in a complete previous pass
+ * (see oi_flux_iter_enable_mask()), and the number and dimensions of
+ * the tables are unchanged, the next pass replays the recorded
+ * data. Otherwise the data are recorded afresh.
+ *
+ * @param pIter  Initialised iterator struct.
+ */
+void oi_flux_iter_reset(oi_flux_iter *pIter)
+{
+  iter_reset(pIter);
+}
+
+/**
+ * Discard data recorded by flux iterator.
+ *
+ * Call this after modifying data values that may affect which data
+ * pass the filter. The data will be recorded afresh after the next
+ * call to oi_flux_iter_reset(). If tables are added to or removed
+ * from the dataset, the iterator must be freed and re-initialised
+ * instead.
+ *
+ * @param pIter  Initialised iterator struct.
+ */
+void oi_flux_iter_invalidate(oi_flux_iter *pIter)
+{
+  iter_invalidate(pIter);
+}
+
+/**
+ * Record data accepted by instrumental polarisation iterator for replay.
+ *
+ * During the first complete pass through the data, the accepted
+ * data are recorded. Passes started by oi_inspol_iter_reset() after
+ * this replay the recorded data without re-evaluating the filter.
+ *
+ * @param pIter  Initialised iterator, which must not have been advanced.
+ */
+void oi_inspol_iter_enable_mask(oi_inspol_iter *pIter)
+{
+  iter_enable_mask(pIter);
+}
+
+/**
+ * Return instrumental polarisation iterator to its initial position.
+ *
+ * If the accepted data were recorded in a complete previous pass
+ * (see oi_inspol_iter_enable_mask()), and the number and dimensions of
+ * the tables are unchanged, the next pass replays the recorded
+ * data. Otherwise the data are recorded afresh.
+ *
+ * @param pIter  Initialised iterator struct.
+ */
+void oi_inspol_iter_reset(oi_inspol_iter *pIter)
+{
+  iter_reset(pIter);
+}
+
+/**
+ * Discard data recorded by instrumental polarisation iterator.
+ *
+ * Call this after modifying data values that may affect which data
+ * pass the filter. The data will be recorded afresh after the next
+ * call to oi_inspol_iter_reset(). If tables are added to or removed
+ * from the dataset, the iterator must be freed and re-initialised
+ * instead.
+ *
+ * @param pIter  Initialised iterator struct.
+ */
+void oi_inspol_iter_invalidate(oi_inspol_iter *pIter)
+{
+  iter_invalidate(pIter);
+}
+
+/**
+ * Free resources used by iterator
+ */
+static void iter_free(_oi_iter *pIter)
+{
+  g_assert(pIter != NULL);
+
+  oi_free(pIter->acceptTable);
+  oi_free(pIter->tableWave);
+  pIter->acceptTable = NULL;
+  pIter->tableWave = NULL;
+  if (pIter->insnameWave != NULL)
+  {
+    g_hash_table_unref(pIter->insnameWave);
+    pIter->insnameWave = NULL;
+  }
+  if (pIter->mask != NULL)
+  {
+    g_array_free(pIter->mask, TRUE);
+    g_array_free(pIter->maskTables, TRUE);
+    g_array_free(pIter->fingerprint, TRUE);
+    pIter->mask = NULL;
+    pIter->maskTables = NULL;
+    pIter->fingerprint = NULL;
+  }
+}
+
+/**
+ * Free resources used by complex visibility iterator.
+ *
+ * The iterator may be re-initialised afterwards.
+ *
+ * @param pIter  Iterator initialised by oi_vis_iter_init() or
+ *               oi_vis_iter_init_view().
+ */
+void oi_vis_iter_free(oi_vis_iter *pIter)
+{
+  iter_free(pIter);
+}
+
+/**
+ * Free resources used by squared visibility iterator.
+ *
+ * The iterator may be re-initialised afterwards.
+ *
+ * @param pIter  Iterator initialised by oi_vis2_iter_init() or
+ *               oi_vis2_iter_init_view().
+ */
+void oi_vis2_iter_free(oi_vis2_iter *pIter)
+{
+  iter_free(pIter);
+}
+
+/**
+ * Free resources used by triple product iterator.
+ *
+ * The iterator may be re-initialised afterwards.
+ *
+ * @param pIter  Iterator initialised by oi_t3_iter_init() or
+ *               oi_t3_iter_init_view().
+ */
+void oi_t3_iter_free(oi_t3_iter *pIter)
+{
+  iter_free(pIter);
+}
+
+/**
+ * Free resources used by flux iterator.
+ *
+ * The iterator may be re-initialised afterwards.
+ *
+ * @param pIter  Iterator initialised by oi_flux_iter_init() or
+ *               oi_flux_iter_init_view().
+ */
+void oi_flux_iter_free(oi_flux_iter *pIter)
+{
+  iter_free(pIter);
+}
 
-  return ret;
+/**
+ * Free resources used by instrumental polarisation iterator.
+ *
+ * The iterator may be re-initialised afterwards.
+ *
+ * @param pIter  Iterator initialised by oi_inspol_iter_init() or
+ *               oi_inspol_iter_init_view().
+ */
+void oi_inspol_iter_free(oi_inspol_iter *pIter)
+{
+  iter_free(pIter);
 }
 
 /**
@@ -576,7 +2050,7 @@ void oi_vis_iter_get_uv(const oi_vis_iter *pIter, double *const pEffWave,
 {
   g_assert(pIter != NULL);
 
-  oi_vis *pTable = (oi_vis *)pIter->link->data;
+  oi_vis *pTable = ITER_TABLE(pIter, oi_vis);
   oi_vis_record *pRec = &pTable->record[pIter->irec];
   double effWave = pIter->pWave->eff_wave[pIter->iwave];
   if (pEffWave != NULL) *pEffWave = effWave;
@@ -598,7 +2072,7 @@ void oi_vis2_iter_get_uv(const oi_vis2_iter *pIter, double *const pEffWave,
 {
   g_assert(pIter != NULL);
 
-  oi_vis2 *pTable = (oi_vis2 *)pIter->link->data;
+  oi_vis2 *pTable = ITER_TABLE(pIter, oi_vis2);
   oi_vis2_record *pRec = &pTable->record[pIter->irec];
   double effWave = pIter->pWave->eff_wave[pIter->iwave];
   if (pEffWave != NULL) *pEffWave = effWave;
@@ -626,7 +2100,7 @@ void oi_t3_iter_get_uv(const oi_t3_iter *pIter, double *const pEffWave,
 {
   g_assert(pIter != NULL);
 
-  oi_t3 *pTable = (oi_t3 *)pIter->link->data;
+  oi_t3 *pTable = ITER_TABLE(pIter, oi_t3);
   oi_t3_record *pRec = &pTable->record[pIter->irec];
   double effWave = pIter->pWave->eff_wave[pIter->iwave];
   if (pEffWave != NULL) *pEffWave = effWave;
@@ -635,3 +2109,213 @@ void oi_t3_iter_get_uv(const oi_t3_iter *pIter, double *const pEffWave,
   if (pU2 != NULL) *pU2 = pRec->u2coord / effWave;
   if (pV2 != NULL) *pV2 = pRec->v2coord / effWave;
 }
+
+/**
+ * Get wavelength for current flux datum.
+ *
+ * @param pIter     Initialised iterator struct.
+ * @param pEffWave  Return location for wavelength /m, or NULL.
+ * @param pEffBand  Return location for bandwidth /m, or NULL.
+ */
+void oi_flux_iter_get_wave(const oi_flux_iter *pIter, double *const pEffWave,
+                           double *const pEffBand)
+{
+  g_assert(pIter != NULL);
+
+  if (pEffWave != NULL) *pEffWave = pIter->pWave->eff_wave[pIter->iwave];
+  if (pEffBand != NULL) *pEffBand = pIter->pWave->eff_band[pIter->iwave];
+}
+
+/**
+ * Get wavelength for current instrumental polarisation datum.
+ *
+ * @param pIter     Initialised iterator struct.
+ * @param pEffWave  Return location for wavelength /m, or NULL.
+ * @param pEffBand  Return location for bandwidth /m, or NULL.
+ */
+void oi_inspol_iter_get_wave(const oi_inspol_iter *pIter,
+                             double *const pEffWave, double *const pEffBand)
+{
+  g_assert(pIter != NULL);
+
+  if (pEffWave != NULL) *pEffWave = pIter->pWave->eff_wave[pIter->iwave];
+  if (pEffBand != NULL) *pEffBand = pIter->pWave->eff_band[pIter->iwave];
+}
+
+/**
+ * Count data visited by iterator, using mask to speed up next pass
+ */
+#define COUNT_DATA(pIter, tabType, pCount)                                     \
+  do                                                                           \
+  {                                                                            \
+    *(pCount) = 0;                                                             \
+    tabType##_iter_enable_mask(pIter);                                         \
+    while (tabType##_iter_next(pIter, NULL, NULL, NULL, NULL, NULL))           \
+      ++*(pCount);                                                             \
+    tabType##_iter_reset(pIter);                                               \
+  } while (0)
+
+/**
+ * Set type of @a n flattened data starting at @a offset
+ */
+static void set_flat_type(oi_flat_data *pFlat, long offset, long n,
+                          oi_flat_type type)
+{
+  long i;
+
+  for (i = 0; i < n; i++)
+    pFlat->type[offset + i] = type;
+}
+
+/**
+ * Allocate aligned arrays for @a num flattened data
+ */
+static void alloc_oi_flat_data(oi_flat_data *pFlat, long num)
+{
+  size_t dblSize, typeSize, intSize;
+  char *pAligned;
+
+  pFlat->num = num;
+  dblSize = ALIGN_SIZE(num * sizeof(double));
+  typeSize = ALIGN_SIZE(num * sizeof(oi_flat_type));
+  intSize = ALIGN_SIZE(num * sizeof(int));
+  pFlat->block = chkmalloc(6 * dblSize + typeSize + intSize + FLAT_ALIGN);
+  pAligned = (char *)(((uintptr_t)pFlat->block + FLAT_ALIGN - 1) /
+                      FLAT_ALIGN * FLAT_ALIGN);
+  pFlat->u1 = (double *)pAligned;
+  pFlat->v1 = (double *)(pAligned + dblSize);
+  pFlat->u2 = (double *)(pAligned + 2 * dblSize);
+  pFlat->v2 = (double *)(pAligned + 3 * dblSize);
+  pFlat->value = (double *)(pAligned + 4 * dblSize);
+  pFlat->err = (double *)(pAligned + 5 * dblSize);
+  pFlat->type = (oi_flat_type *)(pAligned + 6 * dblSize);
+  pFlat->target_id = (int *)(pAligned + 6 * dblSize + typeSize);
+}
+
+/**
+ * Copy all accepted data into aligned contiguous arrays.
+ *
+ * Each complex visibility datum contributes an amplitude and a phase
+ * point. Each triple product datum contributes an amplitude point if
+ * the filter accepts OI_T3 amplitudes, and a phase point if it
+ * accepts OI_T3 phases. The arrays should be freed using
+ * free_oi_flat_data().
+ *
+ * @param pData    OIFITS dataset to export.
+ * @param pFilter  Filter to apply, or NULL.
+ * @param pFlat    Return location for flattened data.
+ */
+void oi_fits_export_flat(const oi_fits *pData, const oi_filter_spec *pFilter,
+                         oi_flat_data *pFlat)
+{
+  oi_vis_iter visIter;
+  oi_vis2_iter vis2Iter;
+  oi_t3_iter t3Iter;
+  long nvis, nvis2, nt3, nt3amp, nt3phi, offset;
+
+  g_assert(pData != NULL);
+  g_assert(pFlat != NULL);
+
+  /* Count accepted data of each type */
+  oi_vis_iter_init(&visIter, pData, pFilter);
+  oi_vis2_iter_init(&vis2Iter, pData, pFilter);
+  oi_t3_iter_init(&t3Iter, pData, pFilter);
+  COUNT_DATA(&visIter, oi_vis, &nvis);
+  COUNT_DATA(&vis2Iter, oi_vis2, &nvis2);
+  COUNT_DATA(&t3Iter, oi_t3, &nt3);
+  nt3amp = t3Iter.filter.accept_t3amp ? nt3 : 0;
+  nt3phi = t3Iter.filter.accept_t3phi ? nt3 : 0;
+
+  alloc_oi_flat_data(pFlat, 2 * nvis + nvis2 + nt3amp + nt3phi);
+  memset(pFlat->u2, 0, pFlat->num * sizeof(double));
+  memset(pFlat->v2, 0, pFlat->num * sizeof(double));
+
+  /* Fill arrays, amplitudes first where data have two observables */
+  offset = 0;
+  if (nvis > 0)
+  {
+    oi_vis_batch batch = {pFlat->value + offset,
+                          pFlat->err + offset,
+                          pFlat->value + offset + nvis,
+                          pFlat->err + offset + nvis,
+                          pFlat->u1 + offset,
+                          pFlat->v1 + offset,
+                          NULL,
+                          pFlat->target_id + offset,
+                          NULL,
+                          NULL,
+                          NULL};
+    oi_vis_iter_next_batch(&visIter, nvis, &batch);
+    memcpy(pFlat->u1 + offset + nvis, pFlat->u1 + offset,
+           nvis * sizeof(double));
+    memcpy(pFlat->v1 + offset + nvis, pFlat->v1 + offset,
+           nvis * sizeof(double));
+    memcpy(pFlat->target_id + offset + nvis, pFlat->target_id + offset,
+           nvis * sizeof(int));
+    set_flat_type(pFlat, offset, nvis, OI_FLAT_VISAMP);
+    set_flat_type(pFlat, offset + nvis, nvis, OI_FLAT_VISPHI);
+    offset += 2 * nvis;
+  }
+  if (nvis2 > 0)
+  {
+    oi_vis2_batch batch = {pFlat->value + offset,
+                           pFlat->err + offset,
+                           pFlat->u1 + offset,
+                           pFlat->v1 + offset,
+                           NULL,
+                           pFlat->target_id + offset,
+                           NULL,
+                           NULL,
+                           NULL};
+    oi_vis2_iter_next_batch(&vis2Iter, nvis2, &batch);
+    set_flat_type(pFlat, offset, nvis2, OI_FLAT_VIS2);
+    offset += nvis2;
+  }
+  if (nt3 > 0)
+  {
+    long phiOffset = offset + nt3amp;
+    oi_t3_batch batch = {nt3amp > 0 ? pFlat->value + offset : NULL,
+                         nt3amp > 0 ? pFlat->err + offset : NULL,
+                         nt3phi > 0 ? pFlat->value + phiOffset : NULL,
+                         nt3phi > 0 ? pFlat->err + phiOffset : NULL,
+                         pFlat->u1 + offset,
+                         pFlat->v1 + offset,
+                         pFlat->u2 + offset,
+                         pFlat->v2 + offset,
+                         NULL,
+                         pFlat->target_id + offset,
+                         NULL,
+                         NULL,
+                         NULL};
+    oi_t3_iter_next_batch(&t3Iter, nt3, &batch);
+    if (nt3amp > 0 && nt3phi > 0)
+    {
+      memcpy(pFlat->u1 + phiOffset, pFlat->u1 + offset, nt3 * sizeof(double));
+      memcpy(pFlat->v1 + phiOffset, pFlat->v1 + offset, nt3 * sizeof(double));
+      memcpy(pFlat->u2 + phiOffset, pFlat->u2 + offset, nt3 * sizeof(double));
+      memcpy(pFlat->v2 + phiOffset, pFlat->v2 + offset, nt3 * sizeof(double));
+      memcpy(pFlat->target_id + phiOffset, pFlat->target_id + offset,
+             nt3 * sizeof(int));
+    }
+    set_flat_type(pFlat, offset, nt3amp, OI_FLAT_T3AMP);
+    set_flat_type(pFlat, phiOffset, nt3phi, OI_FLAT_T3PHI);
+  }
+
+  oi_vis_iter_free(&visIter);
+  oi_vis2_iter_free(&vis2Iter);
+  oi_t3_iter_free(&t3Iter);
+}
+
+/**
+ * Free arrays allocated by oi_fits_export_flat().
+ *
+ * @param pFlat  Flattened data to free.
+ */
+void free_oi_flat_data(oi_flat_data *pFlat)
+{
+  g_assert(pFlat != NULL);
+
+  oi_free(pFlat->block);
+  pFlat->block = NULL;
+  pFlat->num = 0;
+}
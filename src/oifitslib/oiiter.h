@@ -29,8 +29,33 @@
  * This module implements an iterator interface for OIFITS data. This
  * interface allows an application to iterate over all of the data
  * points of a particular type (complex visibilities, squared
- * visibilities, or bispectra) within a file, without explicit
- * iteration over the tables that contain them.
+ * visibilities, bispectra, fluxes or instrumental polarisation)
+ * within a file, without explicit iteration over the tables that
+ * contain them. Iterators of all types share one engine, which
+ * evaluates the table selection criteria of the filter once and the
+ * record selection criteria once per record.
+ *
+ * An iterator is initialised using e.g. oi_vis2_iter_init(), which
+ * applies the table selection criteria of the filter once, and must
+ * be freed using e.g. oi_vis2_iter_free() when no longer needed.
+ *
+ * To avoid the overhead of one function call per datum, use
+ * e.g. oi_vis2_iter_next_batch() to retrieve many data at once into
+ * contiguous arrays.
+ *
+ * A newly-initialised iterator may be divided into several iterators
+ * over disjoint ranges of the data using e.g. oi_vis2_iter_split(),
+ * for instance to process the data on multiple threads.
+ *
+ * Where the same data are iterated over many times, call
+ * e.g. oi_vis2_iter_enable_mask() before the first pass and
+ * oi_vis2_iter_reset() before each subsequent pass. The data accepted
+ * by the filter are recorded during the first pass and replayed
+ * without re-evaluating the filter in later passes.
+ *
+ * oi_fits_export_flat() uses the iterators to copy all accepted
+ * complex visibility, squared visibility and triple product data
+ * into aligned arrays suitable for vectorised model fitting.
  *
  * @{
  */
@@ -39,10 +64,12 @@
 #define OIITER_H
 
 #include "oifile.h"
-#include "oifilter.h" /* oi_filter_spec */
+#include "oifilter.h" /* oi_filter_spec, oi_fits_view */
 
 #include <stdbool.h>
 
+struct _oi_iter_type;
+
 /**
  * Opaque structure representing an iterator that can be used to
  * iterate over data points in an OIFITS dataset.
@@ -50,12 +77,34 @@
 typedef struct
 {
   /** @privatesection */
+  const struct _oi_iter_type *pType; /* Operations for type of table */
   const oi_fits *pData;
+  const oi_fits_view *pView;
   oi_filter_spec filter;
   GList *link;
+  int numTables;             /* Length of table list */
+  char *acceptTable;         /* Does each table in list pass filter? */
+  oi_wavelength **tableWave; /* OI_WAVELENGTH for each table in list */
+  GHashTable *insnameWave;   /* OI_WAVELENGTH for each accepted INSNAME,
+                                if given by each record, else NULL */
+  GList *endLink;            /* Table containing end of range, or NULL */
+  long endView;              /* Index of first record after range */
+  GList *startLink;          /* Table containing start of range */
+  int startExtver;           /* EXTVER of startLink */
+  long startView;            /* Index of first record in range */
+  GArray *mask;              /* Accepted data recorded, or NULL */
+  GArray *maskTables;        /* Tables referenced by mask */
+  GArray *fingerprint;       /* Table dimensions when mask recorded */
+  guint imask;               /* Index of next mask entry to replay */
+  int maskState;             /* Is mask being recorded, complete or stale? */
+  bool replaying;            /* Is current pass replaying mask? */
   oi_wavelength *pWave;
+  const char *useWave; /* Channels selected by view, or NULL */
+  long numrec;         /* Number of records to visit in current table */
+  int nwave;           /* Number of channels in current table */
   int extver;
   long irec;
+  long iview;
   int iwave;
 
 } _oi_iter;
@@ -78,21 +127,227 @@ typedef _oi_iter oi_vis2_iter;
  */
 typedef _oi_iter oi_t3_iter;
 
+/**
+ * Opaque structure representing an iterator that can be used to
+ * iterate over the flux points in an OIFITS dataset.
+ */
+typedef _oi_iter oi_flux_iter;
+
+/**
+ * Opaque structure representing an iterator that can be used to
+ * iterate over the instrumental polarisation points in an OIFITS
+ * dataset.
+ */
+typedef _oi_iter oi_inspol_iter;
+
+/**
+ * Caller-provided arrays to receive a batch of complex visibility
+ * data from oi_vis_iter_next_batch(). Each non-NULL array must have
+ * room for the maximum number of data requested. Set pointers to
+ * NULL for quantities that are not required.
+ */
+typedef struct
+{
+  DATA *visamp;    /**< Visibility amplitude */
+  DATA *visamperr; /**< Error in visibility amplitude */
+  DATA *visphi;    /**< Visibility phase /deg */
+  DATA *visphierr; /**< Error in visibility phase /deg */
+  double *u;       /**< u coordinate /wavelengths */
+  double *v;       /**< v coordinate /wavelengths */
+  double *mjd;     /**< Modified Julian Date */
+  int *target_id;  /**< TARGET_ID */
+  int *extver;     /**< Table EXTVER */
+  long *irec;      /**< Record index */
+  int *iwave;      /**< Channel index */
+
+} oi_vis_batch;
+
+/**
+ * Caller-provided arrays to receive a batch of squared visibility
+ * data from oi_vis2_iter_next_batch(). Each non-NULL array must have
+ * room for the maximum number of data requested. Set pointers to
+ * NULL for quantities that are not required.
+ */
+typedef struct
+{
+  DATA *vis2data; /**< Squared visibility */
+  DATA *vis2err;  /**< Error in squared visibility */
+  double *u;      /**< u coordinate /wavelengths */
+  double *v;      /**< v coordinate /wavelengths */
+  double *mjd;    /**< Modified Julian Date */
+  int *target_id; /**< TARGET_ID */
+  int *extver;    /**< Table EXTVER */
+  long *irec;     /**< Record index */
+  int *iwave;     /**< Channel index */
+
+} oi_vis2_batch;
+
+/**
+ * Caller-provided arrays to receive a batch of triple product data
+ * from oi_t3_iter_next_batch(). Each non-NULL array must have room
+ * for the maximum number of data requested. Set pointers to NULL for
+ * quantities that are not required.
+ */
+typedef struct
+{
+  DATA *t3amp;    /**< Triple product amplitude */
+  DATA *t3amperr; /**< Error in triple product amplitude */
+  DATA *t3phi;    /**< Triple product phase /deg */
+  DATA *t3phierr; /**< Error in triple product phase /deg */
+  double *u1;     /**< Baseline AB u coordinate /wavelengths */
+  double *v1;     /**< Baseline AB v coordinate /wavelengths */
+  double *u2;     /**< Baseline BC u coordinate /wavelengths */
+  double *v2;     /**< Baseline BC v coordinate /wavelengths */
+  double *mjd;    /**< Modified Julian Date */
+  int *target_id; /**< TARGET_ID */
+  int *extver;    /**< Table EXTVER */
+  long *irec;     /**< Record index */
+  int *iwave;     /**< Channel index */
+
+} oi_t3_batch;
+
+/**
+ * Caller-provided arrays to receive a batch of flux data from
+ * oi_flux_iter_next_batch(). Each non-NULL array must have room for
+ * the maximum number of data requested. Set pointers to NULL for
+ * quantities that are not required.
+ */
+typedef struct
+{
+  DATA *fluxdata;   /**< Flux */
+  DATA *fluxerr;    /**< Error in flux */
+  double *eff_wave; /**< Wavelength /m */
+  double *mjd;      /**< Modified Julian Date */
+  int *target_id;   /**< TARGET_ID */
+  int *sta_index;   /**< STA_INDEX, -1 if not specified */
+  int *extver;      /**< Table EXTVER */
+  long *irec;       /**< Record index */
+  int *iwave;       /**< Channel index */
+
+} oi_flux_batch;
+
+/**
+ * Caller-provided arrays to receive a batch of instrumental
+ * polarisation data from oi_inspol_iter_next_batch(). Each non-NULL
+ * array must have room for the maximum number of data
+ * requested. Set pointers to NULL for quantities that are not
+ * required.
+ */
+typedef struct
+{
+  float complex *jxx; /**< Jones matrix element XX */
+  float complex *jyy; /**< Jones matrix element YY */
+  float complex *jxy; /**< Jones matrix element XY */
+  float complex *jyx; /**< Jones matrix element YX */
+  double *eff_wave;   /**< Wavelength /m */
+  double *mjd_obs;    /**< Start of time range /MJD */
+  double *mjd_end;    /**< End of time range /MJD */
+  int *target_id;     /**< TARGET_ID */
+  int *sta_index;     /**< STA_INDEX */
+  int *extver;        /**< Table EXTVER */
+  long *irec;         /**< Record index */
+  int *iwave;         /**< Channel index */
+
+} oi_inspol_batch;
+
+/** Type of observable in flattened data */
+typedef enum
+{
+  OI_FLAT_VISAMP, /**< Visibility amplitude */
+  OI_FLAT_VISPHI, /**< Visibility phase /deg */
+  OI_FLAT_VIS2,   /**< Squared visibility */
+  OI_FLAT_T3AMP,  /**< Triple product amplitude */
+  OI_FLAT_T3PHI   /**< Triple product phase /deg */
+
+} oi_flat_type;
+
+/**
+ * Accepted data flattened into contiguous arrays, each aligned on a
+ * 64-byte boundary. The data are in the order OI_FLAT_VISAMP,
+ * OI_FLAT_VISPHI, OI_FLAT_VIS2, OI_FLAT_T3AMP, OI_FLAT_T3PHI.
+ */
+typedef struct
+{
+  /** @publicsection */
+  long num;             /**< Number of data points */
+  double *u1;           /**< u coordinate /wavelengths (AB for OI_T3) */
+  double *v1;           /**< v coordinate /wavelengths (AB for OI_T3) */
+  double *u2;           /**< BC u coordinate /wavelengths, 0 if not OI_T3 */
+  double *v2;           /**< BC v coordinate /wavelengths, 0 if not OI_T3 */
+  double *value;        /**< Observable */
+  double *err;          /**< Error in observable */
+  oi_flat_type *type;   /**< Type of observable */
+  int *target_id;       /**< TARGET_ID */
+
+  /** @privatesection */
+  void *block;          /**< Unaligned storage for all arrays */
+
+} oi_flat_data;
+
 void oi_vis_iter_init(oi_vis_iter *, const oi_fits *, const oi_filter_spec *);
+void oi_vis_iter_init_view(oi_vis_iter *, const oi_fits_view *);
+void oi_vis_iter_free(oi_vis_iter *);
+void oi_vis_iter_split(const oi_vis_iter *, int, oi_vis_iter[]);
+void oi_vis_iter_enable_mask(oi_vis_iter *);
+void oi_vis_iter_reset(oi_vis_iter *);
+void oi_vis_iter_invalidate(oi_vis_iter *);
 bool oi_vis_iter_next(oi_vis_iter *, int *const, oi_vis **, long *const,
                       oi_vis_record **, int *const);
+long oi_vis_iter_next_batch(oi_vis_iter *, long, oi_vis_batch *);
 void oi_vis_iter_get_uv(const oi_vis_iter *, double *const, double *const,
                         double *const);
 void oi_vis2_iter_init(oi_vis2_iter *, const oi_fits *, const oi_filter_spec *);
+void oi_vis2_iter_init_view(oi_vis2_iter *, const oi_fits_view *);
+void oi_vis2_iter_free(oi_vis2_iter *);
+void oi_vis2_iter_split(const oi_vis2_iter *, int, oi_vis2_iter[]);
+void oi_vis2_iter_enable_mask(oi_vis2_iter *);
+void oi_vis2_iter_reset(oi_vis2_iter *);
+void oi_vis2_iter_invalidate(oi_vis2_iter *);
 bool oi_vis2_iter_next(oi_vis2_iter *, int *const, oi_vis2 **, long *const,
                        oi_vis2_record **, int *const);
+long oi_vis2_iter_next_batch(oi_vis2_iter *, long, oi_vis2_batch *);
 void oi_vis2_iter_get_uv(const oi_vis2_iter *, double *const, double *const,
                          double *const);
 void oi_t3_iter_init(oi_t3_iter *, const oi_fits *, const oi_filter_spec *);
+void oi_t3_iter_init_view(oi_t3_iter *, const oi_fits_view *);
+void oi_t3_iter_free(oi_t3_iter *);
+void oi_t3_iter_split(const oi_t3_iter *, int, oi_t3_iter[]);
+void oi_t3_iter_enable_mask(oi_t3_iter *);
+void oi_t3_iter_reset(oi_t3_iter *);
+void oi_t3_iter_invalidate(oi_t3_iter *);
 bool oi_t3_iter_next(oi_t3_iter *, int *const, oi_t3 **, long *const,
                      oi_t3_record **, int *const);
+long oi_t3_iter_next_batch(oi_t3_iter *, long, oi_t3_batch *);
 void oi_t3_iter_get_uv(const oi_t3_iter *, double *const, double *const,
                        double *const, double *const, double *const);
+void oi_flux_iter_init(oi_flux_iter *, const oi_fits *, const oi_filter_spec *);
+void oi_flux_iter_init_view(oi_flux_iter *, const oi_fits_view *);
+void oi_flux_iter_free(oi_flux_iter *);
+void oi_flux_iter_split(const oi_flux_iter *, int, oi_flux_iter[]);
+void oi_flux_iter_enable_mask(oi_flux_iter *);
+void oi_flux_iter_reset(oi_flux_iter *);
+void oi_flux_iter_invalidate(oi_flux_iter *);
+bool oi_flux_iter_next(oi_flux_iter *, int *const, oi_flux **, long *const,
+                       oi_flux_record **, int *const);
+long oi_flux_iter_next_batch(oi_flux_iter *, long, oi_flux_batch *);
+void oi_flux_iter_get_wave(const oi_flux_iter *, double *const,
+                           double *const);
+void oi_inspol_iter_init(oi_inspol_iter *, const oi_fits *,
+                         const oi_filter_spec *);
+void oi_inspol_iter_init_view(oi_inspol_iter *, const oi_fits_view *);
+void oi_inspol_iter_free(oi_inspol_iter *);
+void oi_inspol_iter_split(const oi_inspol_iter *, int, oi_inspol_iter[]);
+void oi_inspol_iter_enable_mask(oi_inspol_iter *);
+void oi_inspol_iter_reset(oi_inspol_iter *);
+void oi_inspol_iter_invalidate(oi_inspol_iter *);
+bool oi_inspol_iter_next(oi_inspol_iter *, int *const, oi_inspol **,
+                         long *const, oi_inspol_record **, int *const);
+long oi_inspol_iter_next_batch(oi_inspol_iter *, long, oi_inspol_batch *);
+void oi_inspol_iter_get_wave(const oi_inspol_iter *, double *const,
+                             double *const);
+void oi_fits_export_flat(const oi_fits *, const oi_filter_spec *,
+                         oi_flat_data *);
+void free_oi_flat_data(oi_flat_data *);
 
 #endif /* #ifndef OIITER_H */
 
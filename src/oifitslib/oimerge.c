@@ -54,82 +54,367 @@ static element *lookup_element(const oi_array *pArray, int staIndex)
   return NULL;
 }
 
+/** Size of index cell in units of matching tolerance */
+#define INDEX_CELL_FACTOR 100
+
+/** Quantised fingerprint of a table, used as key of table_index */
+typedef struct
+{
+  gint64 cell[3]; /**< Indices of cells containing fingerprint values */
+  int extra;      /**< Additional integer that must match exactly */
+
+} index_key;
+
+/** Table stored in table_index */
+typedef struct
+{
+  int order;    /**< Position of table in output list */
+  void *pTable; /**< Indexed table */
+
+} index_entry;
+
 /**
- * Return pointer to first oi_array in list that contains identical
- * coordinates and station indices to pArray.
+ * Index of tables by quantised fingerprint, so that an incoming table
+ * need only be compared in full with tables that could match it
+ */
+typedef struct
+{
+  GHashTable *hash; /**< GArray of index_entry, indexed by index_key */
+  double tol;       /**< Tolerance for matching fingerprint values */
+  double cellSize;  /**< Size of quantisation cell */
+
+} table_index;
+
+static guint index_key_hash(gconstpointer key)
+{
+  const index_key *pKey = key;
+  guint h;
+  int i;
+
+  h = (guint)pKey->extra;
+  for (i = 0; i < 3; i++)
+    h = 31 * h + (guint)(pKey->cell[i] ^ (pKey->cell[i] >> 32));
+  return h;
+}
+
+static gboolean index_key_equal(gconstpointer key1, gconstpointer key2)
+{
+  const index_key *pKey1 = key1, *pKey2 = key2;
+
+  return (pKey1->extra == pKey2->extra && pKey1->cell[0] == pKey2->cell[0] &&
+          pKey1->cell[1] == pKey2->cell[1] && pKey1->cell[2] == pKey2->cell[2]);
+}
+
+static void free_index_entries(gpointer entries)
+{
+  g_array_free((GArray *)entries, TRUE);
+}
+
+/**
+ * Initialise empty table index, for fingerprint values that match
+ * if they differ by at most @a tol
+ */
+static void init_table_index(table_index *pIndex, double tol)
+{
+  pIndex->hash = g_hash_table_new_full(index_key_hash, index_key_equal, oi_free,
+                                       free_index_entries);
+  pIndex->tol = tol;
+  pIndex->cellSize = INDEX_CELL_FACTOR * tol;
+}
+
+/**
+ * Free storage used by table index
+ */
+static void free_table_index(table_index *pIndex)
+{
+  g_hash_table_destroy(pIndex->hash);
+  pIndex->hash = NULL;
+}
+
+/**
+ * Add table with specified fingerprint to index
+ */
+static void table_index_add(table_index *pIndex, const double values[3],
+                            int extra, int order, void *pTable)
+{
+  index_key key, *pKey;
+  index_entry entry;
+  GArray *entries;
+  int i;
+
+  key.extra = extra;
+  for (i = 0; i < 3; i++)
+    key.cell[i] = (gint64)floor(values[i] / pIndex->cellSize);
+  entries = g_hash_table_lookup(pIndex->hash, &key);
+  if (entries == NULL)
+  {
+    pKey = chkmalloc(sizeof(index_key));
+    *pKey = key;
+    entries = g_array_new(FALSE, FALSE, sizeof(index_entry));
+    g_hash_table_insert(pIndex->hash, pKey, entries);
+  }
+  entry.order = order;
+  entry.pTable = pTable;
+  g_array_append_val(entries, entry);
+}
+
+/** Function comparing two tables in full */
+typedef gboolean (*table_match_func)(const void *, const void *);
+
+/**
+ * Return earliest indexed table that matches @a pTable, or NULL
+ *
+ * Each fingerprint value within the tolerance of one in @a values
+ * lies in the same or an adjacent cell, so at most eight cells are
+ * searched. Only tables in these cells are compared in full.
+ */
+static void *table_index_match(const table_index *pIndex,
+                               const double values[3], int extra,
+                               table_match_func match, const void *pTable)
+{
+  index_key key;
+  const index_entry *pEntry;
+  const GArray *entries;
+  gint64 lo[3], hi[3];
+  void *pBest;
+  int i, bestOrder;
+  guint k;
+
+  for (i = 0; i < 3; i++)
+  {
+    lo[i] = (gint64)floor((values[i] - pIndex->tol) / pIndex->cellSize);
+    hi[i] = (gint64)floor((values[i] + pIndex->tol) / pIndex->cellSize);
+  }
+  pBest = NULL;
+  bestOrder = G_MAXINT;
+  key.extra = extra;
+  for (key.cell[0] = lo[0]; key.cell[0] <= hi[0]; key.cell[0]++)
+  {
+    for (key.cell[1] = lo[1]; key.cell[1] <= hi[1]; key.cell[1]++)
+    {
+      for (key.cell[2] = lo[2]; key.cell[2] <= hi[2]; key.cell[2]++)
+      {
+        entries = g_hash_table_lookup(pIndex->hash, &key);
+        if (entries == NULL) continue;
+        for (k = 0; k < entries->len; k++)
+        {
+          pEntry = &g_array_index(entries, index_entry, k);
+          if (pEntry->order < bestOrder && (*match)(pTable, pEntry->pTable))
+          {
+            pBest = pEntry->pTable;
+            bestOrder = pEntry->order;
+          }
+        }
+      }
+    }
+  }
+  return pBest;
+}
+
+/**
+ * Get fingerprint of array table from coordinates of array centre
+ */
+static void oi_array_fingerprint(const oi_array *pArray, double values[3])
+{
+  values[0] = pArray->arrayx;
+  values[1] = pArray->arrayy;
+  values[2] = pArray->arrayz;
+}
+
+/**
+ * Get fingerprint of wavelength table from first and last wavebands
+ */
+static void oi_wavelength_fingerprint(const oi_wavelength *pWave,
+                                      double values[3])
+{
+  if (pWave->nwave > 0)
+  {
+    values[0] = pWave->eff_wave[0];
+    values[1] = pWave->eff_wave[pWave->nwave - 1];
+    values[2] = pWave->eff_band[0];
+  }
+  else
+  {
+    values[0] = values[1] = values[2] = 0.0;
+  }
+}
+
+/**
+ * Does oi_array @a pCmp contain identical coordinates and station
+ * indices to @a pArray?
  *
  * Coordinates must match for the array centre and all stations in
  * pArray (extra stations are allowed in the matching array
  * table). Array, station and telescope names are ignored.
  */
-static oi_array *match_oi_array(const oi_array *pArray, const GList *list)
+static gboolean oi_array_matches(const void *pTable, const void *pCmpTable)
 {
-  const GList *link;
-  oi_array *pCmp;
+  const oi_array *pArray = pTable, *pCmp = pCmpTable;
   element *pCmpEl;
   const double tol = 1e-10;
   const float ftol = 1e-3;
   int i;
 
-  link = list;
-  while (link != NULL)
-  {
-    pCmp = (oi_array *)link->data;
-    link = link->next; /* follow link now so we can use continue statements */
-
-    if (fabs(pArray->arrayx - pCmp->arrayx) > tol) continue;
-    if (fabs(pArray->arrayy - pCmp->arrayy) > tol) continue;
-    if (fabs(pArray->arrayz - pCmp->arrayz) > tol) continue;
+  if (fabs(pArray->arrayx - pCmp->arrayx) > tol) return FALSE;
+  if (fabs(pArray->arrayy - pCmp->arrayy) > tol) return FALSE;
+  if (fabs(pArray->arrayz - pCmp->arrayz) > tol) return FALSE;
 
-    for (i = 0; i < pArray->nelement; i++)
+  for (i = 0; i < pArray->nelement; i++)
+  {
+    pCmpEl = lookup_element(pCmp, pArray->elem[i].sta_index);
+    if (pCmpEl == NULL) return FALSE;
+    if (fabs(pArray->elem[i].staxyz[0] - pCmpEl->staxyz[0]) > tol)
+      return FALSE;
+    if (fabs(pArray->elem[i].staxyz[1] - pCmpEl->staxyz[1]) > tol)
+      return FALSE;
+    if (fabs(pArray->elem[i].staxyz[2] - pCmpEl->staxyz[2]) > tol)
+      return FALSE;
+    if (fabs(pArray->elem[i].diameter - pCmpEl->diameter) > ftol) return FALSE;
+    if (pArray->revision >= 2 && pCmp->revision >= 2)
     {
-      pCmpEl = lookup_element(pCmp, pArray->elem[i].sta_index);
-      if (pCmpEl == NULL) break;
-      if (fabs(pArray->elem[i].staxyz[0] - pCmpEl->staxyz[0]) > tol) break;
-      if (fabs(pArray->elem[i].staxyz[1] - pCmpEl->staxyz[1]) > tol) break;
-      if (fabs(pArray->elem[i].staxyz[2] - pCmpEl->staxyz[2]) > tol) break;
-      if (fabs(pArray->elem[i].diameter - pCmpEl->diameter) > ftol) break;
-      if (pArray->revision >= 2 && pCmp->revision >= 2)
-      {
-        /* compare FOV in OIFITS v2+ */
-        if (fabs(pArray->elem[i].fov - pCmpEl->fov) > tol) break;
-        if (strcmp(pArray->elem[i].fovtype, pCmpEl->fovtype) != 0) break;
-      }
+      /* compare FOV in OIFITS v2+ */
+      if (fabs(pArray->elem[i].fov - pCmpEl->fov) > tol) return FALSE;
+      if (strcmp(pArray->elem[i].fovtype, pCmpEl->fovtype) != 0) return FALSE;
     }
-    if (i == pArray->nelement) return pCmp; /* all elements match */
   }
-  return NULL;
+  return TRUE; /* all elements match */
 }
 
 /**
- * Return pointer to first oi_wavelength in list that contains
- * identical wavebands (in same order) to pWave.
+ * Does oi_wavelength @a pCmp contain identical wavebands (in same
+ * order) to @a pWave?
  */
-static oi_wavelength *match_oi_wavelength(const oi_wavelength *pWave,
-                                          const GList *list)
+static gboolean oi_wavelength_matches(const void *pTable, const void *pCmpTable)
 {
-  const GList *link;
-  oi_wavelength *pCmp;
+  const oi_wavelength *pWave = pTable, *pCmp = pCmpTable;
   const double tol = 1e-10;
   int i;
 
-  link = list;
-  while (link != NULL)
+  if (pCmp->nwave != pWave->nwave) return FALSE;
+  for (i = 0; i < pWave->nwave; i++)
   {
-    pCmp = (oi_wavelength *)link->data;
-    if (pCmp->nwave == pWave->nwave)
-    {
-      for (i = 0; i < pWave->nwave; i++)
-      {
-        if (fabs(pCmp->eff_wave[i] - pWave->eff_wave[i]) >= tol ||
-            fabs(pCmp->eff_band[i] - pWave->eff_band[i]) >= tol)
-          break;
-      }
-      if (i == pWave->nwave) return pCmp; /* all wavebands match */
-    }
-    link = link->next;
+    if (fabs(pCmp->eff_wave[i] - pWave->eff_wave[i]) >= tol ||
+        fabs(pCmp->eff_band[i] - pWave->eff_band[i]) >= tol)
+      return FALSE;
   }
-  return NULL;
+  return TRUE; /* all wavebands match */
+}
+
+/**
+ * Add output array table to index
+ *
+ * The table is indexed under the STA_INDEX of each of its elements,
+ * and under -1 to match array tables with no elements.
+ */
+static void index_oi_array(table_index *pIndex, oi_array *pArray, int order)
+{
+  double values[3];
+  int i;
+
+  oi_array_fingerprint(pArray, values);
+  table_index_add(pIndex, values, -1, order, pArray);
+  for (i = 0; i < pArray->nelement; i++)
+    table_index_add(pIndex, values, pArray->elem[i].sta_index, order, pArray);
+}
+
+/**
+ * Return pointer to first indexed oi_array that contains identical
+ * coordinates and station indices to pArray.
+ */
+static oi_array *match_oi_array(const oi_array *pArray,
+                                const table_index *pIndex)
+{
+  double values[3];
+  int extra;
+
+  oi_array_fingerprint(pArray, values);
+  /* Any match must contain the first element of pArray */
+  extra = (pArray->nelement > 0) ? pArray->elem[0].sta_index : -1;
+  return table_index_match(pIndex, values, extra, oi_array_matches, pArray);
+}
+
+/**
+ * Return pointer to first indexed oi_wavelength that contains
+ * identical wavebands (in same order) to pWave.
+ */
+static oi_wavelength *match_oi_wavelength(const oi_wavelength *pWave,
+                                          const table_index *pIndex)
+{
+  double values[3];
+
+  oi_wavelength_fingerprint(pWave, values);
+  return table_index_match(pIndex, values, pWave->nwave,
+                           oi_wavelength_matches, pWave);
+}
+
+/** Position of output target, stored in table_index */
+typedef struct
+{
+  double xyz[3];   /**< Unit vector towards RAEP0, DECEP0 */
+  double maxChord; /**< Matching tolerance, as chord length */
+  int targetId;    /**< TARGET_ID in output table */
+  int lastInput;   /**< Index of latest input dataset that refers to
+                        this target */
+
+} target_pos;
+
+/**
+ * Convert angular separation in arcsec to chord length on unit sphere
+ */
+static double sep_to_chord(double sep)
+{
+  return 2.0 * sin(0.5 * sep * G_PI / 180.0 / 3600.0);
+}
+
+/**
+ * Set unit vector and matching tolerance for target position
+ */
+static void init_target_pos(target_pos *pPos, const target *pTarg,
+                            double maxSep)
+{
+  const double deg = G_PI / 180.0;
+
+  pPos->xyz[0] = cos(pTarg->decep0 * deg) * cos(pTarg->raep0 * deg);
+  pPos->xyz[1] = cos(pTarg->decep0 * deg) * sin(pTarg->raep0 * deg);
+  pPos->xyz[2] = sin(pTarg->decep0 * deg);
+  pPos->maxChord = sep_to_chord(maxSep);
+  pPos->targetId = pTarg->target_id;
+}
+
+/**
+ * Return squared chord length between two target positions
+ */
+static double target_pos_chord2(const target_pos *pPos1,
+                                const target_pos *pPos2)
+{
+  double chord2;
+  int i;
+
+  chord2 = 0.0;
+  for (i = 0; i < 3; i++)
+    chord2 += pow(pPos1->xyz[i] - pPos2->xyz[i], 2);
+  return chord2;
+}
+
+/**
+ * Return angular separation in arcsec between two target positions
+ */
+static double target_pos_sep(const target_pos *pPos1, const target_pos *pPos2)
+{
+  return 2.0 * asin(0.5 * sqrt(target_pos_chord2(pPos1, pPos2))) * 180.0 /
+         G_PI * 3600.0;
+}
+
+/**
+ * Is indexed target position @a pCmpTable within tolerance of
+ * @a pTable, and not already used by the same input dataset?
+ */
+static gboolean target_pos_matches(const void *pTable, const void *pCmpTable)
+{
+  const target_pos *pPos = pTable, *pCmpPos = pCmpTable;
+
+  return (pPos->lastInput != pCmpPos->lastInput &&
+          target_pos_chord2(pPos, pCmpPos) <= pPos->maxChord * pPos->maxChord);
 }
 
 /**
@@ -222,25 +507,44 @@ void merge_oi_header(const GList *inList, oi_fits *pOutput)
 /**
  * Copy records for uniquely-named targets into output target table
  *
- * @param inList   linked list of oi_fits structs to merge
- * @param pOutput  pointer to oi_fits struct to write merged data to
+ * If @a maxTargetSep is positive, a target whose name has not been
+ * seen before is also matched by position (RAEP0, DECEP0) to targets
+ * from earlier input datasets, so that targets named differently by
+ * different pipelines are merged. Targets within the same input
+ * dataset are never merged with each other by position. Candidate
+ * matches are found from an index of positions on a grid of cells,
+ * so the cost grows linearly with the number of targets. Each
+ * positional match is reported with g_message().
+ *
+ * @param inList        linked list of oi_fits structs to merge
+ * @param maxTargetSep  if positive, max separation in arcsec of
+ *                      differently-named targets to merge
+ * @param pOutput       pointer to oi_fits struct to write merged data to
  *
  * @return Hash table giving new TARGET_ID indexed by target name
  */
-GHashTable *merge_oi_target(const GList *inList, oi_fits *pOutput)
+GHashTable *merge_oi_target(const GList *inList, double maxTargetSep,
+                            oi_fits *pOutput)
 {
-#define MAX_TARGET 100
   GHashTable *targetIdHash;
   const GList *link;
+  GPtrArray *posArray;
+  table_index posIndex;
   oi_target *pInTab, *pOutTab;
-  int i, *pValue;
+  target_pos pos, *pMatch, *pNewPos;
+  int i, *pValue, maxTarget, input;
 
   pOutTab = &pOutput->targets;
   pOutTab->revision = OI_REVN_V2_TARGET;
   pOutTab->ntarget = 0;
-  pOutTab->targ = chkmalloc(MAX_TARGET * sizeof(target));
-  targetIdHash = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, free);
+  maxTarget = 16;
+  pOutTab->targ = chkmalloc(maxTarget * sizeof(target));
+  targetIdHash = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, oi_free);
+  posArray = g_ptr_array_new_with_free_func(oi_free);
+  if (maxTargetSep > 0.0)
+    init_table_index(&posIndex, sep_to_chord(maxTargetSep));
   link = inList;
+  input = 0;
   while (link != NULL)
   {
     pInTab = &((oi_fits *)link->data)->targets;
@@ -248,20 +552,66 @@ GHashTable *merge_oi_target(const GList *inList, oi_fits *pOutput)
       pOutTab->revision = pInTab->revision;
     for (i = 0; i < pInTab->ntarget; i++)
     {
-      if (!g_hash_table_lookup(targetIdHash, pInTab->targ[i].target))
+      pValue = g_hash_table_lookup(targetIdHash, pInTab->targ[i].target);
+      if (pValue != NULL)
+      {
+        /* Don't alias another target in this input to the same one */
+        if (maxTargetSep > 0.0)
+        {
+          pMatch = g_ptr_array_index(posArray, *pValue - 1);
+          pMatch->lastInput = input;
+        }
+        continue;
+      }
+      pValue = chkmalloc(sizeof(int));
+      if (maxTargetSep > 0.0)
+      {
+        init_target_pos(&pos, &pInTab->targ[i], maxTargetSep);
+        pos.lastInput = input;
+        pMatch = table_index_match(&posIndex, pos.xyz, 0, target_pos_matches,
+                                   &pos);
+        if (pMatch != NULL)
+        {
+          /* Alias this name to matching output target */
+          pMatch->lastInput = input;
+          *pValue = pMatch->targetId;
+          g_hash_table_insert(targetIdHash, pInTab->targ[i].target, pValue);
+          g_message("Target '%s' merged with '%s' (separation %.3g arcsec)",
+                    pInTab->targ[i].target,
+                    pOutTab->targ[pMatch->targetId - 1].target,
+                    target_pos_sep(&pos, pMatch));
+          continue;
+        }
+      }
+      if (pOutTab->ntarget == maxTarget)
+      {
+        maxTarget *= 2;
+        pOutTab->targ = chkrealloc(pOutTab->targ, maxTarget * sizeof(target));
+      }
+      *pValue = ++pOutTab->ntarget;
+      g_hash_table_insert(targetIdHash, pInTab->targ[i].target, pValue);
+      memcpy(&pOutTab->targ[pOutTab->ntarget - 1], &pInTab->targ[i],
+             sizeof(target));
+      pOutTab->targ[pOutTab->ntarget - 1].target_id = pOutTab->ntarget;
+      if (maxTargetSep > 0.0)
       {
-        pValue = chkmalloc(sizeof(int));
-        *pValue = ++pOutTab->ntarget;
-        g_assert_cmpint(pOutTab->ntarget, <, MAX_TARGET);
-        g_hash_table_insert(targetIdHash, pInTab->targ[i].target, pValue);
-        memcpy(&pOutTab->targ[pOutTab->ntarget - 1], &pInTab->targ[i],
-               sizeof(target));
-        pOutTab->targ[pOutTab->ntarget - 1].target_id = pOutTab->ntarget;
+        pNewPos = chkmalloc(sizeof(target_pos));
+        init_target_pos(pNewPos, &pOutTab->targ[pOutTab->ntarget - 1],
+                        maxTargetSep);
+        pNewPos->lastInput = input;
+        g_ptr_array_add(posArray, pNewPos);
+        table_index_add(&posIndex, pNewPos->xyz, 0, pOutTab->ntarget,
+                        pNewPos);
       }
     }
     link = link->next;
+    ++input;
   }
-  pOutTab->targ = realloc(pOutTab->targ, pOutTab->ntarget * sizeof(target));
+  if (maxTargetSep > 0.0) free_table_index(&posIndex);
+  g_ptr_array_free(posArray, TRUE);
+  if (pOutTab->ntarget > 0)
+    pOutTab->targ = chkrealloc(pOutTab->targ,
+                               pOutTab->ntarget * sizeof(target));
   return targetIdHash;
 }
 
@@ -279,11 +629,15 @@ GList *merge_all_oi_array(const GList *inList, oi_fits *pOutput)
   GList *arrnameHashList;
   const GList *arrayList, *ilink, *jlink;
   GHashTable *hash;
+  table_index index;
   oi_array *pInTab, *pOutTab;
   char newName[FLEN_VALUE];
+  oi_timer start;
 
+  start = oi_profile_start();
   arrnameHashList = NULL;
   g_assert(pOutput->arrayList == NULL);
+  init_table_index(&index, 1e-10);
 
   /* Loop over input datasets */
   ilink = inList;
@@ -298,7 +652,7 @@ GList *merge_all_oi_array(const GList *inList, oi_fits *pOutput)
     while (jlink != NULL)
     {
       pInTab = (oi_array *)jlink->data;
-      pOutTab = match_oi_array(pInTab, pOutput->arrayList);
+      pOutTab = match_oi_array(pInTab, &index);
       if (pOutTab == NULL)
       {
         /* Add copy of pInTab to output, changing ARRNAME if it clashes */
@@ -316,13 +670,15 @@ GList *merge_all_oi_array(const GList *inList, oi_fits *pOutput)
         }
         g_hash_table_insert(pOutput->arrayHash, pOutTab->arrname, pOutTab);
         pOutput->arrayList = g_list_append(pOutput->arrayList, pOutTab);
-        ++pOutput->numArray;
+        index_oi_array(&index, pOutTab, pOutput->numArray++);
       }
       g_hash_table_insert(hash, pInTab->arrname, pOutTab->arrname);
       jlink = jlink->next;
     }
     ilink = ilink->next;
   }
+  free_table_index(&index);
+  oi_profile_stop(OI_PHASE_MATCH, start);
   return arrnameHashList;
 }
 
@@ -340,11 +696,16 @@ GList *merge_all_oi_wavelength(const GList *inList, oi_fits *pOutput)
   GList *insnameHashList;
   const GList *waveList, *ilink, *jlink;
   GHashTable *hash;
+  table_index index;
   oi_wavelength *pInTab, *pOutTab;
+  double values[3];
   char newName[FLEN_VALUE];
+  oi_timer start;
 
+  start = oi_profile_start();
   insnameHashList = NULL;
   g_assert(pOutput->wavelengthList == NULL);
+  init_table_index(&index, 1e-10);
 
   /* Loop over input datasets */
   ilink = inList;
@@ -359,7 +720,7 @@ GList *merge_all_oi_wavelength(const GList *inList, oi_fits *pOutput)
     while (jlink != NULL)
     {
       pInTab = (oi_wavelength *)jlink->data;
-      pOutTab = match_oi_wavelength(pInTab, pOutput->wavelengthList);
+      pOutTab = match_oi_wavelength(pInTab, &index);
       if (pOutTab == NULL)
       {
         /* Add copy of pInTab to output, changing INSNAME if it clashes */
@@ -380,13 +741,17 @@ GList *merge_all_oi_wavelength(const GList *inList, oi_fits *pOutput)
         g_hash_table_insert(pOutput->wavelengthHash, pOutTab->insname, pOutTab);
         pOutput->wavelengthList =
             g_list_append(pOutput->wavelengthList, pOutTab);
-        ++pOutput->numWavelength;
+        oi_wavelength_fingerprint(pOutTab, values);
+        table_index_add(&index, values, pOutTab->nwave,
+                        pOutput->numWavelength++, pOutTab);
       }
       g_hash_table_insert(hash, pInTab->insname, pOutTab->insname);
       jlink = jlink->next;
     }
     ilink = ilink->next;
   }
+  free_table_index(&index);
+  oi_profile_stop(OI_PHASE_MATCH, start);
   return insnameHashList;
 }
 
@@ -492,6 +857,86 @@ GList *merge_all_oi_corr(const GList *inList, oi_fits *pOutput)
     }                                                                          \
   } while (0)
 
+/** Mappings used to rewrite cross-references in tables from one input */
+typedef struct
+{
+  const oi_fits *pInput;     /**< input metadata, for TARGET_ID lookup */
+  GHashTable *targetIdHash;  /**< new TARGET_ID indexed by target name */
+  GHashTable *arrnameHash;   /**< new ARRNAME indexed by old */
+  GHashTable *insnameHash;   /**< new INSNAME indexed by old */
+  GHashTable *corrnameHash;  /**< new CORRNAME indexed by old */
+
+} table_remap;
+
+/** Rewrite cross-references in OI_INSPOL table read from input file */
+static void remap_oi_inspol(oi_inspol *pTab, const table_remap *pRemap)
+{
+  int i;
+
+  REPLACE_ARRNAME(pTab, pTab->arrname, pRemap->arrnameHash);
+  REPLACE_TARGET_ID(pTab, pRemap->pInput, pRemap->targetIdHash);
+  for (i = 0; i < pTab->numrec; i++)
+  {
+    g_strlcpy(pTab->record[i].insname,
+              g_hash_table_lookup(pRemap->insnameHash,
+                                  pTab->record[i].insname),
+              FLEN_VALUE);
+  }
+}
+
+/** Rewrite cross-references in OI_VIS table read from input file */
+static void remap_oi_vis(oi_vis *pTab, const table_remap *pRemap)
+{
+  upgrade_oi_vis(pTab);
+  REPLACE_ARRNAME(pTab, pTab->arrname, pRemap->arrnameHash);
+  REPLACE_INSNAME(pTab, pTab->insname, pRemap->insnameHash);
+  REPLACE_CORRNAME(pTab, pTab->corrname, pRemap->corrnameHash);
+  REPLACE_TARGET_ID(pTab, pRemap->pInput, pRemap->targetIdHash);
+}
+
+/** Rewrite cross-references in OI_VIS2 table read from input file */
+static void remap_oi_vis2(oi_vis2 *pTab, const table_remap *pRemap)
+{
+  upgrade_oi_vis2(pTab);
+  REPLACE_ARRNAME(pTab, pTab->arrname, pRemap->arrnameHash);
+  REPLACE_INSNAME(pTab, pTab->insname, pRemap->insnameHash);
+  REPLACE_CORRNAME(pTab, pTab->corrname, pRemap->corrnameHash);
+  REPLACE_TARGET_ID(pTab, pRemap->pInput, pRemap->targetIdHash);
+}
+
+/** Rewrite cross-references in OI_T3 table read from input file */
+static void remap_oi_t3(oi_t3 *pTab, const table_remap *pRemap)
+{
+  upgrade_oi_t3(pTab);
+  REPLACE_ARRNAME(pTab, pTab->arrname, pRemap->arrnameHash);
+  REPLACE_INSNAME(pTab, pTab->insname, pRemap->insnameHash);
+  REPLACE_CORRNAME(pTab, pTab->corrname, pRemap->corrnameHash);
+  REPLACE_TARGET_ID(pTab, pRemap->pInput, pRemap->targetIdHash);
+}
+
+/** Rewrite cross-references in OI_FLUX table read from input file */
+static void remap_oi_flux(oi_flux *pTab, const table_remap *pRemap)
+{
+  REPLACE_ARRNAME(pTab, pTab->arrname, pRemap->arrnameHash);
+  REPLACE_INSNAME(pTab, pTab->insname, pRemap->insnameHash);
+  REPLACE_CORRNAME(pTab, pTab->corrname, pRemap->corrnameHash);
+  REPLACE_TARGET_ID(pTab, pRemap->pInput, pRemap->targetIdHash);
+}
+
+/** Free list of hash tables returned by merge_all_oi_array() etc. */
+static void free_hash_list(GList *hashList)
+{
+  GList *link;
+
+  link = hashList;
+  while (link != NULL)
+  {
+    g_hash_table_destroy((GHashTable *)link->data);
+    link = link->next;
+  }
+  g_list_free(hashList);
+}
+
 /**
  * Copy all input OI_INSPOL tables into output dataset.
  *
@@ -785,6 +1230,9 @@ void merge_all_oi_flux(const GList *inList, GHashTable *targetIdHash,
 /**
  * Merge list of oi_fits structs into single dataset.
  *
+ * Targets are merged by name only. Use merge_oi_fits_list_threaded()
+ * to also merge targets by position.
+ *
  * The output dataset is always OIFITS v2.
  *
  * @param inList   linked list of oi_fits structs to merge
@@ -793,11 +1241,11 @@ void merge_all_oi_flux(const GList *inList, GHashTable *targetIdHash,
 void merge_oi_fits_list(const GList *inList, oi_fits *pOutput)
 {
   GHashTable *targetIdHash;
-  GList *arrnameHashList, *insnameHashList, *corrnameHashList, *link;
+  GList *arrnameHashList, *insnameHashList, *corrnameHashList;
 
   init_oi_fits(pOutput);
   merge_oi_header(inList, pOutput);
-  targetIdHash = merge_oi_target(inList, pOutput);
+  targetIdHash = merge_oi_target(inList, 0.0, pOutput);
   arrnameHashList = merge_all_oi_array(inList, pOutput);
   insnameHashList = merge_all_oi_wavelength(inList, pOutput);
   corrnameHashList = merge_all_oi_corr(inList, pOutput);
@@ -813,57 +1261,1114 @@ void merge_oi_fits_list(const GList *inList, oi_fits *pOutput)
                     corrnameHashList, pOutput);
 
   g_hash_table_destroy(targetIdHash);
-  link = arrnameHashList;
-  while (link != NULL)
-  {
-    g_hash_table_destroy((GHashTable *)link->data);
-    link = link->next;
-  }
-  g_list_free(arrnameHashList);
-  link = insnameHashList;
-  while (link != NULL)
-  {
-    g_hash_table_destroy((GHashTable *)link->data);
-    link = link->next;
-  }
-  g_list_free(insnameHashList);
-  link = corrnameHashList;
-  while (link != NULL)
-  {
-    g_hash_table_destroy((GHashTable *)link->data);
-    link = link->next;
-  }
-  g_list_free(corrnameHashList);
+  free_hash_list(arrnameHashList);
+  free_hash_list(insnameHashList);
+  free_hash_list(corrnameHashList);
 }
 
+/** Move list of tables from input to output, rewriting cross-references */
+#define STEAL_OI_LIST(pInput, pOutput, type, list, num, remap_func, pRemap)   \
+  do                                                                           \
+  {                                                                            \
+    GList *link;                                                               \
+    for (link = (pInput)->list; link != NULL; link = link->next)               \
+      remap_func((type *)link->data, pRemap);                                  \
+    (pOutput)->list = g_list_concat((pOutput)->list, (pInput)->list);          \
+    (pOutput)->num += (pInput)->num;                                           \
+    (pInput)->list = NULL;                                                     \
+    (pInput)->num = 0;                                                         \
+  } while (0)
+
 /**
- * Merge supplied oi_fits structs into single dataset.
+ * Merge list of oi_fits structs into single dataset, moving data
+ * tables from the inputs to the output.
+ *
+ * Equivalent to merge_oi_fits_list(), except that the OI_INSPOL and
+ * data tables are transferred to the output rather than copied. Their
+ * ARRNAME, INSNAME, CORRNAME and TARGET_ID values are rewritten in
+ * place. On return each input dataset retains its header and
+ * metadata tables but has no OI_INSPOL or data tables, and may still
+ * be passed to free_oi_fits().
  *
  * The output dataset is always OIFITS v2.
  *
- * @param pOutput  pointer to oi_fits struct to write merged data to
- * @param pInput1  pointer to first oi_fits struct to merge
- * @param pInput2  pointer to second oi_fits struct to merge,
- *                 followed by pointers to any further structs to merge,
- *                 followed by NULL
+ * @param inList        linked list of oi_fits structs to merge
+ * @param maxTargetSep  if positive, max separation in arcsec of
+ *                      differently-named targets to merge, see
+ *                      merge_oi_target()
+ * @param pOutput       pointer to oi_fits struct to write merged data to
  */
-void merge_oi_fits(oi_fits *pOutput, oi_fits *pInput1, oi_fits *pInput2, ...)
+void merge_oi_fits_list_steal(const GList *inList, double maxTargetSep,
+                              oi_fits *pOutput)
 {
-  GList *inList;
-  va_list ap;
+  GHashTable *targetIdHash;
+  GList *arrnameHashList, *insnameHashList, *corrnameHashList;
+  const GList *ilink, *arrHashLink, *insHashLink, *corrHashLink;
   oi_fits *pInput;
+  table_remap remap;
 
-  inList = NULL;
-  inList = g_list_append(inList, pInput1);
-  inList = g_list_append(inList, pInput2);
-  va_start(ap, pInput2);
-  pInput = va_arg(ap, oi_fits *);
-  while (pInput != NULL)
+  init_oi_fits(pOutput);
+  merge_oi_header(inList, pOutput);
+  targetIdHash = merge_oi_target(inList, maxTargetSep, pOutput);
+  arrnameHashList = merge_all_oi_array(inList, pOutput);
+  insnameHashList = merge_all_oi_wavelength(inList, pOutput);
+  corrnameHashList = merge_all_oi_corr(inList, pOutput);
+
+  /* Loop over input datasets */
+  remap.targetIdHash = targetIdHash;
+  ilink = inList;
+  arrHashLink = arrnameHashList;
+  insHashLink = insnameHashList;
+  corrHashLink = corrnameHashList;
+  while (ilink != NULL)
   {
-    inList = g_list_append(inList, pInput);
-    pInput = va_arg(ap, oi_fits *);
-  }
-  va_end(ap);
-  merge_oi_fits_list(inList, pOutput);
-  g_list_free(inList);
+    pInput = (oi_fits *)ilink->data;
+    remap.pInput = pInput;
+    remap.arrnameHash = (GHashTable *)arrHashLink->data;
+    remap.insnameHash = (GHashTable *)insHashLink->data;
+    remap.corrnameHash = (GHashTable *)corrHashLink->data;
+    STEAL_OI_LIST(pInput, pOutput, oi_inspol, inspolList, numInspol,
+                  remap_oi_inspol, &remap);
+    STEAL_OI_LIST(pInput, pOutput, oi_vis, visList, numVis, remap_oi_vis,
+                  &remap);
+    STEAL_OI_LIST(pInput, pOutput, oi_vis2, vis2List, numVis2, remap_oi_vis2,
+                  &remap);
+    STEAL_OI_LIST(pInput, pOutput, oi_t3, t3List, numT3, remap_oi_t3, &remap);
+    STEAL_OI_LIST(pInput, pOutput, oi_flux, fluxList, numFlux, remap_oi_flux,
+                  &remap);
+    /* Input hash tables are keyed by names in the moved data tables */
+    g_hash_table_remove_all(pInput->arrayHash);
+    g_hash_table_remove_all(pInput->wavelengthHash);
+    g_hash_table_remove_all(pInput->corrHash);
+    ilink = ilink->next;
+    arrHashLink = arrHashLink->next;
+    insHashLink = insHashLink->next;
+    corrHashLink = corrHashLink->next;
+  }
+
+  g_hash_table_destroy(targetIdHash);
+  free_hash_list(arrnameHashList);
+  free_hash_list(insnameHashList);
+  free_hash_list(corrnameHashList);
+}
+
+/** Function to copy one table and rewrite its cross-references */
+typedef void *(*copy_remap_func)(const void *, const table_remap *);
+
+/** Copy OI_INSPOL table and rewrite its cross-references */
+static void *copy_remap_oi_inspol(const void *pTab, const table_remap *pRemap)
+{
+  oi_inspol *pOutTab = dup_oi_inspol(pTab);
+  remap_oi_inspol(pOutTab, pRemap);
+  return pOutTab;
+}
+
+/** Copy OI_VIS table and rewrite its cross-references */
+static void *copy_remap_oi_vis(const void *pTab, const table_remap *pRemap)
+{
+  oi_vis *pOutTab = dup_oi_vis(pTab);
+  remap_oi_vis(pOutTab, pRemap);
+  return pOutTab;
+}
+
+/** Copy OI_VIS2 table and rewrite its cross-references */
+static void *copy_remap_oi_vis2(const void *pTab, const table_remap *pRemap)
+{
+  oi_vis2 *pOutTab = dup_oi_vis2(pTab);
+  remap_oi_vis2(pOutTab, pRemap);
+  return pOutTab;
+}
+
+/** Copy OI_T3 table and rewrite its cross-references */
+static void *copy_remap_oi_t3(const void *pTab, const table_remap *pRemap)
+{
+  oi_t3 *pOutTab = dup_oi_t3(pTab);
+  remap_oi_t3(pOutTab, pRemap);
+  return pOutTab;
+}
+
+/** Copy OI_FLUX table and rewrite its cross-references */
+static void *copy_remap_oi_flux(const void *pTab, const table_remap *pRemap)
+{
+  oi_flux *pOutTab = dup_oi_flux(pTab);
+  remap_oi_flux(pOutTab, pRemap);
+  return pOutTab;
+}
+
+/** Location of one list of tables in oi_fits, and how to copy them */
+typedef struct
+{
+  glong listOffset; /**< offset of GList * member in oi_fits */
+  glong numOffset;  /**< offset of int member counting tables */
+  copy_remap_func copyFunc;
+
+} copy_list_type;
+
+/** Lists copied by merge_oi_fits_list_threaded(), in output order */
+static const copy_list_type copyListTypes[] = {
+    {G_STRUCT_OFFSET(oi_fits, inspolList), G_STRUCT_OFFSET(oi_fits, numInspol),
+     copy_remap_oi_inspol},
+    {G_STRUCT_OFFSET(oi_fits, visList), G_STRUCT_OFFSET(oi_fits, numVis),
+     copy_remap_oi_vis},
+    {G_STRUCT_OFFSET(oi_fits, vis2List), G_STRUCT_OFFSET(oi_fits, numVis2),
+     copy_remap_oi_vis2},
+    {G_STRUCT_OFFSET(oi_fits, t3List), G_STRUCT_OFFSET(oi_fits, numT3),
+     copy_remap_oi_t3},
+    {G_STRUCT_OFFSET(oi_fits, fluxList), G_STRUCT_OFFSET(oi_fits, numFlux),
+     copy_remap_oi_flux}};
+
+/** One table to be copied by copy_table_worker() */
+typedef struct
+{
+  const copy_list_type *pType;
+  const void *pInTab;
+  const table_remap *pRemap;
+  void *pOutTab;
+
+} copy_job;
+
+/** GThreadPool worker function to copy and remap one table */
+static void copy_table_worker(gpointer data, gpointer userData)
+{
+  copy_job *pJob = data;
+
+  oi_set_context(userData); /* pool threads don't inherit caller's context */
+  pJob->pOutTab = (*pJob->pType->copyFunc)(pJob->pInTab, pJob->pRemap);
+}
+
+/**
+ * Merge list of oi_fits structs into single dataset, copying and
+ * remapping tables in parallel.
+ *
+ * Equivalent to merge_oi_fits_list(), except that the OI_INSPOL and
+ * data tables are copied and have their cross-references rewritten
+ * by up to @a njobs concurrent threads. If @a maxTargetSep is zero,
+ * the output is identical to that from merge_oi_fits_list(),
+ * including the order of tables.
+ *
+ * The output dataset is always OIFITS v2.
+ *
+ * @param inList        linked list of oi_fits structs to merge
+ * @param njobs         maximum number of tables to copy concurrently
+ * @param maxTargetSep  if positive, max separation in arcsec of
+ *                      differently-named targets to merge, see
+ *                      merge_oi_target()
+ * @param pOutput       pointer to oi_fits struct to write merged data to
+ */
+void merge_oi_fits_list_threaded(const GList *inList, int njobs,
+                                 double maxTargetSep, oi_fits *pOutput)
+{
+  GHashTable *targetIdHash;
+  GList *arrnameHashList, *insnameHashList, *corrnameHashList;
+  const GList *ilink, *arrHashLink, *insHashLink, *corrHashLink, *jlink;
+  GThreadPool *pool;
+  GArray *jobs;
+  table_remap *remaps;
+  copy_job job, *pJob;
+  const oi_fits *pInput;
+  guint i;
+  int itype, iin, numIn;
+
+  init_oi_fits(pOutput);
+  merge_oi_header(inList, pOutput);
+  targetIdHash = merge_oi_target(inList, maxTargetSep, pOutput);
+  arrnameHashList = merge_all_oi_array(inList, pOutput);
+  insnameHashList = merge_all_oi_wavelength(inList, pOutput);
+  corrnameHashList = merge_all_oi_corr(inList, pOutput);
+
+  /* Collect cross-reference mappings for each input dataset */
+  numIn = g_list_length((GList *)inList);
+  remaps = chkmalloc(MAX(numIn, 1) * sizeof(table_remap));
+  ilink = inList;
+  arrHashLink = arrnameHashList;
+  insHashLink = insnameHashList;
+  corrHashLink = corrnameHashList;
+  for (iin = 0; iin < numIn; iin++)
+  {
+    remaps[iin].pInput = (oi_fits *)ilink->data;
+    remaps[iin].targetIdHash = targetIdHash;
+    remaps[iin].arrnameHash = (GHashTable *)arrHashLink->data;
+    remaps[iin].insnameHash = (GHashTable *)insHashLink->data;
+    remaps[iin].corrnameHash = (GHashTable *)corrHashLink->data;
+    ilink = ilink->next;
+    arrHashLink = arrHashLink->next;
+    insHashLink = insHashLink->next;
+    corrHashLink = corrHashLink->next;
+  }
+
+  /* Make list of tables to copy, in output order */
+  jobs = g_array_new(FALSE, FALSE, sizeof(copy_job));
+  for (itype = 0; itype < G_N_ELEMENTS(copyListTypes); itype++)
+  {
+    for (iin = 0, ilink = inList; ilink != NULL; iin++, ilink = ilink->next)
+    {
+      pInput = ilink->data;
+      jlink = G_STRUCT_MEMBER(GList *, pInput, copyListTypes[itype].listOffset);
+      for (; jlink != NULL; jlink = jlink->next)
+      {
+        job.pType = &copyListTypes[itype];
+        job.pInTab = jlink->data;
+        job.pRemap = &remaps[iin];
+        job.pOutTab = NULL;
+        g_array_append_val(jobs, job);
+      }
+    }
+  }
+
+  /* Copy tables, concurrently if more than one job requested */
+  if (njobs > 1 && jobs->len > 1)
+  {
+    pool = g_thread_pool_new(copy_table_worker, (gpointer)oi_get_context(),
+                             njobs, TRUE, NULL);
+    for (i = 0; i < jobs->len; i++)
+      g_thread_pool_push(pool, &g_array_index(jobs, copy_job, i), NULL);
+    g_thread_pool_free(pool, FALSE, TRUE); /* wait for all copies */
+  }
+  else
+  {
+    for (i = 0; i < jobs->len; i++)
+      copy_table_worker(&g_array_index(jobs, copy_job, i), NULL);
+  }
+
+  /* Append copies to output in order */
+  for (i = 0; i < jobs->len; i++)
+  {
+    pJob = &g_array_index(jobs, copy_job, i);
+    G_STRUCT_MEMBER(GList *, pOutput, pJob->pType->listOffset) =
+        g_list_append(
+            G_STRUCT_MEMBER(GList *, pOutput, pJob->pType->listOffset),
+            pJob->pOutTab);
+    ++G_STRUCT_MEMBER(int, pOutput, pJob->pType->numOffset);
+  }
+
+  g_array_free(jobs, TRUE);
+  oi_free(remaps);
+  g_hash_table_destroy(targetIdHash);
+  free_hash_list(arrnameHashList);
+  free_hash_list(insnameHashList);
+  free_hash_list(corrnameHashList);
+}
+
+/**
+ * Merge supplied oi_fits structs into single dataset.
+ *
+ * The output dataset is always OIFITS v2.
+ *
+ * @param pOutput  pointer to oi_fits struct to write merged data to
+ * @param pInput1  pointer to first oi_fits struct to merge
+ * @param pInput2  pointer to second oi_fits struct to merge,
+ *                 followed by pointers to any further structs to merge,
+ *                 followed by NULL
+ */
+void merge_oi_fits(oi_fits *pOutput, oi_fits *pInput1, oi_fits *pInput2, ...)
+{
+  GList *inList;
+  va_list ap;
+  oi_fits *pInput;
+
+  inList = NULL;
+  inList = g_list_append(inList, pInput1);
+  inList = g_list_append(inList, pInput2);
+  va_start(ap, pInput2);
+  pInput = va_arg(ap, oi_fits *);
+  while (pInput != NULL)
+  {
+    inList = g_list_append(inList, pInput);
+    pInput = va_arg(ap, oi_fits *);
+  }
+  va_end(ap);
+  merge_oi_fits_list(inList, pOutput);
+  g_list_free(inList);
+}
+
+/**
+ * Copy all tables of one type from input to output FITS file, one
+ * table at a time, rewriting cross-references. Bad input tables are
+ * skipped, as in read_oi_fits().
+ */
+#define STREAM_OI_TABLES(inFptr, outFptr, type, extname, read_next_func,       \
+                         remap_func, write_func, free_func, pRemap, pExtver,   \
+                         pStatus)                                              \
+  do                                                                           \
+  {                                                                            \
+    type tab;                                                                  \
+    int hdutype;                                                               \
+    fits_movabs_hdu(inFptr, 1, &hdutype, pStatus); /* back to start */         \
+    while (!*(pStatus))                                                        \
+    {                                                                          \
+      if (read_next_func(inFptr, &tab, pStatus))                               \
+      {                                                                        \
+        if (*(pStatus) == END_OF_FILE)                                         \
+        {                                                                      \
+          *(pStatus) = 0;                                                      \
+          break; /* no more tables of this type */                            \
+        }                                                                      \
+        oi_report_bad_table(extname, *(pStatus));                              \
+        *(pStatus) = 0;                                                        \
+        continue;                                                              \
+      }                                                                        \
+      remap_func(&tab, pRemap);                                                \
+      write_func(outFptr, tab, (*(pExtver))++, pStatus);                       \
+      free_func(&tab);                                                         \
+    }                                                                          \
+  } while (0)
+
+/** Next EXTVER for each type of table streamed to output */
+typedef struct
+{
+  int inspol;
+  int vis;
+  int vis2;
+  int t3;
+  int flux;
+
+} stream_extver;
+
+/** Write list of tables to FITS file, numbering from *pExtver */
+#define WRITE_OI_LIST(fptr, list, type, write_func, pExtver, pStatus)         \
+  do                                                                           \
+  {                                                                            \
+    GList *link;                                                               \
+    for (link = (list); link != NULL; link = link->next)                       \
+      write_func(fptr, *((type *)link->data), (*(pExtver))++, pStatus);        \
+  } while (0)
+
+/**
+ * Stream OI_INSPOL and data tables from one input file to output,
+ * one table at a time.
+ */
+static STATUS stream_data_tables(const char *filename,
+                                 const table_remap *pRemap, fitsfile *outFptr,
+                                 stream_extver *pExtver, STATUS *pStatus)
+{
+  fitsfile *inFptr;
+
+  fits_open_file(&inFptr, filename, READONLY, pStatus);
+  if (*pStatus) return *pStatus;
+  STREAM_OI_TABLES(inFptr, outFptr, oi_inspol, "OI_INSPOL",
+                   read_next_oi_inspol, remap_oi_inspol, write_oi_inspol,
+                   free_oi_inspol, pRemap, &pExtver->inspol, pStatus);
+  STREAM_OI_TABLES(inFptr, outFptr, oi_vis, "OI_VIS", read_next_oi_vis,
+                   remap_oi_vis, write_oi_vis, free_oi_vis, pRemap,
+                   &pExtver->vis, pStatus);
+  STREAM_OI_TABLES(inFptr, outFptr, oi_vis2, "OI_VIS2", read_next_oi_vis2,
+                   remap_oi_vis2, write_oi_vis2, free_oi_vis2, pRemap,
+                   &pExtver->vis2, pStatus);
+  STREAM_OI_TABLES(inFptr, outFptr, oi_t3, "OI_T3", read_next_oi_t3,
+                   remap_oi_t3, write_oi_t3, free_oi_t3, pRemap, &pExtver->t3,
+                   pStatus);
+  STREAM_OI_TABLES(inFptr, outFptr, oi_flux, "OI_FLUX", read_next_oi_flux,
+                   remap_oi_flux, write_oi_flux, free_oi_flux, pRemap,
+                   &pExtver->flux, pStatus);
+  fits_close_file(inFptr, pStatus);
+  return *pStatus;
+}
+
+/** OI_INSPOL and data tables loaded from one input file */
+typedef struct
+{
+  const char *filename;
+  const table_remap *pRemap;
+  oi_fits data;    /**< remapped tables, valid if done and status is zero */
+  STATUS status;
+  gboolean done;
+  GMutex *pLock;   /**< protects done */
+  GCond *pDone;    /**< signalled when done is set */
+
+} load_slot;
+
+/** GThreadPool worker function to load and remap tables from one file */
+static void load_data_worker(gpointer data, gpointer userData)
+{
+  load_slot *pSlot = data;
+  oi_fits input;
+
+  oi_set_context(userData); /* pool threads don't inherit caller's context */
+  pSlot->status = 0;
+  if (!read_oi_fits(pSlot->filename, &input, &pSlot->status))
+  {
+    init_oi_fits(&pSlot->data);
+    STEAL_OI_LIST(&input, &pSlot->data, oi_inspol, inspolList, numInspol,
+                  remap_oi_inspol, pSlot->pRemap);
+    STEAL_OI_LIST(&input, &pSlot->data, oi_vis, visList, numVis,
+                  remap_oi_vis, pSlot->pRemap);
+    STEAL_OI_LIST(&input, &pSlot->data, oi_vis2, vis2List, numVis2,
+                  remap_oi_vis2, pSlot->pRemap);
+    STEAL_OI_LIST(&input, &pSlot->data, oi_t3, t3List, numT3, remap_oi_t3,
+                  pSlot->pRemap);
+    STEAL_OI_LIST(&input, &pSlot->data, oi_flux, fluxList, numFlux,
+                  remap_oi_flux, pSlot->pRemap);
+    free_oi_fits(&input);
+  }
+  g_mutex_lock(pSlot->pLock);
+  pSlot->done = TRUE;
+  g_cond_broadcast(pSlot->pDone);
+  g_mutex_unlock(pSlot->pLock);
+}
+
+/**
+ * Copy OI_INSPOL and data tables from input files to output, loading
+ * and remapping up to @a njobs files concurrently.
+ *
+ * Tables are written in the same order as by stream_data_tables().
+ * At most @a njobs input files are held in memory at once.
+ */
+static STATUS load_data_tables(const GList *filenameList,
+                               const table_remap *remaps, int njobs,
+                               fitsfile *outFptr, stream_extver *pExtver,
+                               STATUS *pStatus)
+{
+  GThreadPool *pool;
+  GMutex lock;
+  GCond done;
+  load_slot *slots;
+  const GList *link;
+  int i, j, num;
+
+  num = g_list_length((GList *)filenameList);
+  if (num == 0) return *pStatus;
+  g_mutex_init(&lock);
+  g_cond_init(&done);
+  slots = chkmalloc(num * sizeof(load_slot));
+  for (i = 0, link = filenameList; link != NULL; i++, link = link->next)
+  {
+    slots[i].filename = link->data;
+    slots[i].pRemap = &remaps[i];
+    slots[i].status = 0;
+    slots[i].done = FALSE;
+    slots[i].pLock = &lock;
+    slots[i].pDone = &done;
+  }
+
+  /* Keep up to njobs files loading ahead of the writer */
+  pool = g_thread_pool_new(load_data_worker, (gpointer)oi_get_context(), njobs,
+                           TRUE, NULL);
+  for (i = 0; i < MIN(njobs, num); i++)
+    g_thread_pool_push(pool, &slots[i], NULL);
+  for (i = 0; i < num; i++)
+  {
+    g_mutex_lock(&lock);
+    while (!slots[i].done)
+      g_cond_wait(&done, &lock);
+    g_mutex_unlock(&lock);
+    *pStatus = slots[i].status;
+    if (*pStatus) break;
+    WRITE_OI_LIST(outFptr, slots[i].data.inspolList, oi_inspol,
+                  write_oi_inspol, &pExtver->inspol, pStatus);
+    WRITE_OI_LIST(outFptr, slots[i].data.visList, oi_vis, write_oi_vis,
+                  &pExtver->vis, pStatus);
+    WRITE_OI_LIST(outFptr, slots[i].data.vis2List, oi_vis2, write_oi_vis2,
+                  &pExtver->vis2, pStatus);
+    WRITE_OI_LIST(outFptr, slots[i].data.t3List, oi_t3, write_oi_t3,
+                  &pExtver->t3, pStatus);
+    WRITE_OI_LIST(outFptr, slots[i].data.fluxList, oi_flux, write_oi_flux,
+                  &pExtver->flux, pStatus);
+    free_oi_fits(&slots[i].data);
+    if (*pStatus) break;
+    if (i + njobs < num) g_thread_pool_push(pool, &slots[i + njobs], NULL);
+  }
+  g_thread_pool_free(pool, FALSE, TRUE); /* wait for loads in progress */
+
+  /* Discard files loaded ahead of an error */
+  for (j = i + 1; j < num; j++)
+  {
+    if (slots[j].done && !slots[j].status) free_oi_fits(&slots[j].data);
+  }
+  oi_free(slots);
+  g_cond_clear(&done);
+  g_mutex_clear(&lock);
+  return *pStatus;
+}
+
+/**
+ * Merge list of OIFITS files into a new file, in bounded memory.
+ *
+ * The merge is done in two phases. First the primary header and the
+ * OI_TARGET, OI_ARRAY, OI_WAVELENGTH and OI_CORR tables are read from
+ * every input file and merged, exactly as merge_oi_fits_list() does.
+ * Then the OI_INSPOL and data tables are streamed from each input
+ * file in turn to the output file, one table at a time, rewriting
+ * ARRNAME, INSNAME, CORRNAME and TARGET_ID. With @a njobs equal to
+ * one, peak memory use is therefore set by the metadata plus the
+ * largest single table, rather than by the total size of the inputs.
+ *
+ * If @a njobs is greater than one, the input files are read by up
+ * to @a njobs concurrent threads in both phases, and in the second
+ * phase up to @a njobs whole input files are held in memory, so peak
+ * memory use is instead set by the metadata plus the @a njobs
+ * largest input files. If CFITSIO was built without thread support,
+ * @a njobs is treated as one. The output file is identical whatever
+ * the value of @a njobs.
+ *
+ * The output file is always OIFITS v2, and contains the same tables
+ * as would be written by merge_oi_fits_list_threaded() with the same
+ * @a maxTargetSep followed by write_oi_fits(), although the data
+ * tables may appear in a different order.
+ *
+ * @param filenameList  linked list of names of files to merge
+ * @param njobs         maximum number of input files to read concurrently
+ * @param maxTargetSep  if positive, max separation in arcsec of
+ *                      differently-named targets to merge, see
+ *                      merge_oi_target()
+ * @param outFilename   name of file to create
+ * @param pStatus       pointer to status variable
+ *
+ * @return On error, returns non-zero cfitsio error code (also assigned to
+ *         *pStatus)
+ */
+STATUS merge_oi_fits_files(const GList *filenameList, int njobs,
+                           double maxTargetSep, const char *outFilename,
+                           STATUS *pStatus)
+{
+  const char function[] = "merge_oi_fits_files";
+  GList *inList, *arrnameHashList, *insnameHashList, *corrnameHashList;
+  const GList *link, *inLink, *arrHashLink, *insHashLink, *corrHashLink;
+  GHashTable *targetIdHash;
+  fitsfile *outFptr;
+  oi_fits outMeta;
+  table_remap *remaps;
+  stream_extver extver;
+  int i, tabExtver;
+
+  if (*pStatus) return *pStatus; /* error flag set - do nothing */
+
+  if (!fits_is_reentrant()) njobs = 1;
+  targetIdHash = NULL;
+  arrnameHashList = NULL;
+  insnameHashList = NULL;
+  corrnameHashList = NULL;
+  remaps = NULL;
+  outFptr = NULL;
+  init_oi_fits(&outMeta);
+
+  /* Phase 1: read and merge metadata from all input files */
+  inList = read_oi_fits_meta_list(filenameList, njobs, pStatus);
+  if (*pStatus) goto except;
+  merge_oi_header(inList, &outMeta);
+  targetIdHash = merge_oi_target(inList, maxTargetSep, &outMeta);
+  arrnameHashList = merge_all_oi_array(inList, &outMeta);
+  insnameHashList = merge_all_oi_wavelength(inList, &outMeta);
+  corrnameHashList = merge_all_oi_corr(inList, &outMeta);
+
+  /* Write merged metadata */
+  fits_create_file(&outFptr, outFilename, pStatus);
+  if (*pStatus) goto except;
+  write_oi_header(outFptr, outMeta.header, pStatus);
+  write_oi_target(outFptr, outMeta.targets, pStatus);
+  tabExtver = 1;
+  WRITE_OI_LIST(outFptr, outMeta.arrayList, oi_array, write_oi_array,
+                &tabExtver, pStatus);
+  tabExtver = 1;
+  WRITE_OI_LIST(outFptr, outMeta.wavelengthList, oi_wavelength,
+                write_oi_wavelength, &tabExtver, pStatus);
+  tabExtver = 1;
+  WRITE_OI_LIST(outFptr, outMeta.corrList, oi_corr, write_oi_corr,
+                &tabExtver, pStatus);
+  if (*pStatus) goto except;
+
+  /* Collect cross-reference mappings for each input file */
+  remaps = chkmalloc(MAX(g_list_length(inList), 1) * sizeof(table_remap));
+  inLink = inList;
+  arrHashLink = arrnameHashList;
+  insHashLink = insnameHashList;
+  corrHashLink = corrnameHashList;
+  for (i = 0; inLink != NULL; i++)
+  {
+    remaps[i].pInput = (oi_fits *)inLink->data;
+    remaps[i].targetIdHash = targetIdHash;
+    remaps[i].arrnameHash = (GHashTable *)arrHashLink->data;
+    remaps[i].insnameHash = (GHashTable *)insHashLink->data;
+    remaps[i].corrnameHash = (GHashTable *)corrHashLink->data;
+    inLink = inLink->next;
+    arrHashLink = arrHashLink->next;
+    insHashLink = insHashLink->next;
+    corrHashLink = corrHashLink->next;
+  }
+
+  /* Phase 2: copy data tables from each input file in turn */
+  extver.inspol = extver.vis = extver.vis2 = extver.t3 = extver.flux = 1;
+  if (njobs > 1)
+  {
+    load_data_tables(filenameList, remaps, njobs, outFptr, &extver, pStatus);
+  }
+  else
+  {
+    for (i = 0, link = filenameList; link != NULL && !*pStatus;
+         i++, link = link->next)
+      stream_data_tables(link->data, &remaps[i], outFptr, &extver, pStatus);
+  }
+
+except:
+  if (outFptr) fits_close_file(outFptr, pStatus);
+  if (*pStatus) oi_report_error(function, *pStatus);
+  oi_free(remaps);
+  if (targetIdHash) g_hash_table_destroy(targetIdHash);
+  free_hash_list(arrnameHashList);
+  free_hash_list(insnameHashList);
+  free_hash_list(corrnameHashList);
+  for (link = inList; link != NULL; link = link->next)
+  {
+    free_oi_fits((oi_fits *)link->data);
+    oi_free(link->data);
+  }
+  g_list_free(inList);
+  free_oi_fits(&outMeta);
+  return *pStatus;
+}
+
+/** Offset to add to CORRINDX values referring to a merged OI_CORR table */
+#define CORR_OFFSET(corrOffsetHash, corrname)                                  \
+  GPOINTER_TO_INT(g_hash_table_lookup(corrOffsetHash, corrname))
+
+/**
+ * Combine all OI_CORR tables into the first, and update CORRNAME and
+ * CORRINDX values in data tables accordingly.
+ */
+static void concat_oi_corr(oi_fits *pData)
+{
+  GHashTable *corrOffsetHash;
+  GList *link;
+  oi_corr *pOutCorr, *pCorr;
+  oi_vis *pVis;
+  oi_vis2 *pVis2;
+  oi_t3 *pT3;
+  oi_flux *pFlux;
+  int i, offset, ndata, ncorr;
+
+  if (pData->numCorr < 2) return;
+
+  /* Append correlations to first table, offsetting indices */
+  pOutCorr = pData->corrList->data;
+  corrOffsetHash =
+      g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+  ndata = 0;
+  ncorr = 0;
+  for (link = pData->corrList; link != NULL; link = link->next)
+  {
+    pCorr = link->data;
+    ndata += pCorr->ndata;
+    ncorr += pCorr->ncorr;
+  }
+  if (ncorr > 0)
+  {
+    pOutCorr->iindx = chkrealloc(pOutCorr->iindx, ncorr * sizeof(int));
+    pOutCorr->jindx = chkrealloc(pOutCorr->jindx, ncorr * sizeof(int));
+    pOutCorr->corr = chkrealloc(pOutCorr->corr, ncorr * sizeof(double));
+  }
+  offset = pOutCorr->ndata;
+  ncorr = pOutCorr->ncorr;
+  for (link = pData->corrList->next; link != NULL; link = link->next)
+  {
+    pCorr = link->data;
+    for (i = 0; i < pCorr->ncorr; i++)
+    {
+      pOutCorr->iindx[ncorr + i] = pCorr->iindx[i] + offset;
+      pOutCorr->jindx[ncorr + i] = pCorr->jindx[i] + offset;
+      pOutCorr->corr[ncorr + i] = pCorr->corr[i];
+    }
+    /* copy key, as table is freed below */
+    g_hash_table_insert(corrOffsetHash, g_strdup(pCorr->corrname),
+                        GINT_TO_POINTER(offset));
+    offset += pCorr->ndata;
+    ncorr += pCorr->ncorr;
+    free_oi_corr(pCorr);
+    oi_free(pCorr);
+  }
+  pOutCorr->ndata = ndata;
+  pOutCorr->ncorr = ncorr;
+  g_list_free(pData->corrList->next);
+  pData->corrList->next = NULL;
+  pData->numCorr = 1;
+
+  /* Redirect data tables to combined OI_CORR */
+  for (link = pData->visList; link != NULL; link = link->next)
+  {
+    pVis = link->data;
+    if (strlen(pVis->corrname) == 0) continue;
+    offset = CORR_OFFSET(corrOffsetHash, pVis->corrname);
+    for (i = 0; i < pVis->numrec; i++)
+    {
+      pVis->record[i].corrindx_visamp += offset;
+      pVis->record[i].corrindx_visphi += offset;
+      if (pVis->usecomplex)
+      {
+        pVis->record[i].corrindx_rvis += offset;
+        pVis->record[i].corrindx_ivis += offset;
+      }
+    }
+    g_strlcpy(pVis->corrname, pOutCorr->corrname, FLEN_VALUE);
+  }
+  for (link = pData->vis2List; link != NULL; link = link->next)
+  {
+    pVis2 = link->data;
+    if (strlen(pVis2->corrname) == 0) continue;
+    offset = CORR_OFFSET(corrOffsetHash, pVis2->corrname);
+    for (i = 0; i < pVis2->numrec; i++)
+      pVis2->record[i].corrindx_vis2data += offset;
+    g_strlcpy(pVis2->corrname, pOutCorr->corrname, FLEN_VALUE);
+  }
+  for (link = pData->t3List; link != NULL; link = link->next)
+  {
+    pT3 = link->data;
+    if (strlen(pT3->corrname) == 0) continue;
+    offset = CORR_OFFSET(corrOffsetHash, pT3->corrname);
+    for (i = 0; i < pT3->numrec; i++)
+    {
+      pT3->record[i].corrindx_t3amp += offset;
+      pT3->record[i].corrindx_t3phi += offset;
+    }
+    g_strlcpy(pT3->corrname, pOutCorr->corrname, FLEN_VALUE);
+  }
+  for (link = pData->fluxList; link != NULL; link = link->next)
+  {
+    pFlux = link->data;
+    if (strlen(pFlux->corrname) == 0) continue;
+    offset = CORR_OFFSET(corrOffsetHash, pFlux->corrname);
+    for (i = 0; i < pFlux->numrec; i++)
+      pFlux->record[i].corrindx_fluxdata += offset;
+    g_strlcpy(pFlux->corrname, pOutCorr->corrname, FLEN_VALUE);
+  }
+  g_hash_table_destroy(corrOffsetHash);
+}
+
+/** Can records from OI_VIS tables @a pTab1 and @a pTab2 share a table? */
+static gboolean oi_vis_compatible(const oi_vis *pTab1, const oi_vis *pTab2)
+{
+  return (pTab1->revision == pTab2->revision &&
+          pTab1->nwave == pTab2->nwave &&
+          strcmp(pTab1->arrname, pTab2->arrname) == 0 &&
+          strcmp(pTab1->insname, pTab2->insname) == 0 &&
+          strcmp(pTab1->corrname, pTab2->corrname) == 0 &&
+          strcmp(pTab1->amptyp, pTab2->amptyp) == 0 &&
+          strcmp(pTab1->phityp, pTab2->phityp) == 0 &&
+          pTab1->amporder == pTab2->amporder &&
+          pTab1->phiorder == pTab2->phiorder &&
+          pTab1->usevisrefmap == pTab2->usevisrefmap &&
+          pTab1->usecomplex == pTab2->usecomplex &&
+          strcmp(pTab1->complexunit, pTab2->complexunit) == 0 &&
+          strcmp(pTab1->ampunit, pTab2->ampunit) == 0);
+}
+
+/** Can records from OI_VIS2 tables @a pTab1 and @a pTab2 share a table? */
+static gboolean oi_vis2_compatible(const oi_vis2 *pTab1, const oi_vis2 *pTab2)
+{
+  return (pTab1->revision == pTab2->revision &&
+          pTab1->nwave == pTab2->nwave &&
+          strcmp(pTab1->arrname, pTab2->arrname) == 0 &&
+          strcmp(pTab1->insname, pTab2->insname) == 0 &&
+          strcmp(pTab1->corrname, pTab2->corrname) == 0);
+}
+
+/** Can records from OI_T3 tables @a pTab1 and @a pTab2 share a table? */
+static gboolean oi_t3_compatible(const oi_t3 *pTab1, const oi_t3 *pTab2)
+{
+  return (pTab1->revision == pTab2->revision &&
+          pTab1->nwave == pTab2->nwave &&
+          strcmp(pTab1->arrname, pTab2->arrname) == 0 &&
+          strcmp(pTab1->insname, pTab2->insname) == 0 &&
+          strcmp(pTab1->corrname, pTab2->corrname) == 0);
+}
+
+/** Can records from OI_FLUX tables @a pTab1 and @a pTab2 share a table? */
+static gboolean oi_flux_compatible(const oi_flux *pTab1, const oi_flux *pTab2)
+{
+  return (pTab1->revision == pTab2->revision &&
+          pTab1->nwave == pTab2->nwave &&
+          strcmp(pTab1->arrname, pTab2->arrname) == 0 &&
+          strcmp(pTab1->insname, pTab2->insname) == 0 &&
+          strcmp(pTab1->corrname, pTab2->corrname) == 0 &&
+          pTab1->fov == pTab2->fov &&
+          strcmp(pTab1->fovtype, pTab2->fovtype) == 0 &&
+          pTab1->calstat == pTab2->calstat &&
+          strcmp(pTab1->fluxunit, pTab2->fluxunit) == 0);
+}
+
+/**
+ * Concatenate compatible tables in list, moving records into the
+ * first table of each compatible set. The order of records is
+ * preserved within each output table.
+ */
+#define CONCAT_OI_LIST(list, num, type, compatible_func)                       \
+  do                                                                           \
+  {                                                                            \
+    GList *link, *outLink, *next;                                              \
+    type *pOutTab, *pTab;                                                      \
+    long numrec;                                                               \
+    for (outLink = (list); outLink != NULL; outLink = outLink->next)           \
+    {                                                                          \
+      pOutTab = outLink->data;                                                 \
+      /* Count records to move into pOutTab */                                 \
+      numrec = pOutTab->numrec;                                                \
+      for (link = outLink->next; link != NULL; link = link->next)              \
+      {                                                                        \
+        pTab = link->data;                                                     \
+        if (compatible_func(pOutTab, pTab)) numrec += pTab->numrec;            \
+      }                                                                        \
+      if (numrec == pOutTab->numrec) continue;                                 \
+      pOutTab->record = chkrealloc(pOutTab->record,                            \
+                                   numrec * sizeof(pOutTab->record[0]));       \
+      /* Move records, then remove emptied table from list */                  \
+      for (link = outLink->next; link != NULL; link = next)                    \
+      {                                                                        \
+        next = link->next;                                                     \
+        pTab = link->data;                                                     \
+        if (!compatible_func(pOutTab, pTab)) continue;                         \
+        memcpy(&pOutTab->record[pOutTab->numrec], pTab->record,                \
+               pTab->numrec * sizeof(pTab->record[0]));                        \
+        pOutTab->numrec += pTab->numrec;                                       \
+        if (strlen(pTab->date_obs) > 0 &&                                      \
+            strcmp(pTab->date_obs, pOutTab->date_obs) < 0)                     \
+          g_strlcpy(pOutTab->date_obs, pTab->date_obs, FLEN_VALUE);            \
+        oi_free(pTab->record);                                                 \
+        oi_free(pTab);                                                         \
+        (list) = g_list_delete_link((list), link);                             \
+        --(num);                                                               \
+      }                                                                        \
+    }                                                                          \
+  } while (0)
+
+/**
+ * Concatenate compatible data tables to reduce the number of HDUs.
+ *
+ * Merging many files typically gives many small data tables with the
+ * same ARRNAME, INSNAME and CORRNAME. This function moves the records
+ * of each set of OI_VIS, OI_VIS2, OI_T3 or OI_FLUX tables that have
+ * the same table revision, number of spectral channels, names and
+ * other keywords into a single table. DATE-OBS is set to the earliest
+ * value. Records are moved, not copied.
+ *
+ * If the dataset has more than one OI_CORR table, they are first
+ * combined into a single table, and the CORRNAME and CORRINDX values
+ * of the data tables are adjusted to refer to it.
+ *
+ * Call after merge_oi_fits() or similar to produce a compact merged
+ * dataset.
+ *
+ * @param pData  pointer to oi_fits struct to modify
+ */
+void concat_oi_fits_tables(oi_fits *pData)
+{
+  concat_oi_corr(pData);
+  CONCAT_OI_LIST(pData->visList, pData->numVis, oi_vis, oi_vis_compatible);
+  CONCAT_OI_LIST(pData->vis2List, pData->numVis2, oi_vis2, oi_vis2_compatible);
+  CONCAT_OI_LIST(pData->t3List, pData->numT3, oi_t3, oi_t3_compatible);
+  CONCAT_OI_LIST(pData->fluxList, pData->numFlux, oi_flux,
+                 oi_flux_compatible);
+  rehash_oi_fits(pData);
+}
+
+/** Key identifying a data record, for detecting duplicates */
+typedef struct
+{
+  int tabType;      /**< which kind of data table */
+  int targetId;
+  double mjd;
+  double intTime;
+  int staIndex[3];  /**< unused elements are zero */
+  const char *insname;
+
+} record_key;
+
+enum
+{
+  KEY_OI_VIS,
+  KEY_OI_VIS2,
+  KEY_OI_T3,
+  KEY_OI_FLUX
+};
+
+static guint record_key_hash(gconstpointer key)
+{
+  const record_key *pKey = key;
+  guint hash;
+  int i;
+
+  hash = g_str_hash(pKey->insname);
+  hash = 31 * hash + pKey->tabType;
+  hash = 31 * hash + pKey->targetId;
+  hash = 31 * hash + g_double_hash(&pKey->mjd);
+  hash = 31 * hash + g_double_hash(&pKey->intTime);
+  for (i = 0; i < 3; i++)
+    hash = 31 * hash + pKey->staIndex[i];
+  return hash;
+}
+
+static gboolean record_key_equal(gconstpointer key1, gconstpointer key2)
+{
+  const record_key *pKey1 = key1, *pKey2 = key2;
+
+  return (pKey1->tabType == pKey2->tabType &&
+          pKey1->targetId == pKey2->targetId && pKey1->mjd == pKey2->mjd &&
+          pKey1->intTime == pKey2->intTime &&
+          pKey1->staIndex[0] == pKey2->staIndex[0] &&
+          pKey1->staIndex[1] == pKey2->staIndex[1] &&
+          pKey1->staIndex[2] == pKey2->staIndex[2] &&
+          strcmp(pKey1->insname, pKey2->insname) == 0);
+}
+
+static void oi_vis_record_key(const oi_vis *pTab, long irec, record_key *pKey)
+{
+  pKey->tabType = KEY_OI_VIS;
+  pKey->targetId = pTab->record[irec].target_id;
+  pKey->mjd = pTab->record[irec].mjd;
+  pKey->intTime = pTab->record[irec].int_time;
+  pKey->staIndex[0] = pTab->record[irec].sta_index[0];
+  pKey->staIndex[1] = pTab->record[irec].sta_index[1];
+  pKey->staIndex[2] = 0;
+  pKey->insname = pTab->insname;
+}
+
+static void oi_vis2_record_key(const oi_vis2 *pTab, long irec,
+                               record_key *pKey)
+{
+  pKey->tabType = KEY_OI_VIS2;
+  pKey->targetId = pTab->record[irec].target_id;
+  pKey->mjd = pTab->record[irec].mjd;
+  pKey->intTime = pTab->record[irec].int_time;
+  pKey->staIndex[0] = pTab->record[irec].sta_index[0];
+  pKey->staIndex[1] = pTab->record[irec].sta_index[1];
+  pKey->staIndex[2] = 0;
+  pKey->insname = pTab->insname;
+}
+
+static void oi_t3_record_key(const oi_t3 *pTab, long irec, record_key *pKey)
+{
+  pKey->tabType = KEY_OI_T3;
+  pKey->targetId = pTab->record[irec].target_id;
+  pKey->mjd = pTab->record[irec].mjd;
+  pKey->intTime = pTab->record[irec].int_time;
+  pKey->staIndex[0] = pTab->record[irec].sta_index[0];
+  pKey->staIndex[1] = pTab->record[irec].sta_index[1];
+  pKey->staIndex[2] = pTab->record[irec].sta_index[2];
+  pKey->insname = pTab->insname;
+}
+
+static void oi_flux_record_key(const oi_flux *pTab, long irec,
+                               record_key *pKey)
+{
+  pKey->tabType = KEY_OI_FLUX;
+  pKey->targetId = pTab->record[irec].target_id;
+  pKey->mjd = pTab->record[irec].mjd;
+  pKey->intTime = pTab->record[irec].int_time;
+  pKey->staIndex[0] = pTab->record[irec].sta_index;
+  pKey->staIndex[1] = 0;
+  pKey->staIndex[2] = 0;
+  pKey->insname = pTab->insname;
+}
+
+/**
+ * Find records in list of tables whose keys are already in @a keySet,
+ * optionally removing them. Tables left empty are removed too.
+ */
+#define DEDUP_OI_LIST(list, num, type, key_func, free_func, keySet, keys,     \
+                      pNumKey, removeDups, pNumDup)                            \
+  do                                                                           \
+  {                                                                            \
+    GList *link, *next;                                                        \
+    type *pTab, dropped;                                                       \
+    record_key *pKey;                                                          \
+    long irec, numKeep, numDrop;                                               \
+    for (link = (list); link != NULL; link = next)                             \
+    {                                                                          \
+      next = link->next;                                                       \
+      pTab = link->data;                                                       \
+      /* dropped records are freed as a temporary table */                     \
+      dropped = *pTab;                                                         \
+      dropped.record = chkmalloc(MAX(pTab->numrec, 1) *                        \
+                                 sizeof(pTab->record[0]));                     \
+      numKeep = 0;                                                             \
+      numDrop = 0;                                                             \
+      for (irec = 0; irec < pTab->numrec; irec++)                              \
+      {                                                                        \
+        pKey = &(keys)[*(pNumKey)];                                            \
+        key_func(pTab, irec, pKey);                                            \
+        if (g_hash_table_contains(keySet, pKey))                               \
+        {                                                                      \
+          ++*(pNumDup);                                                        \
+          if (removeDups)                                                      \
+          {                                                                    \
+            dropped.record[numDrop++] = pTab->record[irec];                    \
+            continue;                                                          \
+          }                                                                    \
+        }                                                                      \
+        else                                                                   \
+        {                                                                      \
+          g_hash_table_add(keySet, pKey);                                      \
+          ++*(pNumKey);                                                        \
+        }                                                                      \
+        pTab->record[numKeep++] = pTab->record[irec];                          \
+      }                                                                        \
+      pTab->numrec = numKeep;                                                  \
+      dropped.numrec = numDrop;                                                \
+      free_func(&dropped);                                                     \
+      if (numKeep == 0 && numDrop > 0)                                         \
+      {                                                                        \
+        free_func(pTab);                                                       \
+        oi_free(pTab);                                                         \
+        (list) = g_list_delete_link((list), link);                             \
+        --(num);                                                               \
+      }                                                                        \
+    }                                                                          \
+  } while (0)
+
+/** Count records in list of tables */
+#define COUNT_OI_RECORDS(list, type, pCount)                                   \
+  do                                                                           \
+  {                                                                            \
+    GList *link;                                                               \
+    for (link = (list); link != NULL; link = link->next)                       \
+      *(pCount) += ((type *)link->data)->numrec;                               \
+  } while (0)
+
+/**
+ * Find and optionally remove duplicate data records.
+ *
+ * Intended for use after merging datasets that partially overlap,
+ * for example the same night delivered twice. Records of OI_VIS,
+ * OI_VIS2, OI_T3 and OI_FLUX tables are identified by their table
+ * type, TARGET_ID, MJD, INT_TIME, STA_INDEX and INSNAME. The first
+ * record with each identity is kept, and later records with the same
+ * identity are counted as duplicates. Lookups use a hash set, so the
+ * cost is linear in the number of records.
+ *
+ * Note that duplicates are detected regardless of the data values,
+ * so records from different reductions of the same observation are
+ * also treated as duplicates.
+ *
+ * @param pData       pointer to oi_fits struct to modify
+ * @param removeDups  if TRUE, remove duplicate records (and any tables
+ *                    left empty); if FALSE, only count them
+ *
+ * @return Number of duplicate records found
+ */
+long dedup_oi_fits(oi_fits *pData, gboolean removeDups)
+{
+  GHashTable *keySet;
+  record_key *keys;
+  long numRecord, numKey, numDup;
+
+  numRecord = 0;
+  COUNT_OI_RECORDS(pData->visList, oi_vis, &numRecord);
+  COUNT_OI_RECORDS(pData->vis2List, oi_vis2, &numRecord);
+  COUNT_OI_RECORDS(pData->t3List, oi_t3, &numRecord);
+  COUNT_OI_RECORDS(pData->fluxList, oi_flux, &numRecord);
+  if (numRecord == 0) return 0;
+
+  keySet = g_hash_table_new(record_key_hash, record_key_equal);
+  keys = chkmalloc(numRecord * sizeof(record_key));
+  numKey = 0;
+  numDup = 0;
+  DEDUP_OI_LIST(pData->visList, pData->numVis, oi_vis, oi_vis_record_key,
+                free_oi_vis, keySet, keys, &numKey, removeDups, &numDup);
+  DEDUP_OI_LIST(pData->vis2List, pData->numVis2, oi_vis2, oi_vis2_record_key,
+                free_oi_vis2, keySet, keys, &numKey, removeDups, &numDup);
+  DEDUP_OI_LIST(pData->t3List, pData->numT3, oi_t3, oi_t3_record_key,
+                free_oi_t3, keySet, keys, &numKey, removeDups, &numDup);
+  DEDUP_OI_LIST(pData->fluxList, pData->numFlux, oi_flux, oi_flux_record_key,
+                free_oi_flux, keySet, keys, &numKey, removeDups, &numDup);
+  g_hash_table_destroy(keySet);
+  oi_free(keys);
+
+  if (removeDups && numDup > 0) rehash_oi_fits(pData);
+  return numDup;
 }
@@ -30,15 +30,29 @@
  * single dataset.
  *
  * Target records with the same target name are merged (without
- * checking that the coordinates etc. are identical), as are duplicate
- * OI_WAVELENGTH tables.
+ * checking that the coordinates etc. are identical). Functions that
+ * take a maximum target separation also merge differently-named
+ * targets from different datasets whose positions agree to within
+ * that many arcseconds. Duplicate OI_ARRAY and OI_WAVELENGTH tables are
+ * merged too. Candidate duplicates are found from an index of
+ * quantised table fingerprints or positions, so the cost of merging
+ * grows linearly with the number of distinct tables or targets.
  *
- * A merged dataset should be obtained by calling merge_oi_fits()
- * (which takes a variable number of arguments) or
- * merge_oi_fits_list() (which takes a linked list of datasets to
- * merge). Applications should not normally need to call the
- * lower-level functions that merge subsets of the OIFITS tables (such
- * as merge_oi_target() and merge_all_oi_vis2()).
+ * A merged dataset should be obtained by calling merge_oi_fits() (which
+ * takes a variable number of arguments) or merge_oi_fits_list() (which
+ * takes a linked list of datasets to merge). If the input datasets are
+ * no longer needed, merge_oi_fits_list_steal() avoids copying their
+ * data tables. To merge files that are too large to hold in memory
+ * together, call merge_oi_fits_files() instead, which reads only the
+ * metadata tables of every file up front and then copies the data
+ * tables to the output file one at a time. Calling
+ * concat_oi_fits_tables() on a merged dataset combines data tables that
+ * share the same setup, so that the output has fewer, larger tables.
+ * Records duplicated between overlapping inputs can be found and
+ * removed with dedup_oi_fits().
+ * Applications should not normally need to call the lower-level
+ * functions that merge subsets of the OIFITS tables (such as
+ * merge_oi_target() and merge_all_oi_vis2()).
  *
  * @{
  */
@@ -52,7 +66,7 @@
  * Function prototypes
  */
 void merge_oi_header(const GList *, oi_fits *);
-GHashTable *merge_oi_target(const GList *, oi_fits *);
+GHashTable *merge_oi_target(const GList *, double, oi_fits *);
 GList *merge_all_oi_array(const GList *, oi_fits *);
 GList *merge_all_oi_wavelength(const GList *, oi_fits *);
 GList *merge_all_oi_corr(const GList *, oi_fits *);
@@ -65,7 +79,13 @@ void merge_all_oi_t3(const GList *, GHashTable *, const GList *, const GList *,
 void merge_all_oi_flux(const GList *, GHashTable *, const GList *,
                        const GList *, const GList *, oi_fits *);
 void merge_oi_fits_list(const GList *, oi_fits *);
+void merge_oi_fits_list_steal(const GList *, double, oi_fits *);
+void merge_oi_fits_list_threaded(const GList *, int, double, oi_fits *);
 void merge_oi_fits(oi_fits *, oi_fits *, oi_fits *, ...);
+STATUS merge_oi_fits_files(const GList *, int, double, const char *,
+                           STATUS *);
+void concat_oi_fits_tables(oi_fits *);
+long dedup_oi_fits(oi_fits *, gboolean);
 
 #endif /* #ifndef OIMERGE_H */
 
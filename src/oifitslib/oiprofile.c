@@ -0,0 +1,184 @@
+/**
+ * @file
+ * @ingroup oitable
+ * Implementation of phase timers and I/O counters.
+ *
+ * Copyright (C) 2026 the OIFITSlib authors
+ *
+ *
+ * This file is part of OIFITSlib.
+ *
+ * OIFITSlib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * OIFITSlib is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with OIFITSlib.  If not, see
+ * http://www.gnu.org/licenses/
+ */
+
+#include "oiprofile.h"
+
+#include <stdatomic.h>
+#include <time.h>
+
+/** Names of phases for oi_profile_print() */
+static const char *const phaseNames[OI_NUM_PHASE] = {
+    "HDU seek", "Decode", "Checksum", "Filter", "Table match", "Write"};
+
+/** Names of counters for oi_profile_print() */
+static const char *const countNames[OI_NUM_COUNT] = {
+    "HDUs visited", "Rows read",     "Bytes read",
+    "Rows written", "Bytes written", "CFITSIO column calls"};
+
+/*
+ * Totals are shared by all threads, so that work done by thread pools
+ * is included. Relaxed atomic operations suffice as the totals are
+ * independent.
+ */
+static atomic_int enabled = 0;
+static atomic_llong totalNanosec[OI_NUM_PHASE];
+static atomic_llong totalCalls[OI_NUM_PHASE];
+static atomic_llong totalCount[OI_NUM_COUNT];
+
+/*
+ * Private functions
+ */
+
+/** Return monotonic time in nanoseconds, never zero */
+static oi_timer now_nanosec(void)
+{
+  struct timespec ts;
+  oi_timer t;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  t = (oi_timer)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+  return (t != 0) ? t : 1;
+}
+
+/*
+ * Public functions
+ */
+
+/**
+ * Enable or disable phase timers and I/O counters for all threads.
+ *
+ * The totals are not reset. When disabled, the only overhead is a
+ * test of a flag at the start of each timed phase.
+ *
+ * @param enable  TRUE to enable profiling, FALSE to disable
+ */
+void oi_profile_enable(int enable)
+{
+  atomic_store_explicit(&enabled, enable != 0, memory_order_relaxed);
+}
+
+/**
+ * Return TRUE if phase timers and I/O counters are enabled.
+ */
+int oi_profile_enabled(void)
+{
+  return atomic_load_explicit(&enabled, memory_order_relaxed);
+}
+
+/**
+ * Start timing a phase.
+ *
+ * @return Start time to pass to oi_profile_stop(), or 0 if disabled
+ */
+oi_timer oi_profile_start(void)
+{
+  if (!oi_profile_enabled()) return 0;
+  return now_nanosec();
+}
+
+/**
+ * Stop timing a phase, adding the elapsed time to its total.
+ *
+ * @param phase  phase being timed
+ * @param start  value returned by oi_profile_start(). If 0, does nothing
+ */
+void oi_profile_stop(oi_phase phase, oi_timer start)
+{
+  if (start == 0) return;
+  atomic_fetch_add_explicit(&totalNanosec[phase], now_nanosec() - start,
+                            memory_order_relaxed);
+  atomic_fetch_add_explicit(&totalCalls[phase], 1, memory_order_relaxed);
+}
+
+/**
+ * Add to I/O counter, if profiling is enabled.
+ *
+ * @param counter  counter to increment
+ * @param n        amount to add
+ */
+void oi_profile_count(oi_counter counter, long long n)
+{
+  if (!oi_profile_enabled()) return;
+  atomic_fetch_add_explicit(&totalCount[counter], n, memory_order_relaxed);
+}
+
+/**
+ * Get totals accumulated since last reset.
+ *
+ * @param pProfile  return location for totals
+ */
+void oi_profile_get(oi_profile *pProfile)
+{
+  int i;
+
+  for (i = 0; i < OI_NUM_PHASE; i++)
+  {
+    pProfile->seconds[i] =
+        1e-9 * atomic_load_explicit(&totalNanosec[i], memory_order_relaxed);
+    pProfile->numCall[i] =
+        atomic_load_explicit(&totalCalls[i], memory_order_relaxed);
+  }
+  for (i = 0; i < OI_NUM_COUNT; i++)
+    pProfile->count[i] =
+        atomic_load_explicit(&totalCount[i], memory_order_relaxed);
+}
+
+/**
+ * Reset all phase timers and I/O counters to zero.
+ */
+void oi_profile_reset(void)
+{
+  int i;
+
+  for (i = 0; i < OI_NUM_PHASE; i++)
+  {
+    atomic_store_explicit(&totalNanosec[i], 0, memory_order_relaxed);
+    atomic_store_explicit(&totalCalls[i], 0, memory_order_relaxed);
+  }
+  for (i = 0; i < OI_NUM_COUNT; i++)
+    atomic_store_explicit(&totalCount[i], 0, memory_order_relaxed);
+}
+
+/**
+ * Print totals accumulated since last reset.
+ *
+ * Phases timed in several threads at once may have a total time
+ * greater than the elapsed time.
+ *
+ * @param stream  stream to print to, e.g. stdout
+ */
+void oi_profile_print(FILE *stream)
+{
+  oi_profile profile;
+  int i;
+
+  oi_profile_get(&profile);
+  fprintf(stream, "%-20s %10s %12s\n", "Phase", "Calls", "Time/s");
+  for (i = 0; i < OI_NUM_PHASE; i++)
+    fprintf(stream, "%-20s %10lld %12.6f\n", phaseNames[i],
+            profile.numCall[i], profile.seconds[i]);
+  for (i = 0; i < OI_NUM_COUNT; i++)
+    fprintf(stream, "%-20s %10lld\n", countNames[i], profile.count[i]);
+}
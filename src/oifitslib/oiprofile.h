@@ -0,0 +1,81 @@
+/**
+ * @file
+ * @ingroup oitable
+ * Definition of phase timers and I/O counters.
+ *
+ * Copyright (C) 2026 the OIFITSlib authors
+ *
+ *
+ * This file is part of OIFITSlib.
+ *
+ * OIFITSlib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * OIFITSlib is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with OIFITSlib.  If not, see
+ * http://www.gnu.org/licenses/
+ */
+
+#ifndef OIPROFILE_H
+#define OIPROFILE_H
+
+#include <stdio.h>
+
+/** Phase of processing timed by oi_profile_start()/oi_profile_stop() */
+typedef enum
+{
+  OI_PHASE_SEEK,     /**< Moving to HDU with required EXTNAME */
+  OI_PHASE_DECODE,   /**< Reading keywords and columns of HDU */
+  OI_PHASE_CHECKSUM, /**< Verifying HDU checksums */
+  OI_PHASE_FILTER,   /**< Applying filter to dataset */
+  OI_PHASE_MATCH,    /**< Matching array and wavelength tables when merging */
+  OI_PHASE_WRITE,    /**< Writing table HDU including checksums */
+  OI_NUM_PHASE       /**< Number of phases */
+
+} oi_phase;
+
+/** Quantity counted by oi_profile_count() */
+typedef enum
+{
+  OI_COUNT_HDU,          /**< HDUs visited while seeking */
+  OI_COUNT_ROW_READ,     /**< Table rows decoded */
+  OI_COUNT_BYTE_READ,    /**< Header and table bytes decoded */
+  OI_COUNT_ROW_WRITTEN,  /**< Table rows written */
+  OI_COUNT_BYTE_WRITTEN, /**< Header and table bytes written */
+  OI_COUNT_COLUMN_IO,    /**< CFITSIO column read and write calls */
+  OI_NUM_COUNT           /**< Number of counters */
+
+} oi_counter;
+
+/** Start time returned by oi_profile_start(), or 0 if disabled */
+typedef long long oi_timer;
+
+/** Totals accumulated since last reset */
+typedef struct
+{
+  double seconds[OI_NUM_PHASE];    /**< Time spent in each phase */
+  long long numCall[OI_NUM_PHASE]; /**< Number of times phase timed */
+  long long count[OI_NUM_COUNT];   /**< Value of each counter */
+
+} oi_profile;
+
+/*
+ * Function prototypes
+ */
+void oi_profile_enable(int);
+int oi_profile_enabled(void);
+oi_timer oi_profile_start(void);
+void oi_profile_stop(oi_phase, oi_timer);
+void oi_profile_count(oi_counter, long long);
+void oi_profile_get(oi_profile *);
+void oi_profile_reset(void);
+void oi_profile_print(FILE *);
+
+#endif /* #ifndef OIPROFILE_H */
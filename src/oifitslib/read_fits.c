@@ -46,14 +46,12 @@ static bool read_key_opt_string(fitsfile *fptr, const char *keyname,
 {
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
-  fits_write_errmark();
   if (fits_read_key(fptr, TSTRING, keyname, keyval, NULL, pStatus))
   {
     keyval[0] = '\0';
     if (*pStatus == KEY_NO_EXIST)
     {
       *pStatus = 0;
-      fits_clear_errmark();
     }
     return FALSE;
   }
@@ -70,14 +68,12 @@ static bool read_key_opt_int(fitsfile *fptr, const char *keyname, int *keyval,
 {
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
-  fits_write_errmark();
   if (fits_read_key(fptr, TINT, keyname, keyval, NULL, pStatus))
   {
     *keyval = -1;
     if (*pStatus == KEY_NO_EXIST)
     {
       *pStatus = 0;
-      fits_clear_errmark();
     }
     return FALSE;
   }
@@ -100,14 +96,12 @@ static bool read_key_opt_double(fitsfile *fptr, const char *keyname,
   nan = 0.0;
   nan /= nan;
 
-  fits_write_errmark();
   if (fits_read_key(fptr, TDOUBLE, keyname, keyval, NULL, pStatus))
   {
     *keyval = nan;
     if (*pStatus == KEY_NO_EXIST)
     {
       *pStatus = 0;
-      fits_clear_errmark();
     }
     return FALSE;
   }
@@ -132,15 +126,10 @@ static bool read_col_string(fitsfile *fptr, bool optional, char *colname,
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
-  fits_write_errmark();
   fits_get_colnum(fptr, CASEINSEN, colname, &colnum, pStatus);
   if (*pStatus == COL_NOT_FOUND)
   {
-    if (optional)
-    {
-      *pStatus = 0;
-      fits_clear_errmark();
-    }
+    if (optional) *pStatus = 0;
     return FALSE;
   }
   else
@@ -186,15 +175,10 @@ static bool read_col_string_truncate(fitsfile *fptr, bool optional,
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
-  fits_write_errmark();
   fits_get_colnum(fptr, CASEINSEN, colname, &colnum, pStatus);
   if (*pStatus == COL_NOT_FOUND)
   {
-    if (optional)
-    {
-      *pStatus = 0;
-      fits_clear_errmark();
-    }
+    if (optional) *pStatus = 0;
     return FALSE;
   }
   else
@@ -206,8 +190,8 @@ static bool read_col_string_truncate(fitsfile *fptr, bool optional,
       return FALSE;
     }
     if (warnRepeat && actualRepeat != maxRepeat)
-      printf("WARNING! Expecting format %ldA but found %ldA for column '%s'\n",
-             maxRepeat, actualRepeat, colname);
+      oi_warning("Expecting format %ldA but found %ldA for column '%s'\n",
+                 maxRepeat, actualRepeat, colname);
     char *longvalue = chkmalloc(actualRepeat + 1);
     if (fits_read_col(fptr, TSTRING, colnum, irow, 1, 1, NULL, &longvalue,
                       &anynull, pStatus))
@@ -218,7 +202,7 @@ static bool read_col_string_truncate(fitsfile *fptr, bool optional,
       value[i] = longvalue[i];
     }
     value[i] = '\0';
-    free(longvalue);
+    oi_free(longvalue);
     return TRUE;
   }
 }
@@ -237,9 +221,11 @@ static STATUS verify_chksum(fitsfile *fptr, STATUS *pStatus)
   int dataok, hduok;
   char extname[FLEN_VALUE];
   int hdunum, extver;
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
+  start = oi_profile_start();
   fits_verify_chksum(fptr, &dataok, &hduok, pStatus);
   if (dataok == -1 || hduok == -1)
   {
@@ -253,14 +239,15 @@ static STATUS verify_chksum(fitsfile *fptr, STATUS *pStatus)
       extver = 0;
     }
     if (dataok == -1)
-      printf("WARNING! Data checksum verification failed "
-             "for HDU #%d (EXTNAME='%s' EXTVER=%d)\n",
-             hdunum, extname, extver);
+      oi_warning("Data checksum verification failed "
+                 "for HDU #%d (EXTNAME='%s' EXTVER=%d)\n",
+                 hdunum, extname, extver);
     if (hduok == -1)
-      printf("WARNING! HDU checksum verification failed "
-             "for HDU #%d (EXTNAME='%s' EXTVER=%d)\n",
-             hdunum, extname, extver);
+      oi_warning("HDU checksum verification failed "
+                 "for HDU #%d (EXTNAME='%s' EXTVER=%d)\n",
+                 hdunum, extname, extver);
   }
+  oi_profile_stop(OI_PHASE_CHECKSUM, start);
   return *pStatus;
 }
 
@@ -279,27 +266,28 @@ static STATUS next_named_hdu(fitsfile *fptr, const char *reqName,
 {
   char extname[FLEN_VALUE];
   int hdutype;
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
   /* Move to correct HDU - don't assume anything about EXTVERs */
+  start = oi_profile_start();
   while (1 == 1)
   {
     fits_movrel_hdu(fptr, 1, &hdutype, pStatus);
-    if (*pStatus) return *pStatus; /* no more HDUs */
+    if (*pStatus) break; /* no more HDUs */
+    oi_profile_count(OI_COUNT_HDU, 1);
     if (hdutype == BINARY_TBL)
     {
-      fits_write_errmark();
       fits_read_key(fptr, TSTRING, "EXTNAME", extname, NULL, pStatus);
       if (*pStatus == KEY_NO_EXIST)
       {
-        printf("WARNING! Skipping binary table HDU with no EXTNAME\n");
+        oi_warning("Skipping binary table HDU with no EXTNAME\n");
         *pStatus = 0;
-        fits_clear_errmark();
       }
       else if (*pStatus)
       {
-        return *pStatus;
+        break;
       }
       else if (strcmp(extname, reqName) == 0)
       {
@@ -307,6 +295,7 @@ static STATUS next_named_hdu(fitsfile *fptr, const char *reqName,
       }
     }
   }
+  oi_profile_stop(OI_PHASE_SEEK, start);
   return *pStatus;
 }
 
@@ -328,25 +317,26 @@ static STATUS specific_named_hdu(fitsfile *fptr, const char *reqName,
 {
   char extname[FLEN_VALUE], value[FLEN_VALUE];
   int ihdu, nhdu, hdutype;
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
   /* Move to correct HDU - don't assume anything about EXTVERs */
   fits_get_num_hdus(fptr, &nhdu, pStatus);
   if (*pStatus) return *pStatus;
+  start = oi_profile_start();
   for (ihdu = 2; ihdu <= nhdu; ihdu++)
   {
     fits_movabs_hdu(fptr, ihdu, &hdutype, pStatus);
-    if (*pStatus) return *pStatus;
+    if (*pStatus) break;
+    oi_profile_count(OI_COUNT_HDU, 1);
     if (hdutype == BINARY_TBL)
     {
-      fits_write_errmark();
       fits_read_key(fptr, TSTRING, "EXTNAME", extname, NULL, pStatus);
       fits_read_key(fptr, TSTRING, keyword, value, NULL, pStatus);
       if (*pStatus)
       {
         *pStatus = 0;
-        fits_clear_errmark();
         continue; /* next HDU */
       }
       if (strcmp(extname, reqName) != 0 || strcmp(value, reqVal) != 0)
@@ -359,10 +349,46 @@ static STATUS specific_named_hdu(fitsfile *fptr, const char *reqName,
     /* no matching HDU */
     *pStatus = BAD_HDU_NUM;
   }
+  oi_profile_stop(OI_PHASE_SEEK, start);
 
   return *pStatus;
 }
 
+/**
+ * Record time spent decoding current HDU, and count rows and bytes read.
+ *
+ * @param fptr      see cfitsio documentation
+ * @param start     value returned by oi_profile_start()
+ * @param firstRow  first table row read (1 for first row)
+ * @param numRows   number of table rows read, 0 for primary HDU
+ * @param pStatus   pointer to status variable
+ */
+static void profile_decode(fitsfile *fptr, oi_timer start, long firstRow,
+                           long numRows, const STATUS *pStatus)
+{
+  LONGLONG headStart, dataStart, dataEnd;
+  long rowLen;
+  int ncols;
+  STATUS status = 0; /* don't disturb caller's status */
+
+  if (start == 0) return; /* profiling disabled */
+  oi_profile_stop(OI_PHASE_DECODE, start);
+  if (*pStatus) return;
+  fits_get_hduaddrll(fptr, &headStart, &dataStart, &dataEnd, &status);
+  if (status == 0 && firstRow == 1)
+    oi_profile_count(OI_COUNT_BYTE_READ, dataStart - headStart);
+  if (numRows > 0)
+  {
+    fits_read_key(fptr, TLONG, "NAXIS1", &rowLen, NULL, &status);
+    fits_get_num_cols(fptr, &ncols, &status);
+    if (status) return;
+    oi_profile_count(OI_COUNT_ROW_READ, numRows);
+    oi_profile_count(OI_COUNT_BYTE_READ, (long long)numRows * rowLen);
+    /* One fits_read_col() per column per row */
+    oi_profile_count(OI_COUNT_COLUMN_IO, (long long)numRows * ncols);
+  }
+}
+
 /**
  * Read OI_ARRAY fits binary table at current HDU.
  *
@@ -398,8 +424,8 @@ static STATUS read_oi_array_chdu(fitsfile *fptr, oi_array *pArray,
   }
   if (pArray->revision > revision)
   {
-    printf("WARNING! Expecting OI_REVN <= %d in OI_ARRAY table. Got %d\n",
-           revision, pArray->revision);
+    oi_warning("Expecting OI_REVN <= %d in OI_ARRAY table. Got %d\n",
+               revision, pArray->revision);
   }
   if (arrname == NULL)
   {
@@ -486,8 +512,8 @@ static STATUS read_oi_wavelength_chdu(fitsfile *fptr, oi_wavelength *pWave,
   }
   if (pWave->revision > revision)
   {
-    printf("WARNING! Expecting OI_REVN <= %d in OI_WAVELENGTH table. Got %d\n",
-           revision, pWave->revision);
+    oi_warning("Expecting OI_REVN <= %d in OI_WAVELENGTH table. Got %d\n",
+               revision, pWave->revision);
   }
   if (insname == NULL)
   {
@@ -543,8 +569,8 @@ static STATUS read_oi_corr_chdu(fitsfile *fptr, oi_corr *pCorr,
   }
   if (pCorr->revision > revision)
   {
-    printf("WARNING! Expecting OI_REVN <= %d in OI_CORR table. Got %d\n",
-           revision, pCorr->revision);
+    oi_warning("Expecting OI_REVN <= %d in OI_CORR table. Got %d\n",
+               revision, pCorr->revision);
   }
   if (corrname == NULL)
   {
@@ -602,8 +628,8 @@ static STATUS read_oi_inspol_chdu(fitsfile *fptr, oi_inspol *pInspol,
   }
   if (pInspol->revision > revision)
   {
-    printf("WARNING! Expecting OI_REVN <= %d in OI_INSPOL table. Got %d\n",
-           revision, pInspol->revision);
+    oi_warning("Expecting OI_REVN <= %d in OI_INSPOL table. Got %d\n",
+               revision, pInspol->revision);
   }
   fits_read_key(fptr, TSTRING, "DATE-OBS", pInspol->date_obs, NULL, pStatus);
   fits_read_key(fptr, TINT, "NPOL", &pInspol->npol, NULL, pStatus);
@@ -671,12 +697,17 @@ static STATUS read_oi_inspol_chdu(fitsfile *fptr, oi_inspol *pInspol,
 STATUS read_oi_header(fitsfile *fptr, oi_header *pHeader, STATUS *pStatus)
 {
   const char function[] = "read_oi_header";
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
   /* Move to primary HDU */
+  start = oi_profile_start();
   fits_movabs_hdu(fptr, 1, NULL, pStatus);
+  oi_profile_count(OI_COUNT_HDU, 1);
+  oi_profile_stop(OI_PHASE_SEEK, start);
   verify_chksum(fptr, pStatus);
+  start = oi_profile_start();
 
   /* Note all header keywords (except SIMPLE etc.) are optional in OIFITS v1 */
   read_key_opt_string(fptr, "ORIGIN", pHeader->origin, pStatus);
@@ -694,12 +725,9 @@ STATUS read_oi_header(fitsfile *fptr, oi_header *pHeader, STATUS *pStatus)
   read_key_opt_string(fptr, "PROG_ID", pHeader->prog_id, pStatus);
   read_key_opt_string(fptr, "PROCSOFT", pHeader->procsoft, pStatus);
   read_key_opt_string(fptr, "OBSTECH", pHeader->obstech, pStatus);
+  profile_decode(fptr, start, 1, 0, pStatus);
 
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
 
@@ -719,11 +747,15 @@ STATUS read_oi_target(fitsfile *fptr, oi_target *pTargets, STATUS *pStatus)
   const int revision = OI_REVN_V2_TARGET;
   int irow, colnum, anynull;
   long nrows;
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
+  start = oi_profile_start();
   fits_movnam_hdu(fptr, BINARY_TBL, "OI_TARGET", 0, pStatus);
+  oi_profile_stop(OI_PHASE_SEEK, start);
   verify_chksum(fptr, pStatus);
+  start = oi_profile_start();
   fits_read_key(fptr, TINT, "OI_REVN", &pTargets->revision, NULL, pStatus);
   if (*pStatus)
   {
@@ -732,8 +764,8 @@ STATUS read_oi_target(fitsfile *fptr, oi_target *pTargets, STATUS *pStatus)
   }
   if (pTargets->revision > revision)
   {
-    printf("WARNING! Expecting OI_REVN <= %d in OI_TARGET table. Got %d\n",
-           revision, pTargets->revision);
+    oi_warning("Expecting OI_REVN <= %d in OI_TARGET table. Got %d\n",
+               revision, pTargets->revision);
   }
   /* get number of rows and allocate storage */
   fits_get_num_rows(fptr, &nrows, pStatus);
@@ -816,11 +848,8 @@ STATUS read_oi_target(fitsfile *fptr, oi_target *pTargets, STATUS *pStatus)
   }
 
 except:
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
+  profile_decode(fptr, start, 1, pTargets->ntarget, pStatus);
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
 
@@ -839,18 +868,17 @@ STATUS read_oi_array(fitsfile *fptr, char *arrname, oi_array *pArray,
                      STATUS *pStatus)
 {
   const char function[] = "read_oi_array";
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
   specific_named_hdu(fptr, "OI_ARRAY", "ARRNAME", arrname, pStatus);
   verify_chksum(fptr, pStatus);
+  start = oi_profile_start();
   read_oi_array_chdu(fptr, pArray, arrname, pStatus);
+  profile_decode(fptr, start, 1, pArray->nelement, pStatus);
 
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
 
@@ -867,19 +895,18 @@ STATUS read_oi_array(fitsfile *fptr, char *arrname, oi_array *pArray,
 STATUS read_next_oi_array(fitsfile *fptr, oi_array *pArray, STATUS *pStatus)
 {
   const char function[] = "read_next_oi_array";
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
   next_named_hdu(fptr, "OI_ARRAY", pStatus);
   if (*pStatus == END_OF_FILE) return *pStatus; /* don't report EOF to stderr */
   verify_chksum(fptr, pStatus);
+  start = oi_profile_start();
   read_oi_array_chdu(fptr, pArray, NULL, pStatus);
+  profile_decode(fptr, start, 1, pArray->nelement, pStatus);
 
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
 
@@ -898,18 +925,17 @@ STATUS read_oi_wavelength(fitsfile *fptr, char *insname, oi_wavelength *pWave,
                           STATUS *pStatus)
 {
   const char function[] = "read_oi_wavelength";
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
   specific_named_hdu(fptr, "OI_WAVELENGTH", "INSNAME", insname, pStatus);
   verify_chksum(fptr, pStatus);
+  start = oi_profile_start();
   read_oi_wavelength_chdu(fptr, pWave, insname, pStatus);
+  profile_decode(fptr, start, 1, pWave->nwave, pStatus);
 
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
 
@@ -927,19 +953,18 @@ STATUS read_next_oi_wavelength(fitsfile *fptr, oi_wavelength *pWave,
                                STATUS *pStatus)
 {
   const char function[] = "read_next_oi_wavelength";
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
   next_named_hdu(fptr, "OI_WAVELENGTH", pStatus);
   if (*pStatus == END_OF_FILE) return *pStatus; /* don't report EOF to stderr */
   verify_chksum(fptr, pStatus);
+  start = oi_profile_start();
   read_oi_wavelength_chdu(fptr, pWave, NULL, pStatus);
+  profile_decode(fptr, start, 1, pWave->nwave, pStatus);
 
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
 
@@ -958,18 +983,17 @@ STATUS read_oi_corr(fitsfile *fptr, char *corrname, oi_corr *pCorr,
                     STATUS *pStatus)
 {
   const char function[] = "read_oi_corr";
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
   specific_named_hdu(fptr, "OI_CORR", "CORRNAME", corrname, pStatus);
   verify_chksum(fptr, pStatus);
+  start = oi_profile_start();
   read_oi_corr_chdu(fptr, pCorr, corrname, pStatus);
+  profile_decode(fptr, start, 1, pCorr->ncorr, pStatus);
 
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
 
@@ -986,19 +1010,18 @@ STATUS read_oi_corr(fitsfile *fptr, char *corrname, oi_corr *pCorr,
 STATUS read_next_oi_corr(fitsfile *fptr, oi_corr *pCorr, STATUS *pStatus)
 {
   const char function[] = "read_next_oi_corr";
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
   next_named_hdu(fptr, "OI_CORR", pStatus);
   if (*pStatus == END_OF_FILE) return *pStatus; /* don't report EOF to stderr */
   verify_chksum(fptr, pStatus);
+  start = oi_profile_start();
   read_oi_corr_chdu(fptr, pCorr, NULL, pStatus);
+  profile_decode(fptr, start, 1, pCorr->ncorr, pStatus);
 
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
 
@@ -1015,34 +1038,32 @@ STATUS read_next_oi_corr(fitsfile *fptr, oi_corr *pCorr, STATUS *pStatus)
 STATUS read_next_oi_inspol(fitsfile *fptr, oi_inspol *pInspol, STATUS *pStatus)
 {
   const char function[] = "read_next_oi_inspol";
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
   next_named_hdu(fptr, "OI_INSPOL", pStatus);
   if (*pStatus == END_OF_FILE) return *pStatus; /* don't report EOF to stderr */
   verify_chksum(fptr, pStatus);
+  start = oi_profile_start();
   read_oi_inspol_chdu(fptr, pInspol, pStatus);
+  profile_decode(fptr, start, 1, pInspol->numrec, pStatus);
 
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
 
 /**
  * Read OI_VIS optional columns for complex visibility representation
  */
-static STATUS read_oi_vis_complex(fitsfile *fptr, oi_vis *pVis, bool correlated,
-                                  STATUS *pStatus)
+static STATUS read_oi_vis_complex(fitsfile *fptr, oi_vis *pVis, long row0,
+                                  bool correlated, STATUS *pStatus)
 {
   char keyword[FLEN_KEYWORD];
   int irow, colnum, anynull;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
-  fits_write_errmark();
   fits_get_colnum(fptr, CASEINSEN, "RVIS", &colnum, pStatus);
   if (*pStatus == COL_NOT_FOUND)
   {
@@ -1056,7 +1077,6 @@ static STATUS read_oi_vis_complex(fitsfile *fptr, oi_vis *pVis, bool correlated,
       pVis->record[irow - 1].iviserr = NULL;
     }
     *pStatus = 0;
-    fits_clear_errmark();
   }
   else
   {
@@ -1077,24 +1097,24 @@ static STATUS read_oi_vis_complex(fitsfile *fptr, oi_vis *pVis, bool correlated,
       pVis->record[irow - 1].iviserr =
           chkmalloc(pVis->nwave * sizeof(pVis->record[0].iviserr[0]));
       fits_get_colnum(fptr, CASEINSEN, "RVIS", &colnum, pStatus);
-      fits_read_col(fptr, TDOUBLE, colnum, irow, 1, pVis->nwave, NULL,
+      fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, pVis->nwave, NULL,
                     pVis->record[irow - 1].rvis, &anynull, pStatus);
       fits_get_colnum(fptr, CASEINSEN, "RVISERR", &colnum, pStatus);
-      fits_read_col(fptr, TDOUBLE, colnum, irow, 1, pVis->nwave, NULL,
+      fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, pVis->nwave, NULL,
                     pVis->record[irow - 1].rviserr, &anynull, pStatus);
       fits_get_colnum(fptr, CASEINSEN, "IVIS", &colnum, pStatus);
-      fits_read_col(fptr, TDOUBLE, colnum, irow, 1, pVis->nwave, NULL,
+      fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, pVis->nwave, NULL,
                     pVis->record[irow - 1].ivis, &anynull, pStatus);
       fits_get_colnum(fptr, CASEINSEN, "IVISERR", &colnum, pStatus);
-      fits_read_col(fptr, TDOUBLE, colnum, irow, 1, pVis->nwave, NULL,
+      fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, pVis->nwave, NULL,
                     pVis->record[irow - 1].iviserr, &anynull, pStatus);
       if (correlated)
       {
         fits_get_colnum(fptr, CASEINSEN, "CORRINDX_RVIS", &colnum, pStatus);
-        fits_read_col(fptr, TINT, colnum, irow, 1, 1, NULL,
+        fits_read_col(fptr, TINT, colnum, row0 + irow, 1, 1, NULL,
                       &pVis->record[irow - 1].corrindx_rvis, &anynull, pStatus);
         fits_get_colnum(fptr, CASEINSEN, "CORRINDX_IVIS", &colnum, pStatus);
-        fits_read_col(fptr, TINT, colnum, irow, 1, 1, NULL,
+        fits_read_col(fptr, TINT, colnum, row0 + irow, 1, 1, NULL,
                       &pVis->record[irow - 1].corrindx_ivis, &anynull, pStatus);
       }
     }
@@ -1105,7 +1125,8 @@ static STATUS read_oi_vis_complex(fitsfile *fptr, oi_vis *pVis, bool correlated,
 /**
  * Read OI_VIS optional content
  */
-static STATUS read_oi_vis_opt(fitsfile *fptr, oi_vis *pVis, STATUS *pStatus)
+static STATUS read_oi_vis_opt(fitsfile *fptr, oi_vis *pVis, long row0,
+                              STATUS *pStatus)
 {
   int irow, colnum, anynull;
   bool correlated;
@@ -1137,14 +1158,13 @@ static STATUS read_oi_vis_opt(fitsfile *fptr, oi_vis *pVis, STATUS *pStatus)
     for (irow = 1; irow <= pVis->numrec; irow++)
     {
       fits_get_colnum(fptr, CASEINSEN, "CORRINDX_VISAMP", &colnum, pStatus);
-      fits_read_col(fptr, TINT, colnum, irow, 1, 1, NULL,
+      fits_read_col(fptr, TINT, colnum, row0 + irow, 1, 1, NULL,
                     &pVis->record[irow - 1].corrindx_visamp, &anynull, pStatus);
       fits_get_colnum(fptr, CASEINSEN, "CORRINDX_VISPHI", &colnum, pStatus);
-      fits_read_col(fptr, TINT, colnum, irow, 1, 1, NULL,
+      fits_read_col(fptr, TINT, colnum, row0 + irow, 1, 1, NULL,
                     &pVis->record[irow - 1].corrindx_visphi, &anynull, pStatus);
     }
   }
-  fits_write_errmark();
   fits_get_colnum(fptr, CASEINSEN, "VISREFMAP", &colnum, pStatus);
   if (*pStatus == COL_NOT_FOUND)
   {
@@ -1154,7 +1174,6 @@ static STATUS read_oi_vis_opt(fitsfile *fptr, oi_vis *pVis, STATUS *pStatus)
       pVis->record[irow - 1].visrefmap = NULL;
     }
     *pStatus = 0;
-    fits_clear_errmark();
   }
   else
   {
@@ -1163,53 +1182,52 @@ static STATUS read_oi_vis_opt(fitsfile *fptr, oi_vis *pVis, STATUS *pStatus)
     {
       pVis->record[irow - 1].visrefmap = chkmalloc(
           pVis->nwave * pVis->nwave * sizeof(pVis->record[0].visrefmap[0]));
-      fits_read_col(fptr, TLOGICAL, colnum, irow, 1, pVis->nwave * pVis->nwave,
-                    NULL, pVis->record[irow - 1].visrefmap, &anynull, pStatus);
+      fits_read_col(fptr, TLOGICAL, colnum, row0 + irow, 1,
+                    pVis->nwave * pVis->nwave, NULL,
+                    pVis->record[irow - 1].visrefmap, &anynull, pStatus);
     }
   }
-  read_oi_vis_complex(fptr, pVis, correlated, pStatus);
+  read_oi_vis_complex(fptr, pVis, row0, correlated, pStatus);
 
   return *pStatus;
 }
 
 /**
- * Read next OI_VIS fits binary table
+ * Read OI_VIS fits binary table at current HDU.
  *
- * @param fptr     see cfitsio documentation
- * @param pVis     pointer to data struct, see exchange.h
- * @param pStatus  pointer to status variable
+ * Reads at most @a numRows rows starting at @a firstRow, or all rows
+ * from @a firstRow onwards if @a numRows is negative.
+ *
+ * @param fptr      see cfitsio documentation
+ * @param pVis      pointer to data struct, see exchange.h
+ * @param firstRow  first table row to read (1 for first row)
+ * @param numRows   maximum number of rows to read, or -1 for all
+ * @param pStatus   pointer to status variable
  *
  * @return On error, returns non-zero cfitsio error code (also assigned to
  *         *pStatus). Contents of data struct are undefined
  */
-STATUS read_next_oi_vis(fitsfile *fptr, oi_vis *pVis, STATUS *pStatus)
+static STATUS read_oi_vis_chdu(fitsfile *fptr, oi_vis *pVis, long firstRow,
+                               long numRows, STATUS *pStatus)
 {
-  const char function[] = "read_next_oi_vis";
   char keyword[FLEN_KEYWORD];
   const int revision = OI_REVN_V2_VIS;
   int irow, colnum, anynull;
-  long nrows, repeat;
+  long nrows, repeat, row0;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
-  next_named_hdu(fptr, "OI_VIS", pStatus);
-  if (*pStatus == END_OF_FILE)
-    return *pStatus; /* don't report EOF to stderr */
-  else if (*pStatus)
-    goto except;
-  verify_chksum(fptr, pStatus);
-
   /* Read table */
   fits_read_key(fptr, TINT, "OI_REVN", &pVis->revision, NULL, pStatus);
   if (*pStatus)
   {
     fits_write_errmsg("Failed to read OI_REVN kw in OI_VIS table");
-    goto except;
+    return *pStatus;
   }
   if (pVis->revision > revision)
   {
-    printf("WARNING! Expecting OI_REVN <= %d in OI_VIS table. Got %d\n",
-           revision, pVis->revision);
+    oi_warning("Expecting OI_REVN <= %d in OI_VIS table. Got %d\n",
+               revision, pVis->revision);
   }
   fits_read_key(fptr, TSTRING, "DATE-OBS", pVis->date_obs, NULL, pStatus);
   read_key_opt_string(fptr, "ARRNAME", pVis->arrname, pStatus);
@@ -1219,8 +1237,11 @@ STATUS read_next_oi_vis(fitsfile *fptr, oi_vis *pVis, STATUS *pStatus)
   /* note format specifies same repeat count for VIS* & FLAG columns = nwave */
   fits_get_colnum(fptr, CASEINSEN, "VISAMP", &colnum, pStatus);
   fits_get_coltype(fptr, colnum, NULL, &repeat, NULL, pStatus);
-  if (*pStatus) goto except;
-  alloc_oi_vis(pVis, nrows, repeat);
+  if (*pStatus) return *pStatus;
+  row0 = firstRow - 1;
+  if (numRows < 0 || row0 + numRows > nrows) numRows = nrows - row0;
+  if (numRows < 0) numRows = 0;
+  alloc_oi_vis(pVis, numRows, repeat);
   /* read VISAMP unit (optional) */
   snprintf(keyword, FLEN_KEYWORD, "TUNIT%d", colnum);
   read_key_opt_string(fptr, keyword, pVis->ampunit, pStatus);
@@ -1228,91 +1249,146 @@ STATUS read_next_oi_vis(fitsfile *fptr, oi_vis *pVis, STATUS *pStatus)
   for (irow = 1; irow <= pVis->numrec; irow++)
   {
     fits_get_colnum(fptr, CASEINSEN, "TARGET_ID", &colnum, pStatus);
-    fits_read_col(fptr, TINT, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TINT, colnum, row0 + irow, 1, 1, NULL,
                   &pVis->record[irow - 1].target_id, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "TIME", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, 1, NULL,
                   &pVis->record[irow - 1].time, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "MJD", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, 1, NULL,
                   &pVis->record[irow - 1].mjd, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "INT_TIME", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, 1, NULL,
                   &pVis->record[irow - 1].int_time, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "VISAMP", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, pVis->nwave, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, pVis->nwave, NULL,
                   pVis->record[irow - 1].visamp, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "VISAMPERR", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, pVis->nwave, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, pVis->nwave, NULL,
                   pVis->record[irow - 1].visamperr, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "VISPHI", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, pVis->nwave, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, pVis->nwave, NULL,
                   pVis->record[irow - 1].visphi, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "VISPHIERR", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, pVis->nwave, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, pVis->nwave, NULL,
                   pVis->record[irow - 1].visphierr, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "UCOORD", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, 1, NULL,
                   &pVis->record[irow - 1].ucoord, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "VCOORD", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, 1, NULL,
                   &pVis->record[irow - 1].vcoord, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "STA_INDEX", &colnum, pStatus);
-    fits_read_col(fptr, TINT, colnum, irow, 1, 2, NULL,
+    fits_read_col(fptr, TINT, colnum, row0 + irow, 1, 2, NULL,
                   pVis->record[irow - 1].sta_index, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "FLAG", &colnum, pStatus);
-    fits_read_col(fptr, TLOGICAL, colnum, irow, 1, pVis->nwave, NULL,
+    fits_read_col(fptr, TLOGICAL, colnum, row0 + irow, 1, pVis->nwave, NULL,
                   pVis->record[irow - 1].flag, &anynull, pStatus);
   }
-  read_oi_vis_opt(fptr, pVis, pStatus);
+  read_oi_vis_opt(fptr, pVis, row0, pStatus);
 
-except:
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
   return *pStatus;
 }
 
 /**
- * Read next OI_VIS2 fits binary table
+ * Read next OI_VIS fits binary table
  *
  * @param fptr     see cfitsio documentation
- * @param pVis2    pointer to data struct, see exchange.h
+ * @param pVis     pointer to data struct, see exchange.h
  * @param pStatus  pointer to status variable
  *
  * @return On error, returns non-zero cfitsio error code (also assigned to
  *         *pStatus). Contents of data struct are undefined
  */
-STATUS read_next_oi_vis2(fitsfile *fptr, oi_vis2 *pVis2, STATUS *pStatus)
+STATUS read_next_oi_vis(fitsfile *fptr, oi_vis *pVis, STATUS *pStatus)
 {
-  const char function[] = "read_next_oi_vis2";
-  bool correlated;
-  const int revision = OI_REVN_V2_VIS2;
-  int irow, colnum, anynull;
-  long nrows, repeat;
+  const char function[] = "read_next_oi_vis";
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
-  next_named_hdu(fptr, "OI_VIS2", pStatus);
+  next_named_hdu(fptr, "OI_VIS", pStatus);
   if (*pStatus == END_OF_FILE)
     return *pStatus; /* don't report EOF to stderr */
-  else if (*pStatus)
-    goto except;
   verify_chksum(fptr, pStatus);
+  start = oi_profile_start();
+  read_oi_vis_chdu(fptr, pVis, 1, -1, pStatus);
+  profile_decode(fptr, start, 1, pVis->numrec, pStatus);
+
+  if (*pStatus) oi_report_error(function, *pStatus);
+  return *pStatus;
+}
+
+/**
+ * Read range of rows from OI_VIS fits binary table at current HDU
+ *
+ * Reads the table keywords and at most @a numRows rows starting at
+ * @a firstRow, so that a large table may be processed in chunks
+ * without holding all of its records in memory. The oi_vis::numrec
+ * attribute of @a pVis is set to the number of rows actually read,
+ * which is less than @a numRows if the end of the table is reached.
+ *
+ * @param fptr      see cfitsio documentation
+ * @param firstRow  first table row to read (1 for first row)
+ * @param numRows   maximum number of rows to read, or -1 for all
+ * @param pVis      pointer to data struct, see exchange.h
+ * @param pStatus   pointer to status variable
+ *
+ * @return On error, returns non-zero cfitsio error code (also assigned to
+ *         *pStatus). Contents of data struct are undefined
+ */
+STATUS read_oi_vis_rows(fitsfile *fptr, long firstRow, long numRows,
+                        oi_vis *pVis, STATUS *pStatus)
+{
+  const char function[] = "read_oi_vis_rows";
+  oi_timer start;
+
+  if (*pStatus) return *pStatus; /* error flag set - do nothing */
+
+  start = oi_profile_start();
+  read_oi_vis_chdu(fptr, pVis, firstRow, numRows, pStatus);
+  profile_decode(fptr, start, firstRow, pVis->numrec, pStatus);
+
+  if (*pStatus) oi_report_error(function, *pStatus);
+  return *pStatus;
+}
+
+/**
+ * Read OI_VIS2 fits binary table at current HDU.
+ *
+ * Reads at most @a numRows rows starting at @a firstRow, or all rows
+ * from @a firstRow onwards if @a numRows is negative.
+ *
+ * @param fptr      see cfitsio documentation
+ * @param pVis2     pointer to data struct, see exchange.h
+ * @param firstRow  first table row to read (1 for first row)
+ * @param numRows   maximum number of rows to read, or -1 for all
+ * @param pStatus   pointer to status variable
+ *
+ * @return On error, returns non-zero cfitsio error code (also assigned to
+ *         *pStatus). Contents of data struct are undefined
+ */
+static STATUS read_oi_vis2_chdu(fitsfile *fptr, oi_vis2 *pVis2, long firstRow,
+                                long numRows, STATUS *pStatus)
+{
+  bool correlated;
+  const int revision = OI_REVN_V2_VIS2;
+  int irow, colnum, anynull;
+  long nrows, repeat, row0;
+
+  if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
   /* Read table */
   fits_read_key(fptr, TINT, "OI_REVN", &pVis2->revision, NULL, pStatus);
   if (*pStatus)
   {
     fits_write_errmsg("Failed to read OI_REVN kw in OI_VIS2 table");
-    goto except;
+    return *pStatus;
   }
   if (pVis2->revision > revision)
   {
-    printf("WARNING! Expecting OI_REVN <= %d in OI_VIS2 table. Got %d\n",
-           revision, pVis2->revision);
+    oi_warning("Expecting OI_REVN <= %d in OI_VIS2 table. Got %d\n",
+               revision, pVis2->revision);
   }
   fits_read_key(fptr, TSTRING, "DATE-OBS", pVis2->date_obs, NULL, pStatus);
   read_key_opt_string(fptr, "ARRNAME", pVis2->arrname, pStatus);
@@ -1334,102 +1410,159 @@ STATUS read_next_oi_vis2(fitsfile *fptr, oi_vis2 *pVis2, STATUS *pStatus)
   /* note format specifies same repeat count for VIS2* & FLAG columns = nwave*/
   fits_get_colnum(fptr, CASEINSEN, "VIS2DATA", &colnum, pStatus);
   fits_get_coltype(fptr, colnum, NULL, &repeat, NULL, pStatus);
-  if (*pStatus) goto except;
-  alloc_oi_vis2(pVis2, nrows, repeat);
+  if (*pStatus) return *pStatus;
+  row0 = firstRow - 1;
+  if (numRows < 0 || row0 + numRows > nrows) numRows = nrows - row0;
+  if (numRows < 0) numRows = 0;
+  alloc_oi_vis2(pVis2, numRows, repeat);
   /* read rows */
   for (irow = 1; irow <= pVis2->numrec; irow++)
   {
     fits_get_colnum(fptr, CASEINSEN, "TARGET_ID", &colnum, pStatus);
-    fits_read_col(fptr, TINT, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TINT, colnum, row0 + irow, 1, 1, NULL,
                   &pVis2->record[irow - 1].target_id, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "TIME", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, 1, NULL,
                   &pVis2->record[irow - 1].time, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "MJD", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, 1, NULL,
                   &pVis2->record[irow - 1].mjd, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "INT_TIME", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, 1, NULL,
                   &pVis2->record[irow - 1].int_time, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "VIS2DATA", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, pVis2->nwave, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, pVis2->nwave, NULL,
                   pVis2->record[irow - 1].vis2data, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "VIS2ERR", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, pVis2->nwave, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, pVis2->nwave, NULL,
                   pVis2->record[irow - 1].vis2err, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "UCOORD", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, 1, NULL,
                   &pVis2->record[irow - 1].ucoord, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "VCOORD", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, 1, NULL,
                   &pVis2->record[irow - 1].vcoord, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "STA_INDEX", &colnum, pStatus);
-    fits_read_col(fptr, TINT, colnum, irow, 1, 2, NULL,
+    fits_read_col(fptr, TINT, colnum, row0 + irow, 1, 2, NULL,
                   pVis2->record[irow - 1].sta_index, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "FLAG", &colnum, pStatus);
-    fits_read_col(fptr, TLOGICAL, colnum, irow, 1, pVis2->nwave, NULL,
+    fits_read_col(fptr, TLOGICAL, colnum, row0 + irow, 1, pVis2->nwave, NULL,
                   pVis2->record[irow - 1].flag, &anynull, pStatus);
 
     /* read optional columns */
     if (correlated)
     {
       fits_get_colnum(fptr, CASEINSEN, "CORRINDX_VIS2DATA", &colnum, pStatus);
-      fits_read_col(fptr, TINT, colnum, irow, 1, 1, NULL,
+      fits_read_col(fptr, TINT, colnum, row0 + irow, 1, 1, NULL,
                     &pVis2->record[irow - 1].corrindx_vis2data, &anynull,
                     pStatus);
     }
   }
 
-except:
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "FITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
   return *pStatus;
 }
 
 /**
- * Read next OI_T3 fits binary table
+ * Read next OI_VIS2 fits binary table
  *
  * @param fptr     see cfitsio documentation
- * @param pT3      pointer to data struct, see exchange.h
+ * @param pVis2    pointer to data struct, see exchange.h
  * @param pStatus  pointer to status variable
  *
  * @return On error, returns non-zero cfitsio error code (also assigned to
  *         *pStatus). Contents of data struct are undefined
  */
-STATUS read_next_oi_t3(fitsfile *fptr, oi_t3 *pT3, STATUS *pStatus)
+STATUS read_next_oi_vis2(fitsfile *fptr, oi_vis2 *pVis2, STATUS *pStatus)
 {
-  const char function[] = "read_next_oi_t3";
-  bool correlated;
-  const int revision = OI_REVN_V2_T3;
-  int irow, colnum, anynull;
-  long nrows, repeat;
+  const char function[] = "read_next_oi_vis2";
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
-  next_named_hdu(fptr, "OI_T3", pStatus);
+  next_named_hdu(fptr, "OI_VIS2", pStatus);
   if (*pStatus == END_OF_FILE)
     return *pStatus; /* don't report EOF to stderr */
-  else if (*pStatus)
-    goto except;
   verify_chksum(fptr, pStatus);
+  start = oi_profile_start();
+  read_oi_vis2_chdu(fptr, pVis2, 1, -1, pStatus);
+  profile_decode(fptr, start, 1, pVis2->numrec, pStatus);
+
+  if (*pStatus) oi_report_error(function, *pStatus);
+  return *pStatus;
+}
+
+/**
+ * Read range of rows from OI_VIS2 fits binary table at current HDU
+ *
+ * Reads the table keywords and at most @a numRows rows starting at
+ * @a firstRow, so that a large table may be processed in chunks
+ * without holding all of its records in memory. The oi_vis2::numrec
+ * attribute of @a pVis2 is set to the number of rows actually read,
+ * which is less than @a numRows if the end of the table is reached.
+ *
+ * @param fptr      see cfitsio documentation
+ * @param firstRow  first table row to read (1 for first row)
+ * @param numRows   maximum number of rows to read, or -1 for all
+ * @param pVis2     pointer to data struct, see exchange.h
+ * @param pStatus   pointer to status variable
+ *
+ * @return On error, returns non-zero cfitsio error code (also assigned to
+ *         *pStatus). Contents of data struct are undefined
+ */
+STATUS read_oi_vis2_rows(fitsfile *fptr, long firstRow, long numRows,
+                         oi_vis2 *pVis2, STATUS *pStatus)
+{
+  const char function[] = "read_oi_vis2_rows";
+  oi_timer start;
+
+  if (*pStatus) return *pStatus; /* error flag set - do nothing */
+
+  start = oi_profile_start();
+  read_oi_vis2_chdu(fptr, pVis2, firstRow, numRows, pStatus);
+  profile_decode(fptr, start, firstRow, pVis2->numrec, pStatus);
+
+  if (*pStatus) oi_report_error(function, *pStatus);
+  return *pStatus;
+}
+
+/**
+ * Read OI_T3 fits binary table at current HDU.
+ *
+ * Reads at most @a numRows rows starting at @a firstRow, or all rows
+ * from @a firstRow onwards if @a numRows is negative.
+ *
+ * @param fptr      see cfitsio documentation
+ * @param pT3       pointer to data struct, see exchange.h
+ * @param firstRow  first table row to read (1 for first row)
+ * @param numRows   maximum number of rows to read, or -1 for all
+ * @param pStatus   pointer to status variable
+ *
+ * @return On error, returns non-zero cfitsio error code (also assigned to
+ *         *pStatus). Contents of data struct are undefined
+ */
+static STATUS read_oi_t3_chdu(fitsfile *fptr, oi_t3 *pT3, long firstRow,
+                              long numRows, STATUS *pStatus)
+{
+  bool correlated;
+  const int revision = OI_REVN_V2_T3;
+  int irow, colnum, anynull;
+  long nrows, repeat, row0;
+
+  if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
   /* Read table */
   fits_read_key(fptr, TINT, "OI_REVN", &pT3->revision, NULL, pStatus);
   if (*pStatus)
   {
     fits_write_errmsg("Failed to read OI_REVN kw in OI_T3 table");
-    goto except;
+    return *pStatus;
   }
   if (pT3->revision > revision)
   {
-    printf("WARNING! Expecting OI_REVN <= %d in OI_T3 table. Got %d\n",
-           revision, pT3->revision);
+    oi_warning("Expecting OI_REVN <= %d in OI_T3 table. Got %d\n",
+               revision, pT3->revision);
   }
   fits_read_key(fptr, TSTRING, "DATE-OBS", pT3->date_obs, NULL, pStatus);
-  fits_write_errmark();
   read_key_opt_string(fptr, "ARRNAME", pT3->arrname, pStatus);
   fits_read_key(fptr, TSTRING, "INSNAME", pT3->insname, NULL, pStatus);
 
@@ -1450,114 +1583,172 @@ STATUS read_next_oi_t3(fitsfile *fptr, oi_t3 *pT3, STATUS *pStatus)
   /* format specifies same repeat count for T3* & FLAG columns */
   fits_get_colnum(fptr, CASEINSEN, "T3AMP", &colnum, pStatus);
   fits_get_coltype(fptr, colnum, NULL, &repeat, NULL, pStatus);
-  if (*pStatus) goto except;
-  alloc_oi_t3(pT3, nrows, repeat);
+  if (*pStatus) return *pStatus;
+  row0 = firstRow - 1;
+  if (numRows < 0 || row0 + numRows > nrows) numRows = nrows - row0;
+  if (numRows < 0) numRows = 0;
+  alloc_oi_t3(pT3, numRows, repeat);
   /* read rows */
   for (irow = 1; irow <= pT3->numrec; irow++)
   {
     fits_get_colnum(fptr, CASEINSEN, "TARGET_ID", &colnum, pStatus);
-    fits_read_col(fptr, TINT, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TINT, colnum, row0 + irow, 1, 1, NULL,
                   &pT3->record[irow - 1].target_id, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "TIME", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, 1, NULL,
                   &pT3->record[irow - 1].time, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "MJD", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, 1, NULL,
                   &pT3->record[irow - 1].mjd, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "INT_TIME", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, 1, NULL,
                   &pT3->record[irow - 1].int_time, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "T3AMP", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, pT3->nwave, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, pT3->nwave, NULL,
                   pT3->record[irow - 1].t3amp, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "T3AMPERR", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, pT3->nwave, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, pT3->nwave, NULL,
                   pT3->record[irow - 1].t3amperr, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "T3PHI", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, pT3->nwave, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, pT3->nwave, NULL,
                   pT3->record[irow - 1].t3phi, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "T3PHIERR", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, pT3->nwave, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, pT3->nwave, NULL,
                   pT3->record[irow - 1].t3phierr, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "U1COORD", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, 1, NULL,
                   &pT3->record[irow - 1].u1coord, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "V1COORD", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, 1, NULL,
                   &pT3->record[irow - 1].v1coord, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "U2COORD", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, 1, NULL,
                   &pT3->record[irow - 1].u2coord, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "V2COORD", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, 1, NULL,
                   &pT3->record[irow - 1].v2coord, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "STA_INDEX", &colnum, pStatus);
-    fits_read_col(fptr, TINT, colnum, irow, 1, 3, NULL,
+    fits_read_col(fptr, TINT, colnum, row0 + irow, 1, 3, NULL,
                   pT3->record[irow - 1].sta_index, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "FLAG", &colnum, pStatus);
-    fits_read_col(fptr, TLOGICAL, colnum, irow, 1, pT3->nwave, NULL,
+    fits_read_col(fptr, TLOGICAL, colnum, row0 + irow, 1, pT3->nwave, NULL,
                   pT3->record[irow - 1].flag, &anynull, pStatus);
 
     /* read optional columns */
     if (correlated)
     {
       fits_get_colnum(fptr, CASEINSEN, "CORRINDX_T3AMP", &colnum, pStatus);
-      fits_read_col(fptr, TINT, colnum, irow, 1, 1, NULL,
+      fits_read_col(fptr, TINT, colnum, row0 + irow, 1, 1, NULL,
                     &pT3->record[irow - 1].corrindx_t3amp, &anynull, pStatus);
       fits_get_colnum(fptr, CASEINSEN, "CORRINDX_T3PHI", &colnum, pStatus);
-      fits_read_col(fptr, TINT, colnum, irow, 1, 1, NULL,
+      fits_read_col(fptr, TINT, colnum, row0 + irow, 1, 1, NULL,
                     &pT3->record[irow - 1].corrindx_t3phi, &anynull, pStatus);
     }
   }
 
-except:
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
   return *pStatus;
 }
 
 /**
- * Read next OI_FLUX fits binary table
+ * Read next OI_T3 fits binary table
  *
  * @param fptr     see cfitsio documentation
- * @param pFlux    pointer to data struct, see exchange.h
+ * @param pT3      pointer to data struct, see exchange.h
  * @param pStatus  pointer to status variable
  *
  * @return On error, returns non-zero cfitsio error code (also assigned to
  *         *pStatus). Contents of data struct are undefined
  */
-STATUS read_next_oi_flux(fitsfile *fptr, oi_flux *pFlux, STATUS *pStatus)
+STATUS read_next_oi_t3(fitsfile *fptr, oi_t3 *pT3, STATUS *pStatus)
 {
-  const char function[] = "read_next_oi_flux";
-  bool correlated;
-  char keyword[FLEN_KEYWORD], value[FLEN_VALUE];
-  const int revision = OI_REVN_V2_FLUX;
-  int irow, colnum, anynull;
-  long nrows, repeat;
+  const char function[] = "read_next_oi_t3";
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
-  next_named_hdu(fptr, "OI_FLUX", pStatus);
+  next_named_hdu(fptr, "OI_T3", pStatus);
   if (*pStatus == END_OF_FILE)
     return *pStatus; /* don't report EOF to stderr */
-  else if (*pStatus)
-    goto except;
   verify_chksum(fptr, pStatus);
+  start = oi_profile_start();
+  read_oi_t3_chdu(fptr, pT3, 1, -1, pStatus);
+  profile_decode(fptr, start, 1, pT3->numrec, pStatus);
+
+  if (*pStatus) oi_report_error(function, *pStatus);
+  return *pStatus;
+}
+
+/**
+ * Read range of rows from OI_T3 fits binary table at current HDU
+ *
+ * Reads the table keywords and at most @a numRows rows starting at
+ * @a firstRow, so that a large table may be processed in chunks
+ * without holding all of its records in memory. The oi_t3::numrec
+ * attribute of @a pT3 is set to the number of rows actually read,
+ * which is less than @a numRows if the end of the table is reached.
+ *
+ * @param fptr      see cfitsio documentation
+ * @param firstRow  first table row to read (1 for first row)
+ * @param numRows   maximum number of rows to read, or -1 for all
+ * @param pT3       pointer to data struct, see exchange.h
+ * @param pStatus   pointer to status variable
+ *
+ * @return On error, returns non-zero cfitsio error code (also assigned to
+ *         *pStatus). Contents of data struct are undefined
+ */
+STATUS read_oi_t3_rows(fitsfile *fptr, long firstRow, long numRows,
+                       oi_t3 *pT3, STATUS *pStatus)
+{
+  const char function[] = "read_oi_t3_rows";
+  oi_timer start;
+
+  if (*pStatus) return *pStatus; /* error flag set - do nothing */
+
+  start = oi_profile_start();
+  read_oi_t3_chdu(fptr, pT3, firstRow, numRows, pStatus);
+  profile_decode(fptr, start, firstRow, pT3->numrec, pStatus);
+
+  if (*pStatus) oi_report_error(function, *pStatus);
+  return *pStatus;
+}
+
+/**
+ * Read OI_FLUX fits binary table at current HDU.
+ *
+ * Reads at most @a numRows rows starting at @a firstRow, or all rows
+ * from @a firstRow onwards if @a numRows is negative.
+ *
+ * @param fptr      see cfitsio documentation
+ * @param pFlux     pointer to data struct, see exchange.h
+ * @param firstRow  first table row to read (1 for first row)
+ * @param numRows   maximum number of rows to read, or -1 for all
+ * @param pStatus   pointer to status variable
+ *
+ * @return On error, returns non-zero cfitsio error code (also assigned to
+ *         *pStatus). Contents of data struct are undefined
+ */
+static STATUS read_oi_flux_chdu(fitsfile *fptr, oi_flux *pFlux, long firstRow,
+                                long numRows, STATUS *pStatus)
+{
+  bool correlated;
+  char keyword[FLEN_KEYWORD], value[FLEN_VALUE];
+  const int revision = OI_REVN_V2_FLUX;
+  int irow, colnum, anynull;
+  long nrows, repeat, row0;
+
+  if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
   /* Read table */
   fits_read_key(fptr, TINT, "OI_REVN", &pFlux->revision, NULL, pStatus);
   if (*pStatus)
   {
     fits_write_errmsg("Failed to read OI_REVN kw in OI_FLUX table");
-    goto except;
+    return *pStatus;
   }
   if (pFlux->revision > revision)
   {
-    printf("WARNING! Expecting OI_REVN <= %d in OI_FLUX table. Got %d\n",
-           revision, pFlux->revision);
+    oi_warning("Expecting OI_REVN <= %d in OI_FLUX table. Got %d\n",
+               revision, pFlux->revision);
   }
   fits_read_key(fptr, TSTRING, "DATE-OBS", pFlux->date_obs, NULL, pStatus);
   read_key_opt_string(fptr, "ARRNAME", pFlux->arrname, pStatus);
@@ -1580,8 +1771,11 @@ STATUS read_next_oi_flux(fitsfile *fptr, oi_flux *pFlux, STATUS *pStatus)
   /* note format specifies same repeat count for FLUX* columns = nwave */
   fits_get_colnum(fptr, CASEINSEN, "FLUXDATA", &colnum, pStatus);
   fits_get_coltype(fptr, colnum, NULL, &repeat, NULL, pStatus);
-  if (*pStatus) goto except;
-  alloc_oi_flux(pFlux, nrows, repeat);
+  if (*pStatus) return *pStatus;
+  row0 = firstRow - 1;
+  if (numRows < 0 || row0 + numRows > nrows) numRows = nrows - row0;
+  if (numRows < 0) numRows = 0;
+  alloc_oi_flux(pFlux, numRows, repeat);
   /* read unit (mandatory) */
   snprintf(keyword, FLEN_KEYWORD, "TUNIT%d", colnum);
   fits_read_key(fptr, TSTRING, keyword, pFlux->fluxunit, NULL, pStatus);
@@ -1589,52 +1783,107 @@ STATUS read_next_oi_flux(fitsfile *fptr, oi_flux *pFlux, STATUS *pStatus)
   for (irow = 1; irow <= pFlux->numrec; irow++)
   {
     fits_get_colnum(fptr, CASEINSEN, "TARGET_ID", &colnum, pStatus);
-    fits_read_col(fptr, TINT, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TINT, colnum, row0 + irow, 1, 1, NULL,
                   &pFlux->record[irow - 1].target_id, &anynull, pStatus);
     /* no TIME column */
     fits_get_colnum(fptr, CASEINSEN, "MJD", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, 1, NULL,
                   &pFlux->record[irow - 1].mjd, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "INT_TIME", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, 1, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, 1, NULL,
                   &pFlux->record[irow - 1].int_time, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "FLUXDATA", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, pFlux->nwave, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, pFlux->nwave, NULL,
                   pFlux->record[irow - 1].fluxdata, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "FLUXERR", &colnum, pStatus);
-    fits_read_col(fptr, TDOUBLE, colnum, irow, 1, pFlux->nwave, NULL,
+    fits_read_col(fptr, TDOUBLE, colnum, row0 + irow, 1, pFlux->nwave, NULL,
                   pFlux->record[irow - 1].fluxerr, &anynull, pStatus);
     fits_get_colnum(fptr, CASEINSEN, "FLAG", &colnum, pStatus);
-    fits_read_col(fptr, TLOGICAL, colnum, irow, 1, pFlux->nwave, NULL,
+    fits_read_col(fptr, TLOGICAL, colnum, row0 + irow, 1, pFlux->nwave, NULL,
                   pFlux->record[irow - 1].flag, &anynull, pStatus);
     /* read optional columns */
-    fits_write_errmark();
     fits_get_colnum(fptr, CASEINSEN, "STA_INDEX", &colnum, pStatus);
     if (*pStatus == COL_NOT_FOUND)
     {
       pFlux->record[irow - 1].sta_index = -1;
       *pStatus = 0;
-      fits_clear_errmark();
     }
     else
     {
-      fits_read_col(fptr, TINT, colnum, irow, 1, 1, NULL,
+      fits_read_col(fptr, TINT, colnum, row0 + irow, 1, 1, NULL,
                     &pFlux->record[irow - 1].sta_index, &anynull, pStatus);
     }
     if (correlated)
     {
       fits_get_colnum(fptr, CASEINSEN, "CORRINDX_FLUXDATA", &colnum, pStatus);
-      fits_read_col(fptr, TINT, colnum, irow, 1, 1, NULL,
+      fits_read_col(fptr, TINT, colnum, row0 + irow, 1, 1, NULL,
                     &pFlux->record[irow - 1].corrindx_fluxdata, &anynull,
                     pStatus);
     }
   }
 
-except:
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
+  return *pStatus;
+}
+
+/**
+ * Read next OI_FLUX fits binary table
+ *
+ * @param fptr     see cfitsio documentation
+ * @param pFlux    pointer to data struct, see exchange.h
+ * @param pStatus  pointer to status variable
+ *
+ * @return On error, returns non-zero cfitsio error code (also assigned to
+ *         *pStatus). Contents of data struct are undefined
+ */
+STATUS read_next_oi_flux(fitsfile *fptr, oi_flux *pFlux, STATUS *pStatus)
+{
+  const char function[] = "read_next_oi_flux";
+  oi_timer start;
+
+  if (*pStatus) return *pStatus; /* error flag set - do nothing */
+
+  next_named_hdu(fptr, "OI_FLUX", pStatus);
+  if (*pStatus == END_OF_FILE)
+    return *pStatus; /* don't report EOF to stderr */
+  verify_chksum(fptr, pStatus);
+  start = oi_profile_start();
+  read_oi_flux_chdu(fptr, pFlux, 1, -1, pStatus);
+  profile_decode(fptr, start, 1, pFlux->numrec, pStatus);
+
+  if (*pStatus) oi_report_error(function, *pStatus);
+  return *pStatus;
+}
+
+/**
+ * Read range of rows from OI_FLUX fits binary table at current HDU
+ *
+ * Reads the table keywords and at most @a numRows rows starting at
+ * @a firstRow, so that a large table may be processed in chunks
+ * without holding all of its records in memory. The oi_flux::numrec
+ * attribute of @a pFlux is set to the number of rows actually read,
+ * which is less than @a numRows if the end of the table is reached.
+ *
+ * @param fptr      see cfitsio documentation
+ * @param firstRow  first table row to read (1 for first row)
+ * @param numRows   maximum number of rows to read, or -1 for all
+ * @param pFlux     pointer to data struct, see exchange.h
+ * @param pStatus   pointer to status variable
+ *
+ * @return On error, returns non-zero cfitsio error code (also assigned to
+ *         *pStatus). Contents of data struct are undefined
+ */
+STATUS read_oi_flux_rows(fitsfile *fptr, long firstRow, long numRows,
+                         oi_flux *pFlux, STATUS *pStatus)
+{
+  const char function[] = "read_oi_flux_rows";
+  oi_timer start;
+
+  if (*pStatus) return *pStatus; /* error flag set - do nothing */
+
+  start = oi_profile_start();
+  read_oi_flux_chdu(fptr, pFlux, firstRow, numRows, pStatus);
+  profile_decode(fptr, start, firstRow, pFlux->numrec, pStatus);
+
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
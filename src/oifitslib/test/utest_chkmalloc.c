@@ -6,6 +6,7 @@
  */
 
 #include "chkmalloc.h"
+#include "oicontext.h"
 
 #include <glib.h>
 #include <errno.h>
@@ -23,13 +24,83 @@ static void test_succeed(void)
 
   void *ptr1 = chkmalloc(SIZE);
   assert_not_null(ptr1);
-  free(ptr1);
+  oi_free(ptr1);
 
   void *ptr2 = chkmalloc(SIZE);
   assert_not_null(ptr2);
   ptr2 = chkrealloc(ptr2, 2 * SIZE);
   assert_not_null(ptr2);
-  free(ptr2);
+  oi_free(ptr2);
+}
+
+/* Allocation statistics */
+static void test_stats(void)
+{
+  chkmalloc_stats stats;
+  void *ptr1, *ptr2;
+
+  /* Discard anything recorded if enabled by environment */
+  chkmalloc_stats_enable(FALSE);
+  chkmalloc_stats_enable(TRUE);
+  g_assert(chkmalloc_stats_enabled());
+
+  ptr1 = chkmalloc(SIZE);
+  ptr2 = chkmalloc(SIZE);
+  ptr2 = chkrealloc(ptr2, 2 * SIZE);
+  chkmalloc_stats_get(&stats);
+  g_assert_cmpint(stats.numAlloc, ==, 2);
+  g_assert_cmpint(stats.numRealloc, ==, 1);
+  g_assert_cmpint(stats.current, ==, 3 * SIZE);
+  g_assert_cmpint(stats.peak, ==, 3 * SIZE);
+  g_assert_cmpint(stats.numSite, ==, 3);
+
+  oi_free(ptr1);
+  oi_free(ptr2);
+  chkmalloc_stats_get(&stats);
+  g_assert_cmpint(stats.numFree, ==, 2);
+  g_assert_cmpint(stats.current, ==, 0);
+  g_assert_cmpint(stats.peak, ==, 3 * SIZE);
+
+  chkmalloc_stats_reset();
+  chkmalloc_stats_get(&stats);
+  g_assert_cmpint(stats.numAlloc, ==, 0);
+  g_assert_cmpint(stats.peak, ==, 0);
+  g_assert_cmpint(stats.numSite, ==, 0);
+
+  chkmalloc_stats_enable(FALSE);
+  ptr1 = chkmalloc(SIZE);
+  oi_free(ptr1);
+  chkmalloc_stats_get(&stats);
+  g_assert_cmpint(stats.numAlloc, ==, 0);
+}
+
+static gpointer alloc_thread(gpointer data)
+{
+  return chkmalloc(SIZE);
+}
+
+/* Statistics totalled over all threads */
+static void test_stats_total(void)
+{
+  chkmalloc_stats before, after;
+  GThread *thread;
+  void *ptr;
+
+  /* Enabling statistics applies to threads started later */
+  chkmalloc_stats_enable(TRUE);
+  chkmalloc_stats_get_total(&before);
+  thread = g_thread_new("alloc", alloc_thread, NULL);
+  ptr = g_thread_join(thread);
+  chkmalloc_stats_get_total(&after);
+  g_assert_cmpint(after.numAlloc, ==, before.numAlloc + 1);
+  g_assert_cmpint(after.current, ==, before.current + SIZE);
+
+  /* Block allocated by thread that has exited */
+  oi_free(ptr);
+  chkmalloc_stats_get_total(&after);
+  g_assert_cmpint(after.numFree, ==, before.numFree + 1);
+  g_assert_cmpint(after.current, ==, before.current);
+  chkmalloc_stats_enable(FALSE);
 }
 
 #define TEST_SUBPROCESS_FAILS(cmd)                                             \
@@ -61,6 +132,8 @@ int main(int argc, char *argv[])
 
   g_test_add_func("/chkmalloc/succeed", test_succeed);
   g_test_add_func("/chkmalloc/fail", test_fail);
+  g_test_add_func("/chkmalloc/stats", test_stats);
+  g_test_add_func("/chkmalloc/stats_total", test_stats_total);
 
   return g_test_run();
 }
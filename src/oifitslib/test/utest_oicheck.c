@@ -117,7 +117,6 @@ static void test_check(gconstpointer userData)
   int status;
   oi_check_result result;
   oi_breach_level level;
-  char msg[FLEN_ERRMSG];
 
   const TestSet *pSet = userData;
 
@@ -128,8 +127,6 @@ static void test_check(gconstpointer userData)
     status = 0;
     read_oi_fits(pSet->cases[i].filename, &inData, &status);
     g_assert_false(status);
-    if (fits_read_errmsg(msg))
-      g_error("Uncleared CFITSIO error message: %s", msg);
     level = (*pSet->cases[i].check)(&inData, &result);
     g_assert_cmpint(level, ==, result.level);
     print_check_result(&result);
@@ -145,12 +142,178 @@ static void test_check(gconstpointer userData)
   }
 }
 
+/** Assert two check results are identical, including locations */
+static void assert_same_result(const oi_check_result *pResult1,
+                               const oi_check_result *pResult2)
+{
+  int i;
+
+  g_assert_cmpint(pResult1->level, ==, pResult2->level);
+  g_assert_cmpstr(pResult1->description, ==, pResult2->description);
+  g_assert_cmpint(pResult1->numBreach, ==, pResult2->numBreach);
+  for (i = 0; i < MIN(pResult1->numBreach, MAX_REPORT); i++)
+    g_assert_cmpstr(pResult1->location[i], ==, pResult2->location[i]);
+}
+
+static void test_fused(gconstpointer userData)
+{
+  oi_fits inData;
+  oi_check_result results[OI_NUM_CHECK], result;
+  int status, i, k;
+
+  const TestSet *pSet = userData;
+
+  g_test_log_set_fatal_handler(ignoreMissing, NULL);
+
+  for (i = 0; i < pSet->numCases; i++)
+  {
+    status = 0;
+    read_oi_fits(pSet->cases[i].filename, &inData, &status);
+    g_assert_false(status);
+    (void)oi_check_fused(&inData, OI_NUM_CHECK, oi_check_funcs, results);
+    for (k = 0; k < OI_NUM_CHECK; k++)
+    {
+      (void)(*oi_check_funcs[k])(&inData, &result);
+      assert_same_result(&results[k], &result);
+      free_check_result(&result);
+      free_check_result(&results[k]);
+    }
+    free_oi_fits(&inData);
+  }
+}
+
+static void test_file(gconstpointer userData)
+{
+  oi_fits inData;
+  oi_check_result results[OI_NUM_CHECK], chunkResults[OI_NUM_CHECK];
+  oi_breach_level level, worst;
+  int status, i, k;
+
+  const TestSet *pSet = userData;
+
+  g_test_log_set_fatal_handler(ignoreMissing, NULL);
+
+  for (i = 0; i < pSet->numCases; i++)
+  {
+    status = 0;
+    read_oi_fits(pSet->cases[i].filename, &inData, &status);
+    g_assert_false(status);
+    level = oi_check_fused(&inData, OI_NUM_CHECK, oi_check_funcs, results);
+    free_oi_fits(&inData);
+
+    /* Small chunk size so that tables span several chunks */
+    worst = oi_check_file(pSet->cases[i].filename, 3, OI_NUM_CHECK,
+                          oi_check_funcs, OI_BREACH_NONE, chunkResults,
+                          &status);
+    g_assert_false(status);
+    g_assert_cmpint(worst, ==, level);
+    for (k = 0; k < OI_NUM_CHECK; k++)
+    {
+      assert_same_result(&chunkResults[k], &results[k]);
+      free_check_result(&chunkResults[k]);
+      free_check_result(&results[k]);
+    }
+  }
+}
+
+static void test_until(gconstpointer userData)
+{
+  const oi_breach_level stopLevels[] = {OI_BREACH_WARNING,
+                                        OI_BREACH_NOT_OIFITS};
+  oi_fits inData;
+  oi_check_result results[OI_NUM_CHECK], quickResults[OI_NUM_CHECK];
+  oi_breach_level level, worst, stop;
+  int status, i, j, k;
+
+  const TestSet *pSet = userData;
+
+  g_test_log_set_fatal_handler(ignoreMissing, NULL);
+
+  for (i = 0; i < pSet->numCases; i++)
+  {
+    status = 0;
+    read_oi_fits(pSet->cases[i].filename, &inData, &status);
+    g_assert_false(status);
+    level = oi_check_fused(&inData, OI_NUM_CHECK, oi_check_funcs, results);
+    for (j = 0; j < G_N_ELEMENTS(stopLevels); j++)
+    {
+      stop = stopLevels[j];
+      worst = oi_check_until(&inData, OI_NUM_CHECK, oi_check_funcs, stop,
+                             quickResults);
+      /* Same pass/fail decision, from a subset of the breaches */
+      g_assert_cmpint(worst >= stop, ==, level >= stop);
+      g_assert_cmpint(worst, <=, level);
+      for (k = 0; k < OI_NUM_CHECK; k++)
+      {
+        g_assert_cmpint(quickResults[k].numBreach, <=, results[k].numBreach);
+        free_check_result(&quickResults[k]);
+      }
+
+      worst = oi_check_file(pSet->cases[i].filename, 3, OI_NUM_CHECK,
+                            oi_check_funcs, stop, quickResults, &status);
+      g_assert_false(status);
+      g_assert_cmpint(worst >= stop, ==, level >= stop);
+      for (k = 0; k < OI_NUM_CHECK; k++)
+        free_check_result(&quickResults[k]);
+    }
+    for (k = 0; k < OI_NUM_CHECK; k++)
+      free_check_result(&results[k]);
+    free_oi_fits(&inData);
+  }
+}
+
+static void test_check_all(void)
+{
+  const char *filenames[] = {DIR2 "Mystery--AMBER--LowH.fits",
+                             DIR2 "bad_missing_corr.fits",
+                             DIR2 "bad_time.fits", DIR2 "bad_flux.fits"};
+  const int njobs[] = {1, 4};
+  oi_fits inData;
+  oi_check_result results[OI_NUM_CHECK], result;
+  oi_breach_level level, worst;
+  int status, i, j, k;
+
+  g_test_log_set_fatal_handler(ignoreMissing, NULL);
+
+  for (i = 0; i < G_N_ELEMENTS(filenames); i++)
+  {
+    status = 0;
+    read_oi_fits(filenames[i], &inData, &status);
+    g_assert_false(status);
+    for (j = 0; j < G_N_ELEMENTS(njobs); j++)
+    {
+      worst = oi_check_all(&inData, njobs[j], results);
+      level = OI_BREACH_NONE;
+      for (k = 0; k < OI_NUM_CHECK; k++)
+      {
+        /* Results must match those from calling checks one by one */
+        (void)(*oi_check_funcs[k])(&inData, &result);
+        g_assert_cmpint(results[k].level, ==, result.level);
+        g_assert_cmpint(results[k].numBreach, ==, result.numBreach);
+        if (result.level > level) level = result.level;
+        free_check_result(&result);
+        free_check_result(&results[k]);
+      }
+      g_assert_cmpint(worst, ==, level);
+    }
+    free_oi_fits(&inData);
+  }
+  g_assert_null(oi_check_funcs[OI_NUM_CHECK]);
+}
+
 int main(int argc, char *argv[])
 {
   g_test_init(&argc, &argv, NULL);
 
   g_test_add_data_func("/oifitslib/oicheck/pass", &passSet, test_check);
   g_test_add_data_func("/oifitslib/oicheck/fail", &failSet, test_check);
+  g_test_add_data_func("/oifitslib/oicheck/fused/pass", &passSet, test_fused);
+  g_test_add_data_func("/oifitslib/oicheck/fused/fail", &failSet, test_fused);
+  g_test_add_data_func("/oifitslib/oicheck/file/pass", &passSet, test_file);
+  g_test_add_data_func("/oifitslib/oicheck/file/fail", &failSet, test_file);
+  g_test_add_data_func("/oifitslib/oicheck/until/pass", &passSet, test_until);
+  g_test_add_data_func("/oifitslib/oicheck/until/fail", &failSet, test_until);
+  g_test_add_func("/oifitslib/oicheck/all", test_check_all);
 
   return g_test_run();
 }
@@ -0,0 +1,153 @@
+/**
+ * @file
+ * @ingroup oitable
+ * Unit tests of per-thread library context.
+ *
+ * Copyright (C) 2026 the OIFITSlib authors
+ *
+ *
+ * This file is part of OIFITSlib.
+ *
+ * OIFITSlib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * OIFITSlib is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with OIFITSlib.  If not, see
+ * http://www.gnu.org/licenses/
+ */
+
+#include "oifile.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define FILENAME_MISSING "OIFITS2/no_such_file.fits"
+#define FILENAME_V2 "OIFITS2/alp_aur--COAST_NICMOS.fits"
+
+typedef struct
+{
+  int numError;
+  int numWarning;
+  char lastMessage[256];
+
+} log_counts;
+
+static int numMalloc = 0;
+static int numFree = 0;
+
+static void count_log(oi_log_level level, const char *message, void *data)
+{
+  log_counts *pCounts = data;
+
+  if (level == OI_LOG_ERROR)
+    ++pCounts->numError;
+  else
+    ++pCounts->numWarning;
+  g_strlcpy(pCounts->lastMessage, message, sizeof(pCounts->lastMessage));
+}
+
+static void *count_malloc(size_t size)
+{
+  ++numMalloc;
+  return malloc(size);
+}
+
+static void *count_realloc(void *ptr, size_t size)
+{
+  if (ptr == NULL) ++numMalloc;
+  return realloc(ptr, size);
+}
+
+static void count_free(void *ptr)
+{
+  if (ptr != NULL) ++numFree;
+  free(ptr);
+}
+
+static void test_log(void)
+{
+  oi_context ctx;
+  log_counts counts = {0, 0, ""};
+  oi_fits data;
+  int status;
+
+  init_oi_context(&ctx);
+  ctx.logFunc = count_log;
+  ctx.logData = &counts;
+  g_assert(oi_set_context(&ctx) == NULL);
+  g_assert(oi_get_context() == &ctx);
+
+  status = 0;
+  read_oi_fits(FILENAME_MISSING, &data, &status);
+  g_assert_cmpint(status, !=, 0);
+  g_assert_cmpint(counts.numError, ==, 1);
+  g_assert(strstr(counts.lastMessage, "read_oi_fits") != NULL);
+
+  /* Errors are suppressed by hushErrors */
+  ctx.hushErrors = TRUE;
+  status = 0;
+  read_oi_fits(FILENAME_MISSING, &data, &status);
+  g_assert_cmpint(status, !=, 0);
+  g_assert_cmpint(counts.numError, ==, 1);
+
+  g_assert(oi_set_context(NULL) == &ctx);
+}
+
+static gpointer set_context_thread(gpointer data)
+{
+  oi_context *pCtx = data;
+
+  oi_set_context(pCtx);
+  return (gpointer)oi_get_context();
+}
+
+static void test_thread(void)
+{
+  oi_context ctx;
+  GThread *thread;
+
+  init_oi_context(&ctx);
+  thread = g_thread_new("context", set_context_thread, &ctx);
+  g_assert(g_thread_join(thread) == &ctx);
+  g_assert(oi_get_context() == NULL);
+}
+
+static void test_alloc(void)
+{
+  oi_context ctx;
+  oi_fits data;
+  int status;
+
+  init_oi_context(&ctx);
+  ctx.mallocFunc = count_malloc;
+  ctx.reallocFunc = count_realloc;
+  ctx.freeFunc = count_free;
+  oi_set_context(&ctx);
+
+  status = 0;
+  read_oi_fits(FILENAME_V2, &data, &status);
+  g_assert_cmpint(status, ==, 0);
+  g_assert_cmpint(numMalloc, >, 0);
+  free_oi_fits(&data);
+  g_assert_cmpint(numFree, >, 0);
+  g_assert_cmpint(numFree, <=, numMalloc);
+
+  oi_set_context(NULL);
+}
+
+int main(int argc, char *argv[])
+{
+  g_test_init(&argc, &argv, NULL);
+
+  g_test_add_func("/oifitslib/oicontext/log", test_log);
+  g_test_add_func("/oifitslib/oicontext/thread", test_thread);
+  g_test_add_func("/oifitslib/oicontext/alloc", test_alloc);
+
+  return g_test_run();
+}
@@ -56,7 +56,6 @@ static void test_version(void)
 {
   oi_fits data, data2;
   int status;
-  char msg[FLEN_ERRMSG];
 
   status = 0;
   read_oi_fits(FILENAME_V1, &data, &status);
@@ -88,16 +87,12 @@ static void test_version(void)
   g_assert_false(is_oi_fits_one(&data));
   g_assert_true(is_oi_fits_two(&data));
   free_oi_fits(&data);
-
-  if (fits_read_errmsg(msg))
-    g_error("Uncleared CFITSIO error message: %s", msg);
 }
 
 static void test_atomic(void)
 {
   oi_fits data;
   int status;
-  char msg[FLEN_ERRMSG];
 
   init_oi_fits(&data);
   g_assert_false(is_atomic(&data, 0.5));
@@ -113,24 +108,17 @@ static void test_atomic(void)
   g_assert_false(status);
   g_assert_false(is_atomic(&data, 0.5));
   free_oi_fits(&data);
-
-  if (fits_read_errmsg(msg))
-    g_error("Uncleared CFITSIO error message: %s", msg);
 }
 
 static void test_count(void)
 {
   oi_fits data;
   int status;
-  char msg[FLEN_ERRMSG];
   long numVis, numVis2, numT3;
 
   status = 0;
   read_oi_fits(FILENAME_MULTI, &data, &status);
 
-  if (fits_read_errmsg(msg))
-    g_error("Uncleared CFITSIO error message: %s", msg);
-
   count_oi_fits_data(&data, &numVis, &numVis2, &numT3);
 
   g_assert_cmpint(numVis, ==, MULTI_NUM_VIS);
@@ -143,7 +131,6 @@ static void test_lookup(void)
 {
   oi_fits data;
   int status;
-  char msg[FLEN_ERRMSG];
   oi_vis2 *pVis2;
   oi_array *pArray;
   element *pElem;
@@ -154,9 +141,6 @@ static void test_lookup(void)
   status = 0;
   read_oi_fits(FILENAME_MULTI, &data, &status);
 
-  if (fits_read_errmsg(msg))
-    g_error("Uncleared CFITSIO error message: %s", msg);
-
   pVis2 = (oi_vis2 *)data.vis2List->data;
 
   if (strlen(pVis2->arrname) > 0)
@@ -192,30 +176,63 @@ static void test_long_target(void)
 {
   oi_fits data;
   int status;
-  char msg[FLEN_ERRMSG];
 
   status = 0;
   read_oi_fits(FILENAME_LONG_TARGET, &data, &status);
   g_assert_false(status);
   free_oi_fits(&data);
-
-  if (fits_read_errmsg(msg))
-    g_error("Uncleared CFITSIO error message: %s", msg);
 }
 
 static void test_bad_checksum(void)
 {
   oi_fits data;
   int status;
-  char msg[FLEN_ERRMSG];
 
   status = 0;
   read_oi_fits(FILENAME_BAD_CHECKSUM, &data, &status);
   g_assert_false(status);
   free_oi_fits(&data);
+}
+
+static void test_profile(void)
+{
+  oi_fits data;
+  oi_profile profile;
+  int status;
+
+  oi_profile_reset();
+  oi_profile_enable(TRUE);
+  status = 0;
+  read_oi_fits(FILENAME_V2, &data, &status);
+  g_assert_false(status);
+  oi_profile_get(&profile);
+  g_assert_cmpint(profile.numCall[OI_PHASE_SEEK], >, 0);
+  g_assert_cmpint(profile.numCall[OI_PHASE_DECODE], >, 0);
+  g_assert_cmpint(profile.numCall[OI_PHASE_CHECKSUM], >, 0);
+  g_assert_cmpint(profile.count[OI_COUNT_HDU], >, 0);
+  g_assert_cmpint(profile.count[OI_COUNT_ROW_READ], >=, data.numVis2);
+  g_assert_cmpint(profile.count[OI_COUNT_BYTE_READ], >, 0);
+  g_assert_cmpint(profile.count[OI_COUNT_ROW_WRITTEN], ==, 0);
+
+  write_oi_fits(FILENAME_OUT, data, &status);
+  g_assert_false(status);
+  oi_profile_get(&profile);
+  g_assert_cmpint(profile.numCall[OI_PHASE_WRITE], >, 0);
+  g_assert_cmpint(profile.count[OI_COUNT_ROW_WRITTEN], >, 0);
+  g_assert_cmpint(profile.count[OI_COUNT_BYTE_WRITTEN], >, 0);
+  oi_profile_print(stdout);
+  free_oi_fits(&data);
+  unlink(FILENAME_OUT);
 
-  if (fits_read_errmsg(msg))
-    g_error("Uncleared CFITSIO error message: %s", msg);
+  /* Nothing recorded when disabled */
+  oi_profile_enable(FALSE);
+  oi_profile_reset();
+  read_oi_fits(FILENAME_V2, &data, &status);
+  g_assert_false(status);
+  oi_profile_get(&profile);
+  g_assert_cmpint(profile.numCall[OI_PHASE_DECODE], ==, 0);
+  g_assert_cmpint(profile.count[OI_COUNT_ROW_READ], ==, 0);
+  free_oi_fits(&data);
 }
 
 int main(int argc, char *argv[])
@@ -229,6 +246,7 @@ int main(int argc, char *argv[])
   g_test_add_func("/oifitslib/oifile/lookup", test_lookup);
   g_test_add_func("/oifitslib/oifile/long_target", test_long_target);
   g_test_add_func("/oifitslib/oifile/bad_checksum", test_bad_checksum);
+  g_test_add_func("/oifitslib/oifile/profile", test_profile);
 
   return g_test_run();
 }
@@ -101,14 +101,11 @@ static void check(oi_fits *pData)
 static void setup_fixture(TestFixture *fix, gconstpointer userData)
 {
   int status;
-  char msg[FLEN_ERRMSG];
   const char *filename = userData;
 
   status = 0;
   read_oi_fits(filename, &fix->inData, &status);
   g_assert_false(status);
-  if (fits_read_errmsg(msg))
-    g_error("Uncleared CFITSIO error message: %s", msg);
   check(&fix->inData);
   init_oi_filter(&fix->filter);
   /* outData is initialised in test function */
@@ -585,6 +582,306 @@ static void test_flux(TestFixture *fix, gconstpointer userData)
   g_assert_cmpint(fix->outData.numFlux, ==, 0);
 }
 
+#define ASSERT_SAME_SHAPE(list1, list2, tabType)                               \
+  do                                                                           \
+  {                                                                            \
+    GList *link1, *link2;                                                      \
+    link1 = (list1);                                                           \
+    link2 = (list2);                                                           \
+    while (link1 != NULL && link2 != NULL)                                     \
+    {                                                                          \
+      g_assert_cmpint(((tabType *)link1->data)->numrec, ==,                    \
+                      ((tabType *)link2->data)->numrec);                       \
+      g_assert_cmpint(((tabType *)link1->data)->nwave, ==,                     \
+                      ((tabType *)link2->data)->nwave);                        \
+      link1 = link1->next;                                                     \
+      link2 = link2->next;                                                     \
+    }                                                                          \
+  } while (0)
+
+static void test_view(TestFixture *fix, gconstpointer userData)
+{
+  const char tempName[] = "utest_oifilter_view.fits";
+  oi_fits_view view;
+  oi_fits viewData, readData;
+  int status;
+
+  /* note bigtest2.fits has nonsense MJD values */
+  fix->filter.mjd_range[0] = 0.0;
+  fix->filter.mjd_range[1] = 0.0075;
+  fix->filter.wave_range[0] = 1500.0e-9;
+  fix->filter.wave_range[1] = 1700.0e-9;
+  g_test_log_set_fatal_handler(ignoreRemoved, NULL);
+  apply_oi_filter(&fix->inData, &fix->filter, &fix->outData);
+  check(&fix->outData);
+
+  apply_oi_filter_view(&fix->inData, &fix->filter, &view);
+  materialise_oi_fits_view(&view, &viewData);
+  check(&viewData);
+  g_assert_cmpint(viewData.numArray, ==, fix->outData.numArray);
+  g_assert_cmpint(viewData.numWavelength, ==, fix->outData.numWavelength);
+  g_assert_cmpint(viewData.numCorr, ==, fix->outData.numCorr);
+  g_assert_cmpint(viewData.numInspol, ==, fix->outData.numInspol);
+  g_assert_cmpint(viewData.numVis, ==, fix->outData.numVis);
+  g_assert_cmpint(viewData.numVis2, ==, fix->outData.numVis2);
+  g_assert_cmpint(viewData.numT3, ==, fix->outData.numT3);
+  g_assert_cmpint(viewData.numFlux, ==, fix->outData.numFlux);
+  ASSERT_SAME_SHAPE(viewData.visList, fix->outData.visList, oi_vis);
+  ASSERT_SAME_SHAPE(viewData.vis2List, fix->outData.vis2List, oi_vis2);
+  ASSERT_SAME_SHAPE(viewData.t3List, fix->outData.t3List, oi_t3);
+  ASSERT_SAME_SHAPE(viewData.fluxList, fix->outData.fluxList, oi_flux);
+  free_oi_fits(&viewData);
+
+  status = 0;
+  write_oi_fits_view(tempName, &view, &status);
+  g_assert_false(status);
+  read_oi_fits(tempName, &readData, &status);
+  g_assert_false(status);
+  check(&readData);
+  g_assert_cmpint(readData.numWavelength, ==, fix->outData.numWavelength);
+  g_assert_cmpint(readData.numVis2, ==, fix->outData.numVis2);
+  ASSERT_SAME_SHAPE(readData.vis2List, fix->outData.vis2List, oi_vis2);
+  free_oi_fits(&readData);
+  unlink(tempName);
+
+  free_oi_fits_view(&view);
+}
+
+static void test_inplace(TestFixture *fix, gconstpointer userData)
+{
+  oi_vis2 *pTab1, *pTab2;
+  GHashTableIter iter;
+  gpointer key, value;
+
+  /* note bigtest2.fits has nonsense MJD values */
+  fix->filter.mjd_range[0] = 0.0;
+  fix->filter.mjd_range[1] = 0.0075;
+  fix->filter.wave_range[0] = 1500.0e-9;
+  fix->filter.wave_range[1] = 1700.0e-9;
+  fix->filter.target_id = 1;
+  g_test_log_set_fatal_handler(ignoreRemoved, NULL);
+  apply_oi_filter(&fix->inData, &fix->filter, &fix->outData);
+  check(&fix->outData);
+
+  /* Filtering in place must give the same result as a filtered copy */
+  apply_oi_filter_inplace(&fix->inData, &fix->filter);
+  check(&fix->inData);
+  g_assert_cmpint(fix->inData.targets.ntarget, ==,
+                  fix->outData.targets.ntarget);
+  g_assert_cmpint(fix->inData.numArray, ==, fix->outData.numArray);
+  g_assert_cmpint(fix->inData.numWavelength, ==, fix->outData.numWavelength);
+  g_assert_cmpint(fix->inData.numCorr, ==, fix->outData.numCorr);
+  g_assert_cmpint(fix->inData.numInspol, ==, fix->outData.numInspol);
+  g_assert_cmpint(fix->inData.numVis, ==, fix->outData.numVis);
+  g_assert_cmpint(fix->inData.numVis2, ==, fix->outData.numVis2);
+  g_assert_cmpint(fix->inData.numT3, ==, fix->outData.numT3);
+  g_assert_cmpint(fix->inData.numFlux, ==, fix->outData.numFlux);
+  ASSERT_SAME_SHAPE(fix->inData.visList, fix->outData.visList, oi_vis);
+  ASSERT_SAME_SHAPE(fix->inData.vis2List, fix->outData.vis2List, oi_vis2);
+  ASSERT_SAME_SHAPE(fix->inData.t3List, fix->outData.t3List, oi_t3);
+  ASSERT_SAME_SHAPE(fix->inData.fluxList, fix->outData.fluxList, oi_flux);
+  g_assert_cmpint(fix->inData.numVis2, >, 0);
+  pTab1 = (oi_vis2 *)fix->inData.vis2List->data;
+  pTab2 = (oi_vis2 *)fix->outData.vis2List->data;
+  g_assert_cmpint(pTab1->record[0].target_id, ==, 1);
+  g_assert_cmpfloat(pTab1->record[0].vis2data[0], ==,
+                    pTab2->record[0].vis2data[0]);
+  g_assert_cmpint(pTab1->record[0].flag[0], ==, pTab2->record[0].flag[0]);
+
+  /* Hash keys must not refer to freed data tables */
+  g_hash_table_iter_init(&iter, fix->inData.wavelengthHash);
+  while (g_hash_table_iter_next(&iter, &key, &value))
+    g_assert(key == ((oi_wavelength *)value)->insname);
+  g_hash_table_iter_init(&iter, fix->inData.arrayHash);
+  while (g_hash_table_iter_next(&iter, &key, &value))
+    g_assert(key == ((oi_array *)value)->arrname);
+}
+
+#define ASSERT_SAME_COUNTS(pData1, pData2)                                     \
+  do                                                                           \
+  {                                                                            \
+    g_assert_cmpint((pData1)->numArray, ==, (pData2)->numArray);               \
+    g_assert_cmpint((pData1)->numWavelength, ==, (pData2)->numWavelength);     \
+    g_assert_cmpint((pData1)->numCorr, ==, (pData2)->numCorr);                 \
+    g_assert_cmpint((pData1)->numInspol, ==, (pData2)->numInspol);             \
+    g_assert_cmpint((pData1)->numVis, ==, (pData2)->numVis);                   \
+    g_assert_cmpint((pData1)->numVis2, ==, (pData2)->numVis2);                 \
+    g_assert_cmpint((pData1)->numT3, ==, (pData2)->numT3);                     \
+    g_assert_cmpint((pData1)->numFlux, ==, (pData2)->numFlux);                 \
+    ASSERT_SAME_SHAPE((pData1)->visList, (pData2)->visList, oi_vis);           \
+    ASSERT_SAME_SHAPE((pData1)->vis2List, (pData2)->vis2List, oi_vis2);        \
+    ASSERT_SAME_SHAPE((pData1)->t3List, (pData2)->t3List, oi_t3);              \
+    ASSERT_SAME_SHAPE((pData1)->fluxList, (pData2)->fluxList, oi_flux);        \
+  } while (0)
+
+static void test_view_list(TestFixture *fix, gconstpointer userData)
+{
+  oi_filter_spec filters[2];
+  oi_fits_view views[2];
+  oi_fits viewData;
+  int i;
+
+  filters[0] = fix->filter;
+  filters[0].wave_range[0] = 1500.0e-9;
+  filters[0].wave_range[1] = 1700.0e-9;
+  filters[1] = fix->filter;
+  g_strlcpy(filters[1].insname, "CHARA*", FLEN_VALUE);
+  g_test_log_set_fatal_handler(ignoreRemoved, NULL);
+  apply_oi_filter_view_list(&fix->inData, filters, 2, views);
+
+  for (i = 0; i < 2; i++)
+  {
+    apply_oi_filter(&fix->inData, &filters[i], &fix->outData);
+    materialise_oi_fits_view(&views[i], &viewData);
+    check(&viewData);
+    ASSERT_SAME_COUNTS(&viewData, &fix->outData);
+    free_oi_fits(&viewData);
+    free_oi_fits(&fix->outData);
+    free_oi_fits_view(&views[i]);
+  }
+  init_oi_fits(&fix->outData);
+}
+
+/**
+ * Split fixture data by @a key, checking each view and returning the
+ * total number of OI_VIS2 records in all views
+ */
+static long check_split(TestFixture *fix, oi_split_key key)
+{
+  oi_fits_view *views;
+  oi_fits viewData;
+  long numVis, numVis2, numT3, total;
+  int i, nview;
+
+  total = 0;
+  nview = split_oi_fits_view(&fix->inData, &fix->filter, key, &views);
+  g_assert_cmpint(nview, >, 0);
+  for (i = 0; i < nview; i++)
+  {
+    /* Each view must match output of filter selecting its key value */
+    apply_oi_filter(&fix->inData, &views[i].filter, &fix->outData);
+    materialise_oi_fits_view(&views[i], &viewData);
+    check(&viewData);
+    ASSERT_SAME_COUNTS(&viewData, &fix->outData);
+    if (key == OI_SPLIT_TARGET)
+      g_assert_cmpint(viewData.targets.ntarget, ==, 1);
+    else if (key == OI_SPLIT_INSNAME)
+      g_assert_cmpint(viewData.numWavelength, ==, 1);
+    else if (i > 0)
+      g_assert_cmpint(views[i].night, >, views[i - 1].night);
+    count_oi_fits_data(&viewData, &numVis, &numVis2, &numT3);
+    total += numVis2;
+    free_oi_fits(&viewData);
+    free_oi_fits(&fix->outData);
+    free_oi_fits_view(&views[i]);
+  }
+  oi_free(views);
+  init_oi_fits(&fix->outData);
+  return total;
+}
+
+static void test_split(TestFixture *fix, gconstpointer userData)
+{
+  const oi_split_key keys[] = {OI_SPLIT_TARGET, OI_SPLIT_INSNAME,
+                               OI_SPLIT_NIGHT};
+  int k;
+
+  g_test_log_set_fatal_handler(ignoreRemoved, NULL);
+  for (k = 0; k < sizeof(keys) / sizeof(keys[0]); k++)
+    (void)check_split(fix, keys[k]);
+}
+
+static void test_split_night_boundary(TestFixture *fix,
+                                      gconstpointer userData)
+{
+  oi_vis2 *pVis2;
+  long numVis, numVis2, numT3;
+
+  /* Move first record to noon exactly, the start of a night */
+  g_assert_nonnull(fix->inData.vis2List);
+  pVis2 = fix->inData.vis2List->data;
+  pVis2->record[0].mjd = floor(pVis2->record[0].mjd - 0.5) + 1.5;
+
+  /* Record must appear in one view only */
+  g_test_log_set_fatal_handler(ignoreRemoved, NULL);
+  apply_oi_filter(&fix->inData, &fix->filter, &fix->outData);
+  count_oi_fits_data(&fix->outData, &numVis, &numVis2, &numT3);
+  free_oi_fits(&fix->outData);
+  g_assert_cmpint(check_split(fix, OI_SPLIT_NIGHT), ==, numVis2);
+}
+
+static void discardWarning(const char *logDomain, GLogLevelFlags logLevel,
+                           const char *message, gpointer userData)
+{
+}
+
+#define NUM_PERF_TABLES 4000
+
+static void test_prune_perf(TestFixture *fix, gconstpointer userData)
+{
+  oi_fits refData;
+  oi_vis2 *pTemplate, *pVis2;
+  oi_array *pArray;
+  oi_wavelength *pWave;
+  double elapsed;
+  long irec;
+  int i;
+  guint handler;
+
+  /* Find numbers of tables output without extra tables */
+  fix->filter.mjd_range[1] = 1000.0;
+  g_test_log_set_fatal_handler(ignoreRemoved, NULL);
+  apply_oi_filter(&fix->inData, &fix->filter, &refData);
+
+  /* Add many small OI_VIS2 tables, each with its own OI_ARRAY and
+     OI_WAVELENGTH. Half of these will be rejected by the MJD filter,
+     leaving their OI_ARRAY and OI_WAVELENGTH tables orphaned */
+  pTemplate = fix->inData.vis2List->data;
+  for (i = 0; i < NUM_PERF_TABLES; i++)
+  {
+    pArray = dup_oi_array(oi_fits_lookup_array(&fix->inData,
+                                               pTemplate->arrname));
+    pWave = dup_oi_wavelength(oi_fits_lookup_wavelength(&fix->inData,
+                                                        pTemplate->insname));
+    pVis2 = dup_oi_vis2(pTemplate);
+    g_snprintf(pArray->arrname, FLEN_VALUE, "PERF_ARRAY%d", i);
+    g_snprintf(pWave->insname, FLEN_VALUE, "PERF_INS%d", i);
+    g_strlcpy(pVis2->arrname, pArray->arrname, FLEN_VALUE);
+    g_strlcpy(pVis2->insname, pWave->insname, FLEN_VALUE);
+    pVis2->corrname[0] = '\0';
+    if (i % 2)
+    {
+      for (irec = 0; irec < pVis2->numrec; irec++)
+        pVis2->record[irec].mjd = 2000.0;
+    }
+    fix->inData.arrayList = g_list_prepend(fix->inData.arrayList, pArray);
+    g_hash_table_insert(fix->inData.arrayHash, pArray->arrname, pArray);
+    ++fix->inData.numArray;
+    fix->inData.wavelengthList =
+        g_list_prepend(fix->inData.wavelengthList, pWave);
+    g_hash_table_insert(fix->inData.wavelengthHash, pWave->insname, pWave);
+    ++fix->inData.numWavelength;
+    fix->inData.vis2List = g_list_prepend(fix->inData.vis2List, pVis2);
+    ++fix->inData.numVis2;
+  }
+
+  handler = g_log_set_handler(NULL, G_LOG_LEVEL_WARNING, discardWarning, NULL);
+  g_test_timer_start();
+  apply_oi_filter(&fix->inData, &fix->filter, &fix->outData);
+  elapsed = g_test_timer_elapsed();
+  g_log_remove_handler(NULL, handler);
+  g_test_minimized_result(elapsed, "Filtered %d extra OI_VIS2 tables in %gs",
+                          NUM_PERF_TABLES, elapsed);
+
+  g_assert_cmpint(fix->outData.numArray, ==,
+                  refData.numArray + NUM_PERF_TABLES / 2);
+  g_assert_cmpint(fix->outData.numWavelength, ==,
+                  refData.numWavelength + NUM_PERF_TABLES / 2);
+  g_assert_cmpint(fix->outData.numVis2, ==,
+                  refData.numVis2 + NUM_PERF_TABLES / 2);
+  free_oi_fits(&refData);
+}
+
 int main(int argc, char *argv[])
 {
   g_test_init(&argc, &argv, NULL);
@@ -623,6 +920,20 @@ int main(int argc, char *argv[])
              test_t3, teardown_fixture);
   g_test_add("/oifitslib/oifilter/flux", TestFixture, FILENAME, setup_fixture,
              test_flux, teardown_fixture);
+  g_test_add("/oifitslib/oifilter/view", TestFixture, FILENAME, setup_fixture,
+             test_view, teardown_fixture);
+  g_test_add("/oifitslib/oifilter/inplace", TestFixture, FILENAME,
+             setup_fixture, test_inplace, teardown_fixture);
+  g_test_add("/oifitslib/oifilter/view_list", TestFixture, FILENAME,
+             setup_fixture, test_view_list, teardown_fixture);
+  g_test_add("/oifitslib/oifilter/split", TestFixture, FILENAME,
+             setup_fixture, test_split, teardown_fixture);
+  g_test_add("/oifitslib/oifilter/split_night_boundary", TestFixture,
+             FILENAME, setup_fixture, test_split_night_boundary,
+             teardown_fixture);
+  if (g_test_perf())
+    g_test_add("/oifitslib/oifilter/prune_perf", TestFixture, FILENAME,
+               setup_fixture, test_prune_perf, teardown_fixture);
 
   return g_test_run();
 }
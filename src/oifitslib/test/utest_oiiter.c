@@ -27,6 +27,9 @@
 #include "oifile.h"
 
 #include <math.h>
+#include <stdint.h> /* uintptr_t */
+#include <stdlib.h>
+#include <string.h>
 
 #define FILENAME "OIFITS2/bigtest2.fits"
 #define RAD2DEG (180.0 / 3.14159)
@@ -40,14 +43,11 @@ typedef struct
 static void setup_fixture(TestFixture *fix, gconstpointer userData)
 {
   int status;
-  char msg[FLEN_ERRMSG];
   const char *filename = userData;
 
   status = 0;
   read_oi_fits(filename, &fix->inData, &status);
   g_assert_false(status);
-  if (fits_read_errmsg(msg))
-    g_error("Uncleared CFITSIO error message: %s", msg);
 }
 
 static void teardown_fixture(TestFixture *fix, gconstpointer userData)
@@ -55,6 +55,12 @@ static void teardown_fixture(TestFixture *fix, gconstpointer userData)
   free_oi_fits(&fix->inData);
 }
 
+static gboolean ignoreRemoved(const char *logDomain, GLogLevelFlags logLevel,
+                              const char *message, gpointer userData)
+{
+  return (!g_str_has_suffix(message, "removed from filter output"));
+}
+
 static void test_default_vis(TestFixture *fix, const oi_filter_spec *pFilter)
 {
   oi_vis_iter iter;
@@ -66,6 +72,7 @@ static void test_default_vis(TestFixture *fix, const oi_filter_spec *pFilter)
 
   oi_vis_iter_init(&iter, &fix->inData, pFilter);
   oi_vis_iter_next(&iter, NULL, NULL, NULL, NULL, NULL);
+  oi_vis_iter_free(&iter);
   oi_vis_iter_init(&iter, &fix->inData, pFilter); /* test re-init */
   lastextver = -1;
   lastrec = -1;
@@ -83,6 +90,7 @@ static void test_default_vis(TestFixture *fix, const oi_filter_spec *pFilter)
     lastrec = irec;
     lastwave = iwave;
   }
+  oi_vis_iter_free(&iter);
   count_oi_fits_data(&fix->inData, &ntotal, NULL, NULL);
   g_assert_cmpint(ndata, ==, ntotal);
 }
@@ -98,6 +106,7 @@ static void test_default_vis2(TestFixture *fix, const oi_filter_spec *pFilter)
 
   oi_vis2_iter_init(&iter, &fix->inData, pFilter);
   oi_vis2_iter_next(&iter, NULL, NULL, NULL, NULL, NULL);
+  oi_vis2_iter_free(&iter);
   oi_vis2_iter_init(&iter, &fix->inData, pFilter); /* test re-init */
   lastextver = -1;
   lastrec = -1;
@@ -115,6 +124,7 @@ static void test_default_vis2(TestFixture *fix, const oi_filter_spec *pFilter)
     lastrec = irec;
     lastwave = iwave;
   }
+  oi_vis2_iter_free(&iter);
   count_oi_fits_data(&fix->inData, NULL, &ntotal, NULL);
   g_assert_cmpint(ndata, ==, ntotal);
 }
@@ -130,6 +140,7 @@ static void test_default_t3(TestFixture *fix, const oi_filter_spec *pFilter)
 
   oi_t3_iter_init(&iter, &fix->inData, pFilter);
   oi_t3_iter_next(&iter, NULL, NULL, NULL, NULL, NULL);
+  oi_t3_iter_free(&iter);
   oi_t3_iter_init(&iter, &fix->inData, pFilter); /* test re-init */
   lastextver = -1;
   lastrec = -1;
@@ -147,6 +158,7 @@ static void test_default_t3(TestFixture *fix, const oi_filter_spec *pFilter)
     lastrec = irec;
     lastwave = iwave;
   }
+  oi_t3_iter_free(&iter);
   count_oi_fits_data(&fix->inData, NULL, NULL, &ntotal);
   g_assert_cmpint(ndata, ==, ntotal);
 }
@@ -178,6 +190,7 @@ static void test_arrname(TestFixture *fix, gconstpointer userData)
     {
       g_assert_cmpstr(pTable->arrname, ==, "CHARA_2004Jan");
     }
+    oi_vis_iter_free(&iter);
   }
   {
     oi_vis2_iter iter;
@@ -187,6 +200,7 @@ static void test_arrname(TestFixture *fix, gconstpointer userData)
     {
       g_assert_cmpstr(pTable->arrname, ==, "CHARA_2004Jan");
     }
+    oi_vis2_iter_free(&iter);
   }
   {
     oi_t3_iter iter;
@@ -196,6 +210,7 @@ static void test_arrname(TestFixture *fix, gconstpointer userData)
     {
       g_assert_cmpstr(pTable->arrname, ==, "CHARA_2004Jan");
     }
+    oi_t3_iter_free(&iter);
   }
 }
 
@@ -214,15 +229,20 @@ static void test_insname(TestFixture *fix, gconstpointer userData)
     {
       g_assert_cmpstr(pTable->insname, ==, "IOTA_IONIC_PICNIC");
     }
+    oi_vis_iter_free(&iter);
   }
   {
     oi_vis2_iter iter;
     oi_vis2 *pTable;
+    int extver;
     oi_vis2_iter_init(&iter, &fix->inData, &filt);
-    while (oi_vis2_iter_next(&iter, NULL, &pTable, NULL, NULL, NULL))
+    while (oi_vis2_iter_next(&iter, &extver, &pTable, NULL, NULL, NULL))
     {
       g_assert_cmpstr(pTable->insname, ==, "IOTA_IONIC_PICNIC");
+      /* EXTVER must be correct after skipping rejected tables */
+      g_assert(g_list_nth_data(fix->inData.vis2List, extver - 1) == pTable);
     }
+    oi_vis2_iter_free(&iter);
   }
   {
     oi_t3_iter iter;
@@ -232,6 +252,7 @@ static void test_insname(TestFixture *fix, gconstpointer userData)
     {
       g_assert_cmpstr(pTable->insname, ==, "IOTA_IONIC_PICNIC");
     }
+    oi_t3_iter_free(&iter);
   }
 }
 
@@ -250,6 +271,7 @@ static void test_corrname(TestFixture *fix, gconstpointer userData)
     {
       g_assert_cmpstr(pTable->corrname, ==, "TEST");
     }
+    oi_vis_iter_free(&iter);
   }
   {
     oi_vis2_iter iter;
@@ -259,6 +281,7 @@ static void test_corrname(TestFixture *fix, gconstpointer userData)
     {
       g_assert_cmpstr(pTable->corrname, ==, "TEST");
     }
+    oi_vis2_iter_free(&iter);
   }
   {
     oi_t3_iter iter;
@@ -268,6 +291,7 @@ static void test_corrname(TestFixture *fix, gconstpointer userData)
     {
       g_assert_cmpstr(pTable->corrname, ==, "TEST");
     }
+    oi_t3_iter_free(&iter);
   }
 }
 
@@ -286,6 +310,7 @@ static void test_target(TestFixture *fix, gconstpointer userData)
     {
       g_assert_cmpint(pRec->target_id, ==, 1);
     }
+    oi_vis_iter_free(&iter);
   }
   {
     oi_vis2_iter iter;
@@ -295,6 +320,7 @@ static void test_target(TestFixture *fix, gconstpointer userData)
     {
       g_assert_cmpint(pRec->target_id, ==, 1);
     }
+    oi_vis2_iter_free(&iter);
   }
   {
     oi_t3_iter iter;
@@ -304,6 +330,7 @@ static void test_target(TestFixture *fix, gconstpointer userData)
     {
       g_assert_cmpint(pRec->target_id, ==, 1);
     }
+    oi_t3_iter_free(&iter);
   }
 }
 
@@ -326,6 +353,7 @@ static void test_wave(TestFixture *fix, gconstpointer userData)
       g_assert_cmpfloat(effWave, >=, range[0]);
       g_assert_cmpfloat(effWave, <=, range[1]);
     }
+    oi_vis_iter_free(&iter);
   }
   {
     oi_vis2_iter iter;
@@ -337,6 +365,7 @@ static void test_wave(TestFixture *fix, gconstpointer userData)
       g_assert_cmpfloat(effWave, >=, range[0]);
       g_assert_cmpfloat(effWave, <=, range[1]);
     }
+    oi_vis2_iter_free(&iter);
   }
   {
     oi_t3_iter iter;
@@ -348,6 +377,7 @@ static void test_wave(TestFixture *fix, gconstpointer userData)
       g_assert_cmpfloat(effWave, >=, range[0]);
       g_assert_cmpfloat(effWave, <=, range[1]);
     }
+    oi_t3_iter_free(&iter);
   }
 }
 
@@ -370,6 +400,7 @@ static void test_mjd(TestFixture *fix, gconstpointer userData)
       g_assert_cmpfloat(pRec->mjd, >=, range[0]);
       g_assert_cmpfloat(pRec->mjd, <=, range[1]);
     }
+    oi_vis_iter_free(&iter);
   }
   {
     oi_vis2_iter iter;
@@ -380,6 +411,7 @@ static void test_mjd(TestFixture *fix, gconstpointer userData)
       g_assert_cmpfloat(pRec->mjd, >=, range[0]);
       g_assert_cmpfloat(pRec->mjd, <=, range[1]);
     }
+    oi_vis2_iter_free(&iter);
   }
   {
     oi_t3_iter iter;
@@ -390,6 +422,7 @@ static void test_mjd(TestFixture *fix, gconstpointer userData)
       g_assert_cmpfloat(pRec->mjd, >=, range[0]);
       g_assert_cmpfloat(pRec->mjd, <=, range[1]);
     }
+    oi_t3_iter_free(&iter);
   }
 }
 
@@ -406,6 +439,7 @@ static void test_bas_vis(TestFixture *fix, const oi_filter_spec *pFilter)
     g_assert_cmpfloat(bas, >=, pFilter->bas_range[0]);
     g_assert_cmpfloat(bas, <=, pFilter->bas_range[1]);
   }
+  oi_vis_iter_free(&iter);
 }
 
 static void test_bas_vis2(TestFixture *fix, const oi_filter_spec *pFilter)
@@ -421,6 +455,7 @@ static void test_bas_vis2(TestFixture *fix, const oi_filter_spec *pFilter)
     g_assert_cmpfloat(bas, >=, pFilter->bas_range[0]);
     g_assert_cmpfloat(bas, <=, pFilter->bas_range[1]);
   }
+  oi_vis2_iter_free(&iter);
 }
 
 static void test_bas_t3(TestFixture *fix, const oi_filter_spec *pFilter)
@@ -446,6 +481,7 @@ static void test_bas_t3(TestFixture *fix, const oi_filter_spec *pFilter)
     g_assert_cmpfloat(bas, >=, pFilter->bas_range[0]);
     g_assert_cmpfloat(bas, <=, pFilter->bas_range[1]);
   }
+  oi_t3_iter_free(&iter);
 }
 
 static void test_bas(TestFixture *fix, gconstpointer userData)
@@ -475,6 +511,7 @@ static void test_uvrad_vis(TestFixture *fix, const oi_filter_spec *pFilter)
     g_assert_cmpfloat(uvrad, >=, pFilter->uvrad_range[0]);
     g_assert_cmpfloat(uvrad, <=, pFilter->uvrad_range[1]);
   }
+  oi_vis_iter_free(&iter);
 }
 
 static void test_uvrad_vis2(TestFixture *fix, const oi_filter_spec *pFilter)
@@ -490,6 +527,7 @@ static void test_uvrad_vis2(TestFixture *fix, const oi_filter_spec *pFilter)
     g_assert_cmpfloat(uvrad, >=, pFilter->uvrad_range[0]);
     g_assert_cmpfloat(uvrad, <=, pFilter->uvrad_range[1]);
   }
+  oi_vis2_iter_free(&iter);
 }
 
 static void test_uvrad_t3(TestFixture *fix, const oi_filter_spec *pFilter)
@@ -511,6 +549,7 @@ static void test_uvrad_t3(TestFixture *fix, const oi_filter_spec *pFilter)
     g_assert_cmpfloat(uvrad, >=, pFilter->uvrad_range[0]);
     g_assert_cmpfloat(uvrad, <=, pFilter->uvrad_range[1]);
   }
+  oi_t3_iter_free(&iter);
 }
 
 static void test_uvrad(TestFixture *fix, gconstpointer userData)
@@ -551,6 +590,7 @@ static void test_snr(TestFixture *fix, gconstpointer userData)
       g_assert_cmpfloat(snrPhi, >=, range[0]);
       g_assert_cmpfloat(snrPhi, <=, range[1]);
     }
+    oi_vis_iter_free(&iter);
   }
   {
     oi_vis2_iter iter;
@@ -562,6 +602,7 @@ static void test_snr(TestFixture *fix, gconstpointer userData)
       g_assert_cmpfloat(snrAmp, >=, range[0]);
       g_assert_cmpfloat(snrAmp, <=, range[1]);
     }
+    oi_vis2_iter_free(&iter);
   }
   {
     oi_t3_iter iter;
@@ -576,7 +617,493 @@ static void test_snr(TestFixture *fix, gconstpointer userData)
       g_assert_cmpfloat(snrPhi, >=, range[0]);
       g_assert_cmpfloat(snrPhi, <=, range[1]);
     }
+    oi_t3_iter_free(&iter);
+  }
+}
+
+static void test_view(TestFixture *fix, gconstpointer userData)
+{
+  oi_filter_spec filt;
+  oi_fits_view view;
+  oi_vis2_iter iter, viewIter;
+  int extver, viewExtver, iwave, viewIwave;
+  long irec, viewIrec, ndata;
+  oi_vis2 *pTable, *pViewTable;
+
+  init_oi_filter(&filt);
+  /* note bigtest2.fits has nonsense MJD values */
+  filt.mjd_range[0] = 0.0;
+  filt.mjd_range[1] = 0.0075;
+  filt.wave_range[0] = 1500.0e-9;
+  filt.wave_range[1] = 1700.0e-9;
+  apply_oi_filter_view(&fix->inData, &filt, &view);
+
+  /* Iterating over view must visit same data as filtering iterator */
+  oi_vis2_iter_init(&iter, &fix->inData, &filt);
+  oi_vis2_iter_init_view(&viewIter, &view);
+  ndata = 0;
+  while (oi_vis2_iter_next(&iter, &extver, &pTable, &irec, NULL, &iwave))
+  {
+    g_assert(oi_vis2_iter_next(&viewIter, &viewExtver, &pViewTable, &viewIrec,
+                               NULL, &viewIwave));
+    g_assert_cmpint(viewExtver, ==, extver);
+    g_assert(pViewTable == pTable);
+    g_assert_cmpint(viewIrec, ==, irec);
+    g_assert_cmpint(viewIwave, ==, iwave);
+    ++ndata;
+  }
+  oi_vis2_iter_free(&iter);
+  g_assert_false(
+      oi_vis2_iter_next(&viewIter, NULL, NULL, NULL, NULL, NULL));
+  oi_vis2_iter_free(&viewIter);
+  g_assert_cmpint(ndata, >, 0);
+
+  free_oi_fits_view(&view);
+}
+
+#define BATCH_SIZE 7
+
+static void test_batch(TestFixture *fix, gconstpointer userData)
+{
+  oi_filter_spec filt;
+  int extver[BATCH_SIZE], iwave[BATCH_SIZE];
+  long irec[BATCH_SIZE];
+  double u[BATCH_SIZE], v[BATCH_SIZE];
+  long i, n, ndata;
+
+  init_oi_filter(&filt);
+  filt.wave_range[1] = 2.0e-6;
+
+  /* Batches must contain same data as single-step iterator */
+  {
+    oi_vis_iter iter, batchIter;
+    oi_vis_record *pRec;
+    DATA visamp[BATCH_SIZE];
+    oi_vis_batch batch = {visamp, NULL, NULL, NULL, u, v, NULL, NULL,
+                          extver, irec, iwave};
+    int extver1, iwave1;
+    long irec1;
+    double u1, v1;
+    oi_vis_iter_init(&iter, &fix->inData, &filt);
+    oi_vis_iter_init(&batchIter, &fix->inData, &filt);
+    ndata = 0;
+    while ((n = oi_vis_iter_next_batch(&batchIter, BATCH_SIZE, &batch)) > 0)
+    {
+      for (i = 0; i < n; i++)
+      {
+        g_assert(oi_vis_iter_next(&iter, &extver1, NULL, &irec1, &pRec,
+                                  &iwave1));
+        oi_vis_iter_get_uv(&iter, NULL, &u1, &v1);
+        g_assert_cmpint(extver[i], ==, extver1);
+        g_assert_cmpint(irec[i], ==, irec1);
+        g_assert_cmpint(iwave[i], ==, iwave1);
+        g_assert_cmpfloat(visamp[i], ==, pRec->visamp[iwave1]);
+        g_assert_cmpfloat(u[i], ==, u1);
+        g_assert_cmpfloat(v[i], ==, v1);
+      }
+      ndata += n;
+    }
+    g_assert_false(oi_vis_iter_next(&iter, NULL, NULL, NULL, NULL, NULL));
+    g_assert_cmpint(ndata, >, BATCH_SIZE);
+    oi_vis_iter_free(&iter);
+    oi_vis_iter_free(&batchIter);
+  }
+  {
+    oi_vis2_iter iter, batchIter;
+    oi_vis2_record *pRec;
+    DATA vis2data[BATCH_SIZE];
+    double mjd[BATCH_SIZE];
+    oi_vis2_batch batch = {vis2data, NULL, u, v, mjd, NULL, extver, irec,
+                           iwave};
+    int extver1, iwave1;
+    long irec1;
+    double u1, v1;
+    oi_vis2_iter_init(&iter, &fix->inData, &filt);
+    oi_vis2_iter_init(&batchIter, &fix->inData, &filt);
+    ndata = 0;
+    while ((n = oi_vis2_iter_next_batch(&batchIter, BATCH_SIZE, &batch)) > 0)
+    {
+      for (i = 0; i < n; i++)
+      {
+        g_assert(oi_vis2_iter_next(&iter, &extver1, NULL, &irec1, &pRec,
+                                   &iwave1));
+        oi_vis2_iter_get_uv(&iter, NULL, &u1, &v1);
+        g_assert_cmpint(extver[i], ==, extver1);
+        g_assert_cmpint(irec[i], ==, irec1);
+        g_assert_cmpint(iwave[i], ==, iwave1);
+        g_assert_cmpfloat(vis2data[i], ==, pRec->vis2data[iwave1]);
+        g_assert_cmpfloat(mjd[i], ==, pRec->mjd);
+        g_assert_cmpfloat(u[i], ==, u1);
+        g_assert_cmpfloat(v[i], ==, v1);
+      }
+      ndata += n;
+    }
+    g_assert_false(oi_vis2_iter_next(&iter, NULL, NULL, NULL, NULL, NULL));
+    g_assert_cmpint(ndata, >, BATCH_SIZE);
+    oi_vis2_iter_free(&iter);
+    oi_vis2_iter_free(&batchIter);
+  }
+  {
+    oi_t3_iter iter, batchIter;
+    oi_t3_record *pRec;
+    DATA t3phi[BATCH_SIZE];
+    double u2[BATCH_SIZE], v2[BATCH_SIZE];
+    oi_t3_batch batch = {NULL, NULL, t3phi, NULL, u,      v,    u2,
+                         v2,   NULL, NULL,  extver, irec, iwave};
+    int extver1, iwave1;
+    long irec1;
+    double u1, v1, u21, v21;
+    oi_t3_iter_init(&iter, &fix->inData, &filt);
+    oi_t3_iter_init(&batchIter, &fix->inData, &filt);
+    ndata = 0;
+    while ((n = oi_t3_iter_next_batch(&batchIter, BATCH_SIZE, &batch)) > 0)
+    {
+      for (i = 0; i < n; i++)
+      {
+        g_assert(oi_t3_iter_next(&iter, &extver1, NULL, &irec1, &pRec,
+                                 &iwave1));
+        oi_t3_iter_get_uv(&iter, NULL, &u1, &v1, &u21, &v21);
+        g_assert_cmpint(extver[i], ==, extver1);
+        g_assert_cmpint(irec[i], ==, irec1);
+        g_assert_cmpint(iwave[i], ==, iwave1);
+        g_assert_cmpfloat(t3phi[i], ==, pRec->t3phi[iwave1]);
+        g_assert_cmpfloat(u[i], ==, u1);
+        g_assert_cmpfloat(v[i], ==, v1);
+        g_assert_cmpfloat(u2[i], ==, u21);
+        g_assert_cmpfloat(v2[i], ==, v21);
+      }
+      ndata += n;
+    }
+    g_assert_false(oi_t3_iter_next(&iter, NULL, NULL, NULL, NULL, NULL));
+    g_assert_cmpint(ndata, >, BATCH_SIZE);
+    oi_t3_iter_free(&iter);
+    oi_t3_iter_free(&batchIter);
+  }
+}
+
+static void test_split(TestFixture *fix, gconstpointer userData)
+{
+  const int ks[] = {1, 2, 3, 5, 200};
+  oi_filter_spec filt;
+  oi_fits_view view;
+  oi_vis2_iter iter, *iters;
+  int extver, iwave, splitExtver, splitIwave;
+  long irec, splitIrec, ndata;
+  int i, j, useView;
+
+  init_oi_filter(&filt);
+  filt.wave_range[1] = 2.0e-6;
+  apply_oi_filter_view(&fix->inData, &filt, &view);
+
+  /* Ranges taken in order must visit same data as unsplit iterator */
+  for (useView = 0; useView <= 1; useView++)
+  {
+    for (i = 0; i < sizeof(ks) / sizeof(ks[0]); i++)
+    {
+      iters = malloc(ks[i] * sizeof(iters[0]));
+      if (useView)
+        oi_vis2_iter_init_view(&iter, &view);
+      else
+        oi_vis2_iter_init(&iter, &fix->inData, &filt);
+      oi_vis2_iter_split(&iter, ks[i], iters);
+      ndata = 0;
+      for (j = 0; j < ks[i]; j++)
+      {
+        while (oi_vis2_iter_next(&iters[j], &splitExtver, NULL, &splitIrec,
+                                 NULL, &splitIwave))
+        {
+          g_assert(
+              oi_vis2_iter_next(&iter, &extver, NULL, &irec, NULL, &iwave));
+          g_assert_cmpint(splitExtver, ==, extver);
+          g_assert_cmpint(splitIrec, ==, irec);
+          g_assert_cmpint(splitIwave, ==, iwave);
+          ++ndata;
+        }
+        oi_vis2_iter_free(&iters[j]);
+      }
+      g_assert_false(oi_vis2_iter_next(&iter, NULL, NULL, NULL, NULL, NULL));
+      g_assert_cmpint(ndata, >, 0);
+      oi_vis2_iter_free(&iter);
+      free(iters);
+    }
+  }
+  free_oi_fits_view(&view);
+}
+
+/** Count data visited by squared visibility iterator */
+static long count_vis2(oi_vis2_iter *pIter)
+{
+  long ndata = 0;
+
+  while (oi_vis2_iter_next(pIter, NULL, NULL, NULL, NULL, NULL))
+    ++ndata;
+  return ndata;
+}
+
+static void test_mask(TestFixture *fix, gconstpointer userData)
+{
+  oi_filter_spec filt;
+  oi_vis2_iter iter, refIter;
+  oi_vis2 *pTable, *pRefTable;
+  oi_vis2_record *pRec;
+  int extver, iwave, refExtver, refIwave, pass;
+  long irec, refIrec, ndata;
+  double u, refU;
+
+  init_oi_filter(&filt);
+  filt.wave_range[1] = 2.0e-6;
+  filt.accept_flagged = false;
+  oi_vis2_iter_init(&iter, &fix->inData, &filt);
+  oi_vis2_iter_enable_mask(&iter);
+
+  /* Recording and replaying passes must visit same data as normal
+     iterator */
+  for (pass = 0; pass < 3; pass++)
+  {
+    if (pass > 0) oi_vis2_iter_reset(&iter);
+    oi_vis2_iter_init(&refIter, &fix->inData, &filt);
+    ndata = 0;
+    while (oi_vis2_iter_next(&refIter, &refExtver, &pRefTable, &refIrec, NULL,
+                             &refIwave))
+    {
+      g_assert(oi_vis2_iter_next(&iter, &extver, &pTable, &irec, NULL,
+                                 &iwave));
+      g_assert_cmpint(extver, ==, refExtver);
+      g_assert(pTable == pRefTable);
+      g_assert_cmpint(irec, ==, refIrec);
+      g_assert_cmpint(iwave, ==, refIwave);
+      oi_vis2_iter_get_uv(&iter, NULL, &u, NULL);
+      oi_vis2_iter_get_uv(&refIter, NULL, &refU, NULL);
+      g_assert_cmpfloat(u, ==, refU);
+      ++ndata;
+    }
+    g_assert_false(oi_vis2_iter_next(&iter, NULL, NULL, NULL, NULL, NULL));
+    g_assert_cmpint(ndata, >, 1);
+    oi_vis2_iter_free(&refIter);
   }
+
+  /* Flag first accepted datum. Replayed mask is unaware of this
+     until invalidated */
+  oi_vis2_iter_reset(&iter);
+  g_assert(oi_vis2_iter_next(&iter, NULL, NULL, NULL, &pRec, &iwave));
+  pRec->flag[iwave] = 1;
+  oi_vis2_iter_reset(&iter);
+  g_assert_cmpint(count_vis2(&iter), ==, ndata);
+  oi_vis2_iter_invalidate(&iter);
+  oi_vis2_iter_reset(&iter);
+  g_assert_cmpint(count_vis2(&iter), ==, ndata - 1);
+  oi_vis2_iter_reset(&iter);
+  g_assert_cmpint(count_vis2(&iter), ==, ndata - 1);
+  pRec->flag[iwave] = 0;
+
+  /* Change to table dimensions must be detected */
+  oi_vis2_iter_invalidate(&iter);
+  oi_vis2_iter_reset(&iter);
+  g_assert_cmpint(count_vis2(&iter), ==, ndata);
+  pTable = fix->inData.vis2List->data;
+  --pTable->numrec;
+  oi_vis2_iter_reset(&iter);
+  g_assert_cmpint(count_vis2(&iter), <, ndata);
+  ++pTable->numrec;
+  oi_vis2_iter_reset(&iter);
+  g_assert_cmpint(count_vis2(&iter), ==, ndata);
+
+  oi_vis2_iter_free(&iter);
+}
+
+#define ASSERT_ALIGNED(ptr) g_assert_cmpint((uintptr_t)(ptr) % 64, ==, 0)
+
+static void test_flat(TestFixture *fix, gconstpointer userData)
+{
+  oi_filter_spec filt;
+  oi_flat_data flat;
+  oi_vis2_iter iter;
+  oi_vis2_record *pRec;
+  int iwave;
+  long i, nvis, nvis2, nt3;
+  double u, v;
+
+  init_oi_filter(&filt);
+  filt.wave_range[1] = 2.0e-6;
+  oi_fits_export_flat(&fix->inData, &filt, &flat);
+
+  ASSERT_ALIGNED(flat.u1);
+  ASSERT_ALIGNED(flat.v1);
+  ASSERT_ALIGNED(flat.u2);
+  ASSERT_ALIGNED(flat.v2);
+  ASSERT_ALIGNED(flat.value);
+  ASSERT_ALIGNED(flat.err);
+  ASSERT_ALIGNED(flat.type);
+  ASSERT_ALIGNED(flat.target_id);
+
+  /* Count data of each type */
+  nvis = nvis2 = nt3 = 0;
+  for (i = 0; i < flat.num; i++)
+  {
+    if (flat.type[i] == OI_FLAT_VISAMP) ++nvis;
+    if (flat.type[i] == OI_FLAT_VIS2) ++nvis2;
+    if (flat.type[i] == OI_FLAT_T3PHI) ++nt3;
+  }
+  g_assert_cmpint(nvis, >, 0);
+  g_assert_cmpint(nvis2, >, 0);
+  g_assert_cmpint(nt3, >, 0);
+  g_assert_cmpint(flat.num, ==, 2 * nvis + nvis2 + 2 * nt3);
+
+  /* Squared visibilities must match iterator */
+  i = 2 * nvis;
+  oi_vis2_iter_init(&iter, &fix->inData, &filt);
+  while (oi_vis2_iter_next(&iter, NULL, NULL, NULL, &pRec, &iwave))
+  {
+    oi_vis2_iter_get_uv(&iter, NULL, &u, &v);
+    g_assert_cmpint(flat.type[i], ==, OI_FLAT_VIS2);
+    g_assert_cmpfloat(flat.value[i], ==, pRec->vis2data[iwave]);
+    g_assert_cmpfloat(flat.err[i], ==, pRec->vis2err[iwave]);
+    g_assert_cmpfloat(flat.u1[i], ==, u);
+    g_assert_cmpfloat(flat.v1[i], ==, v);
+    g_assert_cmpfloat(flat.u2[i], ==, 0.0);
+    g_assert_cmpint(flat.target_id[i], ==, pRec->target_id);
+    ++i;
+  }
+  g_assert_cmpint(i, ==, 2 * nvis + nvis2);
+  oi_vis2_iter_free(&iter);
+
+  free_oi_flat_data(&flat);
+}
+
+/** Count data in OI_FLUX and OI_INSPOL tables output by filter */
+static void count_filtered(const oi_fits *pData, oi_filter_spec *pFilter,
+                           long *pNflux, long *pNinspol)
+{
+  oi_fits outData;
+  oi_flux *pFlux;
+  oi_inspol *pInspol;
+  GList *link;
+
+  apply_oi_filter(pData, pFilter, &outData);
+  *pNflux = 0;
+  for (link = outData.fluxList; link != NULL; link = link->next)
+  {
+    pFlux = link->data;
+    *pNflux += pFlux->numrec * pFlux->nwave;
+  }
+  *pNinspol = 0;
+  for (link = outData.inspolList; link != NULL; link = link->next)
+  {
+    pInspol = link->data;
+    *pNinspol += pInspol->numrec * pInspol->nwave;
+  }
+  free_oi_fits(&outData);
+}
+
+static void test_flux_inspol(TestFixture *fix, gconstpointer userData)
+{
+  oi_filter_spec filters[6];
+  oi_flux_iter fluxIter;
+  oi_inspol_iter inspolIter;
+  oi_flux *pFlux;
+  oi_flux_record *pFluxRec;
+  oi_inspol_record *pInspolRec;
+  int i, iwave;
+  long nflux, ninspol, expectFlux, expectInspol;
+  double effWave;
+
+  for (i = 0; i < 6; i++)
+    init_oi_filter(&filters[i]);
+  g_strlcpy(filters[1].arrname, "IOTA*", FLEN_VALUE);
+  g_strlcpy(filters[2].insname, "CHARA*", FLEN_VALUE);
+  filters[3].target_id = 1;
+  /* note bigtest2.fits has nonsense MJD values */
+  filters[4].mjd_range[1] = 0.003;
+  filters[5].wave_range[1] = 1.6e-6;
+
+  /* Iterators must visit same number of data as filter outputs */
+  g_test_log_set_fatal_handler(ignoreRemoved, NULL);
+  for (i = 0; i < 6; i++)
+  {
+    count_filtered(&fix->inData, &filters[i], &expectFlux, &expectInspol);
+
+    oi_flux_iter_init(&fluxIter, &fix->inData, &filters[i]);
+    nflux = 0;
+    while (oi_flux_iter_next(&fluxIter, NULL, &pFlux, NULL, &pFluxRec,
+                             &iwave))
+    {
+      oi_flux_iter_get_wave(&fluxIter, &effWave, NULL);
+      g_assert_cmpfloat(effWave, >=, filters[i].wave_range[0]);
+      g_assert_cmpfloat(effWave, <=, filters[i].wave_range[1]);
+      ++nflux;
+    }
+    oi_flux_iter_free(&fluxIter);
+    g_assert_cmpint(nflux, ==, expectFlux);
+
+    oi_inspol_iter_init(&inspolIter, &fix->inData, &filters[i]);
+    ninspol = 0;
+    while (oi_inspol_iter_next(&inspolIter, NULL, NULL, NULL, &pInspolRec,
+                               NULL))
+    {
+      g_assert_cmpfloat(pInspolRec->mjd_obs, <=, filters[i].mjd_range[1]);
+      ++ninspol;
+    }
+    oi_inspol_iter_free(&inspolIter);
+    g_assert_cmpint(ninspol, ==, expectInspol);
+  }
+  g_assert_cmpint(fix->inData.numFlux, >, 0);
+  g_assert_cmpint(fix->inData.numInspol, >, 0);
+
+  /* Flagged fluxes are rejected unless accept_flagged is set */
+  filters[0].accept_flagged = 0;
+  oi_flux_iter_init(&fluxIter, &fix->inData, &filters[0]);
+  while (oi_flux_iter_next(&fluxIter, NULL, NULL, NULL, &pFluxRec, &iwave))
+    g_assert_false(pFluxRec->flag[iwave]);
+  oi_flux_iter_free(&fluxIter);
+}
+
+static void test_inspol_view(TestFixture *fix, gconstpointer userData)
+{
+  oi_filter_spec filt;
+  oi_fits_view view;
+  oi_inspol_iter iter, viewIter;
+  oi_inspol_batch batch;
+  oi_inspol *pTable, *pViewTable;
+  int extver, viewExtver, iwave, viewIwave;
+  long irec, viewIrec[BATCH_SIZE], ndata, n, i;
+  double effWave[BATCH_SIZE];
+
+  init_oi_filter(&filt);
+  filt.mjd_range[1] = 0.004;
+  apply_oi_filter_view(&fix->inData, &filt, &view);
+
+  /* Batches from view must match single data from filtering iterator */
+  memset(&batch, 0, sizeof(batch));
+  batch.irec = viewIrec;
+  batch.eff_wave = effWave;
+  oi_inspol_iter_init(&iter, &fix->inData, &filt);
+  oi_inspol_iter_init_view(&viewIter, &view);
+  ndata = 0;
+  while ((n = oi_inspol_iter_next_batch(&viewIter, BATCH_SIZE, &batch)) > 0)
+  {
+    for (i = 0; i < n; i++)
+    {
+      g_assert(oi_inspol_iter_next(&iter, &extver, &pTable, &irec, NULL,
+                                   &iwave));
+      g_assert_cmpint(viewIrec[i], ==, irec);
+      g_assert_cmpfloat(effWave[i], ==, 1.65e-6f);
+      ++ndata;
+    }
+  }
+  g_assert_false(oi_inspol_iter_next(&iter, NULL, NULL, NULL, NULL, NULL));
+  oi_inspol_iter_free(&iter);
+  g_assert_cmpint(ndata, ==, 6);
+
+  /* Single-datum access via view */
+  oi_inspol_iter_reset(&viewIter);
+  g_assert(oi_inspol_iter_next(&viewIter, &viewExtver, &pViewTable, NULL,
+                               NULL, &viewIwave));
+  g_assert_cmpint(viewExtver, ==, 1);
+  g_assert(pViewTable == fix->inData.inspolList->data);
+  g_assert_cmpint(viewIwave, ==, 0);
+  oi_inspol_iter_free(&viewIter);
+
+  free_oi_fits_view(&view);
 }
 
 int main(int argc, char *argv[])
@@ -603,6 +1130,20 @@ int main(int argc, char *argv[])
              test_uvrad, teardown_fixture);
   g_test_add("/oifitslib/oiiter/snr", TestFixture, FILENAME, setup_fixture,
              test_snr, teardown_fixture);
+  g_test_add("/oifitslib/oiiter/view", TestFixture, FILENAME, setup_fixture,
+             test_view, teardown_fixture);
+  g_test_add("/oifitslib/oiiter/batch", TestFixture, FILENAME, setup_fixture,
+             test_batch, teardown_fixture);
+  g_test_add("/oifitslib/oiiter/split", TestFixture, FILENAME, setup_fixture,
+             test_split, teardown_fixture);
+  g_test_add("/oifitslib/oiiter/mask", TestFixture, FILENAME, setup_fixture,
+             test_mask, teardown_fixture);
+  g_test_add("/oifitslib/oiiter/flat", TestFixture, FILENAME, setup_fixture,
+             test_flat, teardown_fixture);
+  g_test_add("/oifitslib/oiiter/flux_inspol", TestFixture, FILENAME,
+             setup_fixture, test_flux_inspol, teardown_fixture);
+  g_test_add("/oifitslib/oiiter/inspol_view", TestFixture, FILENAME,
+             setup_fixture, test_inspol_view, teardown_fixture);
 
   return g_test_run();
 }
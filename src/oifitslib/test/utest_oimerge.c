@@ -27,8 +27,11 @@
 #include "oifile.h"
 #include "oicheck.h"
 
+#include <unistd.h> /* unlink() */
+
 #define DIR1 "OIFITS1/"
 #define DIR2 "OIFITS2/"
+#define FILENAME_OUT "utest_oimerge.fits"
 
 typedef struct
 {
@@ -191,7 +194,6 @@ static void test_merge(gconstpointer userData)
   oi_fits outData, inData1, inData2, inData3;
   int status;
   DataCount inCount, outCount;
-  char msg[FLEN_ERRMSG];
 
   const TestSet *pSet = userData;
 
@@ -223,8 +225,6 @@ static void test_merge(gconstpointer userData)
       numCorr += inData3.numCorr;
       numInspol += inData3.numInspol;
     }
-    if (fits_read_errmsg(msg))
-      g_error("Uncleared CFITSIO error message: %s", msg);
 
     /* Merge datasets */
     if (pSet->cases[i].filename3 != NULL)
@@ -260,6 +260,418 @@ static void test_merge(gconstpointer userData)
   }
 }
 
+static void test_tolerance(void)
+{
+  const float shifts[] = {0.5e-10, 2.0e-10};
+  const int expectNumWavelength[] = {1, 2};
+  oi_fits outData, inData1, inData2;
+  oi_wavelength *pWave;
+  int status, i, j;
+
+  for (i = 0; i < 2; i++)
+  {
+    status = 0;
+    read_oi_fits(DIR2 "Alp_Vic--MIRC_H.fits", &inData1, &status);
+    read_oi_fits(DIR2 "Alp_Vic--MIRC_H.fits", &inData2, &status);
+    g_assert_false(status);
+
+    /* Shift wavebands of second dataset by less or more than tolerance */
+    pWave = inData2.wavelengthList->data;
+    for (j = 0; j < pWave->nwave; j++)
+      pWave->eff_wave[j] += shifts[i];
+
+    merge_oi_fits(&outData, &inData1, &inData2, NULL);
+    check(&outData);
+    g_assert_cmpint(outData.numArray, ==, 1);
+    g_assert_cmpint(outData.numWavelength, ==, expectNumWavelength[i]);
+
+    free_oi_fits(&outData);
+    free_oi_fits(&inData1);
+    free_oi_fits(&inData2);
+  }
+}
+
+static void test_target_sep(void)
+{
+  const double seps[] = {0.0, 1.0, 0.1};
+  const int expectNumTarget[] = {2, 1, 2};
+  oi_fits outData, inData1, inData2;
+  GList *inList;
+  oi_vis2 *pVis2;
+  target *pTarg;
+  int status, i, j;
+
+  for (i = 0; i < 3; i++)
+  {
+    status = 0;
+    read_oi_fits(DIR2 "Alp_Vic--MIRC_H.fits", &inData1, &status);
+    read_oi_fits(DIR2 "Alp_Vic--MIRC_H.fits", &inData2, &status);
+    g_assert_false(status);
+    g_assert_cmpint(inData2.targets.ntarget, ==, 1);
+
+    /* Rename target in second dataset and offset it by 0.5 arcsec */
+    pTarg = &inData2.targets.targ[0];
+    g_strlcpy(pTarg->target, "Renamed", sizeof(pTarg->target));
+    pTarg->decep0 += 0.5 / 3600.0;
+
+    inList = NULL;
+    inList = g_list_append(inList, &inData1);
+    inList = g_list_append(inList, &inData2);
+    merge_oi_fits_list_threaded(inList, 1, seps[i], &outData);
+    g_list_free(inList);
+    check(&outData);
+    g_assert_cmpint(outData.targets.ntarget, ==, expectNumTarget[i]);
+    pVis2 = g_list_last(outData.vis2List)->data;
+    for (j = 0; j < pVis2->numrec; j++)
+      g_assert_cmpint(pVis2->record[j].target_id, ==, expectNumTarget[i]);
+
+    free_oi_fits(&outData);
+    free_oi_fits(&inData1);
+    free_oi_fits(&inData2);
+  }
+}
+
+static void test_target_sep_same_input(void)
+{
+  oi_fits outData, inData;
+  GList *inList;
+  target *pTarg;
+  int status;
+
+  status = 0;
+  read_oi_fits(DIR2 "Alp_Vic--MIRC_H.fits", &inData, &status);
+  g_assert_false(status);
+  g_assert_cmpint(inData.targets.ntarget, ==, 1);
+
+  /* Add renamed copy of target offset by 0.5 arcsec */
+  inData.targets.targ =
+      chkrealloc(inData.targets.targ, 2 * sizeof(inData.targets.targ[0]));
+  inData.targets.targ[1] = inData.targets.targ[0];
+  inData.targets.ntarget = 2;
+  pTarg = &inData.targets.targ[1];
+  pTarg->target_id = 2;
+  g_strlcpy(pTarg->target, "Companion", sizeof(pTarg->target));
+  pTarg->decep0 += 0.5 / 3600.0;
+
+  /* Close targets from the same input should not be merged */
+  inList = g_list_append(NULL, &inData);
+  merge_oi_fits_list_threaded(inList, 1, 1.0, &outData);
+  g_list_free(inList);
+  check(&outData);
+  g_assert_cmpint(outData.targets.ntarget, ==, 2);
+
+  free_oi_fits(&outData);
+  free_oi_fits(&inData);
+}
+
+/** Assert data tables in two datasets match, including their order */
+static void assert_same_data(const oi_fits *pData1, const oi_fits *pData2)
+{
+  GList *link1, *link2;
+  oi_vis2 *pVis21, *pVis22;
+  oi_t3 *pT31, *pT32;
+  int i;
+
+  g_assert_cmpint(pData1->numVis2, ==, pData2->numVis2);
+  link1 = pData1->vis2List;
+  link2 = pData2->vis2List;
+  while (link1 != NULL)
+  {
+    pVis21 = link1->data;
+    pVis22 = link2->data;
+    g_assert_cmpstr(pVis21->arrname, ==, pVis22->arrname);
+    g_assert_cmpstr(pVis21->insname, ==, pVis22->insname);
+    g_assert_cmpint(pVis21->numrec, ==, pVis22->numrec);
+    g_assert_cmpint(pVis21->nwave, ==, pVis22->nwave);
+    for (i = 0; i < pVis21->numrec; i++)
+    {
+      g_assert_cmpint(pVis21->record[i].target_id, ==,
+                      pVis22->record[i].target_id);
+      g_assert_cmpfloat(pVis21->record[i].vis2data[0], ==,
+                        pVis22->record[i].vis2data[0]);
+    }
+    link1 = link1->next;
+    link2 = link2->next;
+  }
+  g_assert_cmpint(pData1->numT3, ==, pData2->numT3);
+  link1 = pData1->t3List;
+  link2 = pData2->t3List;
+  while (link1 != NULL)
+  {
+    pT31 = link1->data;
+    pT32 = link2->data;
+    g_assert_cmpstr(pT31->insname, ==, pT32->insname);
+    g_assert_cmpint(pT31->numrec, ==, pT32->numrec);
+    for (i = 0; i < pT31->numrec; i++)
+      g_assert_cmpint(pT31->record[i].target_id, ==, pT32->record[i].target_id);
+    link1 = link1->next;
+    link2 = link2->next;
+  }
+}
+
+static void test_steal(void)
+{
+  oi_fits copyOut, stealOut, inData1, inData2;
+  GList *inList;
+  DataCount copyCount, stealCount;
+  int status;
+
+  status = 0;
+  read_oi_fits("testdata.fits", &inData1, &status);
+  read_oi_fits(DIR2 "bigtest2.fits", &inData2, &status);
+  g_assert_false(status);
+  inList = NULL;
+  inList = g_list_append(inList, &inData1);
+  inList = g_list_append(inList, &inData2);
+
+  merge_oi_fits_list(inList, &copyOut);
+  merge_oi_fits_list_steal(inList, 0.0, &stealOut);
+  check(&stealOut);
+
+  /* Output should be same as from copying merge */
+  g_assert_cmpint(stealOut.numArray, ==, copyOut.numArray);
+  g_assert_cmpint(stealOut.numWavelength, ==, copyOut.numWavelength);
+  g_assert_cmpint(stealOut.numInspol, ==, copyOut.numInspol);
+  g_assert_cmpint(stealOut.numFlux, ==, copyOut.numFlux);
+  zero_count(&copyCount);
+  add_count(&copyCount, &copyOut);
+  zero_count(&stealCount);
+  add_count(&stealCount, &stealOut);
+  g_assert_cmpint(stealCount.numVis, ==, copyCount.numVis);
+  g_assert_cmpint(stealCount.numVis2, ==, copyCount.numVis2);
+  g_assert_cmpint(stealCount.numT3, ==, copyCount.numT3);
+
+  /* Inputs should be left without data tables */
+  g_assert_cmpint(inData1.numVis2, ==, 0);
+  g_assert(inData1.vis2List == NULL);
+  g_assert_cmpint(inData2.numT3, ==, 0);
+  g_assert(inData2.t3List == NULL);
+  g_assert_cmpint(inData2.numInspol, ==, 0);
+  g_assert_cmpint(g_hash_table_size(inData2.wavelengthHash), ==, 0);
+  g_assert_cmpint(inData2.numWavelength, >, 0);
+
+  g_list_free(inList);
+  free_oi_fits(&copyOut);
+  free_oi_fits(&stealOut);
+  free_oi_fits(&inData1);
+  free_oi_fits(&inData2);
+}
+
+static void test_threaded(void)
+{
+  oi_fits serialOut, threadedOut;
+  GList *filenameList, *inList, *link;
+  int status;
+
+  filenameList = NULL;
+  filenameList = g_list_append(filenameList, "testdata.fits");
+  filenameList = g_list_append(filenameList, DIR2 "bigtest2.fits");
+  filenameList = g_list_append(filenameList, DIR2 "Bin_Ary--MIRC_H.fits");
+  status = 0;
+  inList = read_oi_fits_list(filenameList, 3, &status);
+  g_assert_false(status);
+  g_assert_cmpint(g_list_length(inList), ==, 3);
+  g_assert_cmpint(((oi_fits *)inList->data)->numVis2, >, 0);
+
+  merge_oi_fits_list(inList, &serialOut);
+  merge_oi_fits_list_threaded(inList, 4, 0.0, &threadedOut);
+  check(&threadedOut);
+  g_assert_cmpint(threadedOut.numInspol, ==, serialOut.numInspol);
+  g_assert_cmpint(threadedOut.numVis, ==, serialOut.numVis);
+  g_assert_cmpint(threadedOut.numFlux, ==, serialOut.numFlux);
+  assert_same_data(&threadedOut, &serialOut);
+
+  /* Missing input should be reported */
+  filenameList = g_list_append(filenameList, "nonexistent.fits");
+  oi_hush_errors = TRUE;
+  g_assert_null(read_oi_fits_list(filenameList, 3, &status));
+  oi_hush_errors = FALSE;
+  g_assert_cmpint(status, !=, 0);
+
+  free_oi_fits(&serialOut);
+  free_oi_fits(&threadedOut);
+  for (link = inList; link != NULL; link = link->next)
+  {
+    free_oi_fits(link->data);
+    oi_free(link->data);
+  }
+  g_list_free(inList);
+  g_list_free(filenameList);
+}
+
+static void test_concat(void)
+{
+  oi_fits outData, inData1, inData2;
+  DataCount inCount, outCount;
+  oi_vis2 *pVis2;
+  oi_corr *pCorr;
+  int status, ndata, numVis2;
+
+  status = 0;
+  read_oi_fits("testdata.fits", &inData1, &status);
+  read_oi_fits("testdata.fits", &inData2, &status);
+  g_assert_false(status);
+  ndata = ((oi_corr *)inData1.corrList->data)->ndata;
+  numVis2 = ((oi_vis2 *)inData1.vis2List->data)->numrec;
+
+  merge_oi_fits(&outData, &inData1, &inData2, NULL);
+  g_assert_cmpint(outData.numCorr, ==, 2);
+  g_assert_cmpint(outData.numVis2, ==, 2);
+  zero_count(&inCount);
+  add_count(&inCount, &outData);
+
+  concat_oi_fits_tables(&outData);
+  check(&outData);
+  zero_count(&outCount);
+  add_count(&outCount, &outData);
+  g_assert_cmpint(outCount.numVis, ==, inCount.numVis);
+  g_assert_cmpint(outCount.numVis2, ==, inCount.numVis2);
+  g_assert_cmpint(outCount.numT3, ==, inCount.numT3);
+
+  /* Second dataset's records should refer to appended correlations */
+  g_assert_cmpint(outData.numCorr, ==, 1);
+  pCorr = outData.corrList->data;
+  g_assert_cmpint(pCorr->ndata, ==, 2 * ndata);
+  g_assert_cmpint(outData.numVis2, ==, 1);
+  pVis2 = outData.vis2List->data;
+  g_assert_cmpint(pVis2->numrec, ==, 2 * numVis2);
+  g_assert_cmpstr(pVis2->corrname, ==, pCorr->corrname);
+  g_assert_cmpint(pVis2->record[numVis2].corrindx_vis2data, ==,
+                  pVis2->record[0].corrindx_vis2data + ndata);
+
+  free_oi_fits(&outData);
+  free_oi_fits(&inData1);
+  free_oi_fits(&inData2);
+}
+
+static void test_dedup(void)
+{
+  oi_fits outData, inData1, inData2;
+  DataCount inCount, outCount;
+  long numRecord;
+  int status;
+
+  status = 0;
+  read_oi_fits("testdata.fits", &inData1, &status);
+  read_oi_fits("testdata.fits", &inData2, &status);
+  g_assert_false(status);
+  numRecord = (((oi_vis *)inData1.visList->data)->numrec +
+               ((oi_vis2 *)inData1.vis2List->data)->numrec +
+               ((oi_t3 *)inData1.t3List->data)->numrec +
+               ((oi_flux *)inData1.fluxList->data)->numrec);
+  zero_count(&inCount);
+  add_count(&inCount, &inData1);
+
+  /* Every record of second copy is a duplicate */
+  merge_oi_fits(&outData, &inData1, &inData2, NULL);
+  g_assert_cmpint(dedup_oi_fits(&outData, FALSE), ==, numRecord);
+  g_assert_cmpint(outData.numVis2, ==, 2);
+  g_assert_cmpint(dedup_oi_fits(&outData, TRUE), ==, numRecord);
+  check(&outData);
+  g_assert_cmpint(outData.numVis, ==, 1);
+  g_assert_cmpint(outData.numVis2, ==, 1);
+  g_assert_cmpint(outData.numT3, ==, 1);
+  g_assert_cmpint(outData.numFlux, ==, 1);
+  zero_count(&outCount);
+  add_count(&outCount, &outData);
+  g_assert_cmpint(outCount.numVis, ==, inCount.numVis);
+  g_assert_cmpint(outCount.numVis2, ==, inCount.numVis2);
+  g_assert_cmpint(outCount.numT3, ==, inCount.numT3);
+
+  /* No duplicates should remain */
+  g_assert_cmpint(dedup_oi_fits(&outData, TRUE), ==, 0);
+  free_oi_fits(&outData);
+  free_oi_fits(&inData2);
+
+  /* Distinct datasets should have no duplicates */
+  read_oi_fits(DIR2 "bigtest2.fits", &inData2, &status);
+  g_assert_false(status);
+  merge_oi_fits(&outData, &inData1, &inData2, NULL);
+  g_assert_cmpint(dedup_oi_fits(&outData, FALSE), ==, 0);
+
+  free_oi_fits(&outData);
+  free_oi_fits(&inData1);
+  free_oi_fits(&inData2);
+}
+
+static void test_stream(gconstpointer userData)
+{
+  GList *filenameList, *inList, *link;
+  oi_fits streamData, serialData, memData;
+  DataCount memCount, streamCount;
+  int i, njobs, status;
+
+  const TestSet *pSet = userData;
+
+  for (i = 0; i < pSet->numCases; i++)
+  {
+    filenameList = NULL;
+    filenameList = g_list_append(filenameList,
+                                 (char *)pSet->cases[i].filename1);
+    filenameList = g_list_append(filenameList,
+                                 (char *)pSet->cases[i].filename2);
+    if (pSet->cases[i].filename3 != NULL)
+      filenameList = g_list_append(filenameList,
+                                   (char *)pSet->cases[i].filename3);
+
+    /* Merge in memory for comparison */
+    status = 0;
+    inList = read_oi_fits_list(filenameList, 2, &status);
+    g_assert_false(status);
+    merge_oi_fits_list(inList, &memData);
+
+    for (njobs = 1; njobs <= 3; njobs += 2)
+    {
+      /* Merge by streaming to file, then read back */
+      g_assert_cmpint(
+          merge_oi_fits_files(filenameList, njobs, 0.0, FILENAME_OUT,
+                              &status),
+          ==, 0);
+      read_oi_fits(FILENAME_OUT, &streamData, &status);
+      g_assert_false(status);
+      unlink(FILENAME_OUT);
+      check(&streamData);
+
+      g_assert_cmpint(streamData.targets.ntarget, ==, memData.targets.ntarget);
+      g_assert_cmpint(streamData.numArray, ==, memData.numArray);
+      g_assert_cmpint(streamData.numWavelength, ==, memData.numWavelength);
+      g_assert_cmpint(streamData.numCorr, ==, memData.numCorr);
+      g_assert_cmpint(streamData.numInspol, ==, memData.numInspol);
+      g_assert_cmpint(streamData.numVis, ==, memData.numVis);
+      g_assert_cmpint(streamData.numVis2, ==, memData.numVis2);
+      g_assert_cmpint(streamData.numT3, ==, memData.numT3);
+      g_assert_cmpint(streamData.numFlux, ==, memData.numFlux);
+      zero_count(&memCount);
+      add_count(&memCount, &memData);
+      zero_count(&streamCount);
+      add_count(&streamCount, &streamData);
+      g_assert_cmpint(streamCount.numVis, ==, memCount.numVis);
+      g_assert_cmpint(streamCount.numVis2, ==, memCount.numVis2);
+      g_assert_cmpint(streamCount.numT3, ==, memCount.numT3);
+
+      /* Output should not depend on number of jobs */
+      if (njobs == 1)
+        serialData = streamData;
+      else
+      {
+        assert_same_data(&streamData, &serialData);
+        free_oi_fits(&streamData);
+        free_oi_fits(&serialData);
+      }
+    }
+
+    /* Free storage */
+    free_oi_fits(&memData);
+    for (link = inList; link != NULL; link = link->next)
+    {
+      free_oi_fits(link->data);
+      oi_free(link->data);
+    }
+    g_list_free(inList);
+    g_list_free(filenameList);
+  }
+}
+
 int main(int argc, char *argv[])
 {
   g_test_init(&argc, &argv, NULL);
@@ -267,6 +679,16 @@ int main(int argc, char *argv[])
   g_test_add_data_func("/oifitslib/oimerge/ver1", &v1Set, test_merge);
   g_test_add_data_func("/oifitslib/oimerge/ver2", &v2Set, test_merge);
   g_test_add_data_func("/oifitslib/oimerge/ver12", &v12Set, test_merge);
+  g_test_add_func("/oifitslib/oimerge/tolerance", test_tolerance);
+  g_test_add_func("/oifitslib/oimerge/target_sep", test_target_sep);
+  g_test_add_func("/oifitslib/oimerge/target_sep_same_input",
+                  test_target_sep_same_input);
+  g_test_add_func("/oifitslib/oimerge/steal", test_steal);
+  g_test_add_func("/oifitslib/oimerge/threaded", test_threaded);
+  g_test_add_func("/oifitslib/oimerge/concat", test_concat);
+  g_test_add_func("/oifitslib/oimerge/dedup", test_dedup);
+  g_test_add_data_func("/oifitslib/oimerge/stream/ver1", &v1Set, test_stream);
+  g_test_add_data_func("/oifitslib/oimerge/stream/ver2", &v2Set, test_stream);
 
   return g_test_run();
 }
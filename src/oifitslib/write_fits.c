@@ -76,8 +76,39 @@ void free_tform(char **tform, int n)
   int i;
 
   for (i = 0; i < n; i++)
-    free(tform[i]);
-  free(tform);
+    oi_free(tform[i]);
+  oi_free(tform);
+}
+
+/**
+ * Record time spent writing current HDU, and count rows and bytes written.
+ *
+ * @param fptr     see cfitsio documentation
+ * @param start    value returned by oi_profile_start()
+ * @param numRows  number of table rows written, 0 for primary HDU
+ * @param pStatus  pointer to status variable
+ */
+static void profile_write(fitsfile *fptr, oi_timer start, long numRows,
+                          const STATUS *pStatus)
+{
+  LONGLONG headStart, dataStart, dataEnd;
+  int ncols;
+  STATUS status = 0; /* don't disturb caller's status */
+
+  if (start == 0) return; /* profiling disabled */
+  oi_profile_stop(OI_PHASE_WRITE, start);
+  if (*pStatus) return;
+  fits_get_hduaddrll(fptr, &headStart, &dataStart, &dataEnd, &status);
+  if (status == 0)
+    oi_profile_count(OI_COUNT_BYTE_WRITTEN, dataEnd - headStart);
+  if (numRows > 0)
+  {
+    fits_get_num_cols(fptr, &ncols, &status);
+    if (status) return;
+    oi_profile_count(OI_COUNT_ROW_WRITTEN, numRows);
+    /* One fits_write_col() per column per row */
+    oi_profile_count(OI_COUNT_COLUMN_IO, (long long)numRows * ncols);
+  }
 }
 
 /*
@@ -101,9 +132,12 @@ STATUS write_oi_header(fitsfile *fptr, oi_header header, STATUS *pStatus)
 {
   const char function[] = "write_oi_header";
   int nhdu;
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
+  start = oi_profile_start();
+
   /* Move to primary HDU */
   fits_get_num_hdus(fptr, &nhdu, pStatus);
   if (nhdu == 0)
@@ -154,12 +188,9 @@ STATUS write_oi_header(fitsfile *fptr, oi_header header, STATUS *pStatus)
                    "Observation technique", pStatus);
 
   fits_write_chksum(fptr, pStatus);
+  profile_write(fptr, start, 0, pStatus);
 
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
 
@@ -185,15 +216,17 @@ STATUS write_oi_array(fitsfile *fptr, oi_array array, int extver,
   char extname[] = "OI_ARRAY";
   char *str;
   int revision = OI_REVN_V2_ARRAY, irow;
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
+  start = oi_profile_start();
   fits_create_tbl(fptr, BINARY_TBL, 0, tfields, ttype, tform, tunit, extname,
                   pStatus);
   if (array.revision != revision)
   {
-    printf("WARNING! array.revision != %d on entry to %s. "
-           "Writing revision %d table\n",
-           revision, function, revision);
+    oi_warning("array.revision != %d on entry to %s. "
+               "Writing revision %d table\n",
+               revision, function, revision);
   }
   fits_write_key(fptr, TINT, "OI_REVN", &revision,
                  "Revision number of the table definition", pStatus);
@@ -232,12 +265,9 @@ STATUS write_oi_array(fitsfile *fptr, oi_array array, int extver,
   }
 
   fits_write_chksum(fptr, pStatus);
+  profile_write(fptr, start, array.nelement, pStatus);
 
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
 
@@ -266,15 +296,17 @@ STATUS write_oi_target(fitsfile *fptr, oi_target targets, STATUS *pStatus)
   char extname[] = "OI_TARGET";
   char *str;
   int revision = OI_REVN_V2_TARGET, irow;
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
+  start = oi_profile_start();
   fits_create_tbl(fptr, BINARY_TBL, 0, tfields, ttype, tform, tunit, extname,
                   pStatus);
   if (targets.revision != revision)
   {
-    printf("WARNING! targets.revision != %d on entry to %s. "
-           "Writing revision %d table\n",
-           revision, function, revision);
+    oi_warning("targets.revision != %d on entry to %s. "
+               "Writing revision %d table\n",
+               revision, function, revision);
   }
   fits_write_key(fptr, TINT, "OI_REVN", &revision,
                  "Revision number of the table definition", pStatus);
@@ -329,12 +361,9 @@ STATUS write_oi_target(fitsfile *fptr, oi_target targets, STATUS *pStatus)
   }
 
   fits_write_chksum(fptr, pStatus);
+  profile_write(fptr, start, targets.ntarget, pStatus);
 
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
 
@@ -358,15 +387,17 @@ STATUS write_oi_wavelength(fitsfile *fptr, oi_wavelength wave, int extver,
   char *tunit[] = {"m", "m"};
   char extname[] = "OI_WAVELENGTH";
   int revision = OI_REVN_V2_WAVELENGTH;
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
+  start = oi_profile_start();
   fits_create_tbl(fptr, BINARY_TBL, 0, tfields, ttype, tform, tunit, extname,
                   pStatus);
   if (wave.revision != revision)
   {
-    printf("WARNING! wave.revision != %d on entry to %s. "
-           "Writing revision %d table\n",
-           revision, function, revision);
+    oi_warning("wave.revision != %d on entry to %s. "
+               "Writing revision %d table\n",
+               revision, function, revision);
   }
   fits_write_key(fptr, TINT, "OI_REVN", &revision,
                  "Revision number of the table definition", pStatus);
@@ -378,12 +409,9 @@ STATUS write_oi_wavelength(fitsfile *fptr, oi_wavelength wave, int extver,
   fits_write_col(fptr, TFLOAT, 2, 1, 1, wave.nwave, wave.eff_band, pStatus);
 
   fits_write_chksum(fptr, pStatus);
+  profile_write(fptr, start, wave.nwave, pStatus);
 
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
 
@@ -406,15 +434,17 @@ STATUS write_oi_corr(fitsfile *fptr, oi_corr corr, int extver, STATUS *pStatus)
   char *tunit[] = {"\0", "\0", "\0"};
   char extname[] = "OI_CORR";
   int revision = OI_REVN_V2_CORR;
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
+  start = oi_profile_start();
   fits_create_tbl(fptr, BINARY_TBL, 0, tfields, ttype, tform, tunit, extname,
                   pStatus);
   if (corr.revision != revision)
   {
-    printf("WARNING! corr.revision != %d on entry to %s. "
-           "Writing revision %d table\n",
-           revision, function, revision);
+    oi_warning("corr.revision != %d on entry to %s. "
+               "Writing revision %d table\n",
+               revision, function, revision);
   }
   fits_write_key(fptr, TINT, "OI_REVN", &revision,
                  "Revision number of the table definition", pStatus);
@@ -429,12 +459,9 @@ STATUS write_oi_corr(fitsfile *fptr, oi_corr corr, int extver, STATUS *pStatus)
   fits_write_col(fptr, TDOUBLE, 3, 1, 1, corr.ncorr, corr.corr, pStatus);
 
   fits_write_chksum(fptr, pStatus);
+  profile_write(fptr, start, corr.ncorr, pStatus);
 
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
 
@@ -462,9 +489,12 @@ STATUS write_oi_inspol(fitsfile *fptr, oi_inspol inspol, int extver,
   char extname[] = "OI_INSPOL";
   char *str;
   int revision = OI_REVN_V2_INSPOL, irow;
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
+  start = oi_profile_start();
+
   /* Create table structure */
   tform = make_tform(tformTpl, tfields, inspol.nwave);
   fits_create_tbl(fptr, BINARY_TBL, 0, tfields, ttype, tform, tunit, extname,
@@ -474,9 +504,9 @@ STATUS write_oi_inspol(fitsfile *fptr, oi_inspol inspol, int extver,
   /* Write keywords */
   if (inspol.revision != revision)
   {
-    printf("WARNING! inspol.revision != %d on entry to %s. "
-           "Writing revision %d table\n",
-           revision, function, revision);
+    oi_warning("inspol.revision != %d on entry to %s. "
+               "Writing revision %d table\n",
+               revision, function, revision);
   }
   fits_write_key(fptr, TINT, "OI_REVN", &revision,
                  "Revision number of the table definition", pStatus);
@@ -518,12 +548,9 @@ STATUS write_oi_inspol(fitsfile *fptr, oi_inspol inspol, int extver,
   }
 
   fits_write_chksum(fptr, pStatus);
+  profile_write(fptr, start, inspol.numrec, pStatus);
 
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
 
@@ -656,9 +683,12 @@ STATUS write_oi_vis(fitsfile *fptr, oi_vis vis, int extver, STATUS *pStatus)
                    "deg", "deg", "m",   "m", "\0", "\0"};
   char extname[] = "OI_VIS";
   int revision = OI_REVN_V2_VIS, irow;
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
+  start = oi_profile_start();
+
   /* Create table structure */
   tform = make_tform(tformTpl, tfields, vis.nwave);
   fits_create_tbl(fptr, BINARY_TBL, 0, tfields, ttype, tform, tunit, extname,
@@ -675,9 +705,9 @@ STATUS write_oi_vis(fitsfile *fptr, oi_vis vis, int extver, STATUS *pStatus)
   /* Write keywords */
   if (vis.revision != revision)
   {
-    printf("WARNING! vis.revision != %d on entry to %s. "
-           "Writing revision %d table\n",
-           revision, function, revision);
+    oi_warning("vis.revision != %d on entry to %s. "
+               "Writing revision %d table\n",
+               revision, function, revision);
   }
   fits_write_key(fptr, TINT, "OI_REVN", &revision,
                  "Revision number of the table definition", pStatus);
@@ -687,7 +717,7 @@ STATUS write_oi_vis(fitsfile *fptr, oi_vis vis, int extver, STATUS *pStatus)
     fits_write_key(fptr, TSTRING, "ARRNAME", &vis.arrname, "Array name",
                    pStatus);
   else
-    printf("WARNING! vis.arrname not set\n");
+    oi_warning("vis.arrname not set\n");
   fits_write_key(fptr, TSTRING, "INSNAME", &vis.insname, "Detector name",
                  pStatus);
   fits_write_key(fptr, TINT, "EXTVER", &extver, "ID number of this OI_VIS",
@@ -723,12 +753,9 @@ STATUS write_oi_vis(fitsfile *fptr, oi_vis vis, int extver, STATUS *pStatus)
   write_oi_vis_opt(fptr, vis, pStatus);
 
   fits_write_chksum(fptr, pStatus);
+  profile_write(fptr, start, vis.numrec, pStatus);
 
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
 
@@ -758,9 +785,12 @@ STATUS write_oi_vis2(fitsfile *fptr, oi_vis2 vis2, int extver, STATUS *pStatus)
   char extname[] = "OI_VIS2";
   int revision = OI_REVN_V2_VIS2, irow;
   bool correlated;
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
+  start = oi_profile_start();
+
   /* Create table structure */
   tform = make_tform(tformTpl, tfields, vis2.nwave);
   fits_create_tbl(fptr, BINARY_TBL, 0, tfields, ttype, tform, tunit, extname,
@@ -770,9 +800,9 @@ STATUS write_oi_vis2(fitsfile *fptr, oi_vis2 vis2, int extver, STATUS *pStatus)
   /* Write mandatory keywords */
   if (vis2.revision != revision)
   {
-    printf("WARNING! vis2.revision != %d on entry to %s. "
-           "Writing revision %d table\n",
-           revision, function, revision);
+    oi_warning("vis2.revision != %d on entry to %s. "
+               "Writing revision %d table\n",
+               revision, function, revision);
   }
   fits_write_key(fptr, TINT, "OI_REVN", &revision,
                  "Revision number of the table definition", pStatus);
@@ -782,7 +812,7 @@ STATUS write_oi_vis2(fitsfile *fptr, oi_vis2 vis2, int extver, STATUS *pStatus)
     fits_write_key(fptr, TSTRING, "ARRNAME", &vis2.arrname, "Array name",
                    pStatus);
   else
-    printf("WARNING! vis2.arrname not set\n");
+    oi_warning("vis2.arrname not set\n");
   fits_write_key(fptr, TSTRING, "INSNAME", &vis2.insname, "Detector name",
                  pStatus);
   fits_write_key(fptr, TINT, "EXTVER", &extver, "ID number of this OI_VIS2",
@@ -830,12 +860,9 @@ STATUS write_oi_vis2(fitsfile *fptr, oi_vis2 vis2, int extver, STATUS *pStatus)
   }
 
   fits_write_chksum(fptr, pStatus);
+  profile_write(fptr, start, vis2.numrec, pStatus);
 
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
 
@@ -867,9 +894,12 @@ STATUS write_oi_t3(fitsfile *fptr, oi_t3 t3, int extver, STATUS *pStatus)
   char extname[] = "OI_T3";
   int revision = OI_REVN_V2_T3, irow;
   bool correlated;
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
+  start = oi_profile_start();
+
   /* Create table structure */
   tform = make_tform(tformTpl, tfields, t3.nwave);
   fits_create_tbl(fptr, BINARY_TBL, 0, tfields, ttype, tform, tunit, extname,
@@ -879,9 +909,9 @@ STATUS write_oi_t3(fitsfile *fptr, oi_t3 t3, int extver, STATUS *pStatus)
   /* Write mandatory keywords */
   if (t3.revision != revision)
   {
-    printf("WARNING! t3.revision != %d on entry to %s. "
-           "Writing revision %d table\n",
-           revision, function, revision);
+    oi_warning("t3.revision != %d on entry to %s. "
+               "Writing revision %d table\n",
+               revision, function, revision);
   }
   fits_write_key(fptr, TINT, "OI_REVN", &revision,
                  "Revision number of the table definition", pStatus);
@@ -891,7 +921,7 @@ STATUS write_oi_t3(fitsfile *fptr, oi_t3 t3, int extver, STATUS *pStatus)
     fits_write_key(fptr, TSTRING, "ARRNAME", &t3.arrname, "Array name",
                    pStatus);
   else
-    printf("WARNING! t3.arrname not set\n");
+    oi_warning("t3.arrname not set\n");
   fits_write_key(fptr, TSTRING, "INSNAME", &t3.insname, "Detector name",
                  pStatus);
   fits_write_key(fptr, TINT, "EXTVER", &extver, "ID number of this OI_T3",
@@ -950,12 +980,9 @@ STATUS write_oi_t3(fitsfile *fptr, oi_t3 t3, int extver, STATUS *pStatus)
   }
 
   fits_write_chksum(fptr, pStatus);
+  profile_write(fptr, start, t3.numrec, pStatus);
 
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
 
@@ -982,9 +1009,12 @@ STATUS write_oi_flux(fitsfile *fptr, oi_flux flux, int extver, STATUS *pStatus)
   char keyval[FLEN_VALUE];
   int revision = OI_REVN_V2_FLUX, irow;
   bool correlated;
+  oi_timer start;
 
   if (*pStatus) return *pStatus; /* error flag set - do nothing */
 
+  start = oi_profile_start();
+
   /* Create table structure */
   tform = make_tform(tformTpl, tfields, flux.nwave);
   fits_create_tbl(fptr, BINARY_TBL, 0, tfields, ttype, tform, tunit, extname,
@@ -998,9 +1028,9 @@ STATUS write_oi_flux(fitsfile *fptr, oi_flux flux, int extver, STATUS *pStatus)
   /* Write mandatory keywords */
   if (flux.revision != revision)
   {
-    printf("WARNING! flux.revision != %d on entry to %s. "
-           "Writing revision %d table\n",
-           revision, function, revision);
+    oi_warning("flux.revision != %d on entry to %s. "
+               "Writing revision %d table\n",
+               revision, function, revision);
   }
   fits_write_key(fptr, TINT, "OI_REVN", &revision,
                  "Revision number of the table definition", pStatus);
@@ -1071,11 +1101,8 @@ STATUS write_oi_flux(fitsfile *fptr, oi_flux flux, int extver, STATUS *pStatus)
   }
 
   fits_write_chksum(fptr, pStatus);
+  profile_write(fptr, start, flux.numrec, pStatus);
 
-  if (*pStatus && !oi_hush_errors)
-  {
-    fprintf(stderr, "CFITSIO error in %s:\n", function);
-    fits_report_error(stderr, *pStatus);
-  }
+  if (*pStatus) oi_report_error(function, *pStatus);
   return *pStatus;
 }
@@ -24,65 +24,327 @@
 
 #include "oicheck.h"
 
+#include <stdio.h>
+#include <string.h>
+
+static int njobs = 1;
+static int chunkSize = 0;
+static int stopLevel = OI_BREACH_NONE;
+static char *listFilename = NULL;
+static gboolean stats = FALSE;
+
+static GOptionEntry entries[] = {
+    {"jobs", 'j', 0, G_OPTION_ARG_INT, &njobs,
+     "Run up to N checks (or files, if several given) concurrently", "N"},
+    {"chunk", 'c', 0, G_OPTION_ARG_INT, &chunkSize,
+     "Read data tables N records at a time, without loading whole file",
+     "N"},
+    {"stop", 's', 0, G_OPTION_ARG_INT, &stopLevel,
+     "Stop at first breach of severity N or worse (1=warning, 2=not OIFITS) "
+     "and exit with non-zero status. Checks of the metadata tables are "
+     "still run to completion",
+     "N"},
+    {"files-from", 'f', 0, G_OPTION_ARG_FILENAME, &listFilename,
+     "Also check files named in FILE, one per line ('-' for standard input)",
+     "FILE"},
+    {"stats", 0, 0, G_OPTION_ARG_NONE, &stats,
+     "Print time spent in each processing phase and I/O counts", NULL},
+    {NULL}};
+
+/**
+ * Print phase timers and I/O counters at exit
+ */
+static void print_profile(void)
+{
+  oi_profile_print(stderr);
+}
+
+/** Totals accumulated by batch_worker() */
+typedef struct
+{
+  GMutex lock;      /**< Serialises output and updates to totals */
+  int numPassed;    /**< Number of files that passed all checks */
+  int numWarning;   /**< Number of files with warnings only */
+  int numFailed;    /**< Number of files that are not valid OIFITS */
+  int numUnread;    /**< Number of files that could not be read */
+  gboolean stopped; /**< TRUE if any file reached stopLevel */
+
+} batch_totals;
+
+/**
+ * Library logging callback used by batch_worker(), collecting warnings
+ * so they are printed with the summary line for the file
+ */
+static void collect_warning(oi_log_level level, const char *message,
+                            void *data)
+{
+  GString *pWarnings = data;
+
+  if (level == OI_LOG_WARNING)
+    g_string_append_printf(pWarnings, "\n  WARNING! %s", message);
+}
+
+/** GThreadPool worker function to check one file in batch mode */
+static void batch_worker(gpointer data, gpointer userData)
+{
+  char *filename = data;
+  batch_totals *pTotals = userData;
+  oi_context ctx;
+  oi_fits oi;
+  oi_check_result results[OI_NUM_CHECK];
+  oi_breach_level worst;
+  GString *pLine, *pWarnings;
+  char desc[FLEN_STATUS];
+  int status, numBad, i;
+
+  /* Read errors are summarised below, so only collect warnings */
+  pWarnings = g_string_new(NULL);
+  init_oi_context(&ctx);
+  ctx.hushErrors = TRUE;
+  ctx.logFunc = collect_warning;
+  ctx.logData = pWarnings;
+  oi_set_context(&ctx);
+
+  /* Each file is checked serially, parallelism is across files */
+  status = 0;
+  if (chunkSize > 0)
+  {
+    worst = oi_check_file(filename, chunkSize, OI_NUM_CHECK, oi_check_funcs,
+                          stopLevel, results, &status);
+  }
+  else
+  {
+    worst = OI_BREACH_NOT_FITS;
+    if (!read_oi_fits(filename, &oi, &status))
+    {
+      worst = oi_check_until(&oi, OI_NUM_CHECK, oi_check_funcs, stopLevel,
+                             results);
+      free_oi_fits(&oi);
+    }
+  }
+
+  /* Don't use format_check_result(), its buffer is shared */
+  pLine = g_string_new(filename);
+  numBad = 0;
+  if (status)
+  {
+    fits_get_errstatus(status, desc);
+    g_string_append_printf(pLine, ": Cannot read file (%s)", desc);
+  }
+  else
+  {
+    for (i = 0; i < OI_NUM_CHECK; i++)
+    {
+      if (results[i].level != OI_BREACH_NONE) ++numBad;
+      free_check_result(&results[i]);
+    }
+    if (worst == OI_BREACH_NONE)
+      g_string_append(pLine, ": All checks passed");
+    else
+      g_string_append_printf(pLine, ": %s (%d checks failed)",
+                             oi_breach_level_desc[worst], numBad);
+  }
+  oi_set_context(NULL);
+  g_string_append(pLine, pWarnings->str);
+
+  g_mutex_lock(&pTotals->lock);
+  printf("%s\n", pLine->str);
+  if (status)
+    ++pTotals->numUnread;
+  else if (worst == OI_BREACH_NONE)
+    ++pTotals->numPassed;
+  else if (worst == OI_BREACH_WARNING)
+    ++pTotals->numWarning;
+  else
+    ++pTotals->numFailed;
+  if (!status && stopLevel != OI_BREACH_NONE && worst >= stopLevel)
+    pTotals->stopped = TRUE;
+  g_mutex_unlock(&pTotals->lock);
+
+  g_string_free(pLine, TRUE);
+  g_string_free(pWarnings, TRUE);
+  g_free(filename);
+}
+
+/**
+ * Check many files on a pool of worker threads, printing one summary
+ * line per file.
+ *
+ * Filenames are taken from @a files, then from the file named
+ * listFilename (if any), which is read line by line so that checking
+ * starts before the list is complete.
+ *
+ * @return EXIT_SUCCESS if every file could be read (and none reached
+ *         stopLevel), otherwise EXIT_FAILURE
+ */
+static int check_batch(int numFiles, char *files[])
+{
+  GThreadPool *pool;
+  GError *error;
+  batch_totals totals;
+  FILE *fp;
+  char line[FLEN_FILENAME];
+  int numQueued, i;
+
+  if (njobs > 1 && !fits_is_reentrant())
+  {
+    printf("CFITSIO is not thread-safe, checking one file at a time\n");
+    njobs = 1;
+  }
+
+  g_mutex_init(&totals.lock);
+  totals.numPassed = 0;
+  totals.numWarning = 0;
+  totals.numFailed = 0;
+  totals.numUnread = 0;
+  totals.stopped = FALSE;
+
+  error = NULL;
+  pool = g_thread_pool_new(batch_worker, &totals, njobs, TRUE, &error);
+  if (pool == NULL)
+  {
+    printf("Error creating worker threads: %s\n", error->message);
+    g_error_free(error);
+    exit(EXIT_FAILURE);
+  }
+
+  numQueued = 0;
+  for (i = 0; i < numFiles; i++, numQueued++)
+    g_thread_pool_push(pool, g_strdup(files[i]), NULL);
+
+  if (listFilename != NULL)
+  {
+    if (strcmp(listFilename, "-") == 0)
+      fp = stdin;
+    else
+      fp = fopen(listFilename, "r");
+    if (fp == NULL)
+    {
+      printf("Cannot open file list '%s'\n", listFilename);
+      ++totals.numUnread; /* no workers are updating totals yet */
+    }
+    else
+    {
+      while (fgets(line, sizeof(line), fp) != NULL)
+      {
+        g_strstrip(line);
+        if (strlen(line) == 0) continue;
+        g_thread_pool_push(pool, g_strdup(line), NULL);
+        ++numQueued;
+      }
+      if (fp != stdin) fclose(fp);
+    }
+  }
+  g_thread_pool_free(pool, FALSE, TRUE); /* wait for all files */
+  g_mutex_clear(&totals.lock);
+
+  printf("%d files checked: %d passed, %d with warnings, %d failed, "
+         "%d unreadable\n",
+         numQueued, totals.numPassed, totals.numWarning, totals.numFailed,
+         totals.numUnread);
+  if (totals.numUnread > 0 || totals.stopped) return EXIT_FAILURE;
+  return EXIT_SUCCESS;
+}
+
 /**
  * Main function for command-line check utility
  */
 int main(int argc, char *argv[])
 {
-  /** Checking functions to call */
-  check_func checks[] = {check_tables,
-                         check_header,
-                         check_keywords,
-                         check_visrefmap,
-                         check_unique_targets,
-                         check_targets_present,
-                         check_arrname,
-                         check_elements_present,
-                         check_corr_present,
-                         check_flagging,
-                         check_t3amp,
-                         check_waveorder,
-                         check_time,
-                         check_flux,
-                         NULL};
+  GError *error;
+  GOptionContext *context;
   oi_fits oi;
-  oi_check_result result;
+  oi_check_result results[OI_NUM_CHECK];
   oi_breach_level worst;
   char filename[FLEN_FILENAME];
   int status, i;
 
   /* Parse command-line */
-  if (argc != 2)
+  error = NULL;
+  context = g_option_context_new("FILE... - check datasets for conformity");
+  g_option_context_add_main_entries(context, entries, NULL);
+  g_option_context_parse(context, &argc, &argv, &error);
+  g_option_context_free(context);
+  if (error != NULL)
   {
-    printf("Usage:\n%s FILE\n", argv[0]);
+    printf("Error parsing command-line options: %s\n", error->message);
+    g_error_free(error);
     exit(2); /* standard unix behaviour */
   }
+  if (argc < 2 && listFilename == NULL)
+  {
+    printf("Wrong number of command-line arguments\n"
+           "Enter '%s --help' for usage information\n",
+           argv[0]);
+    exit(2);
+  }
+  if (njobs < 1)
+  {
+    printf("Number of jobs must be at least 1\n");
+    exit(2);
+  }
+  if (chunkSize < 0)
+  {
+    printf("Chunk size must not be negative\n");
+    exit(2);
+  }
+  if (stopLevel < OI_BREACH_NONE || stopLevel > OI_BREACH_NOT_FITS)
+  {
+    printf("Invalid severity level %d\n", stopLevel);
+    exit(2);
+  }
+  if (stats)
+  {
+    oi_profile_enable(TRUE);
+    atexit(print_profile);
+  }
+
+  /* Several files => batch mode, one line of output per file */
+  if (argc > 2 || listFilename != NULL)
+    exit(check_batch(argc - 1, &argv[1]));
+
   (void)g_strlcpy(filename, argv[1], FLEN_FILENAME);
 
-  /* Read FITS file */
   status = 0;
-  read_oi_fits(filename, &oi, &status);
-  if (status) goto except;
+  if (chunkSize > 0)
+  {
+    /* Check FITS file while reading it */
+    worst = oi_check_file(filename, chunkSize, OI_NUM_CHECK, oi_check_funcs,
+                          stopLevel, results, &status);
+    if (status) goto except;
+  }
+  else
+  {
+    /* Read FITS file */
+    read_oi_fits(filename, &oi, &status);
+    if (status) goto except;
+
+    /* Display summary info */
+    print_oi_fits_summary(&oi);
 
-  /* Display summary info */
-  print_oi_fits_summary(&oi);
+    /* Run checks */
+    if (stopLevel != OI_BREACH_NONE)
+      worst = oi_check_until(&oi, OI_NUM_CHECK, oi_check_funcs, stopLevel,
+                             results);
+    else
+      worst = oi_check_all(&oi, njobs, results);
+    free_oi_fits(&oi);
+  }
 
-  /* Run checks */
-  worst = OI_BREACH_NONE;
-  i = 0;
-  while (checks[i] != NULL)
+  /* Report results in fixed order */
+  for (i = 0; i < OI_NUM_CHECK; i++)
   {
-    if ((*checks[i++])(&oi, &result) != OI_BREACH_NONE)
-    {
-      print_check_result(&result);
-      if (result.level > worst) worst = result.level;
-    }
-    free_check_result(&result);
+    if (results[i].level != OI_BREACH_NONE) print_check_result(&results[i]);
+    free_check_result(&results[i]);
   }
 
   if (worst == OI_BREACH_NONE) printf("All checks passed\n");
+  if (stopLevel != OI_BREACH_NONE && worst >= stopLevel)
+  {
+    printf("Stopped at first breach of severity %d or worse\n", stopLevel);
+    exit(EXIT_FAILURE);
+  }
 
-  free_oi_fits(&oi);
   exit(EXIT_SUCCESS);
 
 except:
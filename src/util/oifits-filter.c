@@ -23,13 +23,149 @@
  */
 
 #include "oifilter.h"
+#include "chkmalloc.h"
 #include "glib/gstdio.h" /* g_remove() */
 
+#include <string.h>
+
 static gboolean clobber = FALSE;
+static char *split = NULL;
+static gboolean stats = FALSE;
+
+static GOptionEntry entries[] = {
+    {"clobber", 'o', 0, G_OPTION_ARG_NONE, &clobber, "Overwrite output file",
+     NULL},
+    {"split", 's', 0, G_OPTION_ARG_STRING, &split,
+     "Write one file per target, instrument or night", "target|insname|night"},
+    {"stats", 0, 0, G_OPTION_ARG_NONE, &stats,
+     "Print time spent in each processing phase and I/O counts", NULL},
+    {NULL}};
+
+/**
+ * Remove existing output file if permitted
+ *
+ * @return TRUE if file may now be written, FALSE otherwise
+ */
+static gboolean prepare_output(const char *filename)
+{
+  if (g_file_test(filename, G_FILE_TEST_EXISTS))
+  {
+    if (!clobber)
+    {
+      printf("Output file '%s' exists and '--clobber' not specified "
+             "-> Exiting...\n",
+             filename);
+      return FALSE;
+    }
+    else if (g_remove(filename))
+    {
+      printf("Failed to remove existing output file '%s'\n", filename);
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/**
+ * Make output filename for split view by inserting key value before
+ * the extension of @a outFilename
+ */
+static void get_split_filename(const char *outFilename, oi_split_key key,
+                               const oi_fits_view *pView, char *filename)
+{
+  const char *base, *ext;
+  char value[FLEN_VALUE];
+  int i;
+
+  switch (key)
+  {
+  case OI_SPLIT_TARGET:
+    g_snprintf(value, FLEN_VALUE, "target%d", pView->filter.target_id);
+    break;
+  case OI_SPLIT_INSNAME:
+    g_strlcpy(value, pView->filter.insname, FLEN_VALUE);
+    for (i = 0; value[i] != '\0'; i++)
+      if (!g_ascii_isalnum(value[i]) && value[i] != '-') value[i] = '_';
+    break;
+  case OI_SPLIT_NIGHT:
+    /* Night starts at noon on MJD given */
+    g_snprintf(value, FLEN_VALUE, "mjd%d", pView->night);
+    break;
+  }
+  base = strrchr(outFilename, G_DIR_SEPARATOR);
+  ext = strrchr((base != NULL) ? base : outFilename, '.');
+  if (ext == NULL) ext = outFilename + strlen(outFilename);
+  g_snprintf(filename, FLEN_FILENAME, "%.*s_%s%s", (int)(ext - outFilename),
+             outFilename, value, ext);
+}
+
+/**
+ * Print phase timers and I/O counters at exit
+ */
+static void print_profile(void)
+{
+  oi_profile_print(stderr);
+}
+
+/**
+ * Print allocation statistics for all threads at exit
+ */
+static void dump_alloc_stats(void)
+{
+  chkmalloc_stats_dump_total(stderr);
+}
 
-static GOptionEntry entries[] = {{"clobber", 'o', 0, G_OPTION_ARG_NONE,
-                                  &clobber, "Overwrite output file", NULL},
-                                 {NULL}};
+/**
+ * Write one filtered file per value of split key
+ */
+static int write_split(const oi_fits *pData, const char *outFilename,
+                       oi_split_key key)
+{
+  oi_fits_view *views;
+  GHashTable *filenameHash;
+  char(*filenames)[FLEN_FILENAME];
+  int i, nview, status;
+
+  status = 0;
+  nview = split_oi_fits_view(pData, get_user_oi_filter(), key, &views);
+  printf("--> Splitting into %d files\n", nview);
+
+  /* Distinct INSNAMEs may give the same filename, so check before
+   * writing anything rather than overwrite an earlier output file */
+  filenames = g_malloc_n(MAX(nview, 1), sizeof(*filenames));
+  filenameHash = g_hash_table_new(g_str_hash, g_str_equal);
+  for (i = 0; i < nview && !status; i++)
+  {
+    get_split_filename(outFilename, key, &views[i], filenames[i]);
+    if (g_hash_table_contains(filenameHash, filenames[i]))
+    {
+      printf("Output filename '%s' would be used twice\n", filenames[i]);
+      status = 1;
+    }
+    g_hash_table_add(filenameHash, filenames[i]);
+  }
+  g_hash_table_destroy(filenameHash);
+
+  for (i = 0; i < nview; i++)
+  {
+    if (!status)
+    {
+      if (prepare_output(filenames[i]))
+      {
+        printf("%s\n", filenames[i]);
+        write_oi_fits_view(filenames[i], &views[i], &status);
+      }
+      else
+      {
+        status = 1;
+      }
+    }
+    free_oi_fits_view(&views[i]);
+  }
+  g_free(filenames);
+  oi_free(views);
+  return status;
+}
 
 /**
  * Main function for command-line filter utility
@@ -39,7 +175,8 @@ int main(int argc, char *argv[])
   GError *error;
   GOptionContext *context;
   char inFilename[FLEN_FILENAME], outFilename[FLEN_FILENAME];
-  oi_fits inData, outData;
+  oi_fits data;
+  oi_split_key splitKey = OI_SPLIT_TARGET;
   int status;
 
   /* Parse command-line */
@@ -64,46 +201,64 @@ int main(int argc, char *argv[])
   }
   g_strlcpy(inFilename, argv[1], FLEN_FILENAME);
   g_strlcpy(outFilename, argv[2], FLEN_FILENAME);
+  if (split != NULL)
+  {
+    if (strcmp(split, "target") == 0)
+      splitKey = OI_SPLIT_TARGET;
+    else if (strcmp(split, "insname") == 0)
+      splitKey = OI_SPLIT_INSNAME;
+    else if (strcmp(split, "night") == 0)
+      splitKey = OI_SPLIT_NIGHT;
+    else
+    {
+      printf("Invalid split key '%s'\n"
+             "Enter '%s --help' for usage information\n",
+             split, argv[0]);
+      exit(2);
+    }
+  }
+
+  if (chkmalloc_stats_enabled()) atexit(dump_alloc_stats);
+  if (stats)
+  {
+    oi_profile_enable(TRUE);
+    atexit(print_profile);
+  }
 
   /* Read FITS file */
   status = 0;
-  read_oi_fits(inFilename, &inData, &status);
+  read_oi_fits(inFilename, &data, &status);
   if (status) goto except;
 
   /* Display summary info */
   printf("=== INPUT DATA: ===\n");
-  print_oi_fits_summary(&inData);
+  print_oi_fits_summary(&data);
   printf("=== Applying filter: ===\n");
   print_oi_filter(get_user_oi_filter());
 
-  /* Apply filter */
-  apply_user_oi_filter(&inData, &outData);
+  /* Split into several output files, all made from single copy of input */
+  if (split != NULL)
+  {
+    status = write_split(&data, outFilename, splitKey);
+    if (status) goto except;
+    free_oi_fits(&data);
+    g_option_context_free(context);
+    exit(EXIT_SUCCESS);
+  }
+
+  /* Apply filter, discarding rejected data to save memory */
+  apply_user_oi_filter_inplace(&data);
   printf("--> OUTPUT DATA: ===\n");
-  print_oi_fits_summary(&outData);
+  print_oi_fits_summary(&data);
 
   /* Check for existing output file */
-  if (g_file_test(outFilename, G_FILE_TEST_EXISTS))
-  {
-    if (!clobber)
-    {
-      printf("Output file '%s' exists and '--clobber' not specified "
-             "-> Exiting...\n",
-             outFilename);
-      exit(1);
-    }
-    else if (g_remove(outFilename))
-    {
-      printf("Failed to remove existing output file '%s'\n", outFilename);
-      exit(1);
-    }
-  }
+  if (!prepare_output(outFilename)) exit(1);
 
   /* Write out filtered data */
-  write_oi_fits(outFilename, outData, &status);
+  write_oi_fits(outFilename, data, &status);
   if (status) goto except;
 
-  free_oi_fits(&inData);
-  free_oi_fits(&outData);
+  free_oi_fits(&data);
   g_option_context_free(context);
   exit(EXIT_SUCCESS);
 
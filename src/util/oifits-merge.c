@@ -25,23 +25,123 @@
 #include "oimerge.h"
 #include "chkmalloc.h"
 
+static int njobs = 1;
+static gboolean concat = FALSE;
+static gboolean dedup = FALSE;
+static gboolean stats = FALSE;
+static gboolean stream = FALSE;
+static double targetSep = 0.0;
+
+static GOptionEntry entries[] = {
+    {"jobs", 'j', 0, G_OPTION_ARG_INT, &njobs,
+     "Read up to N input files concurrently", "N"},
+    {"concat", 'c', 0, G_OPTION_ARG_NONE, &concat,
+     "Combine data tables with the same setup (not with --stream)", NULL},
+    {"dedup", 'd', 0, G_OPTION_ARG_NONE, &dedup,
+     "Remove duplicated data records (not with --stream)", NULL},
+    {"stream", 0, 0, G_OPTION_ARG_NONE, &stream,
+     "Copy data tables to output one at a time, to merge files too large "
+     "to hold in memory together. Data tables may be in a different order",
+     NULL},
+    {"target-sep", 's', 0, G_OPTION_ARG_DOUBLE, &targetSep,
+     "Also merge targets with positions within SEP arcsec", "SEP"},
+    {"stats", 0, 0, G_OPTION_ARG_NONE, &stats,
+     "Print time spent in each processing phase and I/O counts", NULL},
+    {NULL}};
+
 /**
- * Main function for command-line check utility
+ * Print phase timers and I/O counters at exit
  */
-int main(int argc, char *argv[])
+static void print_profile(void)
+{
+  oi_profile_print(stderr);
+}
+
+/**
+ * Print allocation statistics for all threads at exit
+ */
+static void dump_alloc_stats(void)
 {
-  GList *filenameList, *inOiList, *link;
-  char *filename, *outFilename;
-  oi_fits *pOi;
+  chkmalloc_stats_dump_total(stderr);
+}
+
+/**
+ * Merge files in memory, removing duplicate records and/or
+ * concatenating compatible tables as requested, and print summary
+ */
+static int merge_in_memory(const GList *filenameList, const char *outFilename)
+{
+  GList *inList, *link;
   oi_fits outOi;
+  int status;
+
+  status = 0;
+  inList = read_oi_fits_list(filenameList, njobs, &status);
+  if (status) return status;
+  merge_oi_fits_list_steal(inList, targetSep, &outOi);
+  for (link = inList; link != NULL; link = link->next)
+  {
+    free_oi_fits(link->data);
+    oi_free(link->data);
+  }
+  g_list_free(inList);
+  if (dedup)
+    printf("Removed %ld duplicate records\n", dedup_oi_fits(&outOi, TRUE));
+  if (concat) concat_oi_fits_tables(&outOi);
+
+  printf("=== MERGED DATA: ===\n");
+  print_oi_fits_summary(&outOi);
+  write_oi_fits(outFilename, outOi, &status);
+  free_oi_fits(&outOi);
+  return status;
+}
+
+/**
+ * Main function for command-line merge utility
+ */
+int main(int argc, char *argv[])
+{
+  GError *error;
+  GOptionContext *context;
+  GList *filenameList;
+  char *outFilename;
   int status, i, num;
 
   /* Parse command-line */
-  if (argc < 4)
+  error = NULL;
+  context = g_option_context_new(
+      "OUTFILE INFILE1 INFILE2... - merge datasets into new file");
+  g_option_context_add_main_entries(context, entries, NULL);
+  g_option_context_parse(context, &argc, &argv, &error);
+  g_option_context_free(context);
+  if (error != NULL)
   {
-    printf("Usage:\n%s OUTFILE INFILE1 INFILE2...\n", argv[0]);
+    printf("Error parsing command-line options: %s\n", error->message);
+    g_error_free(error);
     exit(2); /* standard unix behaviour */
   }
+  if (argc < 4)
+  {
+    printf("Wrong number of command-line arguments\n"
+           "Enter '%s --help' for usage information\n",
+           argv[0]);
+    exit(2);
+  }
+  if (njobs < 1)
+  {
+    printf("Number of jobs must be at least 1\n");
+    exit(2);
+  }
+  if (stream && (concat || dedup))
+  {
+    printf("Option '--stream' cannot be used with '--concat' or '--dedup'\n");
+    exit(2);
+  }
+  if (njobs > 1 && !fits_is_reentrant())
+  {
+    printf("CFITSIO is not thread-safe, reading one file at a time\n");
+    njobs = 1;
+  }
   outFilename = argv[1];
   filenameList = NULL;
   num = argc - 2;
@@ -50,43 +150,27 @@ int main(int argc, char *argv[])
     filenameList = g_list_append(filenameList, argv[2 + i]);
   }
 
-  /* Read input files */
-  status = 0;
-  inOiList = NULL;
-  link = filenameList;
-  while (link != NULL)
+  if (chkmalloc_stats_enabled()) atexit(dump_alloc_stats);
+  if (stats)
   {
-    filename = (char *)link->data;
-    pOi = chkmalloc(sizeof(oi_fits));
-    read_oi_fits(filename, pOi, &status);
-    if (status) goto except;
-    inOiList = g_list_append(inOiList, pOi);
-    link = link->next;
+    oi_profile_enable(TRUE);
+    atexit(print_profile);
   }
 
-  /* Do merge */
-  merge_oi_fits_list(inOiList, &outOi);
-
-  /* Display summary info for merged data */
-  printf("=== MERGED DATA: ===\n");
-  print_oi_fits_summary(&outOi);
-
-  /* Write out merged data */
-  write_oi_fits(outFilename, outOi, &status);
-  if (status) goto except;
-
-  /* Free storage */
-  g_list_free(filenameList);
-  link = inOiList;
-  while (link != NULL)
+  /* Do merge, in memory unless streaming data tables from input files
+   * to output was requested */
+  status = 0;
+  if (stream)
   {
-    pOi = (oi_fits *)link->data;
-    free_oi_fits(pOi);
-    free(pOi);
-    link = link->next;
+    merge_oi_fits_files(filenameList, njobs, targetSep, outFilename, &status);
+    if (!status) printf("Merged %d files into '%s'\n", num, outFilename);
   }
-  g_list_free(inOiList);
-  free_oi_fits(&outOi);
+  else
+  {
+    status = merge_in_memory(filenameList, outFilename);
+  }
+  g_list_free(filenameList);
+  if (status) goto except;
 
   exit(EXIT_SUCCESS);
 